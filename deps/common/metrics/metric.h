@@ -21,12 +21,14 @@ namespace common {
 
 class Metric {
 public:
+  virtual ~Metric() {}
+
   virtual void snapshot() = 0;
 
   virtual Snapshot *get_snapshot() { return snapshot_value_; }
 
 protected:
-  Snapshot *snapshot_value_;
+  Snapshot *snapshot_value_ = nullptr;
 };
 
 }//namespace common
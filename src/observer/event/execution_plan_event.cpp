@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "event/execution_plan_event.h"
 #include "event/sql_event.h"
+#include "sql/optimizer/optimizer.h"
 
 ExecutionPlanEvent::ExecutionPlanEvent(SQLStageEvent *sql_event, Query *sqls) : sql_event_(sql_event), sqls_(sqls) {
 }
@@ -25,5 +26,13 @@ ExecutionPlanEvent::~ExecutionPlanEvent() {
 
   query_destroy(sqls_);
   sqls_ = nullptr;
+
+  delete select_plan_;
+  select_plan_ = nullptr;
+}
+
+void ExecutionPlanEvent::set_select_plan(SelectPlan *select_plan) {
+  delete select_plan_;
+  select_plan_ = select_plan;
 }
 
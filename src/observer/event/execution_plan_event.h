@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/parse.h"
 
 class SQLStageEvent;
+struct SelectPlan;
 
 class ExecutionPlanEvent : public common::StageEvent {
 public:
@@ -32,9 +33,18 @@ public:
   SQLStageEvent * sql_event() const {
     return sql_event_;
   }
+
+  /**
+   * 优化器为select语句选出的执行计划，其它语句为nullptr
+   */
+  const SelectPlan * select_plan() const {
+    return select_plan_;
+  }
+  void set_select_plan(SelectPlan *select_plan);
 private:
   SQLStageEvent *      sql_event_;
   Query *             sqls_;
+  SelectPlan *        select_plan_ = nullptr;
 };
 
 #endif // __OBSERVER_EVENT_EXECUTION_PLAN_EVENT_H__
\ No newline at end of file
@@ -36,6 +36,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/plan_cache/plan_cache_stage.h"
 #include "sql/query_cache/query_cache_stage.h"
 #include "storage/default/default_storage_stage.h"
+#include "storage/default/page_cleaner_stage.h"
 #include "storage/mem/mem_storage_stage.h"
 
 using namespace common;
@@ -155,6 +156,8 @@ int prepare_init_seda() {
                                             &DefaultStorageStage::make_stage);
   static StageFactory mem_storage_factory("MemStorageStage",
                                         &MemStorageStage::make_stage);
+  static StageFactory page_cleaner_factory("PageCleanerStage",
+                                         &PageCleanerStage::make_stage);
   return 0;
 }
 
@@ -79,6 +79,7 @@ const char *strrc(RC rc) {
     RC_CASE_STRING(RECORD_SCANOPENNED);
     RC_CASE_STRING(RECORD_EOF);
     RC_CASE_STRING(RECORD_RECORD_NOT_EXIST);
+    RC_CASE_STRING(RECORD_NOT_RECORD_PAGE);
 
     RC_CASE_STRING(SCHEMA_DB_EXIST);
     RC_CASE_STRING(SCHEMA_DB_NOT_EXIST);
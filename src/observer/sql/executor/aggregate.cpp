@@ -1,27 +1,9 @@
-#include <memory>
-#include <string>
-#include <sstream>
+#include <string.h>
 #include <cmath>
-#include <algorithm>
-#include <unordered_map>
+#include <functional>
 
-#include "execute_stage.h"
-#include "common/io/io.h"
 #include "common/log/log.h"
-#include "common/seda/timer_stage.h"
-#include "common/lang/string.h"
-#include "session/session.h"
-#include "event/storage_event.h"
-#include "event/sql_event.h"
-#include "event/session_event.h"
-#include "event/execution_plan_event.h"
-#include "sql/executor/execution_node.h"
-#include "sql/executor/tuple.h"
 #include "sql/executor/aggregate.h"
-#include "storage/common/table.h"
-#include "storage/default/default_handler.h"
-#include "storage/common/condition_filter.h"
-#include "storage/trx/trx.h"
 
 bool is_valid_aggre(const char *attr) {  // number, float, *
     if (strcmp("*", attr) == 0) {
@@ -46,88 +28,602 @@ bool is_valid_aggre(const char *attr) {  // number, float, *
 }
 
 
-RC AggregateMinValue::add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) {
-    RC rc = RC::SUCCESS;
-    if (tuple_value->is_null()) {
-        return rc;
+
+bool is_float_output(AttrType attr_type, AggreType aggre_type){
+    if ( attr_type == AttrType::FLOATS ){
+        return true;
     }
-    if (value_.get() == nullptr || value_->compare(*tuple_value) > 0) {
-        value_ = tuple_value;
+    if ( aggre_type == AggreType::AVG ){
+        return true;
     }
-    return rc;
+    return false;
 }
 
-RC AggregateMaxValue::add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) {
-    RC rc = RC::SUCCESS;
-    if (tuple_value->is_null()) {
-        return rc;
+// 估计每个分组除了键以外占用的内存
+static const size_t GROUP_OVERHEAD = 64;
+static const size_t ACCUMULATOR_SIZE = 16;
+
+static int int_value(const TupleValue &value) {
+    int result;
+    memcpy(&result, value.get_value_pointer(), sizeof(result));
+    return result;
+}
+
+static float float_value(const TupleValue &value) {
+    float result;
+    memcpy(&result, value.get_value_pointer(), sizeof(result));
+    return result;
+}
+
+/**
+ * 写到临时文件时占位用的空值，读出来之后根据空值标记还原成nullptr
+ */
+static void add_null(Tuple &tuple, AttrType type) {
+    int null_data = 0;
+    memcpy(&null_data, "!", 1);
+    switch (type) {
+        case INTS: {
+            tuple.add(null_data);
+        } break;
+        case FLOATS: {
+            float value;
+            memcpy(&value, &null_data, sizeof(value));
+            tuple.add(value);
+        } break;
+        case DATES: {
+            tuple.add(null_data, true);
+        } break;
+        case TEXTS: {
+            std::string value("!");
+            tuple.add(value);
+        } break;
+        default: {
+            tuple.add("!", 1);
+        } break;
     }
-    if (value_.get() == nullptr || value_->compare(*tuple_value) < 0) {
-        value_ = tuple_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void GroupHashTable::clear() {
+    slots_.clear();
+    keys_.clear();
+    hashes_.clear();
+    key_bytes_ = 0;
+}
+
+int GroupHashTable::find(const std::string &key, size_t hash) const {
+    if (slots_.empty()) {
+        return -1;
+    }
+    const size_t mask = slots_.size() - 1;
+    for (size_t pos = hash & mask; ; pos = (pos + 1) & mask) {
+        int group = slots_[pos];
+        if (group < 0) {
+            return -1;
+        }
+        if (hashes_[group] == hash && keys_[group] == key) {
+            return group;
+        }
     }
-    return rc;
 }
 
-RC AggregateAvgValue::add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) {
-    RC rc = RC::SUCCESS;
-    if (type != FLOATS && type != INTS) {
-        rc = RC::GENERIC_ERROR;
-        return rc;
+int GroupHashTable::insert(std::string &&key, size_t hash) {
+    // 负载因子不超过1/2，探测的长度比较短
+    if ((keys_.size() + 1) * 2 > slots_.size()) {
+        grow();
     }
-    if (tuple_value->is_null()) {
-        return rc;
+    const size_t mask = slots_.size() - 1;
+    size_t pos = hash & mask;
+    while (slots_[pos] >= 0) {
+        pos = (pos + 1) & mask;
+    }
+
+    int group = (int)keys_.size();
+    slots_[pos] = group;
+    key_bytes_ += key.size();
+    keys_.push_back(std::move(key));
+    hashes_.push_back(hash);
+    return group;
+}
+
+void GroupHashTable::grow() {
+    size_t capacity = slots_.empty() ? 64 : slots_.size() * 2;
+    slots_.assign(capacity, -1);
+    const size_t mask = capacity - 1;
+    for (size_t group = 0; group < hashes_.size(); group++) {
+        size_t pos = hashes_[group] & mask;
+        while (slots_[pos] >= 0) {
+            pos = (pos + 1) & mask;
+        }
+        slots_[pos] = (int)group;
+    }
+}
+
+size_t GroupHashTable::memory() const {
+    return slots_.size() * sizeof(int) + keys_.size() * (sizeof(std::string) + sizeof(size_t)) + key_bytes_;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const int HashAggregateExeNode::PARTITION_BITS;
+const int HashAggregateExeNode::PARTITION_NUM;
+const int HashAggregateExeNode::MAX_SPILL_LEVEL;
+
+HashAggregateExeNode::~HashAggregateExeNode() {
+    for (SortRun *run : result_runs_) {
+        delete run;
     }
-    if (type == FLOATS) {
-        FloatValue *float_value = dynamic_cast<FloatValue *>(tuple_value.get());
-        sum += float_value->get_value();
-        all_null_ = false;
-    } else {
-        IntValue *int_value = dynamic_cast<IntValue *>(tuple_value.get());
-        sum += int_value->get_value();
-        all_null_ = false;
+    result_runs_.clear();
+    delete child_;
+    child_ = nullptr;
+}
+
+RC HashAggregateExeNode::init(ExecutionNode *child, const TupleSchema &output_schema,
+                              const std::vector<RelAttr> &groupby, const SortOptions &options) {
+    child_ = child;
+    tuple_schema_ = output_schema;
+    options_ = options;
+
+    const TupleSchema &input_schema = child->schema();
+    for (const RelAttr &attr : groupby) {
+        int index = input_schema.index_of_field(attr.relation_name, attr.attribute_name);
+        if (index < 0) {
+            LOG_WARN("No such field in group by. %s.%s", attr.relation_name, attr.attribute_name);
+            return RC::SCHEMA_FIELD_NOT_EXIST;
+        }
+        groupby_indexes_.push_back(index);
+    }
+
+    for (const TupleField &field : output_schema.fields()) {
+        AggregateColumn column;
+        column.aggre_type = field.aggre_type;
+        column.float_output = is_float_output(field.type(), field.aggre_type);
+        if (is_valid_aggre(field.field_name())) {
+            // count(*)、count(1)不关心字段的值
+            column.index = 0;
+            column.count_all = field.aggre_type == AggreType::COUNT;
+        } else {
+            column.index = input_schema.index_of_field(field.table_name(), field.field_name());
+            column.count_all = false;
+        }
+        if (column.index < 0 || column.index >= (int)input_schema.fields().size()) {
+            LOG_WARN("No such field in aggregation. %s.%s", field.table_name(), field.field_name());
+            return RC::SCHEMA_FIELD_NOT_EXIST;
+        }
+        column.attr_type = input_schema.field(column.index).type();
+        columns_.push_back(std::move(column));
+    }
+
+    partition_schema_ = input_schema;
+    partition_schema_.add(INTS, "", "__row");
+    for (const AggregateColumn &column : columns_) {
+        result_schema_.add(output_type(column), "", "");
+    }
+    result_schema_.add(CHARS, "", "__nulls");
+    result_schema_.add(INTS, "", "__row");
+    return RC::SUCCESS;
+}
+
+double HashAggregateExeNode::estimated_rows() const {
+    if (groupby_indexes_.empty()) {
+        return 1;
+    }
+    return child_->estimated_rows();
+}
+
+AttrType HashAggregateExeNode::output_type(const AggregateColumn &column) const {
+    switch (column.aggre_type) {
+        case COUNT:
+        case AVG: {
+            return FLOATS;
+        }
+        default: {
+            return column.attr_type;
+        }
+    }
+}
+
+void HashAggregateExeNode::reset_groups() {
+    hash_table_.clear();
+    first_rows_.clear();
+    group_memory_ = 0;
+    for (AggregateColumn &column : columns_) {
+        column.counts.clear();
+        column.ints.clear();
+        column.floats.clear();
+        column.values.clear();
     }
-    count += 1;
-    return rc;
 }
 
-RC AggregateCountValue::add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) {
-    if ( (tuple_value->is_null() && count_null) || (!tuple_value->is_null()) ) {
-        count += 1;
+RC HashAggregateExeNode::make_key(const Tuple &tuple, std::string &key) const {
+    const TupleSchema &input_schema = child_->schema();
+    for (int index : groupby_indexes_) {
+        const TupleValue &value = tuple.get(index);
+        if (value.is_null()) {
+            key.push_back('\0');
+            continue;
+        }
+        key.push_back('\1');
+        switch (input_schema.field(index).type()) {
+            case INTS:
+            case FLOATS:
+            case DATES: {
+                const char *data = (const char *)value.get_value_pointer();
+                key.append(data, sizeof(int));
+            } break;
+            default: {
+                // 带上长度，避免两个字段的值拼在一起后与其它分组相同
+                std::string s = value.get_string_value();
+                int len = (int)s.size();
+                key.append((const char *)&len, sizeof(len));
+                key.append(s);
+            } break;
+        }
     }
     return RC::SUCCESS;
 }
 
-RC AggregateNonValue::add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) {
-    tuple_value_ = tuple_value;
+int HashAggregateExeNode::add_group(std::string &&key, size_t hash, int row_id) {
+    group_memory_ += key.size() + GROUP_OVERHEAD + columns_.size() * ACCUMULATOR_SIZE;
+    int group = hash_table_.insert(std::move(key), hash);
+    first_rows_.push_back(row_id);
+    for (AggregateColumn &column : columns_) {
+        column.counts.push_back(0);
+        switch (column.aggre_type) {
+            case COUNT: {
+            } break;
+            case AVG: {
+                column.floats.push_back(0);
+            } break;
+            case MIN:
+            case MAX: {
+                if (column.attr_type == INTS) {
+                    column.ints.push_back(0);
+                } else if (column.attr_type == FLOATS) {
+                    column.floats.push_back(0);
+                } else {
+                    column.values.emplace_back();
+                }
+            } break;
+            default: {
+                column.values.emplace_back();
+            } break;
+        }
+    }
+    return group;
+}
+
+RC HashAggregateExeNode::accumulate(int group, const Tuple &tuple) {
+    for (AggregateColumn &column : columns_) {
+        const std::shared_ptr<TupleValue> &value = tuple.get_pointer(column.index);
+        switch (column.aggre_type) {
+            case COUNT: {
+                if (column.count_all || !value->is_null()) {
+                    column.counts[group]++;
+                }
+            } break;
+            case AVG: {
+                if (column.attr_type != INTS && column.attr_type != FLOATS) {
+                    LOG_WARN("Cannot calculate average of type %d", column.attr_type);
+                    return RC::GENERIC_ERROR;
+                }
+                if (value->is_null()) {
+                    break;
+                }
+                column.floats[group] += column.attr_type == INTS ? int_value(*value) : float_value(*value);
+                column.counts[group]++;
+            } break;
+            case MIN:
+            case MAX: {
+                if (value->is_null()) {
+                    break;
+                }
+                const bool is_min = column.aggre_type == MIN;
+                const bool first = column.counts[group] == 0;
+                if (column.attr_type == INTS) {
+                    int v = int_value(*value);
+                    if (first || (is_min ? v < column.ints[group] : v > column.ints[group])) {
+                        column.ints[group] = v;
+                    }
+                } else if (column.attr_type == FLOATS) {
+                    float v = float_value(*value);
+                    if (first || (is_min ? v < column.floats[group] : v > column.floats[group])) {
+                        column.floats[group] = v;
+                    }
+                } else {
+                    if (first) {
+                        column.values[group] = value;
+                    } else {
+                        int result = column.values[group]->compare(*value);
+                        if (is_min ? result > 0 : result < 0) {
+                            column.values[group] = value;
+                        }
+                    }
+                }
+                column.counts[group]++;
+            } break;
+            default: {
+                // 不是聚合的字段取最后一行的值
+                column.values[group] = value;
+            } break;
+        }
+    }
     return RC::SUCCESS;
 }
 
-std::shared_ptr<TupleValue> AggregateMinValue::value() {
-    // 需要在处理精度问题
-    return value_;
+void HashAggregateExeNode::output_group(int group, Tuple &tuple) const {
+    for (const AggregateColumn &column : columns_) {
+        switch (column.aggre_type) {
+            case COUNT: {
+                float value = column.counts[group];
+                if (column.float_output) {
+                    value = round(100 * value) / 100.0;
+                }
+                tuple.add(value);
+            } break;
+            case AVG: {
+                if (column.counts[group] == 0) {
+                    tuple.add(std::shared_ptr<TupleValue>());
+                    break;
+                }
+                float value = round(100 * column.floats[group] / column.counts[group]) / 100.0;
+                value = round(100 * value) / 100.0;
+                tuple.add(value);
+            } break;
+            case MIN:
+            case MAX: {
+                if (column.counts[group] == 0) {
+                    tuple.add(std::shared_ptr<TupleValue>());
+                } else if (column.attr_type == INTS) {
+                    tuple.add(column.ints[group]);
+                } else if (column.attr_type == FLOATS) {
+                    float value = round(100 * column.floats[group]) / 100.0;
+                    tuple.add(value);
+                } else {
+                    tuple.add(column.values[group]);
+                }
+            } break;
+            default: {
+                const std::shared_ptr<TupleValue> &value = column.values[group];
+                if (column.float_output && column.attr_type == FLOATS && !value->is_null()) {
+                    float fvalue = round(100 * float_value(*value)) / 100.0;
+                    tuple.add(fvalue);
+                } else {
+                    tuple.add(value);
+                }
+            } break;
+        }
+    }
+}
+
+RC HashAggregateExeNode::aggregate(SortRun *input, int level, std::vector<SortRun *> &partitions) {
+    RC rc = RC::SUCCESS;
+    std::hash<std::string> hash_fn;
+    const int row_index = (int)child_->schema().fields().size();
+    while (true) {
+        Tuple tuple;
+        int row_id;
+        if (input == nullptr) {
+            rc = child_->next(tuple);
+            row_id = row_num_++;
+        } else {
+            rc = input->next(tuple);
+            row_id = rc == RC::SUCCESS ? int_value(tuple.get(row_index)) : 0;
+        }
+        if (rc != RC::SUCCESS) {
+            break;
+        }
+
+        std::string key;
+        make_key(tuple, key);
+        size_t hash = hash_fn(key);
+        int group = hash_table_.find(key, hash);
+        if (group < 0) {
+            if (partitions.empty() && level < MAX_SPILL_LEVEL &&
+                hash_table_.memory() + group_memory_ > options_.memory_limit) {
+                for (int i = 0; i < PARTITION_NUM; i++) {
+                    SortRun *partition = new SortRun;
+                    partitions.push_back(partition);
+                    rc = partition->create(options_.temp_dir, partition_schema_);
+                    if (rc != RC::SUCCESS) {
+                        return rc;
+                    }
+                }
+            }
+            if (!partitions.empty()) {
+                // 每一层使用哈希值中不同的位分区，哈希表使用低位
+                int partition = (hash >> (sizeof(size_t) * 8 - PARTITION_BITS * (level + 1))) % PARTITION_NUM;
+                if (input == nullptr) {
+                    tuple.add(row_id);
+                }
+                rc = partitions[partition]->append(tuple);
+                if (rc != RC::SUCCESS) {
+                    return rc;
+                }
+                continue;
+            }
+            group = add_group(std::move(key), hash, row_id);
+        }
+        rc = accumulate(group, tuple);
+        if (rc != RC::SUCCESS) {
+            return rc;
+        }
+    }
+    return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+RC HashAggregateExeNode::write_groups() {
+    if (hash_table_.group_num() == 0) {
+        return RC::SUCCESS;
+    }
+    SortRun *run = new SortRun;
+    result_runs_.push_back(run);
+    RC rc = run->create(options_.temp_dir, result_schema_);
+    for (int group = 0; rc == RC::SUCCESS && group < hash_table_.group_num(); group++) {
+        Tuple values;
+        output_group(group, values);
+
+        Tuple tuple;
+        std::string nulls;
+        for (size_t i = 0; i < columns_.size(); i++) {
+            const std::shared_ptr<TupleValue> &value = values.get_pointer(i);
+            if (value == nullptr) {
+                add_null(tuple, result_schema_.field(i).type());
+                nulls.push_back('1');
+            } else {
+                tuple.add(value);
+                nulls.push_back('0');
+            }
+        }
+        tuple.add(nulls.data(), nulls.size());
+        tuple.add(first_rows_[group]);
+        rc = run->append(tuple);
+    }
+    if (rc == RC::SUCCESS) {
+        rc = run->finish();
+    }
+    return rc;
+}
+
+RC HashAggregateExeNode::spill_and_merge(std::vector<SortRun *> &partitions) {
+    RC rc = write_groups();
+
+    // 每个分区单独聚合，结果按分组第一次出现的行号有序，最后归并恢复原来的顺序
+    std::vector<std::pair<SortRun *, int>> pending;
+    for (SortRun *partition : partitions) {
+        pending.emplace_back(partition, 1);
+    }
+    spilled_partition_num_ += partitions.size();
+    partitions.clear();
+
+    while (!pending.empty()) {
+        SortRun *partition = pending.back().first;
+        int level = pending.back().second;
+        pending.pop_back();
+
+        std::vector<SortRun *> sub_partitions;
+        if (rc == RC::SUCCESS) {
+            rc = partition->finish();
+        }
+        if (rc == RC::SUCCESS && partition->row_num() > 0) {
+            reset_groups();
+            rc = aggregate(partition, level, sub_partitions);
+            if (rc == RC::SUCCESS) {
+                rc = write_groups();
+            }
+        }
+        delete partition;
+        spilled_partition_num_ += sub_partitions.size();
+        for (SortRun *sub_partition : sub_partitions) {
+            pending.emplace_back(sub_partition, level + 1);
+        }
+    }
+    reset_groups();
+    if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to aggregate spilled partitions. rc=%d:%s", rc, strrc(rc));
+        return rc;
+    }
+    LOG_INFO("Aggregation spilled %d partitions to %s", spilled_partition_num_, options_.temp_dir.c_str());
+
+    const int way_num = result_runs_.size();
+    heads_.clear();
+    heads_.resize(way_num);
+    exhausted_.assign(way_num, false);
+    for (int i = 0; i < way_num; i++) {
+        rc = result_runs_[i]->next(heads_[i]);
+        if (rc == RC::RECORD_EOF) {
+            exhausted_[i] = true;
+        } else if (rc != RC::SUCCESS) {
+            return rc;
+        }
+    }
+    loser_tree_.init(way_num, [this](int left, int right) { return less(left, right); });
+    return RC::SUCCESS;
 }
 
-std::shared_ptr<TupleValue> AggregateMaxValue::value() {
-    // 需要在处理精度问题
-    return value_;
+bool HashAggregateExeNode::less(int left_way, int right_way) const {
+    if (exhausted_[left_way]) {
+        return false;
+    }
+    if (exhausted_[right_way]) {
+        return true;
+    }
+    const int row_index = columns_.size() + 1;
+    return int_value(heads_[left_way].get(row_index)) < int_value(heads_[right_way].get(row_index));
 }
 
-std::shared_ptr<TupleValue> AggregateAvgValue::value() {
-    if(all_null_){
-        return nullptr;
+RC HashAggregateExeNode::open() {
+    reset_groups();
+    row_num_ = 0;
+    group_pos_ = 0;
+    empty_row_done_ = false;
+    spilled_partition_num_ = 0;
+
+    RC rc = child_->open();
+    if (rc != RC::SUCCESS) {
+        return rc;
+    }
+
+    std::vector<SortRun *> partitions;
+    rc = aggregate(nullptr, 0, partitions);
+    if (rc == RC::SUCCESS && !partitions.empty()) {
+        rc = spill_and_merge(partitions);
+    }
+    for (SortRun *partition : partitions) {
+        delete partition;
     }
-    float avg = round(100*(float)sum/count)/100.0;
-    std::shared_ptr<TupleValue> value = std::make_shared<FloatValue>(avg);
-    return value;
+    return rc;
 }
 
-std::shared_ptr<TupleValue> AggregateCountValue::value() {
-    std::shared_ptr<TupleValue> value = std::make_shared<FloatValue>(count);
-    return value;
+RC HashAggregateExeNode::next(Tuple &tuple) {
+    if (!result_runs_.empty()) {
+        int way = loser_tree_.top();
+        if (way < 0 || exhausted_[way]) {
+            return RC::RECORD_EOF;
+        }
+        const Tuple &head = heads_[way];
+        std::string nulls = head.get(columns_.size()).get_string_value();
+        for (size_t i = 0; i < columns_.size(); i++) {
+            if (nulls[i] == '1') {
+                tuple.add(std::shared_ptr<TupleValue>());
+            } else {
+                tuple.add(head.get_pointer(i));
+            }
+        }
+
+        Tuple next_head;
+        RC rc = result_runs_[way]->next(next_head);
+        if (rc == RC::SUCCESS) {
+            heads_[way] = std::move(next_head);
+        } else if (rc == RC::RECORD_EOF) {
+            exhausted_[way] = true;
+        } else {
+            return rc;
+        }
+        loser_tree_.adjust(way);
+        return RC::SUCCESS;
+    }
+
+    if (group_pos_ < hash_table_.group_num()) {
+        output_group(group_pos_++, tuple);
+        return RC::SUCCESS;
+    }
+    if (groupby_indexes_.empty() && hash_table_.group_num() == 0 && !empty_row_done_) {
+        for (size_t i = 0; i < columns_.size(); i++) {
+            tuple.add(std::shared_ptr<TupleValue>());
+        }
+        empty_row_done_ = true;
+        return RC::SUCCESS;
+    }
+    return RC::RECORD_EOF;
 }
 
-std::shared_ptr<TupleValue> AggregateNonValue::value() {
-    // std::shared_ptr<TupleValue> value(&tuple_value_);
-    // return value;
-    return tuple_value_;
+RC HashAggregateExeNode::close() {
+    for (SortRun *run : result_runs_) {
+        delete run;
+    }
+    result_runs_.clear();
+    heads_.clear();
+    exhausted_.clear();
+    reset_groups();
+    return child_->close();
 }
@@ -1,304 +1,139 @@
+#ifndef __OBSERVER_SQL_EXECUTOR_AGGREGATE_H_
+#define __OBSERVER_SQL_EXECUTOR_AGGREGATE_H_
+
 #include <memory>
 #include <string>
-#include <sstream>
-#include <cmath>
-#include <algorithm>
-#include <unordered_map>
+#include <vector>
 
-#include "execute_stage.h"
-#include "common/io/io.h"
-#include "common/log/log.h"
-#include "common/seda/timer_stage.h"
-#include "common/lang/string.h"
-#include "session/session.h"
-#include "event/storage_event.h"
-#include "event/sql_event.h"
-#include "event/session_event.h"
-#include "event/execution_plan_event.h"
+#include "rc.h"
 #include "sql/executor/execution_node.h"
-#include "sql/executor/tuple.h"
-#include "storage/common/table.h"
-#include "storage/default/default_handler.h"
-#include "storage/common/condition_filter.h"
-#include "storage/trx/trx.h"
+#include "sql/executor/external_sort.h"
 
 bool is_valid_aggre(const char *attr);
 
-class AggregateValue {
+/**
+ * 以group by字段的值为键的开放寻址哈希表，使用线性探测。
+ * 分组号按第一次插入的顺序从0开始分配，聚合的中间结果按分组号保存在数组中
+ */
+class GroupHashTable {
 public:
-    AggregateValue() = default;
-    virtual RC add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) = 0;
-    virtual std::shared_ptr<TupleValue> value() = 0;
-    virtual ~AggregateValue() {
-    }
-protected:
-};
+    GroupHashTable() = default;
 
-class AggregateMaxValue : public AggregateValue {
-public:
-    AggregateMaxValue() = default;
-    ~AggregateMaxValue() = default;
-    RC add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) override;
-    std::shared_ptr<TupleValue> value() override;
-private:
-    std::shared_ptr<TupleValue> value_;
-};
+    void clear();
 
-class AggregateMinValue : public AggregateValue {
-public:
-    AggregateMinValue() = default;
-    ~AggregateMinValue() = default;
-    RC add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) override;
-    std::shared_ptr<TupleValue> value() override;
-private:
-    std::shared_ptr<TupleValue> value_;
-};
+    /**
+     * 查找key所在的分组，没有时返回-1
+     */
+    int find(const std::string &key, size_t hash) const;
 
-class AggregateAvgValue : public AggregateValue {
-public:
-    AggregateAvgValue(): sum(0), count(0), all_null_(true) {
-    }
-    ~AggregateAvgValue() = default;
-    RC add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) override;
-    std::shared_ptr<TupleValue> value() override;
-private:
-    float sum;
-    int count;
-    bool all_null_;
-};
+    /**
+     * 插入一个新的分组，返回分组号。调用前需要确认key不存在
+     */
+    int insert(std::string &&key, size_t hash);
 
-class AggregateCountValue : public AggregateValue {
-public:
-    AggregateCountValue(): count(0) {
+    int group_num() const {
+        return (int)keys_.size();
     }
-    ~AggregateCountValue() = default;
-    RC add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) override;
-    std::shared_ptr<TupleValue> value() override;
+
+    /**
+     * 估计哈希表本身占用的内存，不包含聚合的中间结果
+     */
+    size_t memory() const;
+
 private:
-    int count;
-};
+    void grow();
 
-class AggregateNonValue : public AggregateValue {
-public:
-    AggregateNonValue(): tuple_value_(nullptr){
-    }
-    ~AggregateNonValue() = default;
-    RC add(const std::shared_ptr<TupleValue> &tuple_value, AttrType type, bool count_null) override;
-    std::shared_ptr<TupleValue> value() override;
 private:
-    std::shared_ptr<TupleValue> tuple_value_;
+    std::vector<int> slots_;  // 保存分组号，-1表示空
+    std::vector<std::string> keys_;
+    std::vector<size_t> hashes_;
+    size_t key_bytes_ = 0;
 };
 
-class AggregateExeNode {
+/**
+ * 哈希聚合。每个聚合字段的中间结果按类型保存在数组中，不为每个分组创建对象。
+ * 分组占用的内存超过限制后，不再创建新的分组，属于新分组的行按哈希值写到临时文件的分区中，
+ * 已有分组的数据处理完后再逐个分区聚合。输出的分组按第一次出现的顺序排列。子节点由本节点释放
+ */
+class HashAggregateExeNode : public ExecutionNode {
 public:
-    AggregateExeNode() = default;
-    ~AggregateExeNode() = default;
-    
-    RC add_value(const std::shared_ptr<TupleValue> &tuple_value, int index, 
-                    AggreType agg_type, AttrType attr_type, bool count_null) {
-        AggregateValue* value = record_map[index].get();
-        if (value == nullptr) {
-            if (agg_type == COUNT) {
-                value = new AggregateCountValue();
-            } else if (agg_type == MIN) {
-                value = new AggregateMinValue();
-            } else if (agg_type == MAX) {
-                value = new AggregateMaxValue();
-            } else if (agg_type == AVG) {
-                value = new AggregateAvgValue();
-            } else if ( agg_type == NON ) {
-                value = new AggregateNonValue();
-            }
-            record_map[index].reset(value);
-        }
-        return value->add(tuple_value, attr_type, count_null);
+    static const int PARTITION_BITS = 4;
+    static const int PARTITION_NUM = 1 << PARTITION_BITS;
+    static const int MAX_SPILL_LEVEL = 3;  // 分区还是太大时再次分区的最多次数
+
+    HashAggregateExeNode() = default;
+    virtual ~HashAggregateExeNode();
+
+    /**
+     * @param output_schema 输出的字段，带有聚合类型
+     * @param groupby group by的字段，需要已经填好表名
+     */
+    RC init(ExecutionNode *child, const TupleSchema &output_schema, const std::vector<RelAttr> &groupby,
+            const SortOptions &options);
+
+    RC open() override;
+    RC next(Tuple &tuple) override;
+    RC close() override;
+
+    const TupleSchema &schema() const override {
+        return tuple_schema_;
     }
+    double estimated_rows() const override;
 
-    std::shared_ptr<TupleValue> get_value(int index) {
-        if (record_map.size() == 0) return nullptr;
-        return record_map[index]->value();
+    /**
+     * 写到临时文件中的分区个数，没有超过内存限制时为0
+     */
+    int spilled_partition_num() const {
+        return spilled_partition_num_;
     }
 
-    size_t size() {
-        return record_map.size();
-    }
 private:
-    std::unordered_map<int, std::unique_ptr<AggregateValue>> record_map;
-};
-
-class GroupHandler {
-public:
-    GroupHandler() = default;
-    ~GroupHandler() = default;
-    int get_group(const Tuple &tuple, const std::vector<RelAttr> &groupby_attr, const TupleSchema &output_schema){
-        // Tuple *new_tupe = std::move(tuple);
-        int hashed = 0;
-        for(auto &groupby : groupby_attr){
-            int index = output_schema.index_of_field(groupby.relation_name, groupby.attribute_name);
-            // const TupleValue & tuple_value = tuple.get(index);
-            // TupleValue *tuple_value_addr = const_cast<TupleValue*>(&tuple_value);
-
-            // std::string value = (dynamic_cast<StringValue*>(tuple_value_addr))->get_string_value();
-            std::string value = tuple.get(index).get_string_value();
-            hashed += hash_fn(value);
-        }
-        if(string_group_map.find(hashed)==string_group_map.end()){
-            string_group_map[hashed] = string_group_map.size();
-        }
-        return string_group_map[hashed];
-    }
+    struct AggregateColumn {
+        AggreType aggre_type;
+        AttrType attr_type;     // 输入字段的类型
+        int index;              // 输入字段的位置
+        bool count_all;         // count(*)、count(1)，空值也计数
+        bool float_output;      // 输出时保留两位小数
+
+        std::vector<int> counts;    // COUNT的结果，其它聚合中非空值的个数
+        std::vector<int> ints;      // 整数的MIN/MAX
+        std::vector<float> floats;  // 浮点数的MIN/MAX，AVG的和
+        std::vector<std::shared_ptr<TupleValue>> values;  // 其它类型的MIN/MAX，以及不是聚合的字段
+    };
+
+    void reset_groups();
+    RC make_key(const Tuple &tuple, std::string &key) const;
+    int add_group(std::string &&key, size_t hash, int row_id);
+    RC accumulate(int group, const Tuple &tuple);
+    void output_group(int group, Tuple &tuple) const;
+    AttrType output_type(const AggregateColumn &column) const;
+
+    RC aggregate(SortRun *input, int level, std::vector<SortRun *> &partitions);
+    RC write_groups();
+    RC spill_and_merge(std::vector<SortRun *> &partitions);
+    bool less(int left_way, int right_way) const;
 
-    size_t get_group_num(){
-       return string_group_map.size();
-    }
 private:
-    std::unordered_map<int, int> string_group_map;
-    std::hash<std::string> hash_fn;
-protected:
+    ExecutionNode *child_ = nullptr;
+    TupleSchema tuple_schema_;
+    SortOptions options_;
+    TupleSchema partition_schema_;  // 分区中的行在输入的字段后面加上行号
+    TupleSchema result_schema_;     // 分区的聚合结果在输出的字段后面加上空值标记和行号
+    std::vector<int> groupby_indexes_;
+    std::vector<AggregateColumn> columns_;
+
+    GroupHashTable hash_table_;
+    std::vector<int> first_rows_;  // 每个分组第一次出现的行号，用来恢复输出顺序
+    size_t group_memory_ = 0;
+    int row_num_ = 0;
+    int group_pos_ = 0;
+    bool empty_row_done_ = false;  // 没有group by并且没有数据时，输出一行空值
+
+    int spilled_partition_num_ = 0;
+    std::vector<SortRun *> result_runs_;  // 溢出后每个分区的聚合结果，最后一列是行号
+    std::vector<Tuple> heads_;
+    std::vector<bool> exhausted_;
+    LoserTree loser_tree_;
 };
 
-/*
-    do_aggregate(const Selects &selects, TupleSet &tuple_set, TupleSet &aggred_tupleset) {
-        Tuple aggred_tuple;
-        for(size_t i = 0; i < selects.attr_num; i++) {
-          RelAttr attr = selects.attributes[selects.attr_num - 1 - i];
-          int index = 0;
-          char parsed[100];
-          bool count_null = false;
-          parse_attr(attr.attribute_name, attr.aggre_type, parsed);
-          if(attr.aggre_type != NON && is_valid_aggre(parsed, attr.aggre_type)){  // count(1)\ count(*)\ etc..
-              index = 0;
-              count_null = true;
-           } else {
-             index = tuple_set.get_schema().index_of_field(selects.relations[0], parsed);
-             count_null = false;
-          }
-          if (attr.aggre_type == COUNT){
-            if(count_null) {
-              aggred_tuple.add(tuple_set.size());
-            } else {
-              // null check here
-                int count = 0;
-                for(auto &temp1:tuple_set.tuples()){
-                  if(temp1.get(index).is_null()) continue;
-                  else count++;
-                }
-                aggred_tuple.add(count);
-            }
-          } else if(attr.aggre_type == MIN){
-            int min_index = 0;
-            while(min_index < tuple_set.size() && (tuple_set.get(min_index).get(index).is_null())){
-              min_index++;
-            }
-            for(size_t j = min_index + 1; j < tuple_set.size(); j++){
-              if(tuple_set.get(j).get(index).is_null()) continue;
-              if(tuple_set.get(min_index).get(index).compare(tuple_set.get(j).get(index)) > 0){
-                min_index = j;
-              }
-            }
-            int t1 = 0;
-            bool flag = false;
-            for (auto &temp1: tuple_set.tuples()) {
-                int t2 = 0;
-                for (auto &value: temp1.values()) {
-                    if (t1 == min_index && t2 == index) {
-                        if (tuple_set.get_schema().field(index).type() == FLOATS) {
-                            FloatValue *floatvalue = dynamic_cast<FloatValue *>(value.get());
-                            float fvalue = round(100 * (floatvalue->get_value())) / 100.0;
-                            aggred_tuple.add(fvalue);
-                        } else {
-                            aggred_tuple.add(value);
-                        }
-                        flag = true;
-                        break;
-                    }
-                    t2++;
-                }
-                if (flag) break;
-                t1++;
-            }
-        } else if (attr.aggre_type == MAX) {
-            int max_index = 0;
-            while(max_index<tuple_set.size() && (tuple_set.get(max_index).get(index).is_null())){
-              max_index++;
-            }
-            for(size_t j = max_index + 1; j < tuple_set.size(); j++){
-              if(tuple_set.get(j).get(index).is_null()) continue;
-              if(tuple_set.get(max_index).get(index).compare(tuple_set.get(j).get(index)) < 0){
-                max_index = j;
-              }
-            }
-            int t1 = 0;
-            bool flag = false;
-            for (auto &temp1: tuple_set.tuples()) {
-                int t2 = 0;
-                for (auto &value: temp1.values()) {
-                    if (t1 == max_index && t2 == index) {
-                        if (tuple_set.get_schema().field(index).type() == FLOATS) {
-                            FloatValue *floatvalue = dynamic_cast<FloatValue *>(value.get());
-                            float fvalue = round(100 * (floatvalue->get_value())) / 100.0;
-                            aggred_tuple.add(fvalue);
-                        } else {
-                            aggred_tuple.add(value);
-                        }
-
-                        flag = true;
-                        break;
-                    }
-                    t2++;
-                }
-                if (flag) break;
-                t1++;
-            }
-        } else if (attr.aggre_type == AVG) {
-            AttrType type = tuple_set.get_schema().field(index).type();
-            if (type != FLOATS && type != INTS) {
-                return RC::GENERIC_ERROR;
-            }
-            if(type == FLOATS){
-                float sum  = 0.0;
-                int count = 0;
-                for(auto &temp1:tuple_set.tuples()){
-                  if(temp1.get(index).is_null()) continue;
-                  int t2 = 0;
-                  for(auto &value : temp1.values()){
-                    if(t2==index){
-                        count++;
-                        FloatValue *floatvalue = dynamic_cast<FloatValue *>(value.get());
-                        sum+=floatvalue->get_value();
-                        break;  // changed here directly
-                    }
-                  }
-                }
-                float avg = round(100 * sum / tuple_set.size()) / 100.0;
-                aggred_tuple.add(avg);
-
-            }
-            if (type == INTS) {
-                int sum = 0;
-                int count = 0;
-                for(auto &temp1:tuple_set.tuples()){
-                  if(temp1.get(index).is_null()) continue;
-                  int t2 = 0;
-                  for(auto &value : temp1.values()){
-                    if(t2==index){
-                        count++;
-                        IntValue *intvalue = dynamic_cast<IntValue *>(value.get());
-                        sum+=intvalue->get_value();
-                        break;
-                    }
-                  }
-                }
-                float avg = round(100*(float)sum/count)/100.0;
-                aggred_tuple.add(avg);
-            }
-        }
-
-    }
-    aggred_tupleset.add(std::move(aggred_tuple));
-    return RC::SUCCESS;
-}
-
-private:
-
-}; */
+#endif  //__OBSERVER_SQL_EXECUTOR_AGGREGATE_H_
@@ -16,12 +16,14 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
 #include "execute_stage.h"
 
 #include "sql/executor/aggregate.h"
+#include "common/conf/ini.h"
 #include "common/io/io.h"
 #include "common/log/log.h"
 #include "common/seda/timer_stage.h"
@@ -33,6 +35,7 @@ See the Mulan PSL v2 for more details. */
 #include "event/execution_plan_event.h"
 #include "sql/executor/execution_node.h"
 #include "sql/executor/tuple.h"
+#include "sql/optimizer/optimizer.h"
 #include "storage/common/table.h"
 #include "storage/default/default_handler.h"
 #include "storage/common/condition_filter.h"
@@ -40,28 +43,18 @@ See the Mulan PSL v2 for more details. */
 
 using namespace common;
 
+const char *CONF_SORT_MEMORY_LIMIT = "SortMemoryLimit";
+const char *CONF_TEMP_DIR = "TempDir";
+
 static RC create_selection_executor(Trx *trx, const Selects &selects, Table *table, 
                     const char *table_name, SelectExeNode &select_node);
 
-static RC cross_join(std::vector<TupleSet> &tuple_sets, const Selects &selects, 
-                    const std::vector<SelectExeNode*> &select_nodes,
-                    TupleSet &tuple_set);
-
-static RC do_cross_join(std::vector<TupleSet> &tuple_sets, int index,
-                    std::vector<std::vector<const Condition *>> &conditions,
-                    TupleSet &tuple_set, 
-                    std::unordered_map<std::string, const Tuple*> &tuples_map,
-                    std::unordered_map<std::string, const TupleSchema*> &schemas_map);
-
-static bool do_filter(std::vector<const Condition *> &conditions, 
-                    std::unordered_map<std::string, const Tuple*> &tuples_map,
-                    std::unordered_map<std::string, const TupleSchema*> &schemas_map);
-
-static void gen_conditions_group(std::list<const Condition *> &conditions,
-                            std::list<const Condition *> &match_conditions,
-                            std::vector<std::vector<const Condition*>> &conditions_group,
-                            std::vector<TupleSet> &tuple_sets, 
-                            int index);
+static RC create_join_executor(const Selects &selects, const std::vector<SelectExeNode *> &select_nodes,
+                               const std::vector<int> &join_order, const SortOptions &sort_options,
+                               bool keep_order, ExecutionNode *&root);
+static RC create_sort_executor(const Selects &selects, const SortOptions &sort_options, ExecutionNode *&root);
+static RC create_aggregate_executor(const Selects &selects, const TupleSchema &output_schema,
+                                    const SortOptions &sort_options, ExecutionNode *&root);
 
 static RC schema_add_field(Table *table, const char *field_name, TupleSchema &schema);
 //! Constructor
@@ -78,20 +71,33 @@ Stage *ExecuteStage::make_stage(const std::string &tag) {
         LOG_ERROR("new ExecuteStage failed");
         return nullptr;
     }
-    stage->set_properties();
+    if (!stage->set_properties()) {
+        LOG_ERROR("Failed to set properties of ExecuteStage");
+        delete stage;
+        return nullptr;
+    }
     return stage;
 }
 
 //! Set properties for this object set in stage specific properties
 bool ExecuteStage::set_properties() {
-    //  std::string stageNameStr(stageName);
-    //  std::map<std::string, std::string> section = theGlobalProperties()->get(
-    //    stageNameStr);
-    //
-    //  std::map<std::string, std::string>::iterator it;
-    //
-    //  std::string key;
-
+    std::string stageNameStr(stage_name_);
+    std::map<std::string, std::string> section = get_properties()->get(stageNameStr);
+
+    // 排序、排序归并连接和哈希聚合使用的内存超过限制时，把数据写到临时文件中
+    std::map<std::string, std::string>::iterator iter = section.find(CONF_SORT_MEMORY_LIMIT);
+    if (iter != section.end()) {
+        long long memory_limit = 0;
+        if (!str_to_val(iter->second, memory_limit) || memory_limit <= 0) {
+            LOG_ERROR("Invalid config %s: %s", CONF_SORT_MEMORY_LIMIT, iter->second.c_str());
+            return false;
+        }
+        sort_options_.memory_limit = (size_t)memory_limit;
+    }
+    iter = section.find(CONF_TEMP_DIR);
+    if (iter != section.end()) {
+        sort_options_.temp_dir = iter->second;
+    }
     return true;
 }
 
@@ -151,7 +157,7 @@ void ExecuteStage::handle_request(common::StageEvent *event) {
 
     switch (sql->flag) {
         case SCF_SELECT: { // select
-            do_select(current_db, sql, exe_event->sql_event()->session_event(), nullptr);
+            do_select(current_db, sql, exe_event->sql_event()->session_event(), nullptr, exe_event->select_plan());
             exe_event->done_immediate();
         }
         break;
@@ -162,6 +168,7 @@ void ExecuteStage::handle_request(common::StageEvent *event) {
         case SCF_CREATE_TABLE:
         case SCF_SHOW_TABLES:
         case SCF_DESC_TABLE:
+        case SCF_ANALYZE_TABLE:
         case SCF_DROP_TABLE:
         case SCF_CREATE_INDEX:
         case SCF_DROP_INDEX:
@@ -209,6 +216,7 @@ void ExecuteStage::handle_request(common::StageEvent *event) {
                                    "desc `table name`;\n"
                                    "create table `table name` (`column name` `column type`, ...);\n"
                                    "create index `index name` on `table` (`column`);\n"
+                                   "analyze table `table`;\n"
                                    "insert into `table` values(`value1`,`value2`);\n"
                                    "update `table` set column=value [where `column`=`value`];\n"
                                    "delete from `table` [where `column`=`value`];\n"
@@ -274,7 +282,8 @@ bool is_valid_date(int date) {
 }
 // 这里没有对输入的某些信息做合法性校验，比如查询的列名、where条件中的列名等，没有做必要的合法性校验
 // 需要补充上这一部分. 校验部分也可以放在resolve，不过跟execution放一起也没有关系
-RC ExecuteStage::do_select(const char *db, Query *sql, SessionEvent *session_event, TupleSet *ret_tupleset) {
+RC ExecuteStage::do_select(const char *db, Query *sql, SessionEvent *session_event, TupleSet *ret_tupleset,
+                           const SelectPlan *plan) {
     RC rc = RC::SUCCESS;
     Session *session = session_event->get_client()->session;
     Trx *trx = session->current_trx();
@@ -317,7 +326,7 @@ RC ExecuteStage::do_select(const char *db, Query *sql, SessionEvent *session_eve
                 return RC::INVALID_ARGUMENT;
             }
             TupleSet *subselection_res = new TupleSet();
-            do_select(db, subselection, session_event, subselection_res);
+            do_select(db, subselection, session_event, subselection_res, nullptr);
 
             sql->sstr.selection.conditions[i].left_type = VALUE;
             // sql->sstr.selection.conditions[i].left_value.type = subselection_res->get_schema().field(0).type();
@@ -366,7 +375,7 @@ RC ExecuteStage::do_select(const char *db, Query *sql, SessionEvent *session_eve
                 return RC::INVALID_ARGUMENT;
             }
             TupleSet *subselection_res = new TupleSet();
-            do_select(db, subselection, session_event, subselection_res);
+            do_select(db, subselection, session_event, subselection_res, nullptr);
 
             sql->sstr.selection.conditions[i].right_type = VALUE;
             // sql->sstr.selection.conditions[i].right_value.type = subselection_res->get_schema().field(0).type();
@@ -488,112 +497,148 @@ RC ExecuteStage::do_select(const char *db, Query *sql, SessionEvent *session_eve
         return RC::SQL_SYNTAX;
     }
 
-    std::vector<TupleSet> tuple_sets;
-    for (SelectExeNode *&node: select_nodes) {
-        TupleSet tuple_set;
-        rc = node->execute(tuple_set);
-        if (rc != RC::SUCCESS) {
-            for (SelectExeNode *&tmp_node: select_nodes) {
-                delete tmp_node;
+    // 关联子查询会在from中加入外层的表，这时执行计划与语句不一致，不再使用
+    if (plan != nullptr && plan->accesses.size() != select_nodes.size()) {
+        plan = nullptr;
+    }
+    std::vector<int> join_order;
+    if (plan != nullptr) {
+        for (size_t i = 0; i < select_nodes.size(); i++) {
+            const TableAccess &access = plan->accesses[i];
+            select_nodes[i]->set_estimated_rows(access.rows);
+            if (access.index != nullptr) {
+                select_nodes[i]->set_index_lookup(access.index, access.range);
             }
-            end_trx_if_need(session, trx, false);
-            return rc;
-        } else {
-            tuple_sets.push_back(std::move(tuple_set));
+        }
+        join_order = plan->join_order;
+    } else {
+        for (int i = select_nodes.size() - 1; i >= 0; i--) {
+            join_order.push_back(i);
         }
     }
 
-    TupleSchema output_scheam;
-    rc = gen_output_scheam(tables_map, selects, output_scheam);
+    // 多张表时按照连接顺序逐个做连接，所有执行节点都由根节点释放
+    const bool multi_table = select_nodes.size() != 1;
+    // 没有ORDER BY时输出的顺序与嵌套循环连接一致，否则连接可以按任意顺序输出
+    ExecutionNode *root = nullptr;
+    rc = create_join_executor(selects, select_nodes, join_order, sort_options_, selects.orderbys_num == 0, root);
     if (rc != RC::SUCCESS) {
         snprintf(response, sizeof(response), "FAILURE\n");
         session_event->set_response(response);
-        for (SelectExeNode *&tmp_node: select_nodes) {
-            delete tmp_node;
-        }
         end_trx_if_need(session, trx, false);
         return rc;
     }
-    output_scheam.set_groupby(selects.groupby_attr, selects.groupby_num, selects.relations[0]);
-
-    // 这里需要将多个tuple_set合成一个tuple_set, 但是这不是最后输出的那个tuple_set
-    TupleSet tuple_set;
-    if (select_nodes.size() > 1) {
-        // 本次查询了多张表，需要做join操作
-        RC rc = cross_join(tuple_sets, selects, select_nodes, tuple_set);
+    if (selects.orderbys_num > 0) {
+        rc = create_sort_executor(selects, sort_options_, root);
         if (rc != RC::SUCCESS) {
             snprintf(response, sizeof(response), "FAILURE\n");
             session_event->set_response(response);
-            for (SelectExeNode *&select_node: select_nodes) {
-                delete select_node;
-            }
+            delete root;
             end_trx_if_need(session, trx, false);
             return rc;
         }
-    } else {
-        // 当前只查询一张表，直接返回结果即可
-        tuple_set = std::move(tuple_sets.front());
     }
 
-    if (selects.orderbys_num > 0) {
-        RC rc = tuple_set.sort(selects);
+    TupleSchema output_scheam;
+    rc = gen_output_scheam(tables_map, selects, output_scheam);
+    if (rc != RC::SUCCESS) {
+        snprintf(response, sizeof(response), "FAILURE\n");
+        session_event->set_response(response);
+        delete root;
+        end_trx_if_need(session, trx, false);
+        return rc;
+    }
+
+    bool is_aggregate = false;
+    for (const TupleField &field : output_scheam.fields()) {
+        if (field.aggre_type != AggreType::NON) {
+            is_aggregate = true;
+        }
+    }
+    if (is_aggregate) {
+        rc = create_aggregate_executor(selects, output_scheam, sort_options_, root);
         if (rc != RC::SUCCESS) {
             snprintf(response, sizeof(response), "FAILURE\n");
             session_event->set_response(response);
-            for (SelectExeNode *&select_node: select_nodes) {
-                delete select_node;
-            }
+            delete root;
             end_trx_if_need(session, trx, false);
             return rc;
         }
     }
 
-    if(ret_tupleset!=nullptr){
-        TupleSchema ret_output_scheam;
-        for (int i = 0; i < selects.attr_num; i++) {
-            const RelAttr &attr = selects.attributes[i];
-            const char *table_name = attr.relation_name != nullptr ? attr.relation_name : selects.relations[0];
-            AttrType attr_type = output_scheam.field(i).type();
-            if (attr.aggre_type == AggreType::AVG) {
-                attr_type = FLOATS;
+    if (ret_tupleset == nullptr) {
+        // 每取出一行就投影到输出结果中，不保存中间结果。聚合的结果已经是输出的字段
+        TupleSet tuple_set1; //最后输出的tuple_set
+        tuple_set1.set_schema(output_scheam);
+        RC project_rc = RC::SUCCESS;
+        rc = root->open();
+        while (rc == RC::SUCCESS) {
+            Tuple tuple;
+            rc = root->next(tuple);
+            if (rc == RC::SUCCESS && is_aggregate) {
+                tuple_set1.add(std::move(tuple));
+            } else if (rc == RC::SUCCESS) {
+                project_rc = tuple_set1.add_projected(root->schema(), tuple);
+                if (project_rc != RC::SUCCESS) {
+                    break;
+                }
             }
-            ret_output_scheam.add(attr_type, table_name, attr.attribute_name, attr.aggre_type);
         }
-        ret_tupleset->set_schema(output_scheam);
-        rc = ret_tupleset->set_tuple_set(std::move(tuple_set));
-        ret_tupleset->set_schema(ret_output_scheam);
-        if (rc != RC::SUCCESS) {
+        root->close();
+        delete root;
+        if (project_rc != RC::SUCCESS) {
             snprintf(response, sizeof(response), "FAILURE\n");
             session_event->set_response(response);
-            for (SelectExeNode *&tmp_node: select_nodes) {
-                delete tmp_node;
-            }
             end_trx_if_need(session, trx, false);
-            return rc;
+            return project_rc;
         }
-    } else {
-        TupleSet tuple_set1; //最后输出的tuple_set
-        tuple_set1.set_schema(output_scheam);
-        rc = tuple_set1.set_tuple_set(std::move(tuple_set));
-        if (rc != RC::SUCCESS) {
+        if (rc != RC::RECORD_EOF) {
+            LOG_ERROR("Failed to read the result of select. rc=%d:%s", rc, strrc(rc));
             snprintf(response, sizeof(response), "FAILURE\n");
             session_event->set_response(response);
-            for (SelectExeNode *&tmp_node: select_nodes) {
-                delete tmp_node;
-            }
             end_trx_if_need(session, trx, false);
             return rc;
         }
 
         std::stringstream ss;
-        tuple_set1.print(ss, select_nodes.size() != 1);
-        for (SelectExeNode *&tmp_node: select_nodes) {
-            delete tmp_node;
-        }
+        tuple_set1.print(ss, multi_table);
         session_event->set_response(ss.str());
         end_trx_if_need(session, trx, true);
+        return RC::SUCCESS;
+    }
+
+    // 子查询需要拿到所有的数据
+    TupleSet tuple_set;
+    rc = root->execute(tuple_set);
+    delete root;
+    if (rc != RC::SUCCESS) {
+        end_trx_if_need(session, trx, false);
         return rc;
     }
+
+    TupleSchema ret_output_scheam;
+    for (int i = 0; i < selects.attr_num; i++) {
+        const RelAttr &attr = selects.attributes[i];
+        const char *table_name = attr.relation_name != nullptr ? attr.relation_name : selects.relations[0];
+        AttrType attr_type = output_scheam.field(i).type();
+        if (attr.aggre_type == AggreType::AVG) {
+            attr_type = FLOATS;
+        }
+        ret_output_scheam.add(attr_type, table_name, attr.attribute_name, attr.aggre_type);
+    }
+    if (is_aggregate) {
+        *ret_tupleset = std::move(tuple_set);
+    } else {
+        ret_tupleset->set_schema(output_scheam);
+        rc = ret_tupleset->set_tuple_set(std::move(tuple_set));
+    }
+    ret_tupleset->set_schema(ret_output_scheam);
+    if (rc != RC::SUCCESS) {
+        snprintf(response, sizeof(response), "FAILURE\n");
+        session_event->set_response(response);
+        end_trx_if_need(session, trx, false);
+    }
+    return rc;
 }
 
 RC ExecuteStage::gen_output_scheam(std::unordered_map<std::string, Table*> &tables_map, 
@@ -814,154 +859,117 @@ RC create_selection_executor(Trx *trx, const Selects &selects, Table *table,
     return select_node.init(trx, table, std::move(schema), std::move(condition_filters));
 }
 
-RC cross_join(std::vector<TupleSet> &tuple_sets, const Selects &selects, 
-                    const std::vector<SelectExeNode*> &select_nodes,
-                    TupleSet &tuple_set) {
-    TupleSchema scheam;
-    std::unordered_map<std::string, const TupleSchema*> schemas_map;
-
-    for (auto& tuple_set1 : tuple_sets) {
-        std::string table_name(tuple_set1.get_schema().fields()[0].table_name());
-        schemas_map[table_name] = &tuple_set1.get_schema();
-        scheam.append(tuple_set1.get_schema());
-    }
-    tuple_set.set_schema(scheam);
-
+// 按照join_order逐个做连接，第一张表在最外层。输出时按字段名投影，字段的顺序与连接顺序无关。
+// 两边是不同表字段的条件，在它涉及的表都连接进来之后计算。失败时释放所有的执行节点
+static RC create_join_executor(const Selects &selects, const std::vector<SelectExeNode *> &select_nodes,
+                               const std::vector<int> &join_order, const SortOptions &sort_options,
+                               bool keep_order, ExecutionNode *&root) {
     std::list<const Condition *> conditions;
     for (size_t i = 0; i < selects.condition_num; i++) {
         const Condition &condition = selects.conditions[i];
         if (condition.left_type == ATTR && condition.right_type == ATTR &&
+            condition.left_attr.relation_name != nullptr && condition.right_attr.relation_name != nullptr &&
             0 != strcmp(condition.left_attr.relation_name, condition.right_attr.relation_name)) {
             conditions.push_back(&condition);
         }
     }
-    
-    std::list<const Condition *> match_conditions;
-    std::vector<std::vector<const Condition*>> conditions_group(tuple_sets.size());
-    gen_conditions_group(conditions, match_conditions, conditions_group, tuple_sets, tuple_sets.size() - 1);
-
-    std::unordered_map<std::string, const Tuple*> tuples_map;
-    return do_cross_join(tuple_sets, tuple_sets.size() - 1, conditions_group, tuple_set, tuples_map, schemas_map);
-}
-
-void gen_conditions_group(std::list<const Condition *> &conditions,
-                            std::list<const Condition *> &match_conditions,
-                            std::vector<std::vector<const Condition*>> &conditions_group,
-                            std::vector<TupleSet> &tuple_sets, 
-                            int index) {
-    if (index == -1) {
-        return;
-    }
-
-    const TupleSet &tuple_set = tuple_sets[index];
-    const std::vector<TupleField> &fields = tuple_set.get_schema().fields();
-    std::string table_name(fields[0].table_name());
 
-    for (auto iter = match_conditions.begin(); iter != match_conditions.end();) {
-        auto tmp = iter;
-        iter++;
-        std::string left_table((*tmp)->left_attr.relation_name);
-        std::string right_table((*tmp)->right_attr.relation_name);
-        if (left_table == table_name || right_table == table_name) {
-            conditions_group[index].push_back(*tmp);
-            match_conditions.erase(tmp);
-        }
-    }
-    for (auto iter = conditions.begin(); iter != conditions.end();) {
-        auto tmp = iter;
-        iter++;
-        std::string left_table((*tmp)->left_attr.relation_name);
-        std::string right_table((*tmp)->right_attr.relation_name);
-        if (left_table == table_name || right_table == table_name) {
-            match_conditions.push_back(*tmp);
-            conditions.erase(tmp);
+    root = select_nodes[join_order[0]];
+    std::set<std::string> joined_tables;
+    joined_tables.insert(selects.relations[join_order[0]]);
+    RC rc = RC::SUCCESS;
+    for (size_t pos = 1; pos < join_order.size(); pos++) {
+        const int index = join_order[pos];
+        joined_tables.insert(selects.relations[index]);
+        std::vector<const Condition *> join_conditions;
+        for (auto iter = conditions.begin(); iter != conditions.end();) {
+            if (joined_tables.count((*iter)->left_attr.relation_name) != 0 &&
+                joined_tables.count((*iter)->right_attr.relation_name) != 0) {
+                join_conditions.push_back(*iter);
+                iter = conditions.erase(iter);
+            } else {
+                ++iter;
+            }
         }
-    }
-    gen_conditions_group(conditions, match_conditions, conditions_group, tuple_sets, index - 1);
-}
-
-RC do_cross_join(std::vector<TupleSet> &tuple_sets, int index, 
-                    std::vector<std::vector<const Condition *>> &conditions_group,
-                    TupleSet &tuple_set, 
-                    std::unordered_map<std::string, const Tuple*> &tuples_map,
-                    std::unordered_map<std::string, const TupleSchema*> &schemas_map) {
-
-    if (index == -1) {
-        Tuple new_tuple;
-        // TODO: 这个地方可以优化
-        const std::vector<TupleField> &tuple_fields = tuple_set.get_schema().fields();
-        for (auto& tuple_field : tuple_fields) {
-            std::string table_name(tuple_field.table_name());
-            int i = schemas_map[table_name]->index_of_field(table_name.c_str(), tuple_field.field_name());
-            std::shared_ptr<TupleValue> value_ptr = tuples_map[table_name]->get_pointer(i);
-            new_tuple.add(value_ptr);
-        }
-        tuple_set.add(std::move(new_tuple));
-        return RC::SUCCESS;
-    }
 
-    const TupleSet &tuple_set1 = tuple_sets[index];
-    const std::vector<Tuple> &tuples = tuple_set1.tuples();
-    const std::vector<TupleField> &fields = tuple_set1.get_schema().fields();
-    std::string table_name(fields[0].table_name());
+        // 外层的行比内层少并且内层的连接字段上有索引时，逐行在索引中查找；
+        // 否则有等值条件时用哈希连接，都不满足时只能嵌套循环
+        if (root->estimated_rows() < select_nodes[index]->estimated_rows() &&
+            IndexJoinExeNode::support(*root, *select_nodes[index], join_conditions)) {
+            IndexJoinExeNode *join_node = new IndexJoinExeNode;
+            rc = join_node->init(root, select_nodes[index], std::move(join_conditions));
+            root = join_node;
+        } else if (HashJoinExeNode::support(*root, *select_nodes[index], join_conditions)) {
+            // 哈希表建在较小的一边，需要保持嵌套循环的顺序时建在内层，内存放不下时改用排序归并连接
+            const ExecutionNode &build_node =
+                    !keep_order && root->estimated_rows() < select_nodes[index]->estimated_rows() ?
+                    *root : *select_nodes[index];
+            double build_size = build_node.estimated_rows() * estimated_tuple_size(build_node.schema());
+            if (build_size > sort_options.memory_limit) {
+                MergeJoinExeNode *join_node = new MergeJoinExeNode;
+                rc = join_node->init(root, select_nodes[index], std::move(join_conditions), sort_options, keep_order);
+                root = join_node;
+            } else {
+                HashJoinExeNode *join_node = new HashJoinExeNode;
+                rc = join_node->init(root, select_nodes[index], std::move(join_conditions), keep_order);
+                root = join_node;
+            }
+        } else {
+            JoinExeNode *join_node = new JoinExeNode;
+            rc = join_node->init(root, select_nodes[index], std::move(join_conditions));
+            root = join_node;
+        }
 
-    int size = tuples.size();
-    for (int i = 0; i < size; i++) {
-        tuples_map[table_name] = &tuples[i];
-        if (do_filter(conditions_group[index], tuples_map, schemas_map)) {
-            RC rc = do_cross_join(tuple_sets, index - 1, conditions_group, tuple_set, tuples_map, schemas_map);
-            if (rc != RC::SUCCESS) {
-                return rc;
+        if (rc != RC::SUCCESS) {
+            // 连接节点已经拥有两边的子节点，释放它就释放了已经连接的部分，剩下的表单独释放
+            LOG_ERROR("Failed to init join node of table %s. rc=%d:%s", selects.relations[index], rc, strrc(rc));
+            delete root;
+            root = nullptr;
+            for (size_t rest = pos + 1; rest < join_order.size(); rest++) {
+                delete select_nodes[join_order[rest]];
             }
+            return rc;
         }
     }
-
     return RC::SUCCESS;
 }
 
-static bool do_filter(std::vector<const Condition *> &conditions, 
-                    std::unordered_map<std::string, const Tuple*> &tuples_map,
-                    std::unordered_map<std::string, const TupleSchema*> &schemas_map) {
-
-    for (auto &condition : conditions) {
-        std::string left_table(condition->left_attr.relation_name);
-        std::string right_table(condition->right_attr.relation_name);
-        char *left_attr = condition->left_attr.attribute_name;
-        char *right_attr = condition->right_attr.attribute_name;
-
-        int i = schemas_map[left_table]->index_of_field(left_table.c_str(), left_attr);
-        int j = schemas_map[right_table]->index_of_field(right_table.c_str(), right_attr);
-        if ( i == -1 || j == -1) {
-            return false;
+static RC create_sort_executor(const Selects &selects, const SortOptions &sort_options, ExecutionNode *&root) {
+    std::vector<SortKey> keys;
+    for (size_t i = 0; i < selects.orderbys_num; i++) {
+        const Orderby &orderby = selects.orderbys[i];
+        const char *table_name = orderby.attr.relation_name;
+        if (table_name == nullptr) {
+            table_name = selects.relations[0];
         }
-        const TupleValue &tuple_value1 = tuples_map[left_table]->get(i);
-        const TupleValue &tuple_value2 = tuples_map[right_table]->get(j);
+        int index = root->schema().index_of_field(table_name, orderby.attr.attribute_name);
+        if (index < 0) {
+            LOG_WARN("No such field in order by. %s.%s", table_name, orderby.attr.attribute_name);
+            return RC::SCHEMA_FIELD_NAME_ILLEGAL;
+        }
+        keys.push_back(SortKey{index, orderby.asc_desc == OrderType::O_AES});
+    }
 
-        bool left_is_null = tuple_value1.is_null();
-        bool right_is_null = tuple_value2.is_null();
+    SortExeNode *sort_node = new SortExeNode;
+    sort_node->init(root, std::move(keys), sort_options);
+    root = sort_node;
+    return RC::SUCCESS;
+}
 
-        if (left_is_null && right_is_null) {
-            if (!(condition->comp == IS_COMPOP)) {
-                return false;
-            }
-        } else if (left_is_null || right_is_null) {
-            if (!(condition->comp == IS_NOT_COMPOP)) {
-               return false;
-            }
-        } else {  // notnull comop notnull
-            int result = tuple_value1.compare(tuple_value2);
-            if ((result == 0 && (condition->comp == CompOp::EQUAL_TO || condition->comp == CompOp::GREAT_EQUAL ||
-                                condition->comp == CompOp::LESS_EQUAL)) ||
-                (result == 1 && (condition->comp == CompOp::GREAT_THAN || condition->comp == CompOp::GREAT_EQUAL ||
-                                condition->comp == CompOp::NOT_EQUAL)) ||
-                (result == -1 && (condition->comp == CompOp::LESS_THAN || condition->comp == CompOp::LESS_EQUAL ||
-                                condition->comp == CompOp::NOT_EQUAL))) {
-                // do nothing
-            } else {
-                return false;
-            }
+static RC create_aggregate_executor(const Selects &selects, const TupleSchema &output_schema,
+                                    const SortOptions &sort_options, ExecutionNode *&root) {
+    std::vector<RelAttr> groupby;
+    for (size_t i = 0; i < selects.groupby_num; i++) {
+        RelAttr attr = selects.groupby_attr[i];
+        if (attr.relation_name == nullptr) {
+            attr.relation_name = selects.relations[0];
         }
+        groupby.push_back(attr);
     }
 
-    return true;
+    HashAggregateExeNode *aggregate_node = new HashAggregateExeNode;
+    RC rc = aggregate_node->init(root, output_schema, groupby, sort_options);
+    // 子节点已经交给聚合节点，失败时由调用者一起释放
+    root = aggregate_node;
+    return rc;
 }
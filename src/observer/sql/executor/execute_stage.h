@@ -19,8 +19,10 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/parse.h"
 #include "rc.h"
 #include "tuple.h"
+#include "sql/executor/external_sort.h"
 #include <unordered_map>
 class SessionEvent;
+struct SelectPlan;
 
 class ExecuteStage : public common::Stage {
 public:
@@ -39,7 +41,11 @@ protected:
                      common::CallbackContext *context) override;
 
   void handle_request(common::StageEvent *event);
-  RC do_select(const char *db, Query *sql, SessionEvent *session_event, TupleSet *ret_tupleset);
+  /**
+   * @param plan 优化器选出的执行计划，为nullptr时按照from中表的顺序执行
+   */
+  RC do_select(const char *db, Query *sql, SessionEvent *session_event, TupleSet *ret_tupleset,
+               const SelectPlan *plan);
   RC gen_output_scheam(std::unordered_map<std::string, Table*> &tables_map,
                 const Selects &selects, TupleSchema &output_scheam);
   RC do_aggregate(const Selects &selects, TupleSet &tuple_set, TupleSet &aggred_tupleset);
@@ -47,6 +53,7 @@ protected:
 private:
   Stage *default_storage_stage_ = nullptr;
   Stage *mem_storage_stage_ = nullptr;
+  SortOptions sort_options_;
 };
 
 #endif //__OBSERVER_SQL_EXECUTE_STAGE_H__
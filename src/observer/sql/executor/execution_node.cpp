@@ -12,14 +12,43 @@ See the Mulan PSL v2 for more details. */
 // Created by Wangyunlai on 2021/5/14.
 //
 
+#include <string.h>
+#include <algorithm>
+
 #include "sql/executor/execution_node.h"
+#include "sql/executor/vectorized.h"
 #include "storage/common/table.h"
+#include "storage/common/index.h"
+#include "storage/common/record_manager.h"
 #include "common/log/log.h"
 
+RC ExecutionNode::execute(TupleSet &tuple_set) {
+  tuple_set.clear();
+  tuple_set.set_schema(schema());
+
+  RC rc = open();
+  if (rc != RC::SUCCESS) {
+    close();
+    return rc;
+  }
+  while (true) {
+    Tuple tuple;
+    rc = next(tuple);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+    tuple_set.add(std::move(tuple));
+  }
+  close();
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
 SelectExeNode::SelectExeNode() : table_(nullptr) {
 }
 
 SelectExeNode::~SelectExeNode() {
+  close_index_scanner();
+  delete select_;
   for (DefaultConditionFilter * &filter : condition_filters_) {
     delete filter;
   }
@@ -35,20 +64,624 @@ SelectExeNode::init(Trx *trx, Table *table, TupleSchema &&tuple_schema, std::vec
   return RC::SUCCESS;
 }
 
-void record_reader(const char *data, void *context) {
-  TupleRecordConverter *converter = (TupleRecordConverter *)context;
-  converter->add_record(data);
+RC SelectExeNode::prepare() {
+  if (select_ == nullptr) {
+    select_ = new VectorizedSelect(table_);
+    RC rc = select_->init(tuple_schema_, condition_filters_);
+    if (rc != RC::SUCCESS) {
+      delete select_;
+      select_ = nullptr;
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
 }
-RC SelectExeNode::execute(TupleSet &tuple_set) {
-  CompositeConditionFilter condition_filter;
-  condition_filter.init((const ConditionFilter **)condition_filters_.data(), condition_filters_.size());
 
-  tuple_set.clear();
-  tuple_set.set_schema(tuple_schema_);
+RC SelectExeNode::open() {
+  RC rc = prepare();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  if (index_ != nullptr) {
+    close_index_scanner();
+    index_tuples_.clear();
+    index_pos_ = 0;
+    if (tuple_schema_.fields().size() == 0) {
+      return RC::SUCCESS;
+    }
+    index_only_ = index_covers(*index_);
+    index_scanner_ = index_->create_scanner(index_range_);
+    if (index_scanner_ == nullptr) {
+      LOG_ERROR("Failed to create index scanner. index=%s", index_->index_meta().name());
+      return RC::GENERIC_ERROR;
+    }
+    return RC::SUCCESS;
+  }
+  return select_->open(trx_);
+}
+
+RC SelectExeNode::next(Tuple &tuple) {
+  if (tuple_schema_.fields().size() == 0) {
+    return RC::RECORD_EOF;
+  }
+  if (select_ == nullptr) {
+    LOG_ERROR("Select node of table %s is not opened.", table_->name());
+    return RC::GENERIC_ERROR;
+  }
+  if (index_ != nullptr) {
+    // 当前批次的行取完后再从索引扫描中取下一批
+    while (index_pos_ >= index_tuples_.size()) {
+      if (index_scanner_ == nullptr) {
+        return RC::RECORD_EOF;
+      }
+      index_tuples_.clear();
+      index_pos_ = 0;
+      RC rc = next_index_batch(*index_, index_only_, index_scanner_, index_batch_);
+      if (rc == RC::SUCCESS) {
+        rc = select_->select(index_batch_, index_tuples_);
+      }
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    for (const std::shared_ptr<TupleValue> &value : index_tuples_[index_pos_++].values()) {
+      tuple.add(value);
+    }
+    return RC::SUCCESS;
+  }
+  return select_->next(tuple);
+}
+
+double SelectExeNode::estimated_rows() const {
+  if (estimated_rows_ >= 0) {
+    return std::max(estimated_rows_, 1.0);
+  }
+  // 没有统计信息，按照等值条件过滤掉9/10、其它条件过滤掉2/3估计
+  double rows = table_->estimated_record_num();
+  for (const DefaultConditionFilter *filter : condition_filters_) {
+    rows /= filter->comp_op() == EQUAL_TO ? 10 : 3;
+  }
+  return std::max(rows, 1.0);
+}
+
+RC SelectExeNode::select_by_index(Index *index, const char *key, std::vector<Tuple> &tuples) {
+  int key_len = 0;
+  for (const FieldMeta &field : index->field_meta()) {
+    key_len += field.len();
+  }
+  IndexScanRange range;
+  range.left_key.assign(key, key_len);
+  range.left_attr_num = index->field_meta().size();
+  range.right_key = range.left_key;
+  range.right_attr_num = range.left_attr_num;
+  return select_by_range(index, range, tuples);
+}
+
+RC SelectExeNode::select_by_range(Index *index, const IndexScanRange &range, std::vector<Tuple> &tuples) {
+  tuples.clear();
   if (tuple_schema_.fields().size() == 0) {
     return RC::SUCCESS;
   }
-  TupleRecordConverter converter(table_, tuple_set);
+  RC rc = prepare();
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
 
-  return table_->scan_record(trx_, &condition_filter, -1, (void *)&converter, record_reader);
+  IndexScanner *scanner = index->create_scanner(range);
+  if (scanner == nullptr) {
+    LOG_ERROR("Failed to create index scanner. index=%s", index->index_meta().name());
+    return RC::GENERIC_ERROR;
+  }
+  const bool index_only = index_covers(*index);
+  RecordBatch batch;
+  while (RC::SUCCESS == (rc = next_index_batch(*index, index_only, scanner, batch))) {
+    rc = select_->select(batch, tuples);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+  }
+  scanner->destroy();
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+RC SelectExeNode::next_index_batch(Index &index, bool index_only, IndexScanner *scanner, RecordBatch &batch) {
+  if (index_only) {
+    return table_->get_index_only_records(trx_, &index, scanner, batch);
+  }
+  return table_->get_records_by_range(trx_, scanner, batch);
+}
+
+static bool index_has_offset(const Index &index, int offset) {
+  for (const FieldMeta &field : index.field_meta()) {
+    if (field.offset() == offset) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SelectExeNode::index_covers(const Index &index) const {
+  const TableMeta &table_meta = table_->table_meta();
+  for (const TupleField &tuple_field : tuple_schema_.fields()) {
+    const FieldMeta *field = table_meta.field(tuple_field.field_name());
+    if (field == nullptr || !index_has_offset(index, field->offset())) {
+      return false;
+    }
+  }
+  for (const DefaultConditionFilter *filter : condition_filters_) {
+    const ConDesc &left = filter->left();
+    const ConDesc &right = filter->right();
+    if ((left.is_attr && !index_has_offset(index, left.attr_offset)) ||
+        (right.is_attr && !index_has_offset(index, right.attr_offset)) ||
+        left.groupby_offset >= 0 || right.groupby_offset >= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SelectExeNode::close_index_scanner() {
+  if (index_scanner_ != nullptr) {
+    index_scanner_->destroy();
+    index_scanner_ = nullptr;
+  }
+}
+
+RC SelectExeNode::close() {
+  close_index_scanner();
+  index_tuples_.clear();
+  if (select_ != nullptr) {
+    select_->close();
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool compare_tuple_value(const TupleValue &left, const TupleValue &right, CompOp comp) {
+  bool left_is_null = left.is_null();
+  bool right_is_null = right.is_null();
+
+  if (left_is_null && right_is_null) {
+    return comp == IS_COMPOP;
+  }
+  if (left_is_null || right_is_null) {
+    return comp == IS_NOT_COMPOP;
+  }
+
+  int result = left.compare(right);
+  return (result == 0 && (comp == EQUAL_TO || comp == GREAT_EQUAL || comp == LESS_EQUAL)) ||
+         (result == 1 && (comp == GREAT_THAN || comp == GREAT_EQUAL || comp == NOT_EQUAL)) ||
+         (result == -1 && (comp == LESS_THAN || comp == LESS_EQUAL || comp == NOT_EQUAL));
+}
+
+void JoinCondition::init(const Condition &condition, const TupleSchema &outer_schema, const TupleSchema &inner_schema) {
+  comp = condition.comp;
+
+  const RelAttr &left = condition.left_attr;
+  const RelAttr &right = condition.right_attr;
+  left_index = inner_schema.index_of_field(left.relation_name, left.attribute_name);
+  left_from_outer = left_index < 0;
+  if (left_from_outer) {
+    left_index = outer_schema.index_of_field(left.relation_name, left.attribute_name);
+  }
+  right_index = inner_schema.index_of_field(right.relation_name, right.attribute_name);
+  right_from_outer = right_index < 0;
+  if (right_from_outer) {
+    right_index = outer_schema.index_of_field(right.relation_name, right.attribute_name);
+  }
+}
+
+bool JoinCondition::is_equi_join(const TupleSchema &outer_schema, const TupleSchema &inner_schema) const {
+  if (comp != EQUAL_TO || left_index < 0 || right_index < 0 || left_from_outer == right_from_outer) {
+    return false;
+  }
+  // 不同类型的值不能直接用compare比较
+  return outer_schema.field(outer_index()).type() == inner_schema.field(inner_index()).type();
+}
+
+bool JoinCondition::filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const {
+  // 字段不存在时所有的行都不满足条件
+  if (left_index < 0 || right_index < 0) {
+    return false;
+  }
+  const Tuple &left = left_from_outer ? outer_tuple : inner_tuple;
+  const Tuple &right = right_from_outer ? outer_tuple : inner_tuple;
+  return compare_tuple_value(left.get(left_index), right.get(right_index), comp);
+}
+
+static void append_values(const Tuple &outer_tuple, const Tuple &inner_tuple, Tuple &tuple) {
+  for (const std::shared_ptr<TupleValue> &value : inner_tuple.values()) {
+    tuple.add(value);
+  }
+  for (const std::shared_ptr<TupleValue> &value : outer_tuple.values()) {
+    tuple.add(value);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+JoinExeNode::~JoinExeNode() {
+  delete outer_;
+  delete inner_;
+}
+
+RC JoinExeNode::init(ExecutionNode *outer, ExecutionNode *inner, std::vector<const Condition *> &&conditions) {
+  outer_ = outer;
+  inner_ = inner;
+  tuple_schema_.append(inner->schema());
+  tuple_schema_.append(outer->schema());
+
+  for (const Condition *condition : conditions) {
+    JoinCondition join_condition;
+    join_condition.init(*condition, outer->schema(), inner->schema());
+    conditions_.push_back(join_condition);
+  }
+  return RC::SUCCESS;
+}
+
+double JoinExeNode::estimated_rows() const {
+  double rows = outer_->estimated_rows() * inner_->estimated_rows();
+  for (size_t i = 0; i < conditions_.size(); i++) {
+    rows /= 3;
+  }
+  return rows;
+}
+
+RC JoinExeNode::open() {
+  outer_valid_ = false;
+  return outer_->open();
+}
+
+RC JoinExeNode::close() {
+  outer_valid_ = false;
+  inner_->close();
+  return outer_->close();
+}
+
+bool JoinExeNode::filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const {
+  for (const JoinCondition &condition : conditions_) {
+    if (!condition.filter(outer_tuple, inner_tuple)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC JoinExeNode::next(Tuple &tuple) {
+  RC rc = RC::SUCCESS;
+  while (true) {
+    if (!outer_valid_) {
+      Tuple outer_tuple;
+      rc = outer_->next(outer_tuple);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+      outer_tuple_ = std::move(outer_tuple);
+      outer_valid_ = true;
+
+      // 每个外层的行都从头扫描一遍内层
+      inner_->close();
+      rc = inner_->open();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+
+    Tuple inner_tuple;
+    rc = inner_->next(inner_tuple);
+    if (rc == RC::RECORD_EOF) {
+      outer_valid_ = false;
+      continue;
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+
+    if (filter(outer_tuple_, inner_tuple)) {
+      append_values(outer_tuple_, inner_tuple, tuple);
+      return RC::SUCCESS;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+HashJoinExeNode::~HashJoinExeNode() {
+  delete outer_;
+  delete inner_;
+}
+
+bool HashJoinExeNode::support(const ExecutionNode &outer, const ExecutionNode &inner,
+                              const std::vector<const Condition *> &conditions) {
+  for (const Condition *condition : conditions) {
+    JoinCondition join_condition;
+    join_condition.init(*condition, outer.schema(), inner.schema());
+    if (join_condition.is_equi_join(outer.schema(), inner.schema())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RC HashJoinExeNode::init(ExecutionNode *outer, ExecutionNode *inner, std::vector<const Condition *> &&conditions,
+                         bool keep_order) {
+  outer_ = outer;
+  inner_ = inner;
+  tuple_schema_.append(inner->schema());
+  tuple_schema_.append(outer->schema());
+
+  for (const Condition *condition : conditions) {
+    JoinCondition join_condition;
+    join_condition.init(*condition, outer->schema(), inner->schema());
+    if (join_condition.is_equi_join(outer->schema(), inner->schema())) {
+      key_conditions_.push_back(conditions_.size());
+    }
+    conditions_.push_back(join_condition);
+  }
+  if (key_conditions_.empty()) {
+    LOG_ERROR("Hash join needs at least one equi-join condition.");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  build_on_inner_ = keep_order || inner->estimated_rows() <= outer->estimated_rows();
+  return RC::SUCCESS;
+}
+
+double HashJoinExeNode::estimated_rows() const {
+  double rows = std::max(outer_->estimated_rows(), inner_->estimated_rows());
+  for (size_t i = key_conditions_.size(); i < conditions_.size(); i++) {
+    rows /= 3;
+  }
+  return rows;
+}
+
+size_t HashJoinExeNode::hash(const Tuple &tuple, bool from_outer, bool &has_null) const {
+  const TupleSchema &schema = from_outer ? outer_->schema() : inner_->schema();
+  size_t hash_value = 0;
+  has_null = false;
+  for (int condition_index : key_conditions_) {
+    const JoinCondition &condition = conditions_[condition_index];
+    int index = from_outer ? condition.outer_index() : condition.inner_index();
+    const TupleValue &value = tuple.get(index);
+    if (value.is_null()) {
+      // null与任何值都不相等
+      has_null = true;
+      return 0;
+    }
+
+    size_t value_hash = 0;
+    switch (schema.field(index).type()) {
+      case INTS:
+      case DATES: {
+        value_hash = std::hash<int>()(*(const int *)value.get_value_pointer());
+      } break;
+      case FLOATS: {
+        value_hash = std::hash<float>()(*(const float *)value.get_value_pointer());
+      } break;
+      default: {
+        value_hash = std::hash<std::string>()(value.get_string_value());
+      } break;
+    }
+    hash_value = hash_value * 31 + value_hash;
+  }
+  return hash_value;
+}
+
+bool HashJoinExeNode::filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const {
+  for (const JoinCondition &condition : conditions_) {
+    if (!condition.filter(outer_tuple, inner_tuple)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC HashJoinExeNode::build(ExecutionNode &node, bool from_outer) {
+  RC rc = node.open();
+  while (rc == RC::SUCCESS) {
+    Tuple tuple;
+    rc = node.next(tuple);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+    bool has_null = false;
+    size_t hash_value = hash(tuple, from_outer, has_null);
+    if (has_null) {
+      continue;
+    }
+    hash_table_[hash_value].push_back(build_tuples_.size());
+    build_tuples_.push_back(std::move(tuple));
+  }
+  node.close();
+  return rc == RC::RECORD_EOF ? RC::SUCCESS : rc;
+}
+
+RC HashJoinExeNode::open() {
+  close();
+
+  ExecutionNode *build_node = build_on_inner_ ? inner_ : outer_;
+  ExecutionNode *probe_node = build_on_inner_ ? outer_ : inner_;
+  RC rc = build(*build_node, !build_on_inner_);
+  if (rc == RC::SUCCESS) {
+    rc = probe_node->open();
+  }
+  return rc;
+}
+
+RC HashJoinExeNode::close() {
+  outer_->close();
+  inner_->close();
+  build_tuples_.clear();
+  hash_table_.clear();
+  bucket_ = nullptr;
+  bucket_pos_ = 0;
+  return RC::SUCCESS;
+}
+
+RC HashJoinExeNode::next(Tuple &tuple) {
+  ExecutionNode *probe_node = build_on_inner_ ? outer_ : inner_;
+  while (true) {
+    while (bucket_ != nullptr && bucket_pos_ < (int)bucket_->size()) {
+      const Tuple &build_tuple = build_tuples_[(*bucket_)[bucket_pos_++]];
+      const Tuple &outer_tuple = build_on_inner_ ? probe_tuple_ : build_tuple;
+      const Tuple &inner_tuple = build_on_inner_ ? build_tuple : probe_tuple_;
+      if (filter(outer_tuple, inner_tuple)) {
+        append_values(outer_tuple, inner_tuple, tuple);
+        return RC::SUCCESS;
+      }
+    }
+
+    Tuple probe_tuple;
+    RC rc = probe_node->next(probe_tuple);
+    if (rc != RC::SUCCESS) {
+      bucket_ = nullptr;
+      return rc;
+    }
+    probe_tuple_ = std::move(probe_tuple);
+
+    bucket_ = nullptr;
+    bucket_pos_ = 0;
+    bool has_null = false;
+    size_t hash_value = hash(probe_tuple_, build_on_inner_, has_null);
+    if (!has_null) {
+      auto iter = hash_table_.find(hash_value);
+      if (iter != hash_table_.end()) {
+        bucket_ = &iter->second;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+IndexJoinExeNode::~IndexJoinExeNode() {
+  delete outer_;
+  delete inner_;
+}
+
+Index *IndexJoinExeNode::find_index(const ExecutionNode &outer, const SelectExeNode &inner,
+                                    const JoinCondition &condition) {
+  if (!condition.is_equi_join(outer.schema(), inner.schema())) {
+    return nullptr;
+  }
+  const TupleField &field = inner.schema().field(condition.inner_index());
+  if (field.type() == TEXTS) {
+    // TEXT字段在记录中只保存溢出页的信息，不能用值在索引中查找
+    return nullptr;
+  }
+  return inner.get_table()->find_index_by_field(field.field_name());
+}
+
+bool IndexJoinExeNode::support(const ExecutionNode &outer, const SelectExeNode &inner,
+                               const std::vector<const Condition *> &conditions) {
+  for (const Condition *condition : conditions) {
+    JoinCondition join_condition;
+    join_condition.init(*condition, outer.schema(), inner.schema());
+    if (find_index(outer, inner, join_condition) != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RC IndexJoinExeNode::init(ExecutionNode *outer, SelectExeNode *inner, std::vector<const Condition *> &&conditions) {
+  outer_ = outer;
+  inner_ = inner;
+  tuple_schema_.append(inner->schema());
+  tuple_schema_.append(outer->schema());
+
+  for (const Condition *condition : conditions) {
+    JoinCondition join_condition;
+    join_condition.init(*condition, outer->schema(), inner->schema());
+    if (index_ == nullptr) {
+      index_ = find_index(*outer, *inner, join_condition);
+      if (index_ != nullptr) {
+        key_condition_ = conditions_.size();
+      }
+    }
+    conditions_.push_back(join_condition);
+  }
+  if (index_ == nullptr) {
+    LOG_ERROR("Index join needs an equi-join condition on an indexed field of table %s.",
+              inner->get_table()->name());
+    return RC::INVALID_ARGUMENT;
+  }
+  key_.resize(index_->field_meta()[0].len());
+  return RC::SUCCESS;
+}
+
+double IndexJoinExeNode::estimated_rows() const {
+  double rows = std::max(outer_->estimated_rows(), inner_->estimated_rows());
+  for (size_t i = 1; i < conditions_.size(); i++) {
+    rows /= 3;
+  }
+  return rows;
+}
+
+bool IndexJoinExeNode::make_key(const Tuple &outer_tuple) {
+  const TupleValue &value = outer_tuple.get(conditions_[key_condition_].outer_index());
+  if (value.is_null()) {
+    // null与任何值都不相等
+    return false;
+  }
+
+  // 与索引中的键一样，按照字段在记录中的格式保存，字符串后面补0
+  memset(key_.data(), 0, key_.size());
+  switch (index_->field_meta()[0].type()) {
+    case INTS:
+    case DATES:
+    case FLOATS: {
+      memcpy(key_.data(), value.get_value_pointer(), std::min(key_.size(), sizeof(int)));
+    } break;
+    default: {
+      std::string s = value.get_string_value();
+      memcpy(key_.data(), s.data(), std::min(key_.size(), s.size()));
+    } break;
+  }
+  return true;
+}
+
+bool IndexJoinExeNode::filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const {
+  for (const JoinCondition &condition : conditions_) {
+    if (!condition.filter(outer_tuple, inner_tuple)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC IndexJoinExeNode::open() {
+  close();
+  return outer_->open();
+}
+
+RC IndexJoinExeNode::close() {
+  inner_tuples_.clear();
+  inner_pos_ = 0;
+  return outer_->close();
+}
+
+RC IndexJoinExeNode::next(Tuple &tuple) {
+  while (true) {
+    while (inner_pos_ < (int)inner_tuples_.size()) {
+      const Tuple &inner_tuple = inner_tuples_[inner_pos_++];
+      if (filter(outer_tuple_, inner_tuple)) {
+        append_values(outer_tuple_, inner_tuple, tuple);
+        return RC::SUCCESS;
+      }
+    }
+
+    Tuple outer_tuple;
+    RC rc = outer_->next(outer_tuple);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    outer_tuple_ = std::move(outer_tuple);
+
+    inner_tuples_.clear();
+    inner_pos_ = 0;
+    if (make_key(outer_tuple_)) {
+      rc = inner_->select_by_index(index_, key_.data(), inner_tuples_);
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+  }
 }
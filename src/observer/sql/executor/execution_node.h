@@ -16,19 +16,48 @@ See the Mulan PSL v2 for more details. */
 #define __OBSERVER_SQL_EXECUTOR_EXECUTION_NODE_H_
 
 
+#include <unordered_map>
 #include <vector>
 #include "storage/common/condition_filter.h"
+#include "storage/common/index.h"
 #include "sql/executor/tuple.h"
 
 class Table;
 class Trx;
+class Index;
+class VectorizedSelect;
 
+/**
+ * 执行计划中的一个算子。按照open/next/close的方式从下层算子逐行拉取数据，
+ * 不需要把中间结果全部保存下来
+ */
 class ExecutionNode {
 public:
   ExecutionNode() = default;
   virtual ~ExecutionNode() = default;
 
-  virtual RC execute(TupleSet &tuple_set) = 0;
+  virtual RC open() = 0;
+
+  /**
+   * 取出下一行数据，没有更多数据时返回RC::RECORD_EOF
+   */
+  virtual RC next(Tuple &tuple) = 0;
+  virtual RC close() = 0;
+
+  /**
+   * next返回的每一行数据的字段
+   */
+  virtual const TupleSchema &schema() const = 0;
+
+  /**
+   * 估计返回的行数，用于选择连接的方式
+   */
+  virtual double estimated_rows() const = 0;
+
+  /**
+   * 取出所有数据放到tuple_set中
+   */
+  RC execute(TupleSet &tuple_set);
 };
 
 class SelectExeNode : public ExecutionNode {
@@ -38,16 +67,233 @@ public:
 
   RC init(Trx *trx, Table *table, TupleSchema && tuple_schema, std::vector<DefaultConditionFilter *> &&condition_filters);
 
-  RC execute(TupleSet &tuple_set) override;
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  RC close() override;
+
+  const TupleSchema &schema() const override {
+    return tuple_schema_;
+  }
+  double estimated_rows() const override;
+
+  /**
+   * 不扫描表，通过索引取出字段值等于key的记录，满足本表条件的行按扫描时的顺序放到tuples中
+   */
+  RC select_by_index(Index *index, const char *key, std::vector<Tuple> &tuples);
+
+  /**
+   * 与select_by_index相同，取出键值在range中的记录
+   */
+  RC select_by_range(Index *index, const IndexScanRange &range, std::vector<Tuple> &tuples);
 
-  Table* get_table() {
+  /**
+   * 优化器根据统计信息估计的行数，设置后不再使用默认的估计方法
+   */
+  void set_estimated_rows(double rows) {
+    estimated_rows_ = rows;
+  }
+
+  /**
+   * 打开时不扫描表，只通过索引取出键值在range中的记录。next每次从索引扫描中取出一批记录
+   */
+  void set_index_lookup(Index *index, const IndexScanRange &range) {
+    index_ = index;
+    index_range_ = range;
+  }
+
+  Table* get_table() const {
       return table_;
   }
+private:
+  RC prepare();
+  void close_index_scanner();
+
+  /**
+   * 从索引扫描中取出下一批记录，index_only时只用索引项构造记录
+   */
+  RC next_index_batch(Index &index, bool index_only, IndexScanner *scanner, RecordBatch &batch);
+
+  /**
+   * 输出的字段和过滤条件中的字段都在索引中时，可以只用索引项构造记录
+   */
+  bool index_covers(const Index &index) const;
+
 private:
   Trx *trx_ = nullptr;
   Table  * table_;
   TupleSchema  tuple_schema_;
   std::vector<DefaultConditionFilter *> condition_filters_;
+  VectorizedSelect *select_ = nullptr;
+  double estimated_rows_ = -1;
+
+  Index *index_ = nullptr;
+  IndexScanRange index_range_;
+  IndexScanner *index_scanner_ = nullptr;
+  bool index_only_ = false;
+  RecordBatch index_batch_;
+  std::vector<Tuple> index_tuples_;          // 当前批次中满足条件的行
+  size_t index_pos_ = 0;
+};
+
+/**
+ * 连接条件两边的字段在外层行或者内层行中的位置
+ */
+struct JoinCondition {
+  CompOp comp;
+  bool left_from_outer;
+  int left_index;
+  bool right_from_outer;
+  int right_index;
+
+  void init(const Condition &condition, const TupleSchema &outer_schema, const TupleSchema &inner_schema);
+
+  /**
+   * 一边是外层字段、另一边是内层字段，并且类型相同的等值条件，可以用来做哈希连接
+   */
+  bool is_equi_join(const TupleSchema &outer_schema, const TupleSchema &inner_schema) const;
+  int outer_index() const { return left_from_outer ? left_index : right_index; }
+  int inner_index() const { return left_from_outer ? right_index : left_index; }
+
+  bool filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const;
+};
+
+/**
+ * 嵌套循环连接。外层每取出一行，内层都重新打开扫描一遍。
+ * 输出的行中内层的字段在前，外层的字段在后。连接后的两个子节点由本节点释放
+ */
+class JoinExeNode : public ExecutionNode {
+public:
+  JoinExeNode() = default;
+  virtual ~JoinExeNode();
+
+  /**
+   * @param conditions 两边都是字段的条件，字段可以来自任意一个子节点
+   */
+  RC init(ExecutionNode *outer, ExecutionNode *inner, std::vector<const Condition *> &&conditions);
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  RC close() override;
+
+  const TupleSchema &schema() const override {
+    return tuple_schema_;
+  }
+  double estimated_rows() const override;
+
+private:
+  bool filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const;
+
+private:
+  ExecutionNode *outer_ = nullptr;
+  ExecutionNode *inner_ = nullptr;
+  TupleSchema tuple_schema_;
+  std::vector<JoinCondition> conditions_;
+  Tuple outer_tuple_;
+  bool outer_valid_ = false;
+};
+
+/**
+ * 哈希连接。把一边放到哈希表中，另一边逐行探测，等值条件之外的条件在匹配后计算，key中有null的行不参与连接。
+ * 输出的字段与JoinExeNode相同。哈希表建在内层时行的顺序也与JoinExeNode相同；
+ * 建在外层时按内层的顺序输出，同一个内层行的匹配再按外层的顺序，与JoinExeNode不同
+ */
+class HashJoinExeNode : public ExecutionNode {
+public:
+  HashJoinExeNode() = default;
+  virtual ~HashJoinExeNode();
+
+  /**
+   * 至少有一个可以用来做哈希的等值条件
+   */
+  static bool support(const ExecutionNode &outer, const ExecutionNode &inner,
+                      const std::vector<const Condition *> &conditions);
+
+  /**
+   * @param keep_order 输出的行需要与JoinExeNode的顺序一致时，哈希表总是建在内层，否则建在估计行数较少的一边
+   */
+  RC init(ExecutionNode *outer, ExecutionNode *inner, std::vector<const Condition *> &&conditions, bool keep_order);
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  RC close() override;
+
+  const TupleSchema &schema() const override {
+    return tuple_schema_;
+  }
+  double estimated_rows() const override;
+
+  bool build_on_inner() const {
+    return build_on_inner_;
+  }
+
+private:
+  RC build(ExecutionNode &node, bool from_outer);
+  size_t hash(const Tuple &tuple, bool from_outer, bool &has_null) const;
+  bool filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const;
+  void make_tuple(const Tuple &outer_tuple, const Tuple &inner_tuple, Tuple &tuple) const;
+
+private:
+  ExecutionNode *outer_ = nullptr;
+  ExecutionNode *inner_ = nullptr;
+  TupleSchema tuple_schema_;
+  std::vector<JoinCondition> conditions_;
+  std::vector<int> key_conditions_;  // 用来计算哈希值的等值条件
+  bool build_on_inner_ = true;
+
+  std::vector<Tuple> build_tuples_;
+  std::unordered_map<size_t, std::vector<int>> hash_table_;  // 哈希值 -> build_tuples_中的位置，保持插入的顺序
+
+  // 逐行读取没有建哈希表的一边，当前行在哈希表中对应的桶
+  Tuple probe_tuple_;
+  const std::vector<int> *bucket_ = nullptr;
+  int bucket_pos_ = 0;
+};
+
+/**
+ * 索引嵌套循环连接。内层是单表查询并且连接字段上有索引时，外层每取出一行，
+ * 就用它的字段值在内层的索引中查找，不需要扫描整个内层表。
+ * 输出的字段和行的顺序都与JoinExeNode相同
+ */
+class IndexJoinExeNode : public ExecutionNode {
+public:
+  IndexJoinExeNode() = default;
+  virtual ~IndexJoinExeNode();
+
+  /**
+   * 有一个等值条件的内层字段上建有单字段索引
+   */
+  static bool support(const ExecutionNode &outer, const SelectExeNode &inner,
+                      const std::vector<const Condition *> &conditions);
+
+  RC init(ExecutionNode *outer, SelectExeNode *inner, std::vector<const Condition *> &&conditions);
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  RC close() override;
+
+  const TupleSchema &schema() const override {
+    return tuple_schema_;
+  }
+  double estimated_rows() const override;
+
+private:
+  static Index *find_index(const ExecutionNode &outer, const SelectExeNode &inner,
+                           const JoinCondition &condition);
+  bool make_key(const Tuple &outer_tuple);
+  bool filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const;
+
+private:
+  ExecutionNode *outer_ = nullptr;
+  SelectExeNode *inner_ = nullptr;
+  TupleSchema tuple_schema_;
+  std::vector<JoinCondition> conditions_;
+  int key_condition_ = -1;  // 用来查找索引的等值条件
+  Index *index_ = nullptr;
+  std::vector<char> key_;
+
+  Tuple outer_tuple_;
+  std::vector<Tuple> inner_tuples_;  // 与当前外层行的连接字段相等的内层行
+  int inner_pos_ = 0;
 };
 
 #endif //__OBSERVER_SQL_EXECUTOR_EXECUTION_NODE_H_
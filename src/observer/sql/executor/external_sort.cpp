@@ -0,0 +1,778 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "sql/executor/external_sort.h"
+#include "common/log/log.h"
+#include "common/os/path.h"
+
+const size_t SortOptions::DEFAULT_MEMORY_LIMIT;
+const int SortRun::PAGE_SIZE;
+
+// 每个TupleValue对象和指向它的shared_ptr大约占用的内存
+static const size_t VALUE_OVERHEAD = 48;
+
+size_t estimated_tuple_size(const TupleSchema &schema)
+{
+  size_t size = 0;
+  for (const TupleField &field : schema.fields()) {
+    switch (field.type()) {
+      case CHARS: {
+        size += 32;
+      } break;
+      case TEXTS: {
+        size += 256;
+      } break;
+      default: {
+        size += sizeof(int);
+      } break;
+    }
+    size += VALUE_OVERHEAD;
+  }
+  return size;
+}
+
+static size_t tuple_memory(const Tuple &tuple)
+{
+  size_t size = 0;
+  for (const std::shared_ptr<TupleValue> &value : tuple.values()) {
+    size += VALUE_OVERHEAD + value->get_string_value().size();
+  }
+  return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int TupleComparator::compare(const Tuple &left, const Tuple &right) const
+{
+  for (const SortKey &key : keys_) {
+    // compare返回值的大小不一定是1，只看符号
+    int result = left.get(key.index).compare(right.get(key.index));
+    if (result != 0) {
+      result = result > 0 ? 1 : -1;
+      return key.asc ? result : -result;
+    }
+  }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SortRun::~SortRun()
+{
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+RC SortRun::create(const std::string &temp_dir, const TupleSchema &schema)
+{
+  std::string dir = temp_dir;
+  if (!common::check_directory(dir)) {
+    LOG_ERROR("Failed to create temporary directory %s for sorting.", temp_dir.c_str());
+    return RC::IOERR;
+  }
+  std::string path = dir + "/sort_run_XXXXXX";
+  std::vector<char> path_buf(path.begin(), path.end());
+  path_buf.push_back('\0');
+  fd_ = mkstemp(path_buf.data());
+  if (fd_ < 0) {
+    LOG_ERROR("Failed to create temporary file for sorting in %s. error=%s", dir.c_str(), strerror(errno));
+    return RC::IOERR;
+  }
+  // 只通过fd访问，关闭后文件就被回收
+  ::unlink(path_buf.data());
+
+  types_.clear();
+  for (const TupleField &field : schema.fields()) {
+    types_.push_back(field.type());
+  }
+  page_.clear();
+  page_.resize(sizeof(int));
+  row_num_ = 0;
+  return RC::SUCCESS;
+}
+
+RC SortRun::append(const Tuple &tuple)
+{
+  size_t old_size = page_.size();
+  for (size_t i = 0; i < types_.size(); i++) {
+    const TupleValue &value = tuple.get(i);
+    switch (types_[i]) {
+      case INTS:
+      case FLOATS:
+      case DATES: {
+        const char *data = (const char *)value.get_value_pointer();
+        page_.insert(page_.end(), data, data + sizeof(int));
+      } break;
+      default: {
+        std::string s = value.get_string_value();
+        int len = (int)s.size();
+        page_.insert(page_.end(), (const char *)&len, (const char *)&len + sizeof(len));
+        page_.insert(page_.end(), s.begin(), s.end());
+      } break;
+    }
+  }
+  row_num_++;
+
+  // 放不下时把之前的行写到文件中，这一行放到新的页中
+  if (page_.size() > (size_t)PAGE_SIZE && old_size > sizeof(int)) {
+    std::vector<char> row(page_.begin() + old_size, page_.end());
+    page_.resize(old_size);
+    RC rc = flush_page();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    page_.insert(page_.end(), row.begin(), row.end());
+  }
+  if (page_.size() >= (size_t)PAGE_SIZE) {
+    return flush_page();
+  }
+  return RC::SUCCESS;
+}
+
+RC SortRun::flush_page()
+{
+  // 页头保存页中数据的长度，整页写入
+  int data_len = (int)(page_.size() - sizeof(int));
+  memcpy(page_.data(), &data_len, sizeof(data_len));
+  size_t page_num = (page_.size() + PAGE_SIZE - 1) / PAGE_SIZE;
+  page_.resize(page_num * PAGE_SIZE);
+  if (::write(fd_, page_.data(), page_.size()) != (ssize_t)page_.size()) {
+    LOG_ERROR("Failed to write sort run. error=%s", strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  page_.clear();
+  page_.resize(sizeof(int));
+  return RC::SUCCESS;
+}
+
+RC SortRun::finish()
+{
+  if (page_.size() > sizeof(int)) {
+    RC rc = flush_page();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  if (::lseek(fd_, 0, SEEK_SET) < 0) {
+    LOG_ERROR("Failed to seek sort run. error=%s", strerror(errno));
+    return RC::IOERR_SEEK;
+  }
+  page_.clear();
+  page_pos_ = 0;
+  page_end_ = 0;
+  return RC::SUCCESS;
+}
+
+RC SortRun::read_page()
+{
+  page_.resize(PAGE_SIZE);
+  ssize_t ret = ::read(fd_, page_.data(), PAGE_SIZE);
+  if (ret == 0) {
+    return RC::RECORD_EOF;
+  }
+  if (ret != PAGE_SIZE) {
+    LOG_ERROR("Failed to read sort run. ret=%d, error=%s", (int)ret, strerror(errno));
+    return RC::IOERR_READ;
+  }
+
+  int data_len = 0;
+  memcpy(&data_len, page_.data(), sizeof(data_len));
+  size_t page_size = sizeof(int) + data_len;
+  if (page_size > (size_t)PAGE_SIZE) {
+    // 一行超过一页，剩下的部分在后面连续的页中
+    size_t total = (page_size + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+    page_.resize(total);
+    size_t rest = total - PAGE_SIZE;
+    if (::read(fd_, page_.data() + PAGE_SIZE, rest) != (ssize_t)rest) {
+      LOG_ERROR("Failed to read sort run. error=%s", strerror(errno));
+      return RC::IOERR_READ;
+    }
+  }
+  page_pos_ = sizeof(int);
+  page_end_ = page_size;
+  return RC::SUCCESS;
+}
+
+RC SortRun::next(Tuple &tuple)
+{
+  if (page_pos_ >= page_end_) {
+    RC rc = read_page();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+
+  const char *data = page_.data();
+  for (AttrType type : types_) {
+    switch (type) {
+      case INTS: {
+        int value;
+        memcpy(&value, data + page_pos_, sizeof(value));
+        tuple.add(value);
+        page_pos_ += sizeof(value);
+      } break;
+      case DATES: {
+        int value;
+        memcpy(&value, data + page_pos_, sizeof(value));
+        tuple.add(value, true);
+        page_pos_ += sizeof(value);
+      } break;
+      case FLOATS: {
+        float value;
+        memcpy(&value, data + page_pos_, sizeof(value));
+        tuple.add(value);
+        page_pos_ += sizeof(value);
+      } break;
+      case TEXTS: {
+        int len;
+        memcpy(&len, data + page_pos_, sizeof(len));
+        std::string text(data + page_pos_ + sizeof(len), len);
+        tuple.add(text);
+        page_pos_ += sizeof(len) + len;
+      } break;
+      default: {
+        int len;
+        memcpy(&len, data + page_pos_, sizeof(len));
+        tuple.add(data + page_pos_ + sizeof(len), len);
+        page_pos_ += sizeof(len) + len;
+      } break;
+    }
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoserTree::init(int way_num, std::function<bool(int, int)> less)
+{
+  way_num_ = way_num;
+  less_ = std::move(less);
+  // -1表示比所有数据都小，从每一路开始调整一次之后所有的内部节点都是真正的败者
+  tree_.assign(std::max(way_num, 1), -1);
+  for (int way = way_num - 1; way >= 0; way--) {
+    adjust(way);
+  }
+}
+
+void LoserTree::adjust(int way)
+{
+  int winner = way;
+  for (int node = (way + way_num_) / 2; node > 0; node /= 2) {
+    int loser = tree_[node];
+    if (loser == -1 || (winner != -1 && less_(loser, winner))) {
+      tree_[node] = winner;
+      winner = loser;
+    }
+  }
+  tree_[0] = winner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SortExeNode::~SortExeNode()
+{
+  close();
+  delete child_;
+}
+
+RC SortExeNode::init(ExecutionNode *child, std::vector<SortKey> &&keys, const SortOptions &options)
+{
+  child_ = child;
+  comparator_ = TupleComparator(keys);
+  options_ = options;
+  return RC::SUCCESS;
+}
+
+RC SortExeNode::spill()
+{
+  std::stable_sort(tuples_.begin(), tuples_.end(), comparator_);
+
+  SortRun *run = new SortRun;
+  RC rc = run->create(options_.temp_dir, schema());
+  for (size_t i = 0; rc == RC::SUCCESS && i < tuples_.size(); i++) {
+    rc = run->append(tuples_[i]);
+  }
+  if (rc == RC::SUCCESS) {
+    rc = run->finish();
+  }
+  if (rc != RC::SUCCESS) {
+    delete run;
+    return rc;
+  }
+  runs_.push_back(run);
+  spilled_run_num_++;
+  tuples_.clear();
+  memory_used_ = 0;
+  return RC::SUCCESS;
+}
+
+bool SortExeNode::less(int left_way, int right_way) const
+{
+  // 读完的一路比所有数据都大；相等时序号小的一路在前，保证排序稳定
+  if (exhausted_[left_way] || exhausted_[right_way]) {
+    if (exhausted_[left_way] && exhausted_[right_way]) {
+      return left_way < right_way;
+    }
+    return exhausted_[right_way];
+  }
+  int result = comparator_.compare(heads_[left_way], heads_[right_way]);
+  return result < 0 || (result == 0 && left_way < right_way);
+}
+
+RC SortExeNode::merge(size_t first, size_t last, SortRun *output)
+{
+  int way_num = (int)(last - first);
+  heads_.clear();
+  heads_.resize(way_num);
+  exhausted_.assign(way_num, false);
+  for (int way = 0; way < way_num; way++) {
+    RC rc = runs_[first + way]->next(heads_[way]);
+    if (rc == RC::RECORD_EOF) {
+      exhausted_[way] = true;
+    } else if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  loser_tree_.init(way_num, [this](int left, int right) { return less(left, right); });
+  if (output == nullptr) {
+    // 最后一轮归并由next逐行取出
+    return RC::SUCCESS;
+  }
+
+  while (!exhausted_[loser_tree_.top()]) {
+    int way = loser_tree_.top();
+    RC rc = output->append(heads_[way]);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    Tuple tuple;
+    rc = runs_[first + way]->next(tuple);
+    if (rc == RC::RECORD_EOF) {
+      exhausted_[way] = true;
+    } else if (rc != RC::SUCCESS) {
+      return rc;
+    } else {
+      heads_[way] = std::move(tuple);
+    }
+    loser_tree_.adjust(way);
+  }
+  return output->finish();
+}
+
+RC SortExeNode::start_merge()
+{
+  // 每一路读的时候需要一页的缓存，路数太多时先把相邻的有序段归并成更长的有序段
+  size_t max_way_num = std::max(options_.memory_limit / (2 * SortRun::PAGE_SIZE), (size_t)2);
+  while (runs_.size() > max_way_num) {
+    std::vector<SortRun *> merged_runs;
+    for (size_t first = 0; first < runs_.size(); first += max_way_num) {
+      size_t last = std::min(first + max_way_num, runs_.size());
+      SortRun *run = new SortRun;
+      RC rc = run->create(options_.temp_dir, schema());
+      if (rc == RC::SUCCESS) {
+        rc = merge(first, last, run);
+      }
+      if (rc != RC::SUCCESS) {
+        delete run;
+        for (SortRun *merged_run : merged_runs) {
+          delete merged_run;
+        }
+        return rc;
+      }
+      merged_runs.push_back(run);
+    }
+    for (SortRun *run : runs_) {
+      delete run;
+    }
+    runs_.swap(merged_runs);
+  }
+  return merge(0, runs_.size(), nullptr);
+}
+
+RC SortExeNode::open()
+{
+  close();
+  RC rc = child_->open();
+  while (rc == RC::SUCCESS) {
+    Tuple tuple;
+    rc = child_->next(tuple);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+    memory_used_ += tuple_memory(tuple);
+    tuples_.push_back(std::move(tuple));
+    if (memory_used_ > options_.memory_limit) {
+      rc = spill();
+    }
+  }
+  child_->close();
+  if (rc != RC::RECORD_EOF) {
+    return rc;
+  }
+
+  if (runs_.empty()) {
+    std::stable_sort(tuples_.begin(), tuples_.end(), comparator_);
+    return RC::SUCCESS;
+  }
+  if (!tuples_.empty()) {
+    rc = spill();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  LOG_INFO("Sort spilled %d runs to %s", spilled_run_num_, options_.temp_dir.c_str());
+  return start_merge();
+}
+
+RC SortExeNode::next(Tuple &tuple)
+{
+  if (runs_.empty()) {
+    if (pos_ >= tuples_.size()) {
+      return RC::RECORD_EOF;
+    }
+    tuple = std::move(tuples_[pos_++]);
+    return RC::SUCCESS;
+  }
+
+  int way = loser_tree_.top();
+  if (exhausted_[way]) {
+    return RC::RECORD_EOF;
+  }
+  tuple = std::move(heads_[way]);
+  Tuple head;
+  RC rc = runs_[way]->next(head);
+  if (rc == RC::RECORD_EOF) {
+    exhausted_[way] = true;
+  } else if (rc != RC::SUCCESS) {
+    return rc;
+  } else {
+    heads_[way] = std::move(head);
+  }
+  loser_tree_.adjust(way);
+  return RC::SUCCESS;
+}
+
+RC SortExeNode::close()
+{
+  tuples_.clear();
+  memory_used_ = 0;
+  pos_ = 0;
+  for (SortRun *run : runs_) {
+    delete run;
+  }
+  runs_.clear();
+  heads_.clear();
+  exhausted_.clear();
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/**
+ * 在子节点的每一行后面加上行号。行号乘2，最低的字节不会是'!'，不会被当作null
+ */
+class SequenceExeNode : public ExecutionNode {
+public:
+  explicit SequenceExeNode(ExecutionNode *child) : child_(child)
+  {
+    tuple_schema_.append(child->schema());
+    tuple_schema_.add(INTS, "", "__seq");
+  }
+  virtual ~SequenceExeNode()
+  {
+    delete child_;
+  }
+
+  RC open() override
+  {
+    seq_ = 0;
+    return child_->open();
+  }
+  RC next(Tuple &tuple) override
+  {
+    RC rc = child_->next(tuple);
+    if (rc == RC::SUCCESS) {
+      tuple.add(seq_ * 2);
+      seq_++;
+    }
+    return rc;
+  }
+  RC close() override
+  {
+    return child_->close();
+  }
+
+  const TupleSchema &schema() const override
+  {
+    return tuple_schema_;
+  }
+  double estimated_rows() const override
+  {
+    return child_->estimated_rows();
+  }
+
+private:
+  ExecutionNode *child_;
+  TupleSchema tuple_schema_;
+  int seq_ = 0;
+};
+
+/**
+ * 把MergeJoinExeNode归并的结果交给SortExeNode排序，不释放MergeJoinExeNode
+ */
+class MergeOutputExeNode : public ExecutionNode {
+public:
+  MergeOutputExeNode(const TupleSchema &schema, double estimated_rows, std::function<RC(Tuple &)> next)
+      : tuple_schema_(schema), estimated_rows_(estimated_rows), next_(std::move(next))
+  {}
+
+  RC open() override
+  {
+    return RC::SUCCESS;
+  }
+  RC next(Tuple &tuple) override
+  {
+    return next_(tuple);
+  }
+  RC close() override
+  {
+    return RC::SUCCESS;
+  }
+
+  const TupleSchema &schema() const override
+  {
+    return tuple_schema_;
+  }
+  double estimated_rows() const override
+  {
+    return estimated_rows_;
+  }
+
+private:
+  TupleSchema tuple_schema_;
+  double estimated_rows_;
+  std::function<RC(Tuple &)> next_;
+};
+
+MergeJoinExeNode::~MergeJoinExeNode()
+{
+  delete order_;
+  delete outer_;
+  delete inner_;
+}
+
+RC MergeJoinExeNode::init(ExecutionNode *outer, ExecutionNode *inner, std::vector<const Condition *> &&conditions,
+    const SortOptions &options, bool keep_order)
+{
+  tuple_schema_.append(inner->schema());
+  tuple_schema_.append(outer->schema());
+  if (keep_order) {
+    // 行号在外层所有字段的后面，连接条件中字段的位置不变
+    outer = new SequenceExeNode(outer);
+  }
+
+  std::vector<SortKey> outer_keys;
+  std::vector<SortKey> inner_keys;
+  for (const Condition *condition : conditions) {
+    JoinCondition join_condition;
+    join_condition.init(*condition, outer->schema(), inner->schema());
+    if (join_condition.is_equi_join(outer->schema(), inner->schema())) {
+      key_conditions_.push_back(conditions_.size());
+      outer_keys.push_back(SortKey{join_condition.outer_index(), true});
+      inner_keys.push_back(SortKey{join_condition.inner_index(), true});
+    }
+    conditions_.push_back(join_condition);
+  }
+
+  outer_ = new SortExeNode;
+  outer_->init(outer, std::move(outer_keys), options);
+  inner_ = new SortExeNode;
+  inner_->init(inner, std::move(inner_keys), options);
+  if (keep_order) {
+    // 同一外层行连接的内层行已经按照内层的顺序排列，稳定排序后保持不变
+    TupleSchema merge_schema;
+    merge_schema.append(inner->schema());
+    merge_schema.append(outer->schema());
+    MergeOutputExeNode *merge_output = new MergeOutputExeNode(merge_schema, estimated_rows(),
+        [this](Tuple &tuple) { return merge_next(tuple); });
+    std::vector<SortKey> seq_keys{SortKey{(int)tuple_schema_.fields().size(), true}};
+    order_ = new SortExeNode;
+    order_->init(merge_output, std::move(seq_keys), options);
+  }
+  if (key_conditions_.empty()) {
+    LOG_ERROR("Merge join needs at least one equi-join condition.");
+    return RC::INVALID_ARGUMENT;
+  }
+  return RC::SUCCESS;
+}
+
+double MergeJoinExeNode::estimated_rows() const
+{
+  double rows = std::max(outer_->estimated_rows(), inner_->estimated_rows());
+  for (size_t i = key_conditions_.size(); i < conditions_.size(); i++) {
+    rows /= 3;
+  }
+  return rows;
+}
+
+int MergeJoinExeNode::compare_key(const Tuple &outer_tuple, const Tuple &inner_tuple) const
+{
+  for (int condition_index : key_conditions_) {
+    const JoinCondition &condition = conditions_[condition_index];
+    int result = outer_tuple.get(condition.outer_index()).compare(inner_tuple.get(condition.inner_index()));
+    if (result != 0) {
+      return result > 0 ? 1 : -1;
+    }
+  }
+  return 0;
+}
+
+bool MergeJoinExeNode::has_null_key(const Tuple &tuple, bool from_outer) const
+{
+  for (int condition_index : key_conditions_) {
+    const JoinCondition &condition = conditions_[condition_index];
+    if (tuple.get(from_outer ? condition.outer_index() : condition.inner_index()).is_null()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool MergeJoinExeNode::filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const
+{
+  for (const JoinCondition &condition : conditions_) {
+    if (!condition.filter(outer_tuple, inner_tuple)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RC MergeJoinExeNode::next_inner()
+{
+  // null与任何值都不相等，直接跳过
+  while (true) {
+    Tuple tuple;
+    RC rc = inner_->next(tuple);
+    if (rc == RC::RECORD_EOF) {
+      inner_valid_ = false;
+      return RC::SUCCESS;
+    }
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    if (!has_null_key(tuple, false)) {
+      inner_tuple_ = std::move(tuple);
+      inner_valid_ = true;
+      return RC::SUCCESS;
+    }
+  }
+}
+
+RC MergeJoinExeNode::open()
+{
+  close();
+  RC rc = outer_->open();
+  if (rc == RC::SUCCESS) {
+    rc = inner_->open();
+  }
+  if (rc == RC::SUCCESS) {
+    rc = next_inner();
+  }
+  if (rc == RC::SUCCESS && order_ != nullptr) {
+    rc = order_->open();
+  }
+  return rc;
+}
+
+RC MergeJoinExeNode::close()
+{
+  if (order_ != nullptr) {
+    order_->close();
+  }
+  outer_->close();
+  inner_->close();
+  inner_valid_ = false;
+  inner_group_.clear();
+  group_pos_ = 0;
+  return RC::SUCCESS;
+}
+
+RC MergeJoinExeNode::next(Tuple &tuple)
+{
+  if (order_ == nullptr) {
+    return merge_next(tuple);
+  }
+
+  Tuple ordered_tuple;
+  RC rc = order_->next(ordered_tuple);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  // 去掉最后的行号
+  const std::vector<std::shared_ptr<TupleValue>> &values = ordered_tuple.values();
+  for (size_t i = 0; i + 1 < values.size(); i++) {
+    tuple.add(values[i]);
+  }
+  return RC::SUCCESS;
+}
+
+RC MergeJoinExeNode::merge_next(Tuple &tuple)
+{
+  while (true) {
+    while (group_pos_ < inner_group_.size()) {
+      const Tuple &inner_tuple = inner_group_[group_pos_++];
+      if (filter(outer_tuple_, inner_tuple)) {
+        for (const std::shared_ptr<TupleValue> &value : inner_tuple.values()) {
+          tuple.add(value);
+        }
+        for (const std::shared_ptr<TupleValue> &value : outer_tuple_.values()) {
+          tuple.add(value);
+        }
+        return RC::SUCCESS;
+      }
+    }
+
+    Tuple outer_tuple;
+    RC rc = outer_->next(outer_tuple);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    outer_tuple_ = std::move(outer_tuple);
+    if (has_null_key(outer_tuple_, true)) {
+      group_pos_ = inner_group_.size();
+      continue;
+    }
+
+    // 外层连接字段相同的行与同一组内层行连接
+    group_pos_ = 0;
+    if (!inner_group_.empty() && compare_key(outer_tuple_, inner_group_[0]) == 0) {
+      continue;
+    }
+
+    inner_group_.clear();
+    while (inner_valid_ && compare_key(outer_tuple_, inner_tuple_) > 0) {
+      rc = next_inner();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+    while (inner_valid_ && compare_key(outer_tuple_, inner_tuple_) == 0) {
+      inner_group_.push_back(std::move(inner_tuple_));
+      rc = next_inner();
+      if (rc != RC::SUCCESS) {
+        return rc;
+      }
+    }
+  }
+}
@@ -0,0 +1,213 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_SQL_EXECUTOR_EXTERNAL_SORT_H_
+#define __OBSERVER_SQL_EXECUTOR_EXTERNAL_SORT_H_
+
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "rc.h"
+#include "sql/executor/execution_node.h"
+
+/**
+ * 排序和哈希聚合使用的内存和临时文件的位置，来自配置文件中ExecuteStage的SortMemoryLimit和TempDir
+ */
+struct SortOptions {
+  static const size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+  size_t memory_limit = DEFAULT_MEMORY_LIMIT;  // 超过后把排好序的数据写到临时文件中
+  std::string temp_dir = ".";
+};
+
+struct SortKey {
+  int index;  // 字段在行中的位置
+  bool asc;
+};
+
+/**
+ * 按照排序键比较两行，每个字段用TupleValue::compare比较
+ */
+class TupleComparator {
+public:
+  TupleComparator() = default;
+  explicit TupleComparator(const std::vector<SortKey> &keys) : keys_(keys) {}
+
+  int compare(const Tuple &left, const Tuple &right) const;
+  bool operator()(const Tuple &left, const Tuple &right) const { return compare(left, right) < 0; }
+
+private:
+  std::vector<SortKey> keys_;
+};
+
+/**
+ * 临时文件中的一段有序数据。按页写入，读的时候每次读入一页。
+ * 一行超过一页时占用连续的多个页。文件创建后立即删除，关闭后空间自动回收
+ */
+class SortRun {
+public:
+  static const int PAGE_SIZE = 64 * 1024;
+
+  SortRun() = default;
+  ~SortRun();
+
+  RC create(const std::string &temp_dir, const TupleSchema &schema);
+  RC append(const Tuple &tuple);
+
+  /**
+   * 写完所有数据后调用，之后就可以从头读取
+   */
+  RC finish();
+
+  /**
+   * 读取下一行，没有更多数据时返回RECORD_EOF
+   */
+  RC next(Tuple &tuple);
+
+  int row_num() const { return row_num_; }
+
+private:
+  RC flush_page();
+  RC read_page();
+
+private:
+  int fd_ = -1;
+  std::vector<AttrType> types_;
+  std::vector<char> page_;
+  size_t page_pos_ = 0;   // 读的时候下一行在page_中的位置
+  size_t page_end_ = 0;
+  int row_num_ = 0;
+};
+
+/**
+ * 败者树，用于多路归并。内部节点保存比赛中的败者，根上面保存最终的胜者，
+ * 某一路取出数据后只需要沿着到根的路径重新比较log(k)次
+ */
+class LoserTree {
+public:
+  /**
+   * @param less 比较两路当前的数据，前一路更小时返回true
+   */
+  void init(int way_num, std::function<bool(int, int)> less);
+
+  int top() const { return tree_[0]; }
+
+  /**
+   * 某一路的数据发生变化后重新调整
+   */
+  void adjust(int way);
+
+private:
+  int way_num_ = 0;
+  std::vector<int> tree_;
+  std::function<bool(int, int)> less_;
+};
+
+/**
+ * 外部排序。数据超过内存限制时，把排好序的部分写到临时文件中，最后用败者树归并。
+ * 排序是稳定的，相等的行保持子节点输出的顺序。子节点由本节点释放
+ */
+class SortExeNode : public ExecutionNode {
+public:
+  SortExeNode() = default;
+  virtual ~SortExeNode();
+
+  RC init(ExecutionNode *child, std::vector<SortKey> &&keys, const SortOptions &options);
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  RC close() override;
+
+  const TupleSchema &schema() const override {
+    return child_->schema();
+  }
+  double estimated_rows() const override {
+    return child_->estimated_rows();
+  }
+
+  /**
+   * 写到临时文件中的有序段的个数，没有超过内存限制时为0
+   */
+  int spilled_run_num() const { return spilled_run_num_; }
+
+private:
+  RC spill();
+  RC merge(size_t first, size_t last, SortRun *output);
+  RC start_merge();
+  bool less(int left_way, int right_way) const;
+
+private:
+  ExecutionNode *child_ = nullptr;
+  TupleComparator comparator_;
+  SortOptions options_;
+
+  std::vector<Tuple> tuples_;
+  size_t memory_used_ = 0;
+  size_t pos_ = 0;
+
+  std::vector<SortRun *> runs_;
+  int spilled_run_num_ = 0;
+  std::vector<Tuple> heads_;  // 每一路当前最小的行
+  std::vector<bool> exhausted_;
+  LoserTree loser_tree_;
+};
+
+/**
+ * 排序归并连接。两边按等值条件的字段各自外部排序后归并，用在两边都很大、哈希表放不下的时候。
+ * 输出的字段与JoinExeNode相同。keep_order为false时行按照连接字段排序，为true时给外层的行编号，
+ * 归并后再按编号排序，输出的顺序与JoinExeNode一致
+ */
+class MergeJoinExeNode : public ExecutionNode {
+public:
+  MergeJoinExeNode() = default;
+  virtual ~MergeJoinExeNode();
+
+  RC init(ExecutionNode *outer, ExecutionNode *inner, std::vector<const Condition *> &&conditions,
+          const SortOptions &options, bool keep_order);
+
+  RC open() override;
+  RC next(Tuple &tuple) override;
+  RC close() override;
+
+  const TupleSchema &schema() const override {
+    return tuple_schema_;
+  }
+  double estimated_rows() const override;
+
+private:
+  RC merge_next(Tuple &tuple);
+  int compare_key(const Tuple &outer_tuple, const Tuple &inner_tuple) const;
+  bool has_null_key(const Tuple &tuple, bool from_outer) const;
+  bool filter(const Tuple &outer_tuple, const Tuple &inner_tuple) const;
+  RC next_inner();
+
+private:
+  SortExeNode *outer_ = nullptr;
+  SortExeNode *inner_ = nullptr;
+  SortExeNode *order_ = nullptr;  // keep_order时按外层行的编号排序归并的结果
+  TupleSchema tuple_schema_;
+  std::vector<JoinCondition> conditions_;
+  std::vector<int> key_conditions_;
+
+  Tuple outer_tuple_;
+  Tuple inner_tuple_;  // 内层还没有归并的第一行
+  bool inner_valid_ = false;
+  std::vector<Tuple> inner_group_;  // 连接字段与当前外层行相等的内层行
+  size_t group_pos_ = 0;
+};
+
+/**
+ * 估计一行数据占用的内存
+ */
+size_t estimated_tuple_size(const TupleSchema &schema);
+
+#endif  //__OBSERVER_SQL_EXECUTOR_EXTERNAL_SORT_H_
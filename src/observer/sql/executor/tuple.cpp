@@ -15,7 +15,6 @@ See the Mulan PSL v2 for more details. */
 #include "sql/executor/tuple.h"
 #include "storage/common/table.h"
 #include "common/log/log.h"
-#include "sql/executor/aggregate.h"
 #include <memory>
 
 /*
@@ -221,16 +220,6 @@ void TupleSchema::print_with_tablename(std::ostream &os) const {
 }
 
 /////////////////////////////////////////////////////////////////////////////
-bool is_float_output(AttrType attr_type, AggreType aggre_type){
-    if ( attr_type == AttrType::FLOATS ){
-        return true;
-    }
-    if ( aggre_type == AggreType::AVG ){
-        return true;
-    }
-    return false;
-}
-
 /////////////////////////////////////////////////////////////////////////////
 TupleSet::TupleSet(TupleSet &&other) : tuples_(std::move(other.tuples_)), schema_(other.schema_) {
     other.schema_.clear();
@@ -254,44 +243,24 @@ void TupleSet::add(Tuple &&tuple) {
     tuples_.emplace_back(std::move(tuple));
 }
 
+RC TupleSet::add_projected(const TupleSchema &input_schema, const Tuple &tuple) {
+    Tuple new_tuple;
+    for (auto& tuple_field : schema_.fields()){
+        int i = input_schema.index_of_field(tuple_field.table_name(), tuple_field.field_name());
+        if (i == -1) {
+            return RC::SCHEMA_FIELD_NOT_EXIST;
+        }
+        new_tuple.add(tuple.get_pointer(i));
+    }
+    add(std::move(new_tuple));
+    return RC::SUCCESS;
+}
+
 void TupleSet::clear() {
     tuples_.clear();
     schema_.clear();
 }
 
-RC TupleSet::sort(const Selects &selects) {
-    RC rc = RC::SUCCESS;
-    const TupleSchema &schema = this->get_schema();
-    auto compare = [&schema, &selects, &rc](const Tuple& tuple1, const Tuple& tuple2) -> bool {
-        if (rc != RC::SUCCESS) {
-            return true;
-        }
-        for (int i = 0; i < (int)selects.orderbys_num; i++) {
-            const Orderby& orderby = selects.orderbys[i];
-            const char* table_name = orderby.attr.relation_name;
-            const char* attribute_name = orderby.attr.attribute_name;
-            if (table_name == nullptr) {
-                table_name = selects.relations[0];
-            }
-            int idx = schema.index_of_field(table_name, attribute_name);
-            if (idx == -1) {
-                rc = RC::SCHEMA_FIELD_NAME_ILLEGAL;
-                return false;
-            }
-            int result = tuple1.get(idx).compare(tuple2.get(idx));
-            if (result == -1) {
-                return orderby.asc_desc == OrderType::O_AES;
-            }
-            if (result == 1) {
-                return orderby.asc_desc == OrderType::O_DESC;
-            }
-        }
-        return true;
-    };
-    std::sort(this->tuples_.begin(), this->tuples_.end(), compare);
-    return rc;
-}
-
 void print_tuples(std::ostream &os, const std::vector<Tuple> &tuples) {
     for (const Tuple &item: tuples) {
         const std::vector<std::shared_ptr<TupleValue>> &values = item.values();
@@ -344,107 +313,14 @@ void TupleSet::set_schema(const TupleSchema &schema) {
 }  
 
 RC TupleSet::set_tuple_set(TupleSet &&tuple_set) {
-    const TupleSchema &output_schema = tuple_set.schema();
-    const TupleSchema &input_schema = this->schema();
-    const std::vector<TupleField> &tuple_fields = input_schema.fields();
-    RC rc = RC::SUCCESS;
-    
-    int index_num = tuple_fields.size();
-    std::vector<bool> field_count_null;
-
-    bool select_isaggre = false;
-    
-    for (auto &field : tuple_fields) {
-        if (field.aggre_type == AggreType::COUNT && is_valid_aggre(field.field_name())){
-            field_count_null.push_back(true);
-        } else {
-            field_count_null.push_back(false);
-        }
-        if (field.aggre_type != AggreType::NON){
-            select_isaggre = true;
-        }
-    }
-    
-    // not aggregate selection, return immediately
-    if (!select_isaggre){
-        for (auto& tuple : tuple_set.tuples()) {
-            Tuple new_tuple;
-            for (auto& tuple_field : tuple_fields){
-                int i = output_schema.index_of_field(tuple_field.table_name(), tuple_field.field_name());
-                if (i == -1) {
-                    rc = RC::SCHEMA_FIELD_NOT_EXIST;
-                    return rc;
-                }
-                const std::shared_ptr<TupleValue> &value_ptr = tuple.get_pointer(i);
-                new_tuple.add(value_ptr);
-            }
-            add(std::move(new_tuple));
-        }
-        return RC::SUCCESS;
-    }
-
-    // need to aggregate
-    //   init groupby
-    const std::vector<RelAttr> &groupby_attr  = input_schema.get_groupby();
-    const int groupby_num = input_schema.get_groupby_num();
-    GroupHandler *group_handler = new GroupHandler();
-
-    AggregateExeNode agg_exec_node;
-
-    // group and aggregate
+    const TupleSchema &input_schema = tuple_set.schema();
     for (auto& tuple : tuple_set.tuples()) {
-        Tuple new_tuple;
-        int group = 0;
-        if ( groupby_num > 0){ 
-            group = group_handler->get_group(tuple,groupby_attr, output_schema);
-            if(group<0){
-                return RC::GENERIC_ERROR;
-            }
-        }
-        int index = 0;
-        for (auto& tuple_field : tuple_fields) {
-            int i = output_schema.index_of_field(tuple_field.table_name(), tuple_field.field_name());
-            if(is_valid_aggre(tuple_field.field_name())) {
-                i = 0;
-            }
-            if (i == -1) {
-                rc = RC::SCHEMA_FIELD_NOT_EXIST;
-                return rc;
-            }
-            const std::shared_ptr<TupleValue> &value_ptr = tuple.get_pointer(i);
-            rc = agg_exec_node.add_value(value_ptr, index+group*index_num, tuple_field.aggre_type, tuple_field.type(),field_count_null[index]);
-            if (rc != RC::SUCCESS) {
-                return rc;
-            }
-            index += 1;
-        }
-    }
-
-    // get aggregated data
-    int group_num = 1;
-    if(groupby_num>0){
-        group_num = group_handler->get_group_num();
-    }
-    for(int group_id = 0; group_id < group_num; group_id++){
-        Tuple new_tuple;
-        int index = 0;
-        for (auto& tuple_field : tuple_fields) {
-            const std::shared_ptr<TupleValue> &value_ptr = agg_exec_node.get_value(index+group_id*index_num);
-                // 处理精度问题
-            if (value_ptr == nullptr){
-                new_tuple.add(nullptr);
-            } else if (is_float_output(tuple_field.type(), tuple_field.aggre_type)) {
-                    FloatValue *fvalue_ptr = dynamic_cast<FloatValue *>(value_ptr.get());
-                    float value = round(100 * (fvalue_ptr->get_value())) / 100.0;
-                    new_tuple.add(value);
-            } else {
-                new_tuple.add(value_ptr);
-            }
-            index += 1;  
+        RC rc = add_projected(input_schema, tuple);
+        if (rc != RC::SUCCESS) {
+            return rc;
         }
-        add(std::move(new_tuple));
     }
-    return rc;
+    return RC::SUCCESS;
 }
 
 const TupleSchema &TupleSet::get_schema() const {
@@ -502,10 +378,11 @@ void TupleRecordConverter::add_record(const char *record) {
             }
                 break;
             case TEXTS: {
-                int num = *(int *) (record + field_meta->offset());
-                std:: string path = "./miniob/db/sys/" + std::string(const_cast<char *>(table_meta.name())) + "_" + std::to_string(num) + "_" + "text.txt";
-                tuple.add(path);
+                std::string text;
+                table_->read_text(record + field_meta->offset(), text);
+                tuple.add(text);
             }
+                break;
 
             default: {
                 LOG_PANIC("Unsupported field type. type=%d", field_meta->type());
@@ -121,23 +121,6 @@ public:
     fields_.clear();
   }
 
-  void set_groupby(const RelAttr *groupby, int groupby_num, const char* table_name) {
-    if(groupby_num==0) return;
-    groupby_num_ = groupby_num;
-    for (int i = 0; i<groupby_num_; i++){
-        groupby_.push_back(groupby[i]);
-        if(groupby_[i].relation_name==nullptr){
-          groupby_[i].relation_name = const_cast<char*>(table_name);
-        }
-    }
-  }
-  const std::vector<RelAttr>& get_groupby() const {
-    return groupby_;
-  }
-  const int get_groupby_num() const {
-    return groupby_num_;
-  }
-
   void print(std::ostream &os) const;
   void print(std::ostream &os, bool flag) const;
   void print_with_tablename(std::ostream &os) const;
@@ -145,8 +128,6 @@ public:
   static void from_table(const Table *table, TupleSchema &schema);
 private:
   std::vector<TupleField> fields_;
-  std::vector<RelAttr> groupby_;
-  int groupby_num_;
 };
 
 class TupleSet {
@@ -166,6 +147,11 @@ public:
 
   void add(Tuple && tuple);
 
+  /**
+   * 按照当前的schema从tuple中取出对应的字段组成新的一行，tuple中的字段由input_schema描述
+   */
+  RC add_projected(const TupleSchema &input_schema, const Tuple &tuple);
+
   void clear();
 
   bool is_empty() const;
@@ -176,7 +162,6 @@ public:
   void print(std::ostream &os) const;
   void print(std::ostream &os, bool flag) const;
   void print_with_tablename(std::ostream &os) const;
-  RC sort(const Selects &selects);
 public:
   const TupleSchema &schema() const {
     return schema_;
@@ -17,7 +17,6 @@ See the Mulan PSL v2 for more details. */
 
 #include <string.h>
 #include<sstream>
-#include<fstream>
 #include <string>
 #include <ostream>
 #include <utility>
@@ -252,12 +251,7 @@ public:
         if (is_null()) {
             os << "null";
         } else {
-            std::ifstream infile(value_.c_str());
-            printf("The file path is %s\n", value_.c_str());
-            std::string temp;
-            while (getline(infile, temp)) {
-                os << temp;
-            }
+            os << value_;
         }
     }
 
@@ -0,0 +1,442 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "sql/executor/vectorized.h"
+
+#include <string.h>
+#include <string>
+
+#include "common/log/log.h"
+#include "sql/executor/tuple.h"
+#include "storage/common/condition_filter.h"
+#include "storage/common/field_meta.h"
+#include "storage/common/record_manager.h"
+#include "storage/common/table.h"
+#include "storage/trx/trx.h"
+
+void ColumnVector::init(const FieldMeta &field_meta)
+{
+  field_meta_ = &field_meta;
+  type_ = field_meta.type();
+  offset_ = field_meta.offset();
+  len_ = field_meta.len();
+  width_ = (type_ == CHARS || type_ == TEXTS) ? len_ + 1 : 0;
+  reset();
+}
+
+void ColumnVector::reset()
+{
+  ints_.clear();
+  floats_.clear();
+  chars_.clear();
+  nulls_.clear();
+}
+
+void ColumnVector::append(const Record *records[], int record_num)
+{
+  const int old_size = size();
+  nulls_.resize(old_size + record_num);
+  for (int i = 0; i < record_num; i++) {
+    nulls_[old_size + i] = records[i]->data[offset_] == '!';
+  }
+
+  switch (type_) {
+    case INTS:
+    case DATES: {
+      ints_.resize(old_size + record_num);
+      for (int i = 0; i < record_num; i++) {
+        memcpy(&ints_[old_size + i], records[i]->data + offset_, sizeof(int));
+      }
+    } break;
+    case FLOATS: {
+      floats_.resize(old_size + record_num);
+      for (int i = 0; i < record_num; i++) {
+        memcpy(&floats_[old_size + i], records[i]->data + offset_, sizeof(float));
+      }
+    } break;
+    default: {
+      chars_.resize((old_size + record_num) * width_);
+      char *dest = chars_.data() + old_size * width_;
+      for (int i = 0; i < record_num; i++, dest += width_) {
+        memcpy(dest, records[i]->data + offset_, len_);
+        dest[len_] = '\0';
+      }
+    } break;
+  }
+}
+
+const int DataChunk::CAPACITY;
+
+int DataChunk::add_column(const FieldMeta &field_meta)
+{
+  for (int i = 0; i < (int)columns_.size(); i++) {
+    if (columns_[i].field_meta() == &field_meta) {
+      return i;
+    }
+  }
+  columns_.emplace_back();
+  columns_.back().init(field_meta);
+  return (int)columns_.size() - 1;
+}
+
+int DataChunk::append(const Record *records[], int record_num)
+{
+  if (record_num > CAPACITY - size_) {
+    record_num = CAPACITY - size_;
+  }
+  for (ColumnVector &column : columns_) {
+    column.append(records, record_num);
+  }
+  for (int i = 0; i < record_num; i++) {
+    selection_.push_back(size_ + i);
+  }
+  size_ += record_num;
+  return record_num;
+}
+
+void DataChunk::reset()
+{
+  for (ColumnVector &column : columns_) {
+    column.reset();
+  }
+  selection_.clear();
+  size_ = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool VectorizedPredicate::support(const DefaultConditionFilter &filter)
+{
+  const ConDesc &left = filter.left();
+  const ConDesc &right = filter.right();
+  if (left.is_attr == right.is_attr) {
+    return false;
+  }
+
+  const ConDesc &value = left.is_attr ? right : left;
+  AttrType attr_type = left.is_attr ? filter.left_attr_type() : filter.right_attr_type();
+  AttrType value_type = left.is_attr ? filter.right_attr_type() : filter.left_attr_type();
+  if (value.value_tuple_size != 0 || (value.value == nullptr && value_type != NULLS)) {
+    return false;
+  }
+  if (attr_type != INTS && attr_type != FLOATS && attr_type != DATES && attr_type != CHARS) {
+    return false;
+  }
+
+  CompOp comp_op = filter.comp_op();
+  if (comp_op == IS_COMPOP || comp_op == IS_NOT_COMPOP) {
+    // 非null的常量与字段比较时按相等处理，很少出现，交给逐条记录过滤
+    return value_type == NULLS;
+  }
+  return comp_op >= EQUAL_TO && comp_op <= GREAT_THAN;
+}
+
+RC VectorizedPredicate::init(const DefaultConditionFilter &filter, int column_index)
+{
+  if (!support(filter)) {
+    LOG_ERROR("Condition cannot be evaluated by column.");
+    return RC::INVALID_ARGUMENT;
+  }
+
+  attr_on_left_ = filter.left().is_attr;
+  column_index_ = column_index;
+  comp_op_ = filter.comp_op();
+  attr_type_ = attr_on_left_ ? filter.left_attr_type() : filter.right_attr_type();
+  value_type_ = attr_on_left_ ? filter.right_attr_type() : filter.left_attr_type();
+  value_ = (const char *)(attr_on_left_ ? filter.right().value : filter.left().value);
+  return RC::SUCCESS;
+}
+
+static inline bool compare_result_match(CompOp comp_op, float cmp_result)
+{
+  switch (comp_op) {
+    case EQUAL_TO:    return 0 == cmp_result;
+    case LESS_EQUAL:  return cmp_result <= 0;
+    case NOT_EQUAL:   return cmp_result != 0;
+    case LESS_THAN:   return cmp_result < 0;
+    case GREAT_EQUAL: return cmp_result >= 0;
+    case GREAT_THAN:  return cmp_result > 0;
+    default:          return false;
+  }
+}
+
+/**
+ * 保留selection中满足get_cmp_result的行。比较结果的计算方式与DefaultConditionFilter::filter_composed保持一致
+ */
+template <typename CmpFunc>
+static void select_rows(const ColumnVector &column, CompOp comp_op, std::vector<int> &selection, CmpFunc get_cmp_result)
+{
+  int selected = 0;
+  for (int row : selection) {
+    if (!column.is_null(row) && compare_result_match(comp_op, get_cmp_result(row))) {
+      selection[selected++] = row;
+    }
+  }
+  selection.resize(selected);
+}
+
+void VectorizedPredicate::filter(const DataChunk &chunk, std::vector<int> &selection) const
+{
+  const ColumnVector &column = chunk.column(column_index_);
+
+  if (value_type_ == NULLS) {
+    // 与null比较时只有is/is not有结果
+    bool keep_null = comp_op_ == IS_COMPOP;
+    if (comp_op_ != IS_COMPOP && comp_op_ != IS_NOT_COMPOP) {
+      selection.clear();
+      return;
+    }
+    int selected = 0;
+    for (int row : selection) {
+      if (column.is_null(row) == keep_null) {
+        selection[selected++] = row;
+      }
+    }
+    selection.resize(selected);
+    return;
+  }
+
+  const bool left = attr_on_left_;
+  switch (attr_type_) {
+    case INTS:
+    case DATES: {
+      if (value_type_ == FLOATS) {
+        float value = *(const float *)value_;
+        select_rows(column, comp_op_, selection, [&column, value, left](int row) -> float {
+          return left ? column.int_value(row) - value : value - column.int_value(row);
+        });
+      } else {
+        int value = *(const int *)value_;
+        select_rows(column, comp_op_, selection, [&column, value, left](int row) -> float {
+          return left ? column.int_value(row) - value : value - column.int_value(row);
+        });
+      }
+    } break;
+    case FLOATS: {
+      if (value_type_ == INTS) {
+        int value = *(const int *)value_;
+        select_rows(column, comp_op_, selection, [&column, value, left](int row) -> float {
+          return left ? column.float_value(row) - value : value - column.float_value(row);
+        });
+      } else {
+        float value = *(const float *)value_;
+        select_rows(column, comp_op_, selection, [&column, value, left](int row) -> float {
+          return left ? column.float_value(row) - value : value - column.float_value(row);
+        });
+      }
+    } break;
+    case CHARS: {
+      const char *value = value_;
+      select_rows(column, comp_op_, selection, [&column, value, left](int row) -> float {
+        return left ? strcmp(column.data(row), value) : strcmp(value, column.data(row));
+      });
+    } break;
+    default: {
+      LOG_PANIC("Unsupported attribute type of vectorized predicate. type=%d", attr_type_);
+    } break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+VectorizedSelect::VectorizedSelect(Table *table) : table_(table)
+{}
+
+int VectorizedSelect::add_column(int offset)
+{
+  const FieldMeta *field_meta = table_->table_meta().find_field_by_offset(offset);
+  if (field_meta == nullptr) {
+    return -1;
+  }
+  return chunk_.add_column(*field_meta);
+}
+
+RC VectorizedSelect::init(const TupleSchema &schema, const std::vector<DefaultConditionFilter *> &condition_filters)
+{
+  const TableMeta &table_meta = table_->table_meta();
+  for (const TupleField &field : schema.fields()) {
+    const FieldMeta *field_meta = table_meta.field(field.field_name());
+    if (field_meta == nullptr) {
+      LOG_WARN("No such field. %s.%s", table_->name(), field.field_name());
+      return RC::SCHEMA_FIELD_MISSING;
+    }
+    output_columns_.push_back(chunk_.add_column(*field_meta));
+  }
+
+  for (const DefaultConditionFilter *filter : condition_filters) {
+    int column_index = -1;
+    if (VectorizedPredicate::support(*filter)) {
+      const ConDesc &attr = filter->left().is_attr ? filter->left() : filter->right();
+      column_index = add_column(attr.attr_offset);
+    }
+    if (column_index < 0) {
+      record_filters_.push_back(filter);
+      continue;
+    }
+
+    predicates_.emplace_back();
+    RC rc = predicates_.back().init(*filter, column_index);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return record_filter_.init(record_filters_.data(), record_filters_.size());
+}
+
+RC VectorizedSelect::open(Trx *trx)
+{
+  close();
+  RC rc = table_->open_scanner(scanner_, &record_filter_);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  trx_ = trx;
+  scanner_opened_ = true;
+  scan_eof_ = false;
+  return RC::SUCCESS;
+}
+
+void VectorizedSelect::close()
+{
+  if (scanner_opened_) {
+    scanner_.close_scan();
+    scanner_opened_ = false;
+  }
+  chunk_.reset();
+  cursor_ = 0;
+  batch_.clear();
+  visible_records_.clear();
+  batch_pos_ = 0;
+}
+
+RC VectorizedSelect::next(Tuple &tuple)
+{
+  if (!scanner_opened_) {
+    LOG_ERROR("Scanner of table %s is not opened.", table_->name());
+    return RC::GENERIC_ERROR;
+  }
+  while (cursor_ >= (int)chunk_.selection().size()) {
+    if (scan_eof_ && batch_pos_ >= (int)visible_records_.size()) {
+      return RC::RECORD_EOF;
+    }
+    RC rc = fill_chunk();
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+  }
+  return project(chunk_.selection()[cursor_++], tuple);
+}
+
+RC VectorizedSelect::select(const RecordBatch &batch, std::vector<Tuple> &tuples)
+{
+  visible_records_.clear();
+  for (int i = 0; i < batch.size(); i++) {
+    const Record &record = batch.record(i);
+    if (record_filter_.filter(record)) {
+      visible_records_.push_back(&record);
+    }
+  }
+
+  RC rc = RC::SUCCESS;
+  int pos = 0;
+  while (rc == RC::SUCCESS && pos < (int)visible_records_.size()) {
+    chunk_.reset();
+    pos += chunk_.append(visible_records_.data() + pos, (int)visible_records_.size() - pos);
+    std::vector<int> &selection = chunk_.selection();
+    for (const VectorizedPredicate &predicate : predicates_) {
+      predicate.filter(chunk_, selection);
+    }
+    for (size_t i = 0; rc == RC::SUCCESS && i < selection.size(); i++) {
+      Tuple tuple;
+      rc = project(selection[i], tuple);
+      if (rc == RC::SUCCESS) {
+        tuples.push_back(std::move(tuple));
+      }
+    }
+  }
+  chunk_.reset();
+  visible_records_.clear();
+  return rc;
+}
+
+RC VectorizedSelect::fill_chunk()
+{
+  chunk_.reset();
+  cursor_ = 0;
+  while (!chunk_.full()) {
+    if (batch_pos_ < (int)visible_records_.size()) {
+      batch_pos_ += chunk_.append(visible_records_.data() + batch_pos_, (int)visible_records_.size() - batch_pos_);
+      continue;
+    }
+    if (scan_eof_) {
+      break;
+    }
+
+    RC rc = scanner_.get_records_batch(batch_);
+    if (rc == RC::RECORD_EOF) {
+      scan_eof_ = true;
+      break;
+    }
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to scan table %s. rc=%d:%s", table_->name(), rc, strrc(rc));
+      return rc;
+    }
+    visible_records_.clear();
+    batch_pos_ = 0;
+    for (int i = 0; i < batch_.size(); i++) {
+      const Record &record = batch_.record(i);
+      if (trx_ == nullptr || trx_->is_visible(table_, &record)) {
+        visible_records_.push_back(&record);
+      }
+    }
+  }
+
+  std::vector<int> &selection = chunk_.selection();
+  for (const VectorizedPredicate &predicate : predicates_) {
+    if (selection.empty()) {
+      break;
+    }
+    predicate.filter(chunk_, selection);
+  }
+  return RC::SUCCESS;
+}
+
+RC VectorizedSelect::project(int row, Tuple &tuple)
+{
+  for (int column_index : output_columns_) {
+    const ColumnVector &column = chunk_.column(column_index);
+    switch (column.type()) {
+      case INTS: {
+        tuple.add(column.int_value(row));
+      } break;
+      case FLOATS: {
+        tuple.add(column.float_value(row));
+      } break;
+      case DATES: {
+        tuple.add(column.int_value(row), true);
+      } break;
+      case CHARS: {
+        const char *s = column.data(row);
+        tuple.add(s, strlen(s));
+      } break;
+      case TEXTS: {
+        std::string text;
+        RC rc = table_->read_text(column.data(row), text);
+        if (rc != RC::SUCCESS) {
+          LOG_ERROR("Failed to read text of table %s. rc=%d:%s", table_->name(), rc, strrc(rc));
+          return rc;
+        }
+        tuple.add(text);
+      } break;
+      default: {
+        LOG_PANIC("Unsupported field type. type=%d", column.type());
+      } break;
+    }
+  }
+  return RC::SUCCESS;
+}
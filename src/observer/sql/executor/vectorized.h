@@ -0,0 +1,176 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_SQL_EXECUTOR_VECTORIZED_H_
+#define __OBSERVER_SQL_EXECUTOR_VECTORIZED_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "rc.h"
+#include "sql/parser/parse.h"
+#include "storage/common/condition_filter.h"
+#include "storage/common/record_manager.h"
+
+class Table;
+class Trx;
+class FieldMeta;
+class Tuple;
+class TupleSchema;
+
+/**
+ * 一列数据。INTS和DATES保存在int数组中，FLOATS保存在float数组中，
+ * CHARS和TEXTS按字段长度定长保存原始数据（TEXTS保存的是记录中的溢出页信息）
+ */
+class ColumnVector {
+public:
+  void init(const FieldMeta &field_meta);
+
+  /**
+   * 清空所有行，保留已经分配的内存
+   */
+  void reset();
+
+  /**
+   * 从记录中取出本列的数据追加到末尾
+   */
+  void append(const Record *records[], int record_num);
+
+  const FieldMeta *field_meta() const { return field_meta_; }
+  AttrType type() const { return type_; }
+  int size() const { return (int)nulls_.size(); }
+
+  /**
+   * 与条件过滤一样，字段的第一个字节是'!'时表示null
+   */
+  bool is_null(int row) const { return nulls_[row] != 0; }
+  int int_value(int row) const { return ints_[row]; }
+  float float_value(int row) const { return floats_[row]; }
+  const char *data(int row) const { return chars_.data() + row * width_; }
+
+private:
+  const FieldMeta *field_meta_ = nullptr;
+  AttrType type_ = UNDEFINED;
+  int offset_ = 0;
+  int len_ = 0;
+  int width_ = 0;  // CHARS多留一个字节放'\0'
+
+  std::vector<int> ints_;
+  std::vector<float> floats_;
+  std::vector<char> chars_;
+  std::vector<uint8_t> nulls_;
+};
+
+/**
+ * 一批按列保存的数据，最多CAPACITY行。selection记录还没有被过滤掉的行号
+ */
+class DataChunk {
+public:
+  static const int CAPACITY = 1024;
+
+  /**
+   * 增加一列，字段已经存在时返回已有的列号
+   */
+  int add_column(const FieldMeta &field_meta);
+  int column_num() const { return (int)columns_.size(); }
+  ColumnVector &column(int index) { return columns_[index]; }
+  const ColumnVector &column(int index) const { return columns_[index]; }
+
+  /**
+   * 追加记录直到装满，返回实际追加的记录数。追加后所有行都处于选中状态
+   */
+  int append(const Record *records[], int record_num);
+  void reset();
+
+  int size() const { return size_; }
+  bool full() const { return size_ >= CAPACITY; }
+
+  std::vector<int> &selection() { return selection_; }
+  const std::vector<int> &selection() const { return selection_; }
+
+private:
+  std::vector<ColumnVector> columns_;
+  std::vector<int> selection_;
+  int size_ = 0;
+};
+
+/**
+ * 按列计算的过滤条件。只处理"字段 比较符 常量"以及"字段 is [not] null"这样的条件，
+ * 其它条件仍然在扫描时逐条记录过滤。结果与DefaultConditionFilter::filter相同
+ */
+class VectorizedPredicate {
+public:
+  static bool support(const DefaultConditionFilter &filter);
+
+  RC init(const DefaultConditionFilter &filter, int column_index);
+
+  /**
+   * 去掉selection中不满足条件的行
+   */
+  void filter(const DataChunk &chunk, std::vector<int> &selection) const;
+
+private:
+  int column_index_ = -1;
+  bool attr_on_left_ = true;
+  CompOp comp_op_ = NO_OP;
+  AttrType attr_type_ = UNDEFINED;
+  AttrType value_type_ = UNDEFINED;
+  const char *value_ = nullptr;
+};
+
+/**
+ * 单表查询的向量化执行：按页面扫描可见的记录并按列装入DataChunk，
+ * 每装满一批就按列过滤，调用next时只把选中的行投影成Tuple
+ */
+class VectorizedSelect {
+public:
+  VectorizedSelect(Table *table);
+
+  RC init(const TupleSchema &schema, const std::vector<DefaultConditionFilter *> &condition_filters);
+
+  RC open(Trx *trx);
+
+  /**
+   * 取出下一个满足条件的行，没有更多数据时返回RECORD_EOF
+   */
+  RC next(Tuple &tuple);
+  void close();
+
+  /**
+   * 不扫描数据文件，对调用方取出的记录(比如通过索引取出的记录)计算过滤条件，
+   * 满足条件的记录按原来的顺序投影后追加到tuples中。不能与扫描同时使用
+   */
+  RC select(const RecordBatch &batch, std::vector<Tuple> &tuples);
+
+private:
+  RC fill_chunk();
+  RC project(int row, Tuple &tuple);
+  int add_column(int offset);
+
+private:
+  Table *table_;
+  Trx *trx_ = nullptr;
+
+  DataChunk chunk_;
+  int cursor_ = 0;  // 下一个要返回的行在selection中的位置
+  std::vector<int> output_columns_;
+  std::vector<VectorizedPredicate> predicates_;
+  std::vector<const ConditionFilter *> record_filters_;  // 不能按列计算的条件
+  CompositeConditionFilter record_filter_;
+
+  RecordFileScanner scanner_;
+  bool scanner_opened_ = false;
+  bool scan_eof_ = false;
+  RecordBatch batch_;
+  std::vector<const Record *> visible_records_;  // batch_中对事务可见的记录
+  int batch_pos_ = 0;
+};
+
+#endif  //__OBSERVER_SQL_EXECUTOR_VECTORIZED_H_
@@ -22,6 +22,12 @@ See the Mulan PSL v2 for more details. */
 #include "common/lang/string.h"
 #include "common/log/log.h"
 #include "common/seda/timer_stage.h"
+#include "event/execution_plan_event.h"
+#include "event/session_event.h"
+#include "event/sql_event.h"
+#include "session/session.h"
+#include "sql/optimizer/optimizer.h"
+#include "storage/default/default_handler.h"
 
 using namespace common;
 
@@ -38,7 +44,11 @@ Stage *OptimizeStage::make_stage(const std::string &tag) {
     LOG_ERROR("new OptimizeStage failed");
     return nullptr;
   }
-  stage->set_properties();
+  if (!stage->set_properties()) {
+    LOG_ERROR("Failed to set properties of OptimizeStage");
+    delete stage;
+    return nullptr;
+  }
   return stage;
 }
 
@@ -76,13 +86,48 @@ void OptimizeStage::cleanup() {
 void OptimizeStage::handle_event(StageEvent *event) {
   LOG_TRACE("Enter\n");
 
-  // optimize sql plan, here just pass the event to the next stage
+  ExecutionPlanEvent *exe_event = static_cast<ExecutionPlanEvent *>(event);
+  Query *sql = exe_event->sqls();
+  if (sql->flag == SCF_SELECT) {
+    SessionEvent *session_event = exe_event->sql_event()->session_event();
+    const char *current_db = session_event->get_client()->session->get_current_db().c_str();
+    exe_event->set_select_plan(optimize_select(current_db, sql->sstr.selection));
+  }
+
   execute_stage->handle_event(event);
 
   LOG_TRACE("Exit\n");
   return;
 }
 
+SelectPlan *OptimizeStage::optimize_select(const char *db, const Selects &selects) {
+  // 带子查询的语句在执行时才能确定条件的值和关联的表，不生成执行计划
+  for (size_t i = 0; i < selects.condition_num; i++) {
+    if (selects.conditions[i].left_type == SUBSELECTION || selects.conditions[i].right_type == SUBSELECTION) {
+      return nullptr;
+    }
+  }
+
+  std::vector<Table *> tables;
+  for (size_t i = 0; i < selects.relation_num; i++) {
+    Table *table = DefaultHandler::get_default().find_table(db, selects.relations[i]);
+    if (table == nullptr) {
+      // 表不存在的错误由执行阶段返回
+      return nullptr;
+    }
+    tables.push_back(table);
+  }
+
+  SelectPlan *plan = new SelectPlan();
+  RC rc = Optimizer::optimize(selects, tables, *plan);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to optimize select. rc=%d:%s", rc, strrc(rc));
+    delete plan;
+    return nullptr;
+  }
+  return plan;
+}
+
 void OptimizeStage::callback_event(StageEvent *event, CallbackContext *context) {
   LOG_TRACE("Enter\n");
 
@@ -16,6 +16,9 @@ See the Mulan PSL v2 for more details. */
 #define __OBSERVER_SQL_OPTIMIZE_STAGE_H__
 
 #include "common/seda/stage.h"
+#include "sql/parser/parse_defs.h"
+
+struct SelectPlan;
 
 class OptimizeStage : public common::Stage {
 public:
@@ -35,6 +38,11 @@ protected:
 
 protected:
 private:
+  /**
+   * 根据统计信息选择连接顺序和每张表的访问方式，不能优化时返回nullptr，由执行阶段按默认方式执行
+   */
+  SelectPlan *optimize_select(const char *db, const Selects &selects);
+
   Stage *execute_stage = nullptr;
 };
 
@@ -0,0 +1,310 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+#include <limits>
+
+#include "sql/optimizer/optimizer.h"
+#include "common/log/log.h"
+#include "storage/common/condition_filter.h"
+#include "storage/common/table.h"
+#include "storage/common/table_stats.h"
+
+const int Optimizer::MAX_DP_TABLES;
+
+static bool match_relation(const Selects &selects, const char *relation_name, const char *table_name) {
+  if (relation_name != nullptr) {
+    return 0 == strcmp(relation_name, table_name);
+  }
+  return selects.relation_num == 1;
+}
+
+/**
+ * 与create_selection_executor相同，找出放在这张表上过滤的条件。子查询在执行时会替换成值
+ */
+static bool is_table_condition(const Selects &selects, const Condition &condition, const char *table_name) {
+  const bool left_is_attr = condition.left_type == ATTR;
+  const bool right_is_attr = condition.right_type == ATTR;
+  if (!left_is_attr && !right_is_attr) {
+    return true;
+  }
+  return (!left_is_attr || match_relation(selects, condition.left_attr.relation_name, table_name)) &&
+         (!right_is_attr || match_relation(selects, condition.right_attr.relation_name, table_name));
+}
+
+static CompOp reverse_comp_op(CompOp op) {
+  switch (op) {
+    case LESS_THAN:   return GREAT_THAN;
+    case LESS_EQUAL:  return GREAT_EQUAL;
+    case GREAT_THAN:  return LESS_THAN;
+    case GREAT_EQUAL: return LESS_EQUAL;
+    default:          return op;
+  }
+}
+
+/**
+ * 估计一个单表条件的选择率。只有 字段 op 常量 的条件使用统计信息
+ */
+static double condition_selectivity(const Condition &condition, const TableStats *stats) {
+  if (stats != nullptr) {
+    if (condition.left_type == ATTR && condition.right_type == VALUE) {
+      return stats->selectivity(condition.left_attr.attribute_name, condition.comp, condition.right_value);
+    }
+    if (condition.left_type == VALUE && condition.right_type == ATTR) {
+      return stats->selectivity(condition.right_attr.attribute_name, reverse_comp_op(condition.comp),
+                                condition.left_value);
+    }
+  }
+  return condition.comp == EQUAL_TO ? TableStats::DEFAULT_EQUAL_SELECTIVITY : TableStats::DEFAULT_RANGE_SELECTIVITY;
+}
+
+static bool add_field(const Selects &selects, const RelAttr &attr, const char *table_name, Table *table,
+                      std::vector<std::string> &fields) {
+  if (!match_relation(selects, attr.relation_name, table_name)) {
+    return true;
+  }
+  if (0 == strcmp(attr.attribute_name, "*") || table->table_meta().field(attr.attribute_name) == nullptr) {
+    return false;
+  }
+  fields.push_back(attr.attribute_name);
+  return true;
+}
+
+/**
+ * 语句中用到的这张表的字段，用来判断能否只读索引。需要整条记录或者不能确定时返回false
+ */
+static bool needed_fields(const Selects &selects, const char *table_name, Table *table,
+                          std::vector<std::string> &fields) {
+  for (size_t i = 0; i < selects.attr_num; i++) {
+    if (!add_field(selects, selects.attributes[i], table_name, table, fields)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < selects.groupby_num; i++) {
+    if (!add_field(selects, selects.groupby_attr[i], table_name, table, fields)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < selects.orderbys_num; i++) {
+    if (!add_field(selects, selects.orderbys[i].attr, table_name, table, fields)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < selects.condition_num; i++) {
+    const Condition &condition = selects.conditions[i];
+    if ((condition.left_type == ATTR && !add_field(selects, condition.left_attr, table_name, table, fields)) ||
+        (condition.right_type == ATTR && !add_field(selects, condition.right_attr, table_name, table, fields))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static double base_rows(Table *table) {
+  const TableStats *stats = table->table_stats();
+  return stats != nullptr ? stats->row_count : table->estimated_record_num();
+}
+
+void Optimizer::choose_access(const Selects &selects, int relation, Table *table, TableAccess &access) {
+  const char *table_name = selects.relations[relation];
+  const TableStats *stats = table->table_stats();
+  const double rows = base_rows(table);
+
+  access.rows = rows;
+  for (size_t i = 0; i < selects.condition_num; i++) {
+    const Condition &condition = selects.conditions[i];
+    if (is_table_condition(selects, condition, table_name)) {
+      access.rows *= condition_selectivity(condition, stats);
+    }
+  }
+  access.rows = std::max(access.rows, 1.0);
+
+  // 由表根据 字段 op 常量 的条件选择索引和扫描范围，顺序扫描的代价是表的行数
+  std::vector<Condition> conditions;
+  for (size_t i = 0; i < selects.condition_num; i++) {
+    if (is_table_condition(selects, selects.conditions[i], table_name)) {
+      conditions.push_back(selects.conditions[i]);
+    }
+  }
+  if (conditions.empty()) {
+    return;
+  }
+  CompositeConditionFilter filter;
+  if (filter.init(*table, conditions.data(), conditions.size()) != RC::SUCCESS) {
+    return;
+  }
+  std::vector<std::string> fields;
+  const bool known_fields = needed_fields(selects, table_name, table, fields);
+  IndexScanRange range;
+  double cost = 0;
+  Index *index = table->find_index_range(&filter, known_fields ? &fields : nullptr, range, cost);
+  if (index != nullptr && cost < rows) {
+    access.index = index;
+    access.range = std::move(range);
+  }
+}
+
+RC Optimizer::optimize(const Selects &selects, const std::vector<Table *> &tables, SelectPlan &plan) {
+  const int relation_num = selects.relation_num;
+  if (relation_num == 0 || (int)tables.size() != relation_num) {
+    return RC::INVALID_ARGUMENT;
+  }
+
+  bool all_analyzed = true;
+  plan.accesses.clear();
+  plan.accesses.resize(relation_num);
+  for (int i = 0; i < relation_num; i++) {
+    choose_access(selects, i, tables[i], plan.accesses[i]);
+    all_analyzed = all_analyzed && tables[i]->table_stats() != nullptr;
+  }
+
+  // 没有统计信息时保持原来的顺序：从最后一张表开始连接
+  plan.join_order.clear();
+  for (int i = relation_num - 1; i >= 0; i--) {
+    plan.join_order.push_back(i);
+  }
+  plan.cost = 0;
+  if (relation_num == 1 || !all_analyzed) {
+    return RC::SUCCESS;
+  }
+
+  std::vector<double> rows;
+  for (const TableAccess &access : plan.accesses) {
+    rows.push_back(access.rows);
+  }
+  std::vector<std::vector<double>> selectivity(relation_num, std::vector<double>(relation_num, 1.0));
+  for (size_t i = 0; i < selects.condition_num; i++) {
+    const Condition &condition = selects.conditions[i];
+    if (condition.left_type != ATTR || condition.right_type != ATTR ||
+        condition.left_attr.relation_name == nullptr || condition.right_attr.relation_name == nullptr) {
+      continue;
+    }
+    int left = -1;
+    int right = -1;
+    for (int j = 0; j < relation_num; j++) {
+      if (0 == strcmp(selects.relations[j], condition.left_attr.relation_name)) {
+        left = j;
+      }
+      if (0 == strcmp(selects.relations[j], condition.right_attr.relation_name)) {
+        right = j;
+      }
+    }
+    if (left < 0 || right < 0 || left == right) {
+      continue;
+    }
+
+    double join_selectivity = TableStats::DEFAULT_RANGE_SELECTIVITY;
+    if (condition.comp == EQUAL_TO) {
+      join_selectivity = tables[left]->table_stats()->join_selectivity(
+          condition.left_attr.attribute_name, tables[right]->table_stats(), condition.right_attr.attribute_name);
+    }
+    selectivity[left][right] *= join_selectivity;
+    selectivity[right][left] *= join_selectivity;
+  }
+
+  plan.cost = order_joins(rows, selectivity, plan.join_order);
+  return RC::SUCCESS;
+}
+
+double Optimizer::order_joins(const std::vector<double> &rows, const std::vector<std::vector<double>> &selectivity,
+                              std::vector<int> &order) {
+  if (rows.size() <= (size_t)MAX_DP_TABLES) {
+    return dp_order(rows, selectivity, order);
+  }
+  return greedy_order(rows, selectivity, order);
+}
+
+/**
+ * 在左深树中，表的集合S的最小代价 = S连接后的行数 + min(S去掉最后连接的一张表后的最小代价)。
+ * 只有一张表时代价是它的行数，这样最外层会选择行数少的表
+ */
+double Optimizer::dp_order(const std::vector<double> &rows, const std::vector<std::vector<double>> &selectivity,
+                           std::vector<int> &order) {
+  const int n = rows.size();
+  const int set_num = 1 << n;
+  std::vector<double> cards(set_num, 1.0);
+  std::vector<double> costs(set_num, std::numeric_limits<double>::max());
+  std::vector<int> last(set_num, -1);
+
+  for (int set = 1; set < set_num; set++) {
+    int lowest = __builtin_ctz(set);
+    int rest = set & (set - 1);
+    double card = cards[rest] * rows[lowest];
+    for (int k = 0; k < n; k++) {
+      if (rest & (1 << k)) {
+        card *= selectivity[lowest][k];
+      }
+    }
+    cards[set] = card;
+
+    if (rest == 0) {
+      costs[set] = card;
+      last[set] = lowest;
+      continue;
+    }
+    // 代价相同时把编号小的表放在后面连接，与没有统计信息时的顺序一致
+    for (int j = 0; j < n; j++) {
+      if ((set & (1 << j)) && costs[set & ~(1 << j)] + card < costs[set]) {
+        costs[set] = costs[set & ~(1 << j)] + card;
+        last[set] = j;
+      }
+    }
+  }
+
+  order.assign(n, -1);
+  for (int set = set_num - 1, pos = n - 1; set != 0; pos--) {
+    order[pos] = last[set];
+    set &= ~(1 << last[set]);
+  }
+  return costs[set_num - 1];
+}
+
+double Optimizer::greedy_order(const std::vector<double> &rows, const std::vector<std::vector<double>> &selectivity,
+                               std::vector<int> &order) {
+  const int n = rows.size();
+  std::vector<bool> joined(n, false);
+  order.clear();
+
+  int first = n - 1;
+  for (int i = n - 1; i >= 0; i--) {
+    if (rows[i] < rows[first]) {
+      first = i;
+    }
+  }
+  order.push_back(first);
+  joined[first] = true;
+  double card = rows[first];
+  double cost = card;
+
+  // 每次连接使结果行数最少的表
+  while ((int)order.size() < n) {
+    int best = -1;
+    double best_card = 0;
+    for (int i = n - 1; i >= 0; i--) {
+      if (joined[i]) {
+        continue;
+      }
+      double new_card = card * rows[i];
+      for (int j : order) {
+        new_card *= selectivity[i][j];
+      }
+      if (best < 0 || new_card < best_card) {
+        best = i;
+        best_card = new_card;
+      }
+    }
+    order.push_back(best);
+    joined[best] = true;
+    card = best_card;
+    cost += card;
+  }
+  return cost;
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_SQL_OPTIMIZER_OPTIMIZER_H__
+#define __OBSERVER_SQL_OPTIMIZER_OPTIMIZER_H__
+
+#include <string>
+#include <vector>
+
+#include "rc.h"
+#include "sql/parser/parse_defs.h"
+#include "storage/common/index.h"
+
+class Table;
+
+/**
+ * 一张表的访问方式。index为nullptr时扫描整个数据文件，否则通过索引取出键值在range中的记录
+ */
+struct TableAccess {
+  double rows = 0;              // 经过本表的条件过滤后估计的行数
+  Index *index = nullptr;
+  IndexScanRange range;
+};
+
+/**
+ * 优化器为一条select语句选出的执行计划。下标与Selects::relations一致
+ */
+struct SelectPlan {
+  std::vector<int> join_order;         // 表的连接顺序，第一个是最外层的表
+  std::vector<TableAccess> accesses;
+  double cost = 0;
+};
+
+/**
+ * 基于代价的优化器。有ANALYZE TABLE收集的统计信息时按照统计信息估计每张表过滤后的行数，
+ * 所有表都有统计信息时才调整连接顺序，否则保持从最后一张表开始连接的顺序。
+ * 代价是所有中间结果的行数之和，表的个数不超过MAX_DP_TABLES时用动态规划找最优的左深树，否则贪心选择
+ */
+class Optimizer {
+public:
+  static const int MAX_DP_TABLES = 6;
+
+  /**
+   * @param tables 与selects.relations一一对应的表
+   */
+  static RC optimize(const Selects &selects, const std::vector<Table *> &tables, SelectPlan &plan);
+
+  /**
+   * 选择连接顺序
+   * @param rows 每张表过滤后的行数
+   * @param selectivity 两张表之间连接条件的选择率，没有连接条件时为1
+   * @param order 输出的连接顺序，第一个是最外层的表
+   * @return 按顺序连接时所有中间结果的行数之和
+   */
+  static double order_joins(const std::vector<double> &rows, const std::vector<std::vector<double>> &selectivity,
+                            std::vector<int> &order);
+
+private:
+  static double dp_order(const std::vector<double> &rows, const std::vector<std::vector<double>> &selectivity,
+                         std::vector<int> &order);
+  static double greedy_order(const std::vector<double> &rows, const std::vector<std::vector<double>> &selectivity,
+                             std::vector<int> &order);
+  static void choose_access(const Selects &selects, int relation, Table *table, TableAccess &access);
+};
+
+#endif  // __OBSERVER_SQL_OPTIMIZER_OPTIMIZER_H__
@@ -1273,7 +1273,7 @@ RETURN_TOKEN(NULLABLE);
 case 59:
 YY_RULE_SETUP
 #line 99 "lex_sql.l"
-yylval->string=strdup(yytext); RETURN_TOKEN(ID);
+if (strcasecmp(yytext, "analyze") == 0) { RETURN_TOKEN(ANALYZE); } yylval->string=strdup(yytext); RETURN_TOKEN(ID);
 	YY_BREAK
 case 60:
 YY_RULE_SETUP
@@ -347,6 +347,15 @@ void desc_table_destroy(DescTable *desc_table) {
     desc_table->relation_name = nullptr;
 }
 
+void analyze_table_init(AnalyzeTable *analyze_table, const char *relation_name) {
+    analyze_table->relation_name = strdup(relation_name);
+}
+
+void analyze_table_destroy(AnalyzeTable *analyze_table) {
+    free((char *) analyze_table->relation_name);
+    analyze_table->relation_name = nullptr;
+}
+
 void load_data_init(LoadData *load_data, const char *relation_name, const char *file_name) {
     load_data->relation_name = strdup(relation_name);
 
@@ -430,6 +439,11 @@ void query_reset(Query *query) {
         }
             break;
 
+        case SCF_ANALYZE_TABLE: {
+            analyze_table_destroy(&query->sstr.analyze_table);
+        }
+            break;
+
         case SCF_LOAD_DATA: {
             load_data_destroy(&query->sstr.load_data);
         }
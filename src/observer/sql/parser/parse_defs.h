@@ -179,6 +179,10 @@ typedef struct {
     const char *relation_name;
 } DescTable;
 
+typedef struct {
+    const char *relation_name;
+} AnalyzeTable;
+
 typedef struct {
     const char *relation_name;
     const char *file_name;
@@ -194,6 +198,7 @@ union Queries {
     CreateIndex create_index;
     DropIndex drop_index;
     DescTable desc_table;
+    AnalyzeTable analyze_table;
     LoadData load_data;
     char *errors;
 };
@@ -218,6 +223,7 @@ enum SqlCommandFlag {
     SCF_LOAD_DATA,
     SCF_HELP,
     SCF_EXIT,
+    SCF_ANALYZE_TABLE,
     SCF_FAILURE
 };
 // struct of flag and sql_struct
@@ -293,6 +299,9 @@ void drop_index_destroy(DropIndex *drop_index);
 void desc_table_init(DescTable *desc_table, const char *relation_name);
 void desc_table_destroy(DescTable *desc_table);
 
+void analyze_table_init(AnalyzeTable *analyze_table, const char *relation_name);
+void analyze_table_destroy(AnalyzeTable *analyze_table);
+
 void load_data_init(LoadData *load_data, const char *relation_name, const char *file_name);
 void load_data_destroy(LoadData *load_data);
 
@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.4"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -61,8 +66,8 @@
 
 
 
-/* Copy the first part of user declarations.  */
-#line 2 "yacc_sql.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 2 "yacc_sql.y"
 
 
 #include "sql/parser/parse_defs.h"
@@ -73,6 +78,7 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
+#include<strings.h>
 
 typedef struct ParserContext {
   Query * ssql;
@@ -124,175 +130,251 @@ ParserContext *get_context(yyscan_t scanner)
 #define CONTEXT get_context(scanner)
 
 
-#line 128 "yacc_sql.tab.c" /* yacc.c:339  */
+#line 134 "yacc_sql.tab.c"
 
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* In a future release of Bison, this section will be replaced
-   by #include "yacc_sql.tab.h".  */
-#ifndef YY_YY_YACC_SQL_TAB_H_INCLUDED
-# define YY_YY_YACC_SQL_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    SEMICOLON = 258,
-    CREATE = 259,
-    DROP = 260,
-    TABLE = 261,
-    TABLES = 262,
-    INDEX = 263,
-    UNIQUE = 264,
-    SELECT = 265,
-    DESC = 266,
-    SHOW = 267,
-    SYNC = 268,
-    INSERT = 269,
-    DELETE = 270,
-    UPDATE = 271,
-    LBRACE = 272,
-    RBRACE = 273,
-    COMMA = 274,
-    TRX_BEGIN = 275,
-    TRX_COMMIT = 276,
-    TRX_ROLLBACK = 277,
-    INT_T = 278,
-    STRING_T = 279,
-    FLOAT_T = 280,
-    DATE_T = 281,
-    TEXT_T = 282,
-    HELP = 283,
-    EXIT = 284,
-    DOT = 285,
-    INTO = 286,
-    VALUES = 287,
-    FROM = 288,
-    WHERE = 289,
-    AND = 290,
-    SET = 291,
-    ON = 292,
-    LOAD = 293,
-    DATA = 294,
-    INFILE = 295,
-    EQ = 296,
-    IN = 297,
-    NOTIN = 298,
-    LT = 299,
-    GT = 300,
-    LE = 301,
-    GE = 302,
-    NE = 303,
-    COU = 304,
-    MI = 305,
-    MA = 306,
-    AV = 307,
-    NOT = 308,
-    NULL_TOKEN = 309,
-    NULLABLE = 310,
-    IS = 311,
-    ISNOT = 312,
-    GROUP = 313,
-    BY = 314,
-    ASC = 315,
-    ORDER = 316,
-    INNER = 317,
-    JOIN = 318,
-    NUMBER = 319,
-    FLOAT = 320,
-    ID = 321,
-    EXPRESSION = 322,
-    PATH = 323,
-    SSS = 324,
-    STAR = 325,
-    STRING_V = 326,
-    DATE = 327,
-    SUB_SELECTION = 328
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-
-union YYSTYPE
+#include "yacc_sql.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-#line 132 "yacc_sql.y" /* yacc.c:355  */
-
-  struct _Attr *attr;
-  struct _Condition *condition1;
-  struct _Value *value1;
-  char *string;
-  int number;
-  float floats;
-    char *position;
-
-
-#line 253 "yacc_sql.tab.c" /* yacc.c:355  */
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SEMICOLON = 3,                  /* SEMICOLON  */
+  YYSYMBOL_CREATE = 4,                     /* CREATE  */
+  YYSYMBOL_DROP = 5,                       /* DROP  */
+  YYSYMBOL_TABLE = 6,                      /* TABLE  */
+  YYSYMBOL_TABLES = 7,                     /* TABLES  */
+  YYSYMBOL_INDEX = 8,                      /* INDEX  */
+  YYSYMBOL_UNIQUE = 9,                     /* UNIQUE  */
+  YYSYMBOL_SELECT = 10,                    /* SELECT  */
+  YYSYMBOL_DESC = 11,                      /* DESC  */
+  YYSYMBOL_SHOW = 12,                      /* SHOW  */
+  YYSYMBOL_ANALYZE = 13,                   /* ANALYZE  */
+  YYSYMBOL_SYNC = 14,                      /* SYNC  */
+  YYSYMBOL_INSERT = 15,                    /* INSERT  */
+  YYSYMBOL_DELETE = 16,                    /* DELETE  */
+  YYSYMBOL_UPDATE = 17,                    /* UPDATE  */
+  YYSYMBOL_LBRACE = 18,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 19,                    /* RBRACE  */
+  YYSYMBOL_COMMA = 20,                     /* COMMA  */
+  YYSYMBOL_TRX_BEGIN = 21,                 /* TRX_BEGIN  */
+  YYSYMBOL_TRX_COMMIT = 22,                /* TRX_COMMIT  */
+  YYSYMBOL_TRX_ROLLBACK = 23,              /* TRX_ROLLBACK  */
+  YYSYMBOL_INT_T = 24,                     /* INT_T  */
+  YYSYMBOL_STRING_T = 25,                  /* STRING_T  */
+  YYSYMBOL_FLOAT_T = 26,                   /* FLOAT_T  */
+  YYSYMBOL_DATE_T = 27,                    /* DATE_T  */
+  YYSYMBOL_TEXT_T = 28,                    /* TEXT_T  */
+  YYSYMBOL_HELP = 29,                      /* HELP  */
+  YYSYMBOL_EXIT = 30,                      /* EXIT  */
+  YYSYMBOL_DOT = 31,                       /* DOT  */
+  YYSYMBOL_INTO = 32,                      /* INTO  */
+  YYSYMBOL_VALUES = 33,                    /* VALUES  */
+  YYSYMBOL_FROM = 34,                      /* FROM  */
+  YYSYMBOL_WHERE = 35,                     /* WHERE  */
+  YYSYMBOL_AND = 36,                       /* AND  */
+  YYSYMBOL_SET = 37,                       /* SET  */
+  YYSYMBOL_ON = 38,                        /* ON  */
+  YYSYMBOL_LOAD = 39,                      /* LOAD  */
+  YYSYMBOL_DATA = 40,                      /* DATA  */
+  YYSYMBOL_INFILE = 41,                    /* INFILE  */
+  YYSYMBOL_EQ = 42,                        /* EQ  */
+  YYSYMBOL_IN = 43,                        /* IN  */
+  YYSYMBOL_NOTIN = 44,                     /* NOTIN  */
+  YYSYMBOL_LT = 45,                        /* LT  */
+  YYSYMBOL_GT = 46,                        /* GT  */
+  YYSYMBOL_LE = 47,                        /* LE  */
+  YYSYMBOL_GE = 48,                        /* GE  */
+  YYSYMBOL_NE = 49,                        /* NE  */
+  YYSYMBOL_COU = 50,                       /* COU  */
+  YYSYMBOL_MI = 51,                        /* MI  */
+  YYSYMBOL_MA = 52,                        /* MA  */
+  YYSYMBOL_AV = 53,                        /* AV  */
+  YYSYMBOL_NOT = 54,                       /* NOT  */
+  YYSYMBOL_NULL_TOKEN = 55,                /* NULL_TOKEN  */
+  YYSYMBOL_NULLABLE = 56,                  /* NULLABLE  */
+  YYSYMBOL_IS = 57,                        /* IS  */
+  YYSYMBOL_ISNOT = 58,                     /* ISNOT  */
+  YYSYMBOL_GROUP = 59,                     /* GROUP  */
+  YYSYMBOL_BY = 60,                        /* BY  */
+  YYSYMBOL_ASC = 61,                       /* ASC  */
+  YYSYMBOL_ORDER = 62,                     /* ORDER  */
+  YYSYMBOL_INNER = 63,                     /* INNER  */
+  YYSYMBOL_JOIN = 64,                      /* JOIN  */
+  YYSYMBOL_NUMBER = 65,                    /* NUMBER  */
+  YYSYMBOL_FLOAT = 66,                     /* FLOAT  */
+  YYSYMBOL_ID = 67,                        /* ID  */
+  YYSYMBOL_EXPRESSION = 68,                /* EXPRESSION  */
+  YYSYMBOL_PATH = 69,                      /* PATH  */
+  YYSYMBOL_SSS = 70,                       /* SSS  */
+  YYSYMBOL_STAR = 71,                      /* STAR  */
+  YYSYMBOL_STRING_V = 72,                  /* STRING_V  */
+  YYSYMBOL_DATE = 73,                      /* DATE  */
+  YYSYMBOL_SUB_SELECTION = 74,             /* SUB_SELECTION  */
+  YYSYMBOL_YYACCEPT = 75,                  /* $accept  */
+  YYSYMBOL_commands = 76,                  /* commands  */
+  YYSYMBOL_command = 77,                   /* command  */
+  YYSYMBOL_exit = 78,                      /* exit  */
+  YYSYMBOL_help = 79,                      /* help  */
+  YYSYMBOL_sync = 80,                      /* sync  */
+  YYSYMBOL_begin = 81,                     /* begin  */
+  YYSYMBOL_commit = 82,                    /* commit  */
+  YYSYMBOL_rollback = 83,                  /* rollback  */
+  YYSYMBOL_drop_table = 84,                /* drop_table  */
+  YYSYMBOL_show_tables = 85,               /* show_tables  */
+  YYSYMBOL_desc_table = 86,                /* desc_table  */
+  YYSYMBOL_analyze_table = 87,             /* analyze_table  */
+  YYSYMBOL_create_index = 88,              /* create_index  */
+  YYSYMBOL_id_list = 89,                   /* id_list  */
+  YYSYMBOL_drop_index = 90,                /* drop_index  */
+  YYSYMBOL_create_table = 91,              /* create_table  */
+  YYSYMBOL_attr_def_list = 92,             /* attr_def_list  */
+  YYSYMBOL_attr_def = 93,                  /* attr_def  */
+  YYSYMBOL_type = 94,                      /* type  */
+  YYSYMBOL_ID_get = 95,                    /* ID_get  */
+  YYSYMBOL_insert = 96,                    /* insert  */
+  YYSYMBOL_value_list = 97,                /* value_list  */
+  YYSYMBOL_value_opt = 98,                 /* value_opt  */
+  YYSYMBOL_99_1 = 99,                      /* $@1  */
+  YYSYMBOL_value = 100,                    /* value  */
+  YYSYMBOL_delete = 101,                   /* delete  */
+  YYSYMBOL_update = 102,                   /* update  */
+  YYSYMBOL_select = 103,                   /* select  */
+  YYSYMBOL_innerjoin_list = 104,           /* innerjoin_list  */
+  YYSYMBOL_innerjoin_conditions = 105,     /* innerjoin_conditions  */
+  YYSYMBOL_innerjoin_condition_list = 106, /* innerjoin_condition_list  */
+  YYSYMBOL_select_attr = 107,              /* select_attr  */
+  YYSYMBOL_selectvalue = 108,              /* selectvalue  */
+  YYSYMBOL_aggrevalue = 109,               /* aggrevalue  */
+  YYSYMBOL_aggrevaluelist = 110,           /* aggrevaluelist  */
+  YYSYMBOL_selectvalue_commaed = 111,      /* selectvalue_commaed  */
+  YYSYMBOL_attr_list = 112,                /* attr_list  */
+  YYSYMBOL_rel_list = 113,                 /* rel_list  */
+  YYSYMBOL_where = 114,                    /* where  */
+  YYSYMBOL_condition_list = 115,           /* condition_list  */
+  YYSYMBOL_condition = 116,                /* condition  */
+  YYSYMBOL_groupby = 117,                  /* groupby  */
+  YYSYMBOL_groupby_list = 118,             /* groupby_list  */
+  YYSYMBOL_orderby = 119,                  /* orderby  */
+  YYSYMBOL_orderby_attr_list = 120,        /* orderby_attr_list  */
+  YYSYMBOL_orderby_attr = 121,             /* orderby_attr  */
+  YYSYMBOL_AscDesc = 122,                  /* AscDesc  */
+  YYSYMBOL_comOp = 123,                    /* comOp  */
+  YYSYMBOL_aggretype = 124,                /* aggretype  */
+  YYSYMBOL_load_data = 125                 /* load_data  */
 };
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-typedef union YYSTYPE YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
 
 
 
-int yyparse (void *scanner);
+#ifdef short
+# undef short
+#endif
 
-#endif /* !YY_YY_YACC_SQL_TAB_H_INCLUDED  */
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
 
-/* Copy the second part of user declarations.  */
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
 
-#line 269 "yacc_sql.tab.c" /* yacc.c:358  */
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
 
-#ifdef short
-# undef short
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef unsigned char yytype_uint8;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#else
-typedef signed char yytype_int8;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -300,15 +382,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -322,47 +417,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -375,8 +466,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -441,8 +546,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -451,17 +555,17 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -474,11 +578,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -490,12 +594,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -507,28 +611,31 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  2
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   289
+#define YYLAST   292
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  74
+#define YYNTOKENS  75
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  50
+#define YYNNTS  51
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  142
+#define YYNRULES  144
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  290
+#define YYNSTATES  295
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   329
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   328
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -562,354 +669,358 @@ static const yytype_uint8 yytranslate[] =
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
       55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      65,    66,    67,    68,    69,    70,    71,    72,    73
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,   162,   162,   164,   168,   169,   170,   171,   172,   173,
-     174,   175,   176,   177,   178,   179,   180,   181,   182,   183,
-     184,   188,   193,   198,   204,   210,   216,   222,   228,   234,
-     241,   246,   254,   256,   260,   267,   276,   278,   282,   295,
-     301,   312,   326,   327,   328,   329,   330,   333,   342,   357,
-     359,   363,   364,   364,   370,   379,   388,   398,   407,   419,
-     429,   439,   458,   459,   463,   465,   469,   471,   477,   480,
-     485,   492,   497,   502,   507,   514,   519,   524,   529,   534,
-     540,   541,   544,   547,   550,   553,   558,   563,   568,   574,
-     576,   581,   586,   588,   591,   595,   597,   601,   603,   608,
-     629,   649,   669,   691,   712,   733,   752,   761,   769,   778,
-     787,   795,   804,   810,   812,   817,   824,   826,   831,   838,
-     840,   844,   846,   851,   856,   865,   868,   871,   876,   877,
-     878,   879,   880,   881,   882,   883,   884,   885,   889,   892,
-     895,   898,   904
+       0,   164,   164,   166,   170,   171,   172,   173,   174,   175,
+     176,   177,   178,   179,   180,   181,   182,   183,   184,   185,
+     186,   187,   191,   196,   201,   207,   213,   219,   225,   231,
+     237,   244,   251,   256,   264,   266,   270,   277,   286,   288,
+     292,   305,   311,   322,   336,   337,   338,   339,   340,   343,
+     352,   367,   369,   373,   374,   374,   380,   389,   398,   408,
+     417,   429,   439,   449,   468,   469,   473,   475,   479,   481,
+     487,   490,   495,   502,   507,   512,   517,   524,   529,   534,
+     539,   544,   550,   551,   554,   557,   560,   563,   568,   573,
+     578,   584,   586,   591,   596,   598,   601,   605,   607,   611,
+     613,   618,   639,   659,   679,   701,   722,   743,   762,   771,
+     779,   788,   797,   805,   814,   820,   822,   827,   834,   836,
+     841,   848,   850,   854,   856,   861,   866,   875,   878,   881,
+     886,   887,   888,   889,   890,   891,   892,   893,   894,   895,
+     899,   902,   905,   908,   914
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "SEMICOLON", "CREATE", "DROP", "TABLE",
-  "TABLES", "INDEX", "UNIQUE", "SELECT", "DESC", "SHOW", "SYNC", "INSERT",
-  "DELETE", "UPDATE", "LBRACE", "RBRACE", "COMMA", "TRX_BEGIN",
-  "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T", "FLOAT_T", "DATE_T",
-  "TEXT_T", "HELP", "EXIT", "DOT", "INTO", "VALUES", "FROM", "WHERE",
-  "AND", "SET", "ON", "LOAD", "DATA", "INFILE", "EQ", "IN", "NOTIN", "LT",
-  "GT", "LE", "GE", "NE", "COU", "MI", "MA", "AV", "NOT", "NULL_TOKEN",
-  "NULLABLE", "IS", "ISNOT", "GROUP", "BY", "ASC", "ORDER", "INNER",
-  "JOIN", "NUMBER", "FLOAT", "ID", "EXPRESSION", "PATH", "SSS", "STAR",
-  "STRING_V", "DATE", "SUB_SELECTION", "$accept", "commands", "command",
-  "exit", "help", "sync", "begin", "commit", "rollback", "drop_table",
-  "show_tables", "desc_table", "create_index", "id_list", "drop_index",
-  "create_table", "attr_def_list", "attr_def", "type", "ID_get", "insert",
-  "value_list", "value_opt", "$@1", "value", "delete", "update", "select",
-  "innerjoin_list", "innerjoin_conditions", "innerjoin_condition_list",
-  "select_attr", "selectvalue", "aggrevalue", "aggrevaluelist",
-  "selectvalue_commaed", "attr_list", "rel_list", "where",
-  "condition_list", "condition", "groupby", "groupby_list", "orderby",
-  "orderby_attr_list", "orderby_attr", "AscDesc", "comOp", "aggretype",
-  "load_data", YY_NULLPTR
+  "\"end of file\"", "error", "\"invalid token\"", "SEMICOLON", "CREATE",
+  "DROP", "TABLE", "TABLES", "INDEX", "UNIQUE", "SELECT", "DESC", "SHOW",
+  "ANALYZE", "SYNC", "INSERT", "DELETE", "UPDATE", "LBRACE", "RBRACE",
+  "COMMA", "TRX_BEGIN", "TRX_COMMIT", "TRX_ROLLBACK", "INT_T", "STRING_T",
+  "FLOAT_T", "DATE_T", "TEXT_T", "HELP", "EXIT", "DOT", "INTO", "VALUES",
+  "FROM", "WHERE", "AND", "SET", "ON", "LOAD", "DATA", "INFILE", "EQ",
+  "IN", "NOTIN", "LT", "GT", "LE", "GE", "NE", "COU", "MI", "MA", "AV",
+  "NOT", "NULL_TOKEN", "NULLABLE", "IS", "ISNOT", "GROUP", "BY", "ASC",
+  "ORDER", "INNER", "JOIN", "NUMBER", "FLOAT", "ID", "EXPRESSION", "PATH",
+  "SSS", "STAR", "STRING_V", "DATE", "SUB_SELECTION", "$accept",
+  "commands", "command", "exit", "help", "sync", "begin", "commit",
+  "rollback", "drop_table", "show_tables", "desc_table", "analyze_table",
+  "create_index", "id_list", "drop_index", "create_table", "attr_def_list",
+  "attr_def", "type", "ID_get", "insert", "value_list", "value_opt", "$@1",
+  "value", "delete", "update", "select", "innerjoin_list",
+  "innerjoin_conditions", "innerjoin_condition_list", "select_attr",
+  "selectvalue", "aggrevalue", "aggrevaluelist", "selectvalue_commaed",
+  "attr_list", "rel_list", "where", "condition_list", "condition",
+  "groupby", "groupby_list", "orderby", "orderby_attr_list",
+  "orderby_attr", "AscDesc", "comOp", "aggretype", "load_data", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315,   316,   317,   318,   319,   320,   321,   322,   323,   324,
-     325,   326,   327,   328
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -242
+#define YYPACT_NINF (-221)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-242)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -1
+#define YYTABLE_NINF (-1)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-    -242,    94,  -242,   132,     9,    27,   -44,    31,    38,    12,
-      24,     5,    84,    87,    92,   108,   115,    80,  -242,  -242,
-    -242,  -242,  -242,  -242,  -242,  -242,  -242,  -242,  -242,  -242,
-    -242,  -242,  -242,  -242,  -242,  -242,    55,    62,   122,    67,
-      78,  -242,  -242,  -242,  -242,   116,  -242,   112,   131,   136,
-     151,   154,  -242,    93,    99,   137,  -242,  -242,  -242,  -242,
-    -242,   118,   150,   134,   102,   169,   174,   -20,   114,   135,
-    -242,     0,  -242,  -242,   146,   168,   139,   138,   140,   142,
-     144,  -242,  -242,  -242,  -242,    -7,   179,   131,   193,   131,
-     192,   192,     2,   192,   194,   196,    19,   211,   175,   184,
-    -242,   198,   173,   201,   153,   155,   157,   168,    30,  -242,
-      16,  -242,    61,  -242,  -242,   156,  -242,  -242,   131,    48,
-    -242,  -242,  -242,   -17,  -242,  -242,   147,   147,   188,  -242,
-      48,   218,   140,   207,  -242,  -242,  -242,  -242,  -242,    -1,
-     160,   210,    -7,   162,   170,  -242,  -242,   212,   192,   192,
-       4,   192,   192,  -242,   213,   163,  -242,  -242,  -242,  -242,
-    -242,  -242,  -242,  -242,  -242,  -242,    70,    83,    97,    19,
-    -242,   168,   167,   198,   231,   171,   182,  -242,   219,   176,
-    -242,   200,   180,   183,   131,  -242,  -242,   177,  -242,  -242,
-    -242,    48,   222,   147,  -242,  -242,  -242,   214,  -242,  -242,
-     215,  -242,  -242,   188,   243,   244,  -242,  -242,   230,  -242,
-     185,   232,   234,    19,   187,   189,   195,   250,  -242,   192,
-     213,   237,   110,   191,   197,  -242,  -242,  -242,  -242,   219,
-     255,   256,   225,   199,  -242,     3,   242,   202,  -242,  -242,
-    -242,   237,   261,   235,  -242,  -242,  -242,  -242,  -242,  -242,
-    -242,    19,  -242,   203,  -242,   204,  -242,  -242,   189,  -242,
-      23,  -242,  -242,   205,   225,   200,     8,   242,   206,   208,
-    -242,   249,  -242,  -242,   187,  -242,  -242,    26,   248,    48,
-    -242,   209,  -242,  -242,   213,   248,   258,  -242,   237,  -242
+    -221,    83,  -221,    32,    24,   -28,   -54,    61,    14,    70,
+      47,    50,    23,    88,    98,   104,   111,   113,    52,  -221,
+    -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,
+    -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,    54,    57,
+     109,    58,    60,  -221,  -221,  -221,  -221,   117,  -221,    94,
+     120,   135,   126,   138,    99,  -221,   101,   102,   118,  -221,
+    -221,  -221,  -221,  -221,   115,   143,   134,   106,   171,   176,
+     -52,   114,    92,  -221,    -1,  -221,  -221,   179,   152,   151,
+     124,   122,   127,   128,   149,  -221,  -221,  -221,  -221,    -8,
+     180,   120,   194,   120,   195,   195,    13,   195,   197,  -221,
+     199,   -39,   215,   177,   188,  -221,   201,   182,   204,   157,
+     158,   159,   151,   -13,  -221,    15,  -221,    44,  -221,  -221,
+     160,  -221,  -221,   120,    53,  -221,  -221,  -221,    89,  -221,
+    -221,   156,   156,   190,  -221,    53,   222,   127,   210,  -221,
+    -221,  -221,  -221,  -221,    -4,   163,   213,    -8,   165,   172,
+    -221,  -221,   214,   195,   195,    22,   195,   195,  -221,   216,
+     168,  -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,
+    -221,    84,    97,   110,   -39,  -221,   151,   170,   201,   235,
+     174,   185,  -221,   221,   175,  -221,   205,   184,   186,   120,
+    -221,  -221,   181,  -221,  -221,  -221,    53,   227,   156,  -221,
+    -221,  -221,   218,  -221,  -221,   219,  -221,  -221,   190,   244,
+     248,  -221,  -221,   233,  -221,   187,   234,   236,   -39,   193,
+     191,   200,   254,  -221,   195,   216,   239,   123,   196,   198,
+    -221,  -221,  -221,  -221,   221,   258,   259,   228,   202,  -221,
+       6,   247,   203,  -221,  -221,  -221,   239,   265,   238,  -221,
+    -221,  -221,  -221,  -221,  -221,  -221,   -39,  -221,   206,  -221,
+     207,  -221,  -221,   191,  -221,    25,  -221,  -221,   208,   228,
+     205,    10,   247,   209,   211,  -221,   253,  -221,  -221,   193,
+    -221,  -221,    26,   252,    53,  -221,   212,  -221,  -221,   216,
+     252,   261,  -221,   239,  -221
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_uint8 yydefact[] =
 {
        2,     0,     1,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     3,    20,
-      19,    14,    15,    16,    17,     9,    10,    11,    12,    13,
-       8,     5,     7,     6,     4,    18,     0,     0,     0,     0,
-       0,   138,   139,   140,   141,    72,    71,     0,    89,     0,
-       0,     0,    23,     0,     0,     0,    24,    25,    26,    22,
-      21,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-      68,     0,    29,    28,     0,    95,     0,     0,     0,     0,
-       0,    27,    34,    73,    74,    92,    86,    89,     0,    89,
-      80,    80,    80,    80,     0,     0,     0,     0,     0,     0,
-      47,    36,     0,     0,     0,     0,     0,    95,     0,    91,
-       0,    70,     0,    78,    79,     0,    76,    75,    89,     0,
-      58,    54,    55,     0,    56,    57,     0,     0,    97,    59,
-       0,     0,     0,     0,    42,    43,    44,    45,    46,    40,
-       0,     0,    92,     0,   119,    87,    88,     0,    80,    80,
-      80,    80,    80,    69,    49,     0,   128,   136,   137,   129,
-     130,   131,   132,   133,   134,   135,     0,     0,     0,     0,
-      96,    95,     0,    36,     0,     0,     0,    39,    32,     0,
-      93,    64,     0,   113,    89,    84,    85,     0,    82,    81,
-      77,     0,     0,     0,   101,   106,    99,   109,   112,   110,
-     102,   107,   100,    97,     0,     0,    37,    35,     0,    41,
-       0,     0,     0,     0,    62,     0,     0,     0,    90,    80,
-      49,    51,     0,     0,     0,    98,    60,   142,    38,    32,
-       0,     0,    66,     0,    94,   125,   121,     0,    61,    83,
-      50,    51,     0,     0,   108,   103,   111,   104,    33,    30,
-      31,     0,    65,     0,   127,     0,   126,   123,     0,   120,
-     116,    52,    48,     0,    66,    64,   125,   121,     0,     0,
-     114,     0,   105,    67,    62,   124,   122,   116,   116,     0,
-      63,     0,   117,   115,    49,   116,     0,   118,    51,    53
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     3,
+      21,    20,    15,    16,    17,    18,     9,    10,    11,    12,
+      13,    14,     8,     5,     7,     6,     4,    19,     0,     0,
+       0,     0,     0,   140,   141,   142,   143,    74,    73,     0,
+      91,     0,     0,     0,     0,    24,     0,     0,     0,    25,
+      26,    27,    23,    22,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,    70,     0,    30,    29,     0,     0,    97,
+       0,     0,     0,     0,     0,    28,    36,    75,    76,    94,
+      88,    91,     0,    91,    82,    82,    82,    82,     0,    31,
+       0,     0,     0,     0,     0,    49,    38,     0,     0,     0,
+       0,     0,    97,     0,    93,     0,    72,     0,    80,    81,
+       0,    78,    77,    91,     0,    60,    56,    57,     0,    58,
+      59,     0,     0,    99,    61,     0,     0,     0,     0,    44,
+      45,    46,    47,    48,    42,     0,     0,    94,     0,   121,
+      89,    90,     0,    82,    82,    82,    82,    82,    71,    51,
+       0,   130,   138,   139,   131,   132,   133,   134,   135,   136,
+     137,     0,     0,     0,     0,    98,    97,     0,    38,     0,
+       0,     0,    41,    34,     0,    95,    66,     0,   115,    91,
+      86,    87,     0,    84,    83,    79,     0,     0,     0,   103,
+     108,   101,   111,   114,   112,   104,   109,   102,    99,     0,
+       0,    39,    37,     0,    43,     0,     0,     0,     0,    64,
+       0,     0,     0,    92,    82,    51,    53,     0,     0,     0,
+     100,    62,   144,    40,    34,     0,     0,    68,     0,    96,
+     127,   123,     0,    63,    85,    52,    53,     0,     0,   110,
+     105,   113,   106,    35,    32,    33,     0,    67,     0,   129,
+       0,   128,   125,     0,   122,   118,    54,    50,     0,    68,
+      66,   127,   123,     0,     0,   116,     0,   107,    69,    64,
+     126,   124,   118,   118,     0,    65,     0,   119,   117,    51,
+     118,     0,   120,    53,    55
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -242,  -242,  -242,  -242,  -242,  -242,  -242,  -242,  -242,  -242,
-    -242,  -242,  -242,    44,  -242,  -242,   104,   148,  -242,  -242,
-    -242,  -215,  -221,  -242,  -119,  -242,  -242,  -242,     7,    13,
-      15,  -242,  -242,   172,   -90,  -242,   -83,   141,   -97,    81,
-    -162,  -242,  -241,  -242,    18,    28,    21,  -118,   220,  -242
+    -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,  -221,
+    -221,  -221,  -221,  -221,    43,  -221,  -221,   103,   145,  -221,
+    -221,  -221,  -220,  -217,  -221,  -124,  -221,  -221,  -221,     4,
+      16,    18,  -221,  -221,   169,   -94,  -221,   -87,   141,  -102,
+      77,  -167,  -221,  -205,  -221,    17,    27,    20,  -123,   220,
+    -221
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int16 yydefgoto[] =
 {
-      -1,     1,    18,    19,    20,    21,    22,    23,    24,    25,
-      26,    27,    28,   211,    29,    30,   133,   101,   139,   102,
-      31,   192,   242,   271,   127,    32,    33,    34,   234,   214,
-     252,    47,    48,    94,   113,    87,    70,   107,    97,   170,
-     128,   217,   270,   183,   259,   236,   257,   166,    49,    35
+       0,     1,    19,    20,    21,    22,    23,    24,    25,    26,
+      27,    28,    29,    30,   216,    31,    32,   138,   106,   144,
+     107,    33,   197,   247,   276,   132,    34,    35,    36,   239,
+     219,   257,    49,    50,    98,   118,    91,    73,   112,   102,
+     175,   133,   222,   275,   188,   264,   241,   262,   171,    51,
+      37
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_uint16 yytable[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
 {
-     154,   114,   116,   117,   109,   240,   111,   203,   167,   168,
-     144,   171,   105,   155,   254,    39,   175,    40,    89,   254,
-     261,   112,    50,   112,   156,   157,   158,   159,   160,   161,
-     162,   163,   115,   255,   187,   153,   282,   283,    51,   164,
-     165,    52,   268,    53,   287,   268,    83,   196,   199,   202,
-      84,   232,   176,   269,   177,   106,   281,    54,   185,   186,
-     188,   189,   190,   256,    90,    91,    92,   289,   256,   286,
-      93,    55,   220,   120,   204,   222,    41,    42,    43,    44,
-      90,    91,    92,   121,   122,   123,    93,    56,   124,   264,
-      57,   125,   126,    45,     2,    58,   145,    46,     3,     4,
-     146,   218,   120,   245,     5,     6,     7,     8,     9,    10,
-      11,    59,   121,   122,    12,    13,    14,   124,    60,    61,
-     125,    62,    15,    16,   120,   148,   149,   150,    63,   239,
-      64,   151,    17,    65,   121,   122,   194,   120,    36,   124,
-      37,    38,   125,   195,    66,    68,    67,   121,   122,   197,
-      69,   120,   124,    71,    72,   125,   198,    73,    77,    74,
-     284,   121,   122,   200,   120,    75,   124,    78,    80,   125,
-     201,    79,    81,    76,   121,   122,   243,    82,    95,   124,
-      85,   104,   125,   244,    41,    42,    43,    44,   156,   157,
-     158,   159,   160,   161,   162,   163,   134,   135,   136,   137,
-     138,    86,    96,   164,   165,    98,   100,    99,   103,   108,
-     110,   112,   118,   119,   129,   131,   130,   132,   140,   141,
-     143,   142,   152,   169,   172,   174,   178,   179,   181,   193,
-     184,   182,   191,   205,   207,   208,   209,   213,   210,   215,
-     221,   216,   212,   219,   223,   224,   226,   227,   228,   233,
-     230,   229,   231,   238,   237,   235,   241,   246,   249,   250,
-     251,   258,   253,   247,   262,   263,   279,   268,   260,   265,
-     266,   272,   277,   248,   278,   285,   288,   206,   274,   273,
-     173,   280,   147,   180,   225,   276,   267,   275,     0,    88
+     159,   119,   121,   122,   114,   245,   116,   208,   172,   173,
+     149,   176,   110,    52,   180,    87,   125,   259,    93,    88,
+      54,   259,    43,    44,    45,    46,   126,   127,   128,   266,
+      41,   129,    42,   117,   130,   131,   158,   260,    38,    47,
+      39,    40,   117,    48,   120,   273,   273,   201,   204,   207,
+     181,   237,   182,   192,   150,   111,   274,   286,   151,   190,
+     191,   193,   194,   195,    94,    95,    96,   261,    53,   291,
+      97,   261,   225,    55,   209,   227,   294,   287,   288,    56,
+      94,    95,    96,     2,    57,   292,    97,     3,     4,   269,
+      58,    59,    64,     5,     6,     7,     8,     9,    10,    11,
+      12,    60,   223,   250,    13,    14,    15,    61,   125,   153,
+     154,   155,    16,    17,    62,   156,    63,    67,   126,   127,
+     160,    65,    18,   129,    66,    68,   130,    69,    71,    75,
+     244,   161,   162,   163,   164,   165,   166,   167,   168,   125,
+      72,    76,    43,    44,    45,    46,   169,   170,    70,   126,
+     127,   199,   125,    74,   129,    80,    81,   130,   200,    90,
+     289,    82,   126,   127,   202,   125,    77,   129,    78,    79,
+     130,   203,    83,    84,    85,   126,   127,   205,   125,    86,
+     129,    89,    99,   130,   206,   100,   101,   109,   126,   127,
+     248,   103,   104,   129,   105,   108,   130,   249,   161,   162,
+     163,   164,   165,   166,   167,   168,   139,   140,   141,   142,
+     143,   113,   115,   169,   170,   117,   123,   124,   134,   135,
+     136,   137,   145,   148,   146,   147,   174,   157,   177,   179,
+     183,   184,   186,   189,   187,   198,   196,   210,   212,   213,
+     214,   215,   217,   218,   220,   221,   226,   231,   224,   228,
+     229,   232,   233,   235,   234,   236,   238,   243,   240,   246,
+     242,   254,   255,   251,   256,   252,   258,   263,   267,   268,
+     265,   284,   273,   270,   271,   277,   282,   253,   283,   290,
+     293,   211,   178,   285,   152,   230,   279,   278,   185,   281,
+     272,   280,    92
 };
 
 static const yytype_int16 yycheck[] =
 {
-     119,    91,    92,    93,    87,   220,    89,   169,   126,   127,
-     107,   130,    19,    30,    11,     6,    17,     8,    18,    11,
-     241,    19,    66,    19,    41,    42,    43,    44,    45,    46,
-      47,    48,    30,    30,    30,   118,   277,   278,     7,    56,
-      57,     3,    19,    31,   285,    19,    66,   166,   167,   168,
-      70,   213,    53,    30,    55,    62,    30,    33,   148,   149,
-     150,   151,   152,    60,    64,    65,    66,   288,    60,   284,
-      70,    66,   191,    54,   171,   193,    49,    50,    51,    52,
-      64,    65,    66,    64,    65,    66,    70,     3,    69,   251,
-       3,    72,    73,    66,     0,     3,    66,    70,     4,     5,
-      70,   184,    54,   222,    10,    11,    12,    13,    14,    15,
-      16,     3,    64,    65,    20,    21,    22,    69,     3,    39,
-      72,    66,    28,    29,    54,    64,    65,    66,    66,   219,
-       8,    70,    38,    66,    64,    65,    66,    54,     6,    69,
-       8,     9,    72,    73,    66,    33,    30,    64,    65,    66,
-      19,    54,    69,    17,     3,    72,    73,     3,    40,    66,
-     279,    64,    65,    66,    54,    66,    69,    17,    66,    72,
-      73,    37,     3,    36,    64,    65,    66,     3,    32,    69,
-      66,    37,    72,    73,    49,    50,    51,    52,    41,    42,
-      43,    44,    45,    46,    47,    48,    23,    24,    25,    26,
-      27,    66,    34,    56,    57,    66,    66,    69,    66,    30,
-      17,    19,    18,    17,     3,    31,    41,    19,    17,    66,
-      63,    66,    66,    35,     6,    18,    66,    17,    66,    66,
-      18,    61,    19,    66,     3,    64,    54,    37,    19,    59,
-      18,    58,    66,    66,    30,    30,     3,     3,    18,    62,
-      18,    66,    18,     3,    59,    66,    19,    66,     3,     3,
-      35,    19,    63,    66,     3,    30,    17,    19,    66,    66,
-      66,    66,    66,   229,    66,    66,    18,   173,   265,   264,
-     132,   274,   110,   142,   203,   267,   258,   266,    -1,    69
+     124,    95,    96,    97,    91,   225,    93,   174,   131,   132,
+     112,   135,    20,    67,    18,    67,    55,    11,    19,    71,
+       6,    11,    50,    51,    52,    53,    65,    66,    67,   246,
+       6,    70,     8,    20,    73,    74,   123,    31,     6,    67,
+       8,     9,    20,    71,    31,    20,    20,   171,   172,   173,
+      54,   218,    56,    31,    67,    63,    31,    31,    71,   153,
+     154,   155,   156,   157,    65,    66,    67,    61,     7,   289,
+      71,    61,   196,     3,   176,   198,   293,   282,   283,    32,
+      65,    66,    67,     0,    34,   290,    71,     4,     5,   256,
+      67,     3,    40,    10,    11,    12,    13,    14,    15,    16,
+      17,     3,   189,   227,    21,    22,    23,     3,    55,    65,
+      66,    67,    29,    30,     3,    71,     3,     8,    65,    66,
+      31,    67,    39,    70,    67,    67,    73,    67,    34,     3,
+     224,    42,    43,    44,    45,    46,    47,    48,    49,    55,
+      20,     3,    50,    51,    52,    53,    57,    58,    31,    65,
+      66,    67,    55,    18,    70,    37,    41,    73,    74,    67,
+     284,    18,    65,    66,    67,    55,    67,    70,    67,    67,
+      73,    74,    38,    67,     3,    65,    66,    67,    55,     3,
+      70,    67,     3,    73,    74,    33,    35,    38,    65,    66,
+      67,    67,    70,    70,    67,    67,    73,    74,    42,    43,
+      44,    45,    46,    47,    48,    49,    24,    25,    26,    27,
+      28,    31,    18,    57,    58,    20,    19,    18,     3,    42,
+      32,    20,    18,    64,    67,    67,    36,    67,     6,    19,
+      67,    18,    67,    19,    62,    67,    20,    67,     3,    65,
+      55,    20,    67,    38,    60,    59,    19,     3,    67,    31,
+      31,     3,    19,    19,    67,    19,    63,     3,    67,    20,
+      60,     3,     3,    67,    36,    67,    64,    20,     3,    31,
+      67,    18,    20,    67,    67,    67,    67,   234,    67,    67,
+      19,   178,   137,   279,   115,   208,   270,   269,   147,   272,
+     263,   271,    72
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-       0,    75,     0,     4,     5,    10,    11,    12,    13,    14,
-      15,    16,    20,    21,    22,    28,    29,    38,    76,    77,
-      78,    79,    80,    81,    82,    83,    84,    85,    86,    88,
-      89,    94,    99,   100,   101,   123,     6,     8,     9,     6,
-       8,    49,    50,    51,    52,    66,    70,   105,   106,   122,
-      66,     7,     3,    31,    33,    66,     3,     3,     3,     3,
-       3,    39,    66,    66,     8,    66,    66,    30,    33,    19,
-     110,    17,     3,     3,    66,    66,    36,    40,    17,    37,
-      66,     3,     3,    66,    70,    66,    66,   109,   122,    18,
-      64,    65,    66,    70,   107,    32,    34,   112,    66,    69,
-      66,    91,    93,    66,    37,    19,    62,   111,    30,   110,
-      17,   110,    19,   108,   108,    30,   108,   108,    18,    17,
-      54,    64,    65,    66,    69,    72,    73,    98,   114,     3,
-      41,    31,    19,    90,    23,    24,    25,    26,    27,    92,
-      17,    66,    66,    63,   112,    66,    70,   107,    64,    65,
-      66,    70,    66,   110,    98,    30,    41,    42,    43,    44,
-      45,    46,    47,    48,    56,    57,   121,   121,   121,    35,
-     113,    98,     6,    91,    18,    17,    53,    55,    66,    17,
-     111,    66,    61,   117,    18,   108,   108,    30,   108,   108,
-     108,    19,    95,    66,    66,    73,    98,    66,    73,    98,
-      66,    73,    98,   114,   112,    66,    90,     3,    64,    54,
-      19,    87,    66,    37,   103,    59,    58,   115,   110,    66,
-      98,    18,   121,    30,    30,   113,     3,     3,    18,    66,
-      18,    18,   114,    62,   102,    66,   119,    59,     3,   108,
-      95,    19,    96,    66,    73,    98,    66,    66,    87,     3,
-       3,    35,   104,    63,    11,    30,    60,   120,    19,   118,
-      66,    96,     3,    30,   114,    66,    66,   119,    19,    30,
-     116,    97,    66,   104,   103,   120,   118,    66,    66,    17,
-     102,    30,   116,   116,    98,    66,    95,   116,    18,    96
+       0,    76,     0,     4,     5,    10,    11,    12,    13,    14,
+      15,    16,    17,    21,    22,    23,    29,    30,    39,    77,
+      78,    79,    80,    81,    82,    83,    84,    85,    86,    87,
+      88,    90,    91,    96,   101,   102,   103,   125,     6,     8,
+       9,     6,     8,    50,    51,    52,    53,    67,    71,   107,
+     108,   124,    67,     7,     6,     3,    32,    34,    67,     3,
+       3,     3,     3,     3,    40,    67,    67,     8,    67,    67,
+      31,    34,    20,   112,    18,     3,     3,    67,    67,    67,
+      37,    41,    18,    38,    67,     3,     3,    67,    71,    67,
+      67,   111,   124,    19,    65,    66,    67,    71,   109,     3,
+      33,    35,   114,    67,    70,    67,    93,    95,    67,    38,
+      20,    63,   113,    31,   112,    18,   112,    20,   110,   110,
+      31,   110,   110,    19,    18,    55,    65,    66,    67,    70,
+      73,    74,   100,   116,     3,    42,    32,    20,    92,    24,
+      25,    26,    27,    28,    94,    18,    67,    67,    64,   114,
+      67,    71,   109,    65,    66,    67,    71,    67,   112,   100,
+      31,    42,    43,    44,    45,    46,    47,    48,    49,    57,
+      58,   123,   123,   123,    36,   115,   100,     6,    93,    19,
+      18,    54,    56,    67,    18,   113,    67,    62,   119,    19,
+     110,   110,    31,   110,   110,   110,    20,    97,    67,    67,
+      74,   100,    67,    74,   100,    67,    74,   100,   116,   114,
+      67,    92,     3,    65,    55,    20,    89,    67,    38,   105,
+      60,    59,   117,   112,    67,   100,    19,   123,    31,    31,
+     115,     3,     3,    19,    67,    19,    19,   116,    63,   104,
+      67,   121,    60,     3,   110,    97,    20,    98,    67,    74,
+     100,    67,    67,    89,     3,     3,    36,   106,    64,    11,
+      31,    61,   122,    20,   120,    67,    98,     3,    31,   116,
+      67,    67,   121,    20,    31,   118,    99,    67,   106,   105,
+     122,   120,    67,    67,    18,   104,    31,   118,   118,   100,
+      67,    97,   118,    19,    98
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-       0,    74,    75,    75,    76,    76,    76,    76,    76,    76,
-      76,    76,    76,    76,    76,    76,    76,    76,    76,    76,
-      76,    77,    78,    79,    80,    81,    82,    83,    84,    85,
-      86,    86,    87,    87,    88,    89,    90,    90,    91,    91,
-      91,    91,    92,    92,    92,    92,    92,    93,    94,    95,
-      95,    96,    97,    96,    98,    98,    98,    98,    98,    99,
-     100,   101,   102,   102,   103,   103,   104,   104,   105,   105,
-     105,   106,   106,   106,   106,   107,   107,   107,   107,   107,
-     108,   108,   108,   108,   108,   108,   109,   109,   109,   110,
-     110,   110,   111,   111,   111,   112,   112,   113,   113,   114,
-     114,   114,   114,   114,   114,   114,   114,   114,   114,   114,
-     114,   114,   114,   115,   115,   115,   116,   116,   116,   117,
-     117,   118,   118,   119,   119,   120,   120,   120,   121,   121,
-     121,   121,   121,   121,   121,   121,   121,   121,   122,   122,
-     122,   122,   123
+       0,    75,    76,    76,    77,    77,    77,    77,    77,    77,
+      77,    77,    77,    77,    77,    77,    77,    77,    77,    77,
+      77,    77,    78,    79,    80,    81,    82,    83,    84,    85,
+      86,    87,    88,    88,    89,    89,    90,    91,    92,    92,
+      93,    93,    93,    93,    94,    94,    94,    94,    94,    95,
+      96,    97,    97,    98,    99,    98,   100,   100,   100,   100,
+     100,   101,   102,   103,   104,   104,   105,   105,   106,   106,
+     107,   107,   107,   108,   108,   108,   108,   109,   109,   109,
+     109,   109,   110,   110,   110,   110,   110,   110,   111,   111,
+     111,   112,   112,   112,   113,   113,   113,   114,   114,   115,
+     115,   116,   116,   116,   116,   116,   116,   116,   116,   116,
+     116,   116,   116,   116,   116,   117,   117,   117,   118,   118,
+     118,   119,   119,   120,   120,   121,   121,   122,   122,   122,
+     123,   123,   123,   123,   123,   123,   123,   123,   123,   123,
+     124,   124,   124,   124,   125
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
        0,     2,     0,     2,     1,     1,     1,     1,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     2,     2,     2,     2,     2,     2,     4,     3,     3,
-      10,    10,     0,     3,     4,     8,     0,     3,     5,     3,
-       2,     4,     1,     1,     1,     1,     1,     1,    10,     0,
-       3,     0,     0,     8,     1,     1,     1,     1,     1,     5,
-       8,     9,     0,     5,     0,     3,     0,     3,     2,     5,
-       4,     1,     1,     3,     3,     2,     2,     4,     2,     2,
-       0,     3,     3,     5,     3,     3,     1,     3,     3,     0,
-       6,     3,     0,     3,     5,     0,     3,     0,     3,     3,
-       3,     3,     3,     5,     5,     7,     3,     3,     5,     3,
-       3,     5,     3,     0,     4,     6,     0,     3,     5,     0,
-       4,     0,     3,     2,     4,     0,     1,     1,     1,     1,
+       1,     1,     2,     2,     2,     2,     2,     2,     4,     3,
+       3,     4,    10,    10,     0,     3,     4,     8,     0,     3,
+       5,     3,     2,     4,     1,     1,     1,     1,     1,     1,
+      10,     0,     3,     0,     0,     8,     1,     1,     1,     1,
+       1,     5,     8,     9,     0,     5,     0,     3,     0,     3,
+       2,     5,     4,     1,     1,     3,     3,     2,     2,     4,
+       2,     2,     0,     3,     3,     5,     3,     3,     1,     3,
+       3,     0,     6,     3,     0,     3,     5,     0,     3,     0,
+       3,     3,     3,     3,     3,     5,     5,     7,     3,     3,
+       5,     3,     3,     5,     3,     0,     4,     6,     0,     3,
+       5,     0,     4,     0,     3,     2,     4,     0,     1,     1,
        1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     8
+       1,     1,     1,     1,     8
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (scanner, YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (scanner, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -926,56 +1037,53 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, scanner); \
+                  Kind, Value, scanner); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, void *scanner)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
-  YYUSE (scanner);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (scanner);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, void *scanner)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, scanner);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -984,7 +1092,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, voi
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -1007,21 +1115,21 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule, void *scanner)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, void *scanner)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                                              , scanner);
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1036,8 +1144,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1060,249 +1168,34 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-static YYSIZE_T
-yystrlen (const char *yystr)
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
 
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
 
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            /* Fall through.  */
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
 
-  if (! yyres)
-    return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
-
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
-
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
-
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, void *scanner)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, void *scanner)
 {
-  YYUSE (yyvaluep);
-  YYUSE (scanner);
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1310,7 +1203,7 @@ yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, void *scanner)
 int
 yyparse (void *scanner)
 {
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 
@@ -1321,45 +1214,38 @@ YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
 YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
 
     /* Number of syntax errors so far.  */
-    int yynerrs;
+    int yynerrs = 0;
 
-    int yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+    int yyerrstatus = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    YYSIZE_T yystacksize;
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1367,71 +1253,75 @@ YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
 
         /* Each stack pointer address is followed by the size of the
            data in use in that stack, in bytes.  This used to be a
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
                     &yystacksize);
-
         yyss = yyss1;
         yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
@@ -1439,30 +1329,31 @@ YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1473,18 +1364,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex (&yylval, scanner);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1512,15 +1414,13 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1535,7 +1435,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1555,137 +1455,146 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 21:
-#line 188 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 22: /* exit: EXIT SEMICOLON  */
+#line 191 "yacc_sql.y"
+                   {
         CONTEXT->ssql->flag=SCF_EXIT;//"exit";
     }
-#line 1564 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1464 "yacc_sql.tab.c"
     break;
 
-  case 22:
-#line 193 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 23: /* help: HELP SEMICOLON  */
+#line 196 "yacc_sql.y"
+                   {
         CONTEXT->ssql->flag=SCF_HELP;//"help";
     }
-#line 1572 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1472 "yacc_sql.tab.c"
     break;
 
-  case 23:
-#line 198 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 24: /* sync: SYNC SEMICOLON  */
+#line 201 "yacc_sql.y"
+                   {
       CONTEXT->ssql->flag = SCF_SYNC;
     }
-#line 1580 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1480 "yacc_sql.tab.c"
     break;
 
-  case 24:
-#line 204 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 25: /* begin: TRX_BEGIN SEMICOLON  */
+#line 207 "yacc_sql.y"
+                        {
       CONTEXT->ssql->flag = SCF_BEGIN;
     }
-#line 1588 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1488 "yacc_sql.tab.c"
     break;
 
-  case 25:
-#line 210 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 26: /* commit: TRX_COMMIT SEMICOLON  */
+#line 213 "yacc_sql.y"
+                         {
       CONTEXT->ssql->flag = SCF_COMMIT;
     }
-#line 1596 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1496 "yacc_sql.tab.c"
     break;
 
-  case 26:
-#line 216 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 27: /* rollback: TRX_ROLLBACK SEMICOLON  */
+#line 219 "yacc_sql.y"
+                           {
       CONTEXT->ssql->flag = SCF_ROLLBACK;
     }
-#line 1604 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1504 "yacc_sql.tab.c"
     break;
 
-  case 27:
-#line 222 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 28: /* drop_table: DROP TABLE ID SEMICOLON  */
+#line 225 "yacc_sql.y"
+                            {
         CONTEXT->ssql->flag = SCF_DROP_TABLE;//"drop_table";
         drop_table_init(&CONTEXT->ssql->sstr.drop_table, (yyvsp[-1].string));
     }
-#line 1613 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1513 "yacc_sql.tab.c"
     break;
 
-  case 28:
-#line 228 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 29: /* show_tables: SHOW TABLES SEMICOLON  */
+#line 231 "yacc_sql.y"
+                          {
       CONTEXT->ssql->flag = SCF_SHOW_TABLES;
     }
-#line 1621 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1521 "yacc_sql.tab.c"
     break;
 
-  case 29:
-#line 234 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 30: /* desc_table: DESC ID SEMICOLON  */
+#line 237 "yacc_sql.y"
+                      {
       CONTEXT->ssql->flag = SCF_DESC_TABLE;
       desc_table_init(&CONTEXT->ssql->sstr.desc_table, (yyvsp[-1].string));
     }
-#line 1630 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1530 "yacc_sql.tab.c"
     break;
 
-  case 30:
-#line 242 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 31: /* analyze_table: ANALYZE TABLE ID SEMICOLON  */
+#line 244 "yacc_sql.y"
+                               {
+      CONTEXT->ssql->flag = SCF_ANALYZE_TABLE;
+      analyze_table_init(&CONTEXT->ssql->sstr.analyze_table, (yyvsp[-1].string));
+    }
+#line 1539 "yacc_sql.tab.c"
+    break;
+
+  case 32: /* create_index: CREATE INDEX ID ON ID LBRACE ID id_list RBRACE SEMICOLON  */
+#line 252 "yacc_sql.y"
+        {
 		CONTEXT->ssql->flag = SCF_CREATE_INDEX; //"create_index";
 		create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-7].string), (yyvsp[-5].string), (yyvsp[-3].string));
 	}
-#line 1639 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1548 "yacc_sql.tab.c"
     break;
 
-  case 31:
-#line 247 "yacc_sql.y" /* yacc.c:1646  */
+  case 33: /* create_index: CREATE UNIQUE INDEX ID ON ID LBRACE ID RBRACE SEMICOLON  */
+#line 257 "yacc_sql.y"
     {
         CONTEXT->ssql->flag = SCF_CREATE_INDEX; //"create_index";
         (CONTEXT->ssql->sstr.create_index).isUnique = 1;
         create_index_init(&CONTEXT->ssql->sstr.create_index, (yyvsp[-6].string), (yyvsp[-4].string), (yyvsp[-2].string));
     }
-#line 1649 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1558 "yacc_sql.tab.c"
     break;
 
-  case 33:
-#line 256 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 35: /* id_list: COMMA ID id_list  */
+#line 266 "yacc_sql.y"
+                          {
 		create_index_add_attr(&CONTEXT->ssql->sstr.create_index, (yyvsp[-1].string));
 	}
-#line 1657 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1566 "yacc_sql.tab.c"
     break;
 
-  case 34:
-#line 261 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 36: /* drop_index: DROP INDEX ID SEMICOLON  */
+#line 271 "yacc_sql.y"
+                {
 			CONTEXT->ssql->flag=SCF_DROP_INDEX;//"drop_index";
 			drop_index_init(&CONTEXT->ssql->sstr.drop_index, (yyvsp[-1].string));
 		}
-#line 1666 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1575 "yacc_sql.tab.c"
     break;
 
-  case 35:
-#line 268 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 37: /* create_table: CREATE TABLE ID LBRACE attr_def attr_def_list RBRACE SEMICOLON  */
+#line 278 "yacc_sql.y"
+                {
 			CONTEXT->ssql->flag=SCF_CREATE_TABLE;//"create_table";
 			// CONTEXT->ssql->sstr.create_table.attribute_count = CONTEXT->value_length;
 			create_table_init_name(&CONTEXT->ssql->sstr.create_table, (yyvsp[-5].string));
 			//临时变量清零	
 			CONTEXT->value_length = 0;
 		}
-#line 1678 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1587 "yacc_sql.tab.c"
     break;
 
-  case 37:
-#line 278 "yacc_sql.y" /* yacc.c:1646  */
-    {    }
-#line 1684 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 39: /* attr_def_list: COMMA attr_def attr_def_list  */
+#line 288 "yacc_sql.y"
+                                   {    }
+#line 1593 "yacc_sql.tab.c"
     break;
 
-  case 38:
-#line 283 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 40: /* attr_def: ID_get type LBRACE NUMBER RBRACE  */
+#line 293 "yacc_sql.y"
+                {
 			AttrInfo attribute;
 			int int_length;
 			string2int(&int_length, (yyvsp[-1].string));
@@ -1697,23 +1606,23 @@ yyreduce:
 			// CONTEXT->ssql->sstr.create_table.attributes[CONTEXT->value_length].length = $4;
 			CONTEXT->value_length++;
 		}
-#line 1701 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1610 "yacc_sql.tab.c"
     break;
 
-  case 39:
-#line 295 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 41: /* attr_def: ID_get type NULLABLE  */
+#line 305 "yacc_sql.y"
+                             {
 		AttrInfo attribute;
 		attr_info_init(&attribute, CONTEXT->id, (yyvsp[-1].number), 4, 1);
 		create_table_append_attribute(&CONTEXT->ssql->sstr.create_table, &attribute);
 		CONTEXT->value_length++;
 	}
-#line 1712 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1621 "yacc_sql.tab.c"
     break;
 
-  case 40:
-#line 302 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 42: /* attr_def: ID_get type  */
+#line 312 "yacc_sql.y"
+                {
 			AttrInfo attribute;
 			attr_info_init(&attribute, CONTEXT->id, (yyvsp[0].number), 4, 0);
 			create_table_append_attribute(&CONTEXT->ssql->sstr.create_table, &attribute);
@@ -1723,12 +1632,12 @@ yyreduce:
 			// CONTEXT->ssql->sstr.create_table.attributes[CONTEXT->value_length].length=4; // default attribute length
 			CONTEXT->value_length++;
 		}
-#line 1727 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1636 "yacc_sql.tab.c"
     break;
 
-  case 41:
-#line 313 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 43: /* attr_def: ID_get type NOT NULL_TOKEN  */
+#line 323 "yacc_sql.y"
+                        {
 			AttrInfo attribute;
 			attr_info_init(&attribute, CONTEXT->id, (yyvsp[-2].number), 4, 0);
 			create_table_append_attribute(&CONTEXT->ssql->sstr.create_table, &attribute);
@@ -1738,51 +1647,51 @@ yyreduce:
 			// CONTEXT->ssql->sstr.create_table.attributes[CONTEXT->value_length].length=4; // default attribute length
 			CONTEXT->value_length++;
 		}
-#line 1742 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1651 "yacc_sql.tab.c"
     break;
 
-  case 42:
-#line 326 "yacc_sql.y" /* yacc.c:1646  */
-    { (yyval.number)=INTS; }
-#line 1748 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 44: /* type: INT_T  */
+#line 336 "yacc_sql.y"
+              { (yyval.number)=INTS; }
+#line 1657 "yacc_sql.tab.c"
     break;
 
-  case 43:
-#line 327 "yacc_sql.y" /* yacc.c:1646  */
-    { (yyval.number)=CHARS; }
-#line 1754 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 45: /* type: STRING_T  */
+#line 337 "yacc_sql.y"
+                  { (yyval.number)=CHARS; }
+#line 1663 "yacc_sql.tab.c"
     break;
 
-  case 44:
-#line 328 "yacc_sql.y" /* yacc.c:1646  */
-    { (yyval.number)=FLOATS; }
-#line 1760 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 46: /* type: FLOAT_T  */
+#line 338 "yacc_sql.y"
+                 { (yyval.number)=FLOATS; }
+#line 1669 "yacc_sql.tab.c"
     break;
 
-  case 45:
-#line 329 "yacc_sql.y" /* yacc.c:1646  */
-    { (yyval.number)=DATES; }
-#line 1766 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 47: /* type: DATE_T  */
+#line 339 "yacc_sql.y"
+                { (yyval.number)=DATES; }
+#line 1675 "yacc_sql.tab.c"
     break;
 
-  case 46:
-#line 330 "yacc_sql.y" /* yacc.c:1646  */
-    { (yyval.number)=TEXTS; }
-#line 1772 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 48: /* type: TEXT_T  */
+#line 340 "yacc_sql.y"
+                { (yyval.number)=TEXTS; }
+#line 1681 "yacc_sql.tab.c"
     break;
 
-  case 47:
-#line 334 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 49: /* ID_get: ID  */
+#line 344 "yacc_sql.y"
+        {
 		char *temp=(yyvsp[0].string); 
 		snprintf(CONTEXT->id, sizeof(CONTEXT->id), "%s", temp);
 	}
-#line 1781 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1690 "yacc_sql.tab.c"
     break;
 
-  case 48:
-#line 343 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 50: /* insert: INSERT INTO ID VALUES LBRACE value value_list RBRACE value_opt SEMICOLON  */
+#line 353 "yacc_sql.y"
+                {
 			// CONTEXT->values[CONTEXT->value_length++] = *$6;
 
 			CONTEXT->ssql->flag=SCF_INSERT;//"insert";
@@ -1796,35 +1705,35 @@ yyreduce:
       //临时变量清零
       CONTEXT->value_length=0;
     }
-#line 1800 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1709 "yacc_sql.tab.c"
     break;
 
-  case 50:
-#line 359 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 52: /* value_list: COMMA value value_list  */
+#line 369 "yacc_sql.y"
+                             {
   		// CONTEXT->values[CONTEXT->value_length++] = *$2;
 	  }
-#line 1808 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1717 "yacc_sql.tab.c"
     break;
 
-  case 52:
-#line 364 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 54: /* $@1: %empty  */
+#line 374 "yacc_sql.y"
+                       {
         CONTEXT->multi_insert_lines += 1;
     }
-#line 1816 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1725 "yacc_sql.tab.c"
     break;
 
-  case 53:
-#line 367 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 55: /* value_opt: COMMA value_opt $@1 LBRACE value value_list RBRACE value_opt  */
+#line 377 "yacc_sql.y"
+                                             {
     }
-#line 1823 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1732 "yacc_sql.tab.c"
     break;
 
-  case 54:
-#line 370 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 56: /* value: NUMBER  */
+#line 380 "yacc_sql.y"
+          {
         if (CONTEXT->multi_insert_lines == 0) {
 
   		    value_init_integer(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].string));
@@ -1833,12 +1742,12 @@ yyreduce:
 		    value_init_integer(&CONTEXT->extraValue[line].values[CONTEXT->extraValue[line].value_length++], (yyvsp[0].string));
 		}
 		}
-#line 1837 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1746 "yacc_sql.tab.c"
     break;
 
-  case 55:
-#line 379 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 57: /* value: FLOAT  */
+#line 389 "yacc_sql.y"
+          {
         if (CONTEXT->multi_insert_lines == 0) {
 
   		    value_init_float(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].string));
@@ -1847,12 +1756,12 @@ yyreduce:
             value_init_float(&CONTEXT->extraValue[line].values[CONTEXT->extraValue[line].value_length++], (yyvsp[0].string));
 		}
 		}
-#line 1851 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1760 "yacc_sql.tab.c"
     break;
 
-  case 56:
-#line 388 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 58: /* value: SSS  */
+#line 398 "yacc_sql.y"
+         {
 		(yyvsp[0].string) = substr((yyvsp[0].string),1,strlen((yyvsp[0].string))-2);
 		if (CONTEXT->multi_insert_lines == 0)  {
 
@@ -1862,12 +1771,12 @@ yyreduce:
 		    value_init_string(&CONTEXT->extraValue[line].values[CONTEXT->extraValue[line].value_length++], (yyvsp[0].string));
 		}
 		}
-#line 1866 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1775 "yacc_sql.tab.c"
     break;
 
-  case 57:
-#line 398 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 59: /* value: DATE  */
+#line 408 "yacc_sql.y"
+              {
 	    (yyvsp[0].string) = substr((yyvsp[0].string),1,strlen((yyvsp[0].string)) - 2);
 	    if (CONTEXT->multi_insert_lines == 0) {
             value_init_date(&CONTEXT->values[CONTEXT->value_length++], (yyvsp[0].string));
@@ -1876,12 +1785,12 @@ yyreduce:
             value_init_date(&CONTEXT->extraValue[line].values[CONTEXT->extraValue[line].value_length++], (yyvsp[0].string));
 	    }
 	    }
-#line 1880 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1789 "yacc_sql.tab.c"
     break;
 
-  case 58:
-#line 407 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 60: /* value: NULL_TOKEN  */
+#line 417 "yacc_sql.y"
+                   {
         if (CONTEXT->multi_insert_lines == 0) {
 
   		    value_init_null(&CONTEXT->values[CONTEXT->value_length++]);
@@ -1890,36 +1799,36 @@ yyreduce:
 		    value_init_null(&CONTEXT->extraValue[line].values[CONTEXT->extraValue[line].value_length++]);
 		}
 		}
-#line 1894 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1803 "yacc_sql.tab.c"
     break;
 
-  case 59:
-#line 420 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 61: /* delete: DELETE FROM ID where SEMICOLON  */
+#line 430 "yacc_sql.y"
+                {
 			CONTEXT->ssql->flag = SCF_DELETE;//"delete";
 			deletes_init_relation(&CONTEXT->ssql->sstr.deletion, (yyvsp[-2].string));
 			deletes_set_conditions(&CONTEXT->ssql->sstr.deletion, 
 					CONTEXT->conditions, CONTEXT->condition_length);
 			CONTEXT->condition_length = 0;	
     }
-#line 1906 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1815 "yacc_sql.tab.c"
     break;
 
-  case 60:
-#line 430 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 62: /* update: UPDATE ID SET ID EQ value where SEMICOLON  */
+#line 440 "yacc_sql.y"
+                {
 			CONTEXT->ssql->flag = SCF_UPDATE;//"update";
 			Value *value = &CONTEXT->values[0];
 			updates_init(&CONTEXT->ssql->sstr.update, (yyvsp[-6].string), (yyvsp[-4].string), value, 
 					CONTEXT->conditions, CONTEXT->condition_length);
 			CONTEXT->condition_length = 0;
 		}
-#line 1918 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1827 "yacc_sql.tab.c"
     break;
 
-  case 61:
-#line 440 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 63: /* select: SELECT select_attr FROM ID rel_list where orderby groupby SEMICOLON  */
+#line 450 "yacc_sql.y"
+                {
 			// CONTEXT->ssql->sstr.selection.relations[CONTEXT->from_length++]=$4;
 			selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-5].string));
 
@@ -1936,272 +1845,272 @@ yyreduce:
 			CONTEXT->select_length=0;
 			CONTEXT->value_length = 0;
 	}
-#line 1940 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1849 "yacc_sql.tab.c"
     break;
 
-  case 63:
-#line 459 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 65: /* innerjoin_list: INNER JOIN ID innerjoin_conditions innerjoin_list  */
+#line 469 "yacc_sql.y"
+                                                           {
 			selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-2].string));
 	}
-#line 1948 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1857 "yacc_sql.tab.c"
     break;
 
-  case 65:
-#line 465 "yacc_sql.y" /* yacc.c:1646  */
-    {	
+  case 67: /* innerjoin_conditions: ON condition innerjoin_condition_list  */
+#line 475 "yacc_sql.y"
+                                            {	
 				// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 			}
-#line 1956 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1865 "yacc_sql.tab.c"
     break;
 
-  case 67:
-#line 471 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 69: /* innerjoin_condition_list: AND condition innerjoin_condition_list  */
+#line 481 "yacc_sql.y"
+                                             {
 				// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 			}
-#line 1964 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1873 "yacc_sql.tab.c"
     break;
 
-  case 68:
-#line 477 "yacc_sql.y" /* yacc.c:1646  */
-    {  
+  case 70: /* select_attr: selectvalue attr_list  */
+#line 487 "yacc_sql.y"
+                         {  
 			
 		}
-#line 1972 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1881 "yacc_sql.tab.c"
     break;
 
-  case 69:
-#line 480 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 71: /* select_attr: aggretype LBRACE aggrevalue RBRACE attr_list  */
+#line 490 "yacc_sql.y"
+                                                      {
 			for (int i = 0; i<CONTEXT->ssql->sstr.selection.attr_num; i++){
 				CONTEXT->ssql->sstr.selection.attributes[i].aggre_type = CONTEXT->aggre_type[i];
 			}
 		}
-#line 1982 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1891 "yacc_sql.tab.c"
     break;
 
-  case 70:
-#line 485 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 72: /* select_attr: aggretype LBRACE RBRACE attr_list  */
+#line 495 "yacc_sql.y"
+                                            {
 			CONTEXT->ssql->flag = SCF_FAILURE;
 		}
-#line 1990 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1899 "yacc_sql.tab.c"
     break;
 
-  case 71:
-#line 492 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 73: /* selectvalue: STAR  */
+#line 502 "yacc_sql.y"
+             {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL, "*");
 		selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 	}
-#line 2000 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1909 "yacc_sql.tab.c"
     break;
 
-  case 72:
-#line 497 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 74: /* selectvalue: ID  */
+#line 507 "yacc_sql.y"
+              {
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, (yyvsp[0].string));
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2010 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1919 "yacc_sql.tab.c"
     break;
 
-  case 73:
-#line 502 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 75: /* selectvalue: ID DOT ID  */
+#line 512 "yacc_sql.y"
+                     {
 			RelAttr attr;
 			relation_attr_init(&attr, (yyvsp[-2].string), (yyvsp[0].string));
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2020 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1929 "yacc_sql.tab.c"
     break;
 
-  case 74:
-#line 507 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 76: /* selectvalue: ID DOT STAR  */
+#line 517 "yacc_sql.y"
+                   {
 			RelAttr attr;
 			relation_attr_init(&attr, (yyvsp[-2].string), "*");
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
         }
-#line 2030 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1939 "yacc_sql.tab.c"
     break;
 
-  case 75:
-#line 514 "yacc_sql.y" /* yacc.c:1646  */
-    {  
+  case 77: /* aggrevalue: STAR aggrevaluelist  */
+#line 524 "yacc_sql.y"
+                            {  
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, "*");
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2040 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1949 "yacc_sql.tab.c"
     break;
 
-  case 76:
-#line 519 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 78: /* aggrevalue: ID aggrevaluelist  */
+#line 529 "yacc_sql.y"
+                        {
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, (yyvsp[-1].string));
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2050 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1959 "yacc_sql.tab.c"
     break;
 
-  case 77:
-#line 524 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 79: /* aggrevalue: ID DOT ID aggrevaluelist  */
+#line 534 "yacc_sql.y"
+                                   {
 			RelAttr attr;
 			relation_attr_init(&attr, (yyvsp[-3].string), (yyvsp[-1].string));
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2060 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1969 "yacc_sql.tab.c"
     break;
 
-  case 78:
-#line 529 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 80: /* aggrevalue: NUMBER aggrevaluelist  */
+#line 539 "yacc_sql.y"
+                                {
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, (yyvsp[-1].string));
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2070 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1979 "yacc_sql.tab.c"
     break;
 
-  case 79:
-#line 534 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 81: /* aggrevalue: FLOAT aggrevaluelist  */
+#line 544 "yacc_sql.y"
+                           {
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, (yyvsp[-1].string));     
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2080 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1989 "yacc_sql.tab.c"
     break;
 
-  case 81:
-#line 541 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 83: /* aggrevaluelist: COMMA STAR aggrevaluelist  */
+#line 551 "yacc_sql.y"
+                                    {
 			CONTEXT->ssql->flag = SCF_FAILURE;
 	    }
-#line 2088 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 1997 "yacc_sql.tab.c"
     break;
 
-  case 82:
-#line 544 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 84: /* aggrevaluelist: COMMA ID aggrevaluelist  */
+#line 554 "yacc_sql.y"
+                                   {
 			CONTEXT->ssql->flag = SCF_FAILURE;
 	    }
-#line 2096 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2005 "yacc_sql.tab.c"
     break;
 
-  case 83:
-#line 547 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 85: /* aggrevaluelist: COMMA ID DOT ID aggrevaluelist  */
+#line 557 "yacc_sql.y"
+                                         {
 			CONTEXT->ssql->flag = SCF_FAILURE;
 	    }
-#line 2104 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2013 "yacc_sql.tab.c"
     break;
 
-  case 84:
-#line 550 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 86: /* aggrevaluelist: COMMA NUMBER aggrevaluelist  */
+#line 560 "yacc_sql.y"
+                                      {
 			CONTEXT->ssql->flag = SCF_FAILURE;
 	    }
-#line 2112 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2021 "yacc_sql.tab.c"
     break;
 
-  case 85:
-#line 553 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 87: /* aggrevaluelist: COMMA FLOAT aggrevaluelist  */
+#line 563 "yacc_sql.y"
+                                     {
 			CONTEXT->ssql->flag = SCF_FAILURE;
 	    }
-#line 2120 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2029 "yacc_sql.tab.c"
     break;
 
-  case 86:
-#line 558 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 88: /* selectvalue_commaed: ID  */
+#line 568 "yacc_sql.y"
+            {
 			RelAttr attr;
 			relation_attr_init(&attr, NULL, (yyvsp[0].string));
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2130 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2039 "yacc_sql.tab.c"
     break;
 
-  case 87:
-#line 563 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 89: /* selectvalue_commaed: ID DOT ID  */
+#line 573 "yacc_sql.y"
+                     {
 			RelAttr attr;
 			relation_attr_init(&attr, (yyvsp[-2].string), (yyvsp[0].string));
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
 		}
-#line 2140 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2049 "yacc_sql.tab.c"
     break;
 
-  case 88:
-#line 568 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 90: /* selectvalue_commaed: ID DOT STAR  */
+#line 578 "yacc_sql.y"
+                   {
 			RelAttr attr;
 			relation_attr_init(&attr, (yyvsp[-2].string), "*");
 			selects_append_attribute(&CONTEXT->ssql->sstr.selection, &attr);
         }
-#line 2150 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2059 "yacc_sql.tab.c"
     break;
 
-  case 90:
-#line 576 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 92: /* attr_list: COMMA aggretype LBRACE aggrevalue RBRACE attr_list  */
+#line 586 "yacc_sql.y"
+                                                             {
 			for (int i = 0; i<CONTEXT->ssql->sstr.selection.attr_num; i++){
 				CONTEXT->ssql->sstr.selection.attributes[i].aggre_type = CONTEXT->aggre_type[i];
 			}
 	    }
-#line 2160 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2069 "yacc_sql.tab.c"
     break;
 
-  case 91:
-#line 581 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 93: /* attr_list: COMMA selectvalue_commaed attr_list  */
+#line 591 "yacc_sql.y"
+                                          {
 			
       }
-#line 2168 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2077 "yacc_sql.tab.c"
     break;
 
-  case 93:
-#line 588 "yacc_sql.y" /* yacc.c:1646  */
-    {	
+  case 95: /* rel_list: COMMA ID rel_list  */
+#line 598 "yacc_sql.y"
+                        {	
 				selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-1].string));
 		  }
-#line 2176 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2085 "yacc_sql.tab.c"
     break;
 
-  case 94:
-#line 591 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 96: /* rel_list: INNER JOIN ID innerjoin_conditions innerjoin_list  */
+#line 601 "yacc_sql.y"
+                                                            {
 		selects_append_relation(&CONTEXT->ssql->sstr.selection, (yyvsp[-2].string));
 	}
-#line 2184 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2093 "yacc_sql.tab.c"
     break;
 
-  case 96:
-#line 597 "yacc_sql.y" /* yacc.c:1646  */
-    {	
+  case 98: /* where: WHERE condition condition_list  */
+#line 607 "yacc_sql.y"
+                                     {	
 				// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 			}
-#line 2192 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2101 "yacc_sql.tab.c"
     break;
 
-  case 98:
-#line 603 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 100: /* condition_list: AND condition condition_list  */
+#line 613 "yacc_sql.y"
+                                   {
 				// CONTEXT->conditions[CONTEXT->condition_length++]=*$2;
 			}
-#line 2200 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2109 "yacc_sql.tab.c"
     break;
 
-  case 99:
-#line 609 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 101: /* condition: ID comOp value  */
+#line 619 "yacc_sql.y"
+                {
 			RelAttr left_attr;
 			relation_attr_init(&left_attr, NULL, (yyvsp[-2].string));
 
@@ -2221,12 +2130,12 @@ yyreduce:
 			// $$->right_value = *$3;
 
 		}
-#line 2225 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2134 "yacc_sql.tab.c"
     break;
 
-  case 100:
-#line 630 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 102: /* condition: value comOp value  */
+#line 640 "yacc_sql.y"
+                {
 			Value *left_value = &CONTEXT->values[CONTEXT->value_length - 2];
 			Value *right_value = &CONTEXT->values[CONTEXT->value_length - 1];
 
@@ -2245,12 +2154,12 @@ yyreduce:
 			// $$->right_value = *$3;
 
 		}
-#line 2249 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2158 "yacc_sql.tab.c"
     break;
 
-  case 101:
-#line 650 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 103: /* condition: ID comOp ID  */
+#line 660 "yacc_sql.y"
+                {
 			RelAttr left_attr;
 			relation_attr_init(&left_attr, NULL, (yyvsp[-2].string));
 			RelAttr right_attr;
@@ -2269,12 +2178,12 @@ yyreduce:
 			// $$->right_attr.attribute_name=$3;
 
 		}
-#line 2273 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2182 "yacc_sql.tab.c"
     break;
 
-  case 102:
-#line 670 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 104: /* condition: value comOp ID  */
+#line 680 "yacc_sql.y"
+                {
 			Value *left_value = &CONTEXT->values[CONTEXT->value_length - 1];
 			RelAttr right_attr;
 			relation_attr_init(&right_attr, NULL, (yyvsp[0].string));
@@ -2295,12 +2204,12 @@ yyreduce:
 			// $$->right_attr.attribute_name=$3;
 		
 		}
-#line 2299 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2208 "yacc_sql.tab.c"
     break;
 
-  case 103:
-#line 692 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 105: /* condition: ID DOT ID comOp value  */
+#line 702 "yacc_sql.y"
+                {
 			RelAttr left_attr;
 			relation_attr_init(&left_attr, (yyvsp[-4].string), (yyvsp[-2].string));
 			Value *right_value = &CONTEXT->values[CONTEXT->value_length - 1];
@@ -2320,12 +2229,12 @@ yyreduce:
 			// $$->right_value =*$5;			
 							
     }
-#line 2324 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2233 "yacc_sql.tab.c"
     break;
 
-  case 104:
-#line 713 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 106: /* condition: value comOp ID DOT ID  */
+#line 723 "yacc_sql.y"
+                {
 			Value *left_value = &CONTEXT->values[CONTEXT->value_length - 1];
 
 			RelAttr right_attr;
@@ -2345,12 +2254,12 @@ yyreduce:
 			// $$->right_attr.attribute_name = $5;
 									
     }
-#line 2349 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2258 "yacc_sql.tab.c"
     break;
 
-  case 105:
-#line 734 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 107: /* condition: ID DOT ID comOp ID DOT ID  */
+#line 744 "yacc_sql.y"
+                {
 			RelAttr left_attr;
 			relation_attr_init(&left_attr, (yyvsp[-6].string), (yyvsp[-4].string));
 			RelAttr right_attr;
@@ -2368,12 +2277,12 @@ yyreduce:
 			// $$->right_attr.relation_name=$5;
 			// $$->right_attr.attribute_name=$7;
     }
-#line 2372 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2281 "yacc_sql.tab.c"
     break;
 
-  case 106:
-#line 753 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 108: /* condition: ID comOp SUB_SELECTION  */
+#line 763 "yacc_sql.y"
+        {
 			RelAttr left_attr;
 			relation_attr_init(&left_attr, NULL, (yyvsp[-2].string));
 
@@ -2381,24 +2290,24 @@ yyreduce:
 			condition_init(&condition, CONTEXT->comp, 1, NULL, &left_attr, NULL, 2, NULL, NULL, (yyvsp[0].string));
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2385 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2294 "yacc_sql.tab.c"
     break;
 
-  case 107:
-#line 762 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 109: /* condition: value comOp SUB_SELECTION  */
+#line 772 "yacc_sql.y"
+        {
 			Value *left_value = &CONTEXT->values[CONTEXT->value_length - 1];
 
 			Condition condition;
 			condition_init(&condition, CONTEXT->comp, 0, left_value, NULL, NULL, 2, NULL, NULL, (yyvsp[0].string));
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2397 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2306 "yacc_sql.tab.c"
     break;
 
-  case 108:
-#line 770 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 110: /* condition: ID DOT ID comOp SUB_SELECTION  */
+#line 780 "yacc_sql.y"
+        {
 			RelAttr left_attr;
 			relation_attr_init(&left_attr, (yyvsp[-4].string), (yyvsp[-2].string));
 
@@ -2406,12 +2315,12 @@ yyreduce:
 			condition_init(&condition, CONTEXT->comp, 1, NULL, &left_attr, NULL, 2, NULL, NULL, (yyvsp[0].string));
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2410 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2319 "yacc_sql.tab.c"
     break;
 
-  case 109:
-#line 779 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 111: /* condition: SUB_SELECTION comOp ID  */
+#line 789 "yacc_sql.y"
+        {
 			RelAttr right_attr;
 			relation_attr_init(&right_attr, NULL, (yyvsp[0].string));
 
@@ -2419,24 +2328,24 @@ yyreduce:
 			condition_init(&condition, CONTEXT->comp, 2, NULL, NULL, (yyvsp[-2].string), 1, NULL, &right_attr, NULL);
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2423 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2332 "yacc_sql.tab.c"
     break;
 
-  case 110:
-#line 788 "yacc_sql.y" /* yacc.c:1646  */
-    {		
+  case 112: /* condition: SUB_SELECTION comOp value  */
+#line 798 "yacc_sql.y"
+        {		
 			Value *right_value = &CONTEXT->values[CONTEXT->value_length - 1];
 
 			Condition condition;
 			condition_init(&condition, CONTEXT->comp, 2, NULL, NULL, (yyvsp[-2].string), 0,right_value, NULL, NULL);
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2435 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2344 "yacc_sql.tab.c"
     break;
 
-  case 111:
-#line 796 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 113: /* condition: SUB_SELECTION comOp ID DOT ID  */
+#line 806 "yacc_sql.y"
+        {
 			RelAttr right_attr;
 			relation_attr_init(&right_attr, (yyvsp[-2].string), (yyvsp[0].string));
 
@@ -2444,222 +2353,223 @@ yyreduce:
 			condition_init(&condition, CONTEXT->comp, 2, NULL, NULL, (yyvsp[-4].string), 1, NULL, &right_attr, NULL);
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2448 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2357 "yacc_sql.tab.c"
     break;
 
-  case 112:
-#line 805 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 114: /* condition: SUB_SELECTION comOp SUB_SELECTION  */
+#line 815 "yacc_sql.y"
+        {
 			Condition condition;
 			condition_init(&condition, CONTEXT->comp, 2, NULL, NULL, (yyvsp[-2].string), 2, NULL, NULL, (yyvsp[0].string));
 			CONTEXT->conditions[CONTEXT->condition_length++] = condition;
 	}
-#line 2458 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2367 "yacc_sql.tab.c"
     break;
 
-  case 114:
-#line 812 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 116: /* groupby: GROUP BY ID groupby_list  */
+#line 822 "yacc_sql.y"
+                                  {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL,(yyvsp[-1].string));
         CONTEXT->ssql->sstr.selection.groupby_attr[(CONTEXT->ssql->sstr.selection.groupby_num)++] = attr;
 	}
-#line 2468 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2377 "yacc_sql.tab.c"
     break;
 
-  case 115:
-#line 817 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 117: /* groupby: GROUP BY ID DOT ID groupby_list  */
+#line 827 "yacc_sql.y"
+                                         {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string),(yyvsp[-1].string));
 		CONTEXT->ssql->sstr.selection.groupby_attr[(CONTEXT->ssql->sstr.selection.groupby_num)++] = attr;
 	}
-#line 2478 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2387 "yacc_sql.tab.c"
     break;
 
-  case 117:
-#line 826 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 119: /* groupby_list: COMMA ID groupby_list  */
+#line 836 "yacc_sql.y"
+                              {
 		RelAttr attr;
 		relation_attr_init(&attr, NULL,(yyvsp[-1].string));
 		CONTEXT->ssql->sstr.selection.groupby_attr[(CONTEXT->ssql->sstr.selection.groupby_num)++] = attr;
 	}
-#line 2488 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2397 "yacc_sql.tab.c"
     break;
 
-  case 118:
-#line 831 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 120: /* groupby_list: COMMA ID DOT ID groupby_list  */
+#line 841 "yacc_sql.y"
+                                     {
 		RelAttr attr;
 		relation_attr_init(&attr, (yyvsp[-3].string),(yyvsp[-1].string));
 		CONTEXT->ssql->sstr.selection.groupby_attr[(CONTEXT->ssql->sstr.selection.groupby_num)++] = attr;
 	}
-#line 2498 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2407 "yacc_sql.tab.c"
     break;
 
-  case 120:
-#line 840 "yacc_sql.y" /* yacc.c:1646  */
-    {	
+  case 122: /* orderby: ORDER BY orderby_attr orderby_attr_list  */
+#line 850 "yacc_sql.y"
+                                              {	
 				//
 			}
-#line 2506 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2415 "yacc_sql.tab.c"
     break;
 
-  case 122:
-#line 846 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 124: /* orderby_attr_list: COMMA orderby_attr orderby_attr_list  */
+#line 856 "yacc_sql.y"
+                                           {
 				// 
 			}
-#line 2514 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2423 "yacc_sql.tab.c"
     break;
 
-  case 123:
-#line 851 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 125: /* orderby_attr: ID AscDesc  */
+#line 861 "yacc_sql.y"
+                   {
 		Orderby orderby;
 		relation_attr_init(&orderby.attr, NULL, (yyvsp[-1].string));
 		orderby_init_append(&(CONTEXT->ssql->sstr.selection), CONTEXT->asc_desc, &orderby);
 	}
-#line 2524 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2433 "yacc_sql.tab.c"
     break;
 
-  case 124:
-#line 856 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 126: /* orderby_attr: ID DOT ID AscDesc  */
+#line 866 "yacc_sql.y"
+                            {
 		Orderby orderby;
 		relation_attr_init(&orderby.attr, (yyvsp[-3].string), (yyvsp[-1].string));
 		orderby_init_append(&(CONTEXT->ssql->sstr.selection), CONTEXT->asc_desc, &orderby);
 	}
-#line 2534 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2443 "yacc_sql.tab.c"
     break;
 
-  case 125:
-#line 865 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 127: /* AscDesc: %empty  */
+#line 875 "yacc_sql.y"
+        {
 		CONTEXT->asc_desc = 0;
 	}
-#line 2542 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2451 "yacc_sql.tab.c"
     break;
 
-  case 126:
-#line 868 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 128: /* AscDesc: ASC  */
+#line 878 "yacc_sql.y"
+              {
 		CONTEXT->asc_desc = 0;
 	}
-#line 2550 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2459 "yacc_sql.tab.c"
     break;
 
-  case 127:
-#line 871 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 129: /* AscDesc: DESC  */
+#line 881 "yacc_sql.y"
+               {
 		CONTEXT->asc_desc = 1;
 	}
-#line 2558 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2467 "yacc_sql.tab.c"
     break;
 
-  case 128:
-#line 876 "yacc_sql.y" /* yacc.c:1646  */
-    { CONTEXT->comp = EQUAL_TO; }
-#line 2564 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 130: /* comOp: EQ  */
+#line 886 "yacc_sql.y"
+             { CONTEXT->comp = EQUAL_TO; }
+#line 2473 "yacc_sql.tab.c"
     break;
 
-  case 129:
-#line 877 "yacc_sql.y" /* yacc.c:1646  */
-    { CONTEXT->comp = LESS_THAN; }
-#line 2570 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 131: /* comOp: LT  */
+#line 887 "yacc_sql.y"
+         { CONTEXT->comp = LESS_THAN; }
+#line 2479 "yacc_sql.tab.c"
     break;
 
-  case 130:
-#line 878 "yacc_sql.y" /* yacc.c:1646  */
-    { CONTEXT->comp = GREAT_THAN; }
-#line 2576 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 132: /* comOp: GT  */
+#line 888 "yacc_sql.y"
+         { CONTEXT->comp = GREAT_THAN; }
+#line 2485 "yacc_sql.tab.c"
     break;
 
-  case 131:
-#line 879 "yacc_sql.y" /* yacc.c:1646  */
-    { CONTEXT->comp = LESS_EQUAL; }
-#line 2582 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 133: /* comOp: LE  */
+#line 889 "yacc_sql.y"
+         { CONTEXT->comp = LESS_EQUAL; }
+#line 2491 "yacc_sql.tab.c"
     break;
 
-  case 132:
-#line 880 "yacc_sql.y" /* yacc.c:1646  */
-    { CONTEXT->comp = GREAT_EQUAL; }
-#line 2588 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 134: /* comOp: GE  */
+#line 890 "yacc_sql.y"
+         { CONTEXT->comp = GREAT_EQUAL; }
+#line 2497 "yacc_sql.tab.c"
     break;
 
-  case 133:
-#line 881 "yacc_sql.y" /* yacc.c:1646  */
-    { CONTEXT->comp = NOT_EQUAL; }
-#line 2594 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 135: /* comOp: NE  */
+#line 891 "yacc_sql.y"
+         { CONTEXT->comp = NOT_EQUAL; }
+#line 2503 "yacc_sql.tab.c"
     break;
 
-  case 134:
-#line 882 "yacc_sql.y" /* yacc.c:1646  */
-    {CONTEXT->comp = IS_COMPOP; }
-#line 2600 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 136: /* comOp: IS  */
+#line 892 "yacc_sql.y"
+             {CONTEXT->comp = IS_COMPOP; }
+#line 2509 "yacc_sql.tab.c"
     break;
 
-  case 135:
-#line 883 "yacc_sql.y" /* yacc.c:1646  */
-    {CONTEXT->comp = IS_NOT_COMPOP; }
-#line 2606 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 137: /* comOp: ISNOT  */
+#line 893 "yacc_sql.y"
+                {CONTEXT->comp = IS_NOT_COMPOP; }
+#line 2515 "yacc_sql.tab.c"
     break;
 
-  case 136:
-#line 884 "yacc_sql.y" /* yacc.c:1646  */
-    {CONTEXT->comp = IN_COMPOP; }
-#line 2612 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 138: /* comOp: IN  */
+#line 894 "yacc_sql.y"
+             {CONTEXT->comp = IN_COMPOP; }
+#line 2521 "yacc_sql.tab.c"
     break;
 
-  case 137:
-#line 885 "yacc_sql.y" /* yacc.c:1646  */
-    {CONTEXT->comp = NOTIN_COMPOP; }
-#line 2618 "yacc_sql.tab.c" /* yacc.c:1646  */
+  case 139: /* comOp: NOTIN  */
+#line 895 "yacc_sql.y"
+                {CONTEXT->comp = NOTIN_COMPOP; }
+#line 2527 "yacc_sql.tab.c"
     break;
 
-  case 138:
-#line 889 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 140: /* aggretype: COU  */
+#line 899 "yacc_sql.y"
+            {
 		CONTEXT->aggre_type[CONTEXT->ssql->sstr.selection.attr_num] = COUNT;
 	}
-#line 2626 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2535 "yacc_sql.tab.c"
     break;
 
-  case 139:
-#line 892 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 141: /* aggretype: MI  */
+#line 902 "yacc_sql.y"
+             {
 		CONTEXT->aggre_type[CONTEXT->ssql->sstr.selection.attr_num] = MIN;
 	}
-#line 2634 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2543 "yacc_sql.tab.c"
     break;
 
-  case 140:
-#line 895 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 142: /* aggretype: MA  */
+#line 905 "yacc_sql.y"
+             {
 		CONTEXT->aggre_type[CONTEXT->ssql->sstr.selection.attr_num] = MAX;
 	}
-#line 2642 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2551 "yacc_sql.tab.c"
     break;
 
-  case 141:
-#line 898 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 143: /* aggretype: AV  */
+#line 908 "yacc_sql.y"
+             {
 		CONTEXT->aggre_type[CONTEXT->ssql->sstr.selection.attr_num] = AVG;
 	}
-#line 2650 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2559 "yacc_sql.tab.c"
     break;
 
-  case 142:
-#line 905 "yacc_sql.y" /* yacc.c:1646  */
-    {
+  case 144: /* load_data: LOAD DATA INFILE SSS INTO TABLE ID SEMICOLON  */
+#line 915 "yacc_sql.y"
+                {
 		  CONTEXT->ssql->flag = SCF_LOAD_DATA;
 			load_data_init(&CONTEXT->ssql->sstr.load_data, (yyvsp[-1].string), (yyvsp[-4].string));
 		}
-#line 2659 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2568 "yacc_sql.tab.c"
     break;
 
 
-#line 2663 "yacc_sql.tab.c" /* yacc.c:1646  */
+#line 2572 "yacc_sql.tab.c"
+
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -2673,25 +2583,23 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -2702,50 +2610,14 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (scanner, YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (scanner, yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2774,12 +2646,11 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
-
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2796,13 +2667,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2816,7 +2688,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, scanner);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2828,7 +2700,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2839,26 +2711,30 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (scanner, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-yyreturn:
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2874,20 +2750,18 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp, scanner);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 910 "yacc_sql.y" /* yacc.c:1906  */
+
+#line 920 "yacc_sql.y"
 
 //_____________________________________________________________________
 extern void scan_string(const char *str, yyscan_t scanner);
@@ -9,6 +9,7 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
+#include<strings.h>
 
 typedef struct ParserContext {
   Query * ssql;
@@ -76,6 +77,7 @@ ParserContext *get_context(yyscan_t scanner)
         SELECT
         DESC
         SHOW
+        ANALYZE
         SYNC
         INSERT
         DELETE
@@ -173,6 +175,7 @@ command:
 	| drop_table
 	| show_tables
 	| desc_table
+	| analyze_table
 	| create_index	
 	| drop_index
 	| sync
@@ -237,6 +240,13 @@ desc_table:
     }
     ;
 
+analyze_table:
+    ANALYZE TABLE ID SEMICOLON {
+      CONTEXT->ssql->flag = SCF_ANALYZE_TABLE;
+      analyze_table_init(&CONTEXT->ssql->sstr.analyze_table, $3);
+    }
+    ;
+
 create_index:		/*create index 语句的语法解析树*/
 	CREATE INDEX ID ON ID LBRACE ID id_list RBRACE SEMICOLON
 	{
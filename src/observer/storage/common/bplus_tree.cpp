@@ -19,6 +19,7 @@ See the Mulan PSL v2 for more details. */
 #include "sql/parser/parse_defs.h"
 #include "functional"
 
+#include <algorithm>
 #include <functional>
 #include <vector>
 
@@ -38,9 +39,37 @@ IndexNode *BplusTreeHandler::get_index_node(char *page_data) const {
 }
 
 RC BplusTreeHandler::sync() {
+    if (header_dirty_) {
+        RC rc = write_header();
+        if (rc != SUCCESS) {
+            return rc;
+        }
+    }
     return disk_buffer_pool_->flush_all_pages(file_id_);
 }
 
+RC BplusTreeHandler::write_header() {
+    BPPageHandle page_handle;
+    char *pdata;
+    RC rc = disk_buffer_pool_->get_this_page(file_id_, 1, &page_handle);
+    if (rc != SUCCESS) {
+        return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS) {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        return rc;
+    }
+    memcpy(pdata, &file_header_, sizeof(file_header_));
+    rc = disk_buffer_pool_->mark_dirty(&page_handle);
+    if (rc != SUCCESS) {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        return rc;
+    }
+    header_dirty_ = false;
+    return disk_buffer_pool_->unpin_page(&page_handle);
+}
+
 /*
 RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_length) {
     BPPageHandle page_handle;
@@ -111,13 +140,26 @@ RC BplusTreeHandler::create(const char *file_name, AttrType attr_type, int attr_
     return SUCCESS;
 } */
 
+// 选择页大小时，B+树节点至少能容纳的key个数
+static const int MIN_INDEX_ORDER = 64;
+
+static int index_order(int page_size, int attrs_len) {
+    return ((int) (page_size - sizeof(PageNum)) - sizeof(IndexFileHeader) - sizeof(IndexNode)) /
+           (attrs_len + 2 * sizeof(RID));
+}
+
 RC BplusTreeHandler::create(const char *file_name, std::vector<const FieldMeta*> fields_meta, int attrs_len) {
     BPPageHandle page_handle;
     IndexNode *root;
     char *pdata;
     RC rc;
     DiskBufferPool *disk_buffer_pool = theGlobalDiskBufferPool();
-    rc = disk_buffer_pool->create_file(file_name);
+    // key比较长时使用更大的页，避免树的高度太高
+    int page_size = BP_PAGE_SIZE;
+    while (page_size < BP_MAX_PAGE_SIZE && index_order(page_size, attrs_len) < MIN_INDEX_ORDER) {
+        page_size <<= 1;
+    }
+    rc = disk_buffer_pool->create_file(file_name, page_size);
     if (rc != SUCCESS) {
         return rc;
     }
@@ -149,14 +191,14 @@ RC BplusTreeHandler::create(const char *file_name, std::vector<const FieldMeta*>
     file_header->key_length = attrs_len + sizeof(RID);
     file_header->attrs_length = attrs_len;
     file_header->node_num = 1;
-    file_header->order =
-            ((int) BP_PAGE_DATA_SIZE - sizeof(IndexFileHeader) - sizeof(IndexNode)) / (attrs_len + 2 * sizeof(RID));
+    file_header->order = index_order(page_size, attrs_len);
     file_header->root_page = page_num;
 
     file_header->attr_num = 0;
     for (auto& field_meta : fields_meta) {
-        file_header->attr_type[file_header->attr_num++] = field_meta->type();
-        file_header->attr_length[file_header->attr_num++] = field_meta->len();
+        file_header->attr_type[file_header->attr_num] = field_meta->type();
+        file_header->attr_length[file_header->attr_num] = field_meta->len();
+        file_header->attr_num++;
     }
 
     root = get_index_node(pdata);
@@ -227,6 +269,190 @@ RC BplusTreeHandler::close() {
     return RC::SUCCESS;
 }
 
+RC BplusTreeHandler::set_parent(PageNum page_num, PageNum parent) {
+    BPPageHandle page_handle;
+    char *pdata;
+    RC rc = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (rc != SUCCESS) {
+        return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS) {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        return rc;
+    }
+    get_index_node(pdata)->parent = parent;
+    rc = disk_buffer_pool_->mark_dirty(&page_handle);
+    if (rc != SUCCESS) {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        return rc;
+    }
+    return disk_buffer_pool_->unpin_page(&page_handle);
+}
+
+// 批量构建时节点至少填充的百分比，太小时删除会频繁合并节点
+static const int MIN_FILL_FACTOR = 50;
+
+RC BplusTreeHandler::bulk_load(int entry_num, int fill_factor,
+                               const std::function<RC(const char *&key)> &next_key) {
+    if (nullptr == disk_buffer_pool_) {
+        return RC::RECORD_CLOSED;
+    }
+    if (disk_buffer_pool_->read_only()) {
+        LOG_WARN("Failed to load entries, index file %d is read only.", file_id_);
+        return RC::READONLY;
+    }
+    if (entry_num <= 0) {
+        return SUCCESS;
+    }
+
+    BPPageHandle page_handle;
+    char *pdata;
+    RC rc = disk_buffer_pool_->get_this_page(file_id_, file_header_.root_page, &page_handle);
+    if (rc != SUCCESS) {
+        return rc;
+    }
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS) {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        return rc;
+    }
+    IndexNode *node = get_index_node(pdata);
+    if (file_header_.root_page != 1 || !node->is_leaf || node->key_num != 0) {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        LOG_WARN("Failed to load entries, index file %d is not empty.", file_id_);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    fill_factor = std::min(std::max(fill_factor, MIN_FILL_FACTOR), 100);
+    const int key_length = file_header_.key_length;
+    const int order = file_header_.order;
+
+    // 叶子节点最多有order-1个键值，所有叶子平均分配，第一个叶子就是原来的根节点
+    int leaf_keys = std::max((order - 1) * fill_factor / 100, 1);
+    int leaf_num = (entry_num + leaf_keys - 1) / leaf_keys;
+    std::vector<PageNum> children;
+    std::vector<char> first_keys;  // 每个子节点中最小的键值
+    children.reserve(leaf_num);
+    first_keys.reserve((size_t) leaf_num * key_length);
+    for (int i = 0; i < leaf_num; i++) {
+        PageNum page_num;
+        if (i > 0) {
+            BPPageHandle new_page_handle;
+            rc = disk_buffer_pool_->allocate_page(file_id_, &new_page_handle);
+            if (rc == SUCCESS) {
+                rc = disk_buffer_pool_->get_page_num(&new_page_handle, &page_num);
+                if (rc != SUCCESS) {
+                    disk_buffer_pool_->unpin_page(&new_page_handle);
+                }
+            }
+            if (rc != SUCCESS) {
+                disk_buffer_pool_->unpin_page(&page_handle);
+                return rc;
+            }
+            // 上一个叶子指向这个叶子后才能写回
+            node->rids[order - 1].page_num = page_num;
+            node->rids[order - 1].slot_num = -1;
+            disk_buffer_pool_->mark_dirty(&page_handle);
+            rc = disk_buffer_pool_->unpin_page(&page_handle);
+            page_handle = new_page_handle;
+            if (rc == SUCCESS) {
+                rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+            }
+            if (rc != SUCCESS) {
+                disk_buffer_pool_->unpin_page(&page_handle);
+                return rc;
+            }
+            node = get_index_node(pdata);
+        } else {
+            page_num = file_header_.root_page;
+        }
+
+        node->is_leaf = 1;
+        node->key_num = entry_num / leaf_num + (i < entry_num % leaf_num ? 1 : 0);
+        node->parent = -1;
+        for (int j = 0; j < node->key_num; j++) {
+            const char *key = nullptr;
+            rc = next_key(key);
+            if (rc != SUCCESS) {
+                LOG_ERROR("Failed to get the key to load. index=%d, rc=%d:%s", file_id_, rc, strrc(rc));
+                disk_buffer_pool_->unpin_page(&page_handle);
+                return rc;
+            }
+            memcpy(node->keys + j * key_length, key, key_length);
+            memcpy(node->rids + j, key + file_header_.attrs_length, sizeof(RID));
+        }
+        node->rids[order - 1].page_num = 0;
+        node->rids[order - 1].slot_num = -1;
+        children.push_back(page_num);
+        first_keys.insert(first_keys.end(), node->keys, node->keys + key_length);
+    }
+    disk_buffer_pool_->mark_dirty(&page_handle);
+    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    if (rc != SUCCESS) {
+        return rc;
+    }
+
+    // 逐层向上构建内部节点，直到只剩一个节点作为根。子节点i+1中最小的键值作为内部节点的第i个键值
+    int max_children = std::max(order * fill_factor / 100, 2);
+    while (children.size() > 1) {
+        const int child_num = children.size();
+        // 每个内部节点至少有两个子节点
+        const int node_num = std::max(std::min((child_num + max_children - 1) / max_children, child_num / 2), 1);
+        std::vector<PageNum> parents;
+        std::vector<char> parent_first_keys;
+        int child = 0;
+        for (int i = 0; i < node_num; i++) {
+            const int node_children = child_num / node_num + (i < child_num % node_num ? 1 : 0);
+            PageNum page_num;
+            rc = disk_buffer_pool_->allocate_page(file_id_, &page_handle);
+            if (rc != SUCCESS) {
+                return rc;
+            }
+            rc = disk_buffer_pool_->get_page_num(&page_handle, &page_num);
+            if (rc == SUCCESS) {
+                rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+            }
+            if (rc != SUCCESS) {
+                disk_buffer_pool_->unpin_page(&page_handle);
+                return rc;
+            }
+            node = get_index_node(pdata);
+            node->is_leaf = 0;
+            node->key_num = node_children - 1;
+            node->parent = -1;
+            for (int j = 0; j < node_children; j++, child++) {
+                node->rids[j].page_num = children[child];
+                node->rids[j].slot_num = -1;
+                if (j > 0) {
+                    memcpy(node->keys + (j - 1) * key_length, first_keys.data() + (size_t) child * key_length,
+                           key_length);
+                }
+            }
+            disk_buffer_pool_->mark_dirty(&page_handle);
+            rc = disk_buffer_pool_->unpin_page(&page_handle);
+            if (rc != SUCCESS) {
+                return rc;
+            }
+
+            for (int j = child - node_children; j < child; j++) {
+                rc = set_parent(children[j], page_num);
+                if (rc != SUCCESS) {
+                    return rc;
+                }
+            }
+            const char *first_key = first_keys.data() + (size_t) (child - node_children) * key_length;
+            parents.push_back(page_num);
+            parent_first_keys.insert(parent_first_keys.end(), first_key, first_key + key_length);
+        }
+        children.swap(parents);
+        first_keys.swap(parent_first_keys);
+    }
+
+    file_header_.root_page = children[0];
+    return write_header();
+}
+
 static int CmpRid(const RID *rid1, const RID *rid2) {
     if (rid1->page_num > rid2->page_num)
         return 1;
@@ -240,54 +466,39 @@ static int CmpRid(const RID *rid1, const RID *rid2) {
 }
 
 int CompareKey(const char *pdata, const char *pkey, AttrType *attrs_type, int *attrs_length, int attr_num) { // 简化
-    int i1, i2;
-    float f1, f2;
-    const char *s1, *s2;
+    int result = 0;
     for (int i = 0; i < attr_num; i++) {
         AttrType attr_type = attrs_type[i];
         int attr_length = attrs_length[i];
         switch (attr_type) {
-            case INTS: {
-                i1 = *(int *) pdata;
-                i2 = *(int *) pkey;
-                if (i1 > i2)
-                    return 1;
-                if (i1 < i2)
-                    return -1;
-                if (i1 == i2)
-                    return 0;
+            case INTS:
+            case DATES: {
+                int i1 = *(int *) pdata;
+                int i2 = *(int *) pkey;
+                result = i1 > i2 ? 1 : (i1 < i2 ? -1 : 0);
             }
                 break;
             case FLOATS: {
-                f1 = *(float *) pdata;
-                f2 = *(float *) pkey;
-                return float_compare(f1, f2);
+                result = float_compare(*(float *) pdata, *(float *) pkey);
             }
                 break;
             case CHARS: {
-                s1 = pdata;
-                s2 = pkey;
-                return strncmp(s1, s2, attr_length);
-            }
-            case DATES: {
-                i1 = *(int *) pdata;
-                i2 = *(int *) pkey;
-                if (i1 > i2)
-                    return 1;
-                if (i1 < i2)
-                    return -1;
-                if (i1 == i2)
-                    return 0;
+                result = strncmp(pdata, pkey, attr_length);
+                result = result > 0 ? 1 : (result < 0 ? -1 : 0);
             }
                 break;
             default: {
                 LOG_PANIC("Unknown attr type: %d", attr_type);
             }
         }
+        // 前面的字段相等时才比较后面的字段
+        if (result != 0) {
+            return result;
+        }
         pdata += attr_length;
         pkey += attr_length;
     }
-    return -2;//This means error happens
+    return result;
 }
 
 int BplusTreeHandler::compare_key(const char *pdata, const char *pkey) {
@@ -304,6 +515,21 @@ int BplusTreeHandler::compare_key_without_rid(const char *pdata, const char *pke
     return CompareKey(pdata, pkey, file_header_.attr_type, file_header_.attr_length, file_header_.attr_num);
 }
 
+int BplusTreeHandler::compare_key_prefix(const char *pdata, const char *pkey, int attr_num) {
+    return CompareKey(pdata, pkey, file_header_.attr_type, file_header_.attr_length,
+                      std::min(attr_num, file_header_.attr_num));
+}
+
+bool BplusTreeHandler::key_prefix_has_null(const char *pkey, int attr_num) {
+    for (int i = 0; i < attr_num && i < file_header_.attr_num; i++) {
+        if (*pkey == '!') {
+            return true;
+        }
+        pkey += file_header_.attr_length[i];
+    }
+    return false;
+}
+
 RC BplusTreeHandler::find_leaf(const char *pkey, PageNum *leaf_page) {
     RC rc;
     BPPageHandle page_handle;
@@ -905,6 +1131,10 @@ RC BplusTreeHandler::insert_entry(const char *pkey, const RID *rid) {
     if (nullptr == disk_buffer_pool_) {
         return RC::RECORD_CLOSED;
     }
+    if (disk_buffer_pool_->read_only()) {
+        LOG_WARN("Failed to insert entry, index file %d is read only.", file_id_);
+        return RC::READONLY;
+    }
     key = (char *) malloc(file_header_.key_length);
     if (key == nullptr) {
         LOG_ERROR("Failed to alloc memory for key. size=%d", file_header_.key_length);
@@ -1257,6 +1487,7 @@ RC BplusTreeHandler::redistribute_nodes(PageNum leaf_page, PageNum right_page) {
                 memcpy(right->rids + i, right->rids + i - 1, sizeof(RID));
             }
             memcpy(right->keys, left->keys + (left->key_num - 1) * file_header_.key_length, file_header_.key_length);
+            memcpy(right->rids, left->rids + left->key_num - 1, sizeof(RID));
 
             left->key_num--;
             right->key_num++;
@@ -1271,9 +1502,12 @@ RC BplusTreeHandler::redistribute_nodes(PageNum leaf_page, PageNum right_page) {
             left->key_num++;
 
             memcpy(parent->keys + k * file_header_.key_length, right->keys, file_header_.key_length);
+            // 内部节点的子节点比键值多一个
             for (i = 0; i < right->key_num - 1; i++) {
                 memcpy(right->keys + i * file_header_.key_length, right->keys + (i + 1) * file_header_.key_length,
                        file_header_.key_length);
+            }
+            for (i = 0; i < right->key_num; i++) {
                 memcpy(right->rids + i, right->rids + i + 1, sizeof(RID));
             }
             right->key_num--;
@@ -1300,6 +1534,8 @@ RC BplusTreeHandler::redistribute_nodes(PageNum leaf_page, PageNum right_page) {
             for (i = right->key_num; i > 0; i--) {
                 memcpy(right->keys + i * file_header_.key_length, right->keys + (i - 1) * file_header_.key_length,
                        file_header_.key_length);
+            }
+            for (i = right->key_num + 1; i > 0; i--) {
                 memcpy(right->rids + i, right->rids + i - 1, sizeof(RID));
             }
             memcpy(right->keys, parent->keys + k * file_header_.key_length, file_header_.key_length);
@@ -1546,6 +1782,10 @@ RC BplusTreeHandler::delete_entry(const char *data, const RID *rid) {
     RC rc;
     PageNum leaf_page;
     char *pkey;
+    if (disk_buffer_pool_->read_only()) {
+        LOG_WARN("Failed to delete entry, index file %d is read only.", file_id_);
+        return RC::READONLY;
+    }
     pkey = (char *) malloc(file_header_.key_length);
     if (nullptr == pkey) {
         LOG_ERROR("Failed to alloc memory for key. size=%d", file_header_.key_length);
@@ -1718,12 +1958,85 @@ RC BplusTreeHandler::find_first_index_satisfied(CompOp compop, const char *key,
 
         }
         next = node->rids[file_header_.order - 1].page_num;
+        rc = disk_buffer_pool_->unpin_page(&page_handle);
+        if (rc != SUCCESS) {
+            return rc;
+        }
     }
-    rc = disk_buffer_pool_->unpin_page(&page_handle);
+    return RC::RECORD_EOF;
+}
+
+RC BplusTreeHandler::find_first_index_of_bound(const char *key, int attr_num, bool inclusive, PageNum *page_num,
+                                               int *rididx) {
+    BPPageHandle page_handle;
+    char *pdata;
+    RC rc = disk_buffer_pool_->get_this_page(file_id_, file_header_.root_page, &page_handle);
     if (rc != SUCCESS) {
         return rc;
     }
-    return RC::RECORD_EOF;
+    rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+    if (rc != SUCCESS) {
+        disk_buffer_pool_->unpin_page(&page_handle);
+        return rc;
+    }
+
+    // 第i个孩子中的键值都小于第i个键值，前面的孩子中不会有满足条件的项
+    IndexNode *node = get_index_node(pdata);
+    while (0 == node->is_leaf) {
+        int i = 0;
+        for (; i < node->key_num; i++) {
+            int result = compare_key_prefix(node->keys + i * file_header_.key_length, key, attr_num);
+            if (result > 0 || (inclusive && result == 0)) {
+                break;
+            }
+        }
+        PageNum child = node->rids[i].page_num;
+        rc = disk_buffer_pool_->unpin_page(&page_handle);
+        if (rc != SUCCESS) {
+            return rc;
+        }
+        rc = disk_buffer_pool_->get_this_page(file_id_, child, &page_handle);
+        if (rc != SUCCESS) {
+            return rc;
+        }
+        rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+        if (rc != SUCCESS) {
+            disk_buffer_pool_->unpin_page(&page_handle);
+            return rc;
+        }
+        node = get_index_node(pdata);
+    }
+
+    // 找到的叶子节点中可能都是更小的键值，需要继续看后面的叶子节点
+    while (true) {
+        for (int i = 0; i < node->key_num; i++) {
+            int result = compare_key_prefix(node->keys + i * file_header_.key_length, key, attr_num);
+            if (result > 0 || (inclusive && result == 0)) {
+                rc = disk_buffer_pool_->get_page_num(&page_handle, page_num);
+                *rididx = i;
+                disk_buffer_pool_->unpin_page(&page_handle);
+                return rc;
+            }
+        }
+        PageNum next = node->rids[file_header_.order - 1].page_num;
+        rc = disk_buffer_pool_->unpin_page(&page_handle);
+        if (rc != SUCCESS) {
+            return rc;
+        }
+        if (next <= 0) {
+            return RC::RECORD_EOF;
+        }
+        rc = disk_buffer_pool_->get_this_page(file_id_, next, &page_handle);
+        if (rc != SUCCESS) {
+            return rc;
+        }
+        rc = disk_buffer_pool_->get_data(&page_handle, &pdata);
+        if (rc != SUCCESS) {
+            disk_buffer_pool_->unpin_page(&page_handle);
+            return rc;
+        }
+        node = get_index_node(pdata);
+    }
 }
 
 RC BplusTreeHandler::get_first_leaf_page(PageNum *leaf_page) {
@@ -1782,6 +2095,20 @@ RC BplusTreeScanner::open(CompOp comp_op, const char *value) {
         return RC::RECORD_OPENNED;
     }
 
+    const int attr_num = index_handler_.file_header_.attr_num;
+    switch (comp_op) {
+        case EQUAL_TO:
+            return open(value, attr_num, true, value, attr_num, true);
+        case GREAT_EQUAL:
+        case GREAT_THAN:
+            return open(value, attr_num, comp_op == GREAT_EQUAL, nullptr, 0, false);
+        case LESS_EQUAL:
+        case LESS_THAN:
+            return open(nullptr, 0, false, value, attr_num, comp_op == LESS_EQUAL);
+        default:
+            break;
+    }
+
     comp_op_ = comp_op;
 
     char *value_copy = (char *) malloc(index_handler_.file_header_.attrs_length);
@@ -1806,28 +2133,104 @@ RC BplusTreeScanner::open(CompOp comp_op, const char *value) {
     return SUCCESS;
 }
 
+static char *copy_bound(const char *key, int attrs_length) {
+    if (key == nullptr) {
+        return nullptr;
+    }
+    char *copy = (char *) malloc(attrs_length);
+    if (copy != nullptr) {
+        memcpy(copy, key, attrs_length);
+    }
+    return copy;
+}
+
+RC BplusTreeScanner::open(const char *left_key, int left_attr_num, bool left_inclusive,
+                          const char *right_key, int right_attr_num, bool right_inclusive) {
+    if (opened_) {
+        return RC::RECORD_OPENNED;
+    }
+
+    const int attrs_length = index_handler_.file_header_.attrs_length;
+    left_key_ = copy_bound(left_key, attrs_length);
+    right_key_ = copy_bound(right_key, attrs_length);
+    if ((left_key != nullptr && left_key_ == nullptr) || (right_key != nullptr && right_key_ == nullptr)) {
+        LOG_ERROR("Failed to alloc memory for scan bound. size=%d", attrs_length);
+        free(left_key_);
+        free(right_key_);
+        left_key_ = right_key_ = nullptr;
+        return RC::NOMEM;
+    }
+    left_attr_num_ = left_attr_num;
+    left_inclusive_ = left_inclusive;
+    right_attr_num_ = right_attr_num;
+    right_inclusive_ = right_inclusive;
+    range_scan_ = true;
+
+    RC rc = RC::SUCCESS;
+    if ((left_key_ != nullptr && index_handler_.key_prefix_has_null(left_key_, left_attr_num_)) ||
+        (right_key_ != nullptr && index_handler_.key_prefix_has_null(right_key_, right_attr_num_))) {
+        // 与空值比较的结果总是false
+        rc = RC::RECORD_EOF;
+    } else if (left_key_ != nullptr) {
+        rc = index_handler_.find_first_index_of_bound(left_key_, left_attr_num_, left_inclusive_, &next_page_num_,
+                                                      &index_in_node_);
+    } else {
+        rc = index_handler_.get_first_leaf_page(&next_page_num_);
+        index_in_node_ = 0;
+    }
+    if (rc == RC::RECORD_EOF) {
+        next_page_num_ = -1;
+        index_in_node_ = -1;
+    } else if (rc != SUCCESS) {
+        free(left_key_);
+        free(right_key_);
+        left_key_ = right_key_ = nullptr;
+        range_scan_ = false;
+        return rc;
+    }
+
+    num_fixed_pages_ = 1;
+    next_index_of_page_handle_ = 0;
+    pinned_page_count_ = 0;
+    opened_ = true;
+    return SUCCESS;
+}
+
 RC BplusTreeScanner::close() {
     if (!opened_) {
         return RC::RECORD_SCANCLOSED;
     }
+    for (int i = 0; i < pinned_page_count_; i++) {
+        index_handler_.disk_buffer_pool_->unpin_page(page_handles_ + i);
+    }
+    pinned_page_count_ = 0;
     free((void *) value_);
     value_ = nullptr;
+    free(left_key_);
+    left_key_ = nullptr;
+    free(right_key_);
+    right_key_ = nullptr;
+    range_scan_ = false;
     opened_ = false;
     return RC::SUCCESS;
 }
 
 RC BplusTreeScanner::next_entry(RID *rid) {
+    return next_entry(rid, nullptr);
+}
+
+RC BplusTreeScanner::next_entry(RID *rid, char *key) {
     RC rc;
     if (!opened_) {
         return RC::RECORD_CLOSED;
     }
-    rc = get_next_idx_in_memory(rid);//和RM中一样，有可能有错误，一次只查当前页和当前页的下一页，有待确定
+    rc = get_next_idx_in_memory(rid, key);//和RM中一样，有可能有错误，一次只查当前页和当前页的下一页，有待确定
     if (rc == RC::RECORD_NO_MORE_IDX_IN_MEM) {
         rc = find_idx_pages();
         if (rc != SUCCESS) {
             return rc;
         }
-        return get_next_idx_in_memory(rid);
+        return get_next_idx_in_memory(rid, key);
     } else {
         if (rc != SUCCESS) {
             return rc;
@@ -1875,7 +2278,7 @@ RC BplusTreeScanner::find_idx_pages() {
     return RC::RECORD_EOF;
 }
 
-RC BplusTreeScanner::get_next_idx_in_memory(RID *rid) {
+RC BplusTreeScanner::get_next_idx_in_memory(RID *rid, char *key) {
     char *pdata;
     IndexNode *node;
     RC rc;
@@ -1895,8 +2298,18 @@ RC BplusTreeScanner::get_next_idx_in_memory(RID *rid) {
         }
         node = index_handler_.get_index_node(pdata);
         for (; index_in_node_ < node->key_num; index_in_node_++) {
-            if (satisfy_condition(node->keys + index_in_node_ * index_handler_.file_header_.key_length)) {
+            const char *pkey = node->keys + index_in_node_ * index_handler_.file_header_.key_length;
+            if (past_last_satisfied(pkey)) {
+                // 键值有序，后面不会再有满足条件的索引项
+                next_page_num_ = -1;
+                index_in_node_ = -1;
+                return RC::RECORD_EOF;
+            }
+            if (satisfy_condition(pkey)) {
                 memcpy(rid, node->rids + index_in_node_, sizeof(RID));
+                if (key != nullptr) {
+                    memcpy(key, pkey, index_handler_.file_header_.attrs_length);
+                }
                 index_in_node_++;
                 return SUCCESS;
             }
@@ -1908,7 +2321,38 @@ RC BplusTreeScanner::get_next_idx_in_memory(RID *rid) {
 }
 
 
+bool BplusTreeScanner::past_last_satisfied(const char *pkey) {
+    // 空值按照原始的字节参与排序，遇到空值时不能确定后面没有满足条件的项
+    if (!range_scan_ || right_key_ == nullptr || index_handler_.key_prefix_has_null(pkey, right_attr_num_)) {
+        return false;
+    }
+    int result = index_handler_.compare_key_prefix(pkey, right_key_, right_attr_num_);
+    return result > 0 || (result == 0 && !right_inclusive_);
+}
+
+bool BplusTreeScanner::satisfy_range(const char *pkey) {
+    if (index_handler_.key_prefix_has_null(pkey, std::max(left_attr_num_, right_attr_num_))) {
+        return false;
+    }
+    if (left_key_ != nullptr) {
+        int result = index_handler_.compare_key_prefix(pkey, left_key_, left_attr_num_);
+        if (result < 0 || (result == 0 && !left_inclusive_)) {
+            return false;
+        }
+    }
+    if (right_key_ != nullptr) {
+        int result = index_handler_.compare_key_prefix(pkey, right_key_, right_attr_num_);
+        if (result > 0 || (result == 0 && !right_inclusive_)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool BplusTreeScanner::satisfy_condition(const char *pkey) {
+    if (range_scan_) {
+        return satisfy_range(pkey);
+    }
     if (comp_op_ == NO_OP) {
         return true;
     }
@@ -1929,7 +2373,7 @@ bool BplusTreeScanner::satisfy_condition(const char *pkey) {
         int result = CompareKey(pkey, value_, index_handler_.file_header_.attr_type, index_handler_.file_header_.attr_length, index_handler_.file_header_.attr_num);
         if (result == 0 && (comp_op_ == EQUAL_TO || comp_op_ == GREAT_EQUAL || comp_op_ == LESS_EQUAL)) {
             return true;
-        } else if (result == -1 && (comp_op_ == LESS_THAN || comp_op_ == LESS_THAN || comp_op_ == NOT_EQUAL)) {
+        } else if (result == -1 && (comp_op_ == LESS_THAN || comp_op_ == LESS_EQUAL || comp_op_ == NOT_EQUAL)) {
             return true;
         } else if (result == 1 && (comp_op_ == GREAT_THAN || comp_op_ == GREAT_EQUAL || comp_op_ == NOT_EQUAL)) {
             return true;
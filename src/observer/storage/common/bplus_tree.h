@@ -59,6 +59,9 @@ struct Tree {
     TreeNode *root;
 };
 
+/**
+ * 索引页面不加页帧的读写锁，同一个索引上的读写需要由调用方串行执行
+ */
 class BplusTreeHandler {
 public:
     /**
@@ -101,10 +104,26 @@ public:
 
     RC sync();
 
+    /**
+     * 在刚创建的空索引上自底向上构建B+树。next_key按照compare_key的顺序依次返回entry_num个键值(包含rid)，
+     * 叶子节点和内部节点按照fill_factor(百分比)填充，留出的空间给以后的插入
+     */
+    RC bulk_load(int entry_num, int fill_factor, const std::function<RC(const char *&key)> &next_key);
+
     int compare_key(const char *pdata, const char *pkey);
 
     int compare_key_without_rid(const char *pdata, const char *pkey);
 
+    /**
+     * 只比较键值的前attr_num个字段
+     */
+    int compare_key_prefix(const char *pdata, const char *pkey, int attr_num);
+
+    /**
+     * 键值的前attr_num个字段中是否有空值
+     */
+    bool key_prefix_has_null(const char *pkey, int attr_num);
+
 public:
     RC print();
 
@@ -135,11 +154,23 @@ protected:
 
     RC find_first_index_satisfied(CompOp comp_op, const char *pkey, PageNum *page_num, int *rididx);
 
+    /**
+     * 从根节点开始查找第一个前attr_num个字段大于等于key的索引项，inclusive为false时查找大于key的索引项
+     */
+    RC find_first_index_of_bound(const char *key, int attr_num, bool inclusive, PageNum *page_num, int *rididx);
+
     RC get_first_leaf_page(PageNum *leaf_page);
 
 private:
     IndexNode *get_index_node(char *page_data) const;
 
+    /**
+     * 把内存中的文件头写回第一页
+     */
+    RC write_header();
+
+    RC set_parent(PageNum page_num, PageNum parent);
+
 private:
     DiskBufferPool *disk_buffer_pool_ = nullptr;
     int file_id_ = -1;
@@ -148,6 +179,7 @@ private:
 
 private:
     friend class BplusTreeScanner;
+    friend class BplusTreeBuilder;
 };
 
 class BplusTreeScanner {
@@ -157,16 +189,28 @@ public:
     /**
      * 用于在indexHandle对应的索引上初始化一个基于条件的扫描。
      * compOp和*value指定比较符和比较值，indexScan为初始化后的索引扫描结构指针
-     * 没有带两个边界的范围扫描
+     * 比较符是=、<、<=、>、>=时按范围扫描
      */
     RC open(CompOp comp_op, const char *value);
 
+    /**
+     * 范围扫描。left_key/right_key为nullptr时表示这一边没有边界，
+     * 否则只比较键值的前left_attr_num/right_attr_num个字段，用来在复合索引上按前缀查找
+     */
+    RC open(const char *left_key, int left_attr_num, bool left_inclusive,
+            const char *right_key, int right_attr_num, bool right_inclusive);
+
     /**
      * 用于继续索引扫描，获得下一个满足条件的索引项，
      * 并返回该索引项对应的记录的ID
      */
     RC next_entry(RID *rid);
 
+    /**
+     * 同时取出索引项中的字段值，key的长度是所有索引字段的长度之和
+     */
+    RC next_entry(RID *rid, char *key);
+
     /**
      * 关闭一个索引扫描，释放相应的资源
      */
@@ -179,17 +223,31 @@ public:
     // RC getIndexTree(char *fileName, Tree *index);
 
 private:
-    RC get_next_idx_in_memory(RID *rid);
+    RC get_next_idx_in_memory(RID *rid, char *key);
 
     RC find_idx_pages();
 
     bool satisfy_condition(const char *key);
 
+    /**
+     * 范围扫描时键值已经超过了右边界
+     */
+    bool past_last_satisfied(const char *key);
+
+    bool satisfy_range(const char *key);
+
 private:
     BplusTreeHandler &index_handler_;
     bool opened_ = false;
     CompOp comp_op_ = NO_OP;                      // 用于比较的操作符
     const char *value_ = nullptr;                 // 与属性行比较的值
+    bool range_scan_ = false;                     // 按照左右边界扫描，不使用comp_op_和value_
+    char *left_key_ = nullptr;                    // 左边界，nullptr表示没有
+    int left_attr_num_ = 0;
+    bool left_inclusive_ = true;
+    char *right_key_ = nullptr;                   // 右边界，nullptr表示没有
+    int right_attr_num_ = 0;
+    bool right_inclusive_ = true;
     int num_fixed_pages_ = -1;                    // 固定在缓冲区中的页，与指定的页面固定策略有关
     int pinned_page_count_ = 0;                   // 实际固定在缓冲区的页面数
     BPPageHandle page_handles_[BP_BUFFER_SIZE];   // 固定在缓冲区页面所对应的页面操作列表
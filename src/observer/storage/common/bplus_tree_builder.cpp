@@ -0,0 +1,332 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "storage/common/bplus_tree_builder.h"
+#include "common/log/log.h"
+#include "common/os/path.h"
+
+const int IndexBuildOptions::DEFAULT_FILL_FACTOR;
+const size_t IndexBuildOptions::DEFAULT_MEMORY_LIMIT;
+const int KeyRun::BUFFER_SIZE;
+
+KeyRun::~KeyRun() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+RC KeyRun::create(const std::string &temp_dir, int key_length) {
+    std::string dir = temp_dir;
+    if (!common::check_directory(dir)) {
+        LOG_ERROR("Failed to create temporary directory %s for building index.", temp_dir.c_str());
+        return RC::IOERR;
+    }
+    std::string path = dir + "/index_run_XXXXXX";
+    std::vector<char> path_buf(path.begin(), path.end());
+    path_buf.push_back('\0');
+    fd_ = mkstemp(path_buf.data());
+    if (fd_ < 0) {
+        LOG_ERROR("Failed to create temporary file for building index in %s. error=%s", dir.c_str(), strerror(errno));
+        return RC::IOERR;
+    }
+    // 只通过fd访问，关闭后文件就被回收
+    ::unlink(path_buf.data());
+
+    key_length_ = key_length;
+    buffer_.clear();
+    buffer_.reserve(std::max(BUFFER_SIZE / key_length, 1) * key_length);
+    return RC::SUCCESS;
+}
+
+RC KeyRun::append(const char *key) {
+    buffer_.insert(buffer_.end(), key, key + key_length_);
+    if (buffer_.size() == buffer_.capacity()) {
+        return flush();
+    }
+    return RC::SUCCESS;
+}
+
+RC KeyRun::flush() {
+    if (::write(fd_, buffer_.data(), buffer_.size()) != (ssize_t) buffer_.size()) {
+        LOG_ERROR("Failed to write index run. error=%s", strerror(errno));
+        return RC::IOERR_WRITE;
+    }
+    buffer_.clear();
+    return RC::SUCCESS;
+}
+
+RC KeyRun::finish() {
+    if (!buffer_.empty()) {
+        RC rc = flush();
+        if (rc != RC::SUCCESS) {
+            return rc;
+        }
+    }
+    if (::lseek(fd_, 0, SEEK_SET) < 0) {
+        LOG_ERROR("Failed to seek index run. error=%s", strerror(errno));
+        return RC::IOERR_SEEK;
+    }
+    pos_ = 0;
+    return RC::SUCCESS;
+}
+
+RC KeyRun::next(const char *&key) {
+    if (pos_ >= buffer_.size()) {
+        buffer_.resize(buffer_.capacity());
+        ssize_t ret = ::read(fd_, buffer_.data(), buffer_.size());
+        if (ret < 0 || ret % key_length_ != 0) {
+            LOG_ERROR("Failed to read index run. ret=%d, error=%s", (int) ret, strerror(errno));
+            return RC::IOERR_READ;
+        }
+        buffer_.resize(ret);
+        pos_ = 0;
+        if (ret == 0) {
+            return RC::RECORD_EOF;
+        }
+    }
+    key = buffer_.data() + pos_;
+    pos_ += key_length_;
+    return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+BplusTreeBuilder::BplusTreeBuilder(BplusTreeHandler &handler, const IndexBuildOptions &options, bool unique)
+        : handler_(handler), options_(options), key_length_(handler.file_header_.key_length), unique_(unique) {
+    // 每一项除了键值，排序时还需要一个指针
+    max_entry_num_ = std::max(options_.memory_limit / (key_length_ + sizeof(const char *)), (size_t) 1);
+    current_key_.resize(key_length_);
+}
+
+BplusTreeBuilder::~BplusTreeBuilder() {
+    for (KeyRun *run : runs_) {
+        delete run;
+    }
+    runs_.clear();
+}
+
+RC BplusTreeBuilder::add_entry(const char *pkey, const RID *rid) {
+    // vector按倍数扩容，自己控制容量，保证按容量计算的内存也不超过限制。容量已经到达限制时先写到临时文件
+    if (entries_.size() + key_length_ > entries_.capacity()) {
+        const size_t entry_capacity = entries_.capacity() / key_length_;
+        if (entry_capacity >= max_entry_num_) {
+            RC rc = spill();
+            if (rc != RC::SUCCESS) {
+                return rc;
+            }
+        } else {
+            entries_.reserve(std::min(std::max(entry_capacity * 2, (size_t) 64), max_entry_num_) * key_length_);
+        }
+    }
+
+    const int attrs_length = handler_.file_header_.attrs_length;
+    entries_.insert(entries_.end(), pkey, pkey + attrs_length);
+    entries_.insert(entries_.end(), (const char *) rid, (const char *) rid + sizeof(RID));
+    entry_num_++;
+    return RC::SUCCESS;
+}
+
+void BplusTreeBuilder::sort_entries() {
+    sorted_.clear();
+    sorted_.reserve(entries_.size() / key_length_);
+    for (size_t offset = 0; offset < entries_.size(); offset += key_length_) {
+        sorted_.push_back(entries_.data() + offset);
+    }
+    // 键值中包含rid，不会有相等的两项
+    std::sort(sorted_.begin(), sorted_.end(),
+              [this](const char *left, const char *right) { return handler_.compare_key(left, right) < 0; });
+    pos_ = 0;
+}
+
+RC BplusTreeBuilder::spill() {
+    sort_entries();
+
+    KeyRun *run = new KeyRun;
+    RC rc = run->create(options_.temp_dir, key_length_);
+    for (size_t i = 0; rc == RC::SUCCESS && i < sorted_.size(); i++) {
+        rc = run->append(sorted_[i]);
+    }
+    if (rc == RC::SUCCESS) {
+        rc = run->finish();
+    }
+    if (rc != RC::SUCCESS) {
+        delete run;
+        return rc;
+    }
+    runs_.push_back(run);
+    spilled_run_num_++;
+    entries_.clear();
+    sorted_.clear();
+    return RC::SUCCESS;
+}
+
+bool BplusTreeBuilder::less(int left_way, int right_way) const {
+    // 读完的一路比所有数据都大
+    if (exhausted_[left_way] || exhausted_[right_way]) {
+        if (exhausted_[left_way] && exhausted_[right_way]) {
+            return left_way < right_way;
+        }
+        return exhausted_[right_way];
+    }
+    return handler_.compare_key(heads_[left_way], heads_[right_way]) < 0;
+}
+
+RC BplusTreeBuilder::merge(size_t first, size_t last, KeyRun *output) {
+    int way_num = (int) (last - first);
+    heads_.assign(way_num, nullptr);
+    exhausted_.assign(way_num, false);
+    for (int way = 0; way < way_num; way++) {
+        RC rc = runs_[first + way]->next(heads_[way]);
+        if (rc == RC::RECORD_EOF) {
+            exhausted_[way] = true;
+        } else if (rc != RC::SUCCESS) {
+            return rc;
+        }
+    }
+    loser_tree_.init(way_num, [this](int left, int right) { return less(left, right); });
+    if (output == nullptr) {
+        // 最后一轮归并由next_merged_key逐项取出
+        return RC::SUCCESS;
+    }
+
+    while (!exhausted_[loser_tree_.top()]) {
+        int way = loser_tree_.top();
+        RC rc = output->append(heads_[way]);
+        if (rc != RC::SUCCESS) {
+            return rc;
+        }
+        rc = runs_[first + way]->next(heads_[way]);
+        if (rc == RC::RECORD_EOF) {
+            exhausted_[way] = true;
+        } else if (rc != RC::SUCCESS) {
+            return rc;
+        }
+        loser_tree_.adjust(way);
+    }
+    return output->finish();
+}
+
+RC BplusTreeBuilder::start_merge() {
+    // 每一路读的时候需要一块缓存，路数太多时先把相邻的有序段归并成更长的有序段
+    size_t max_way_num = std::max(options_.memory_limit / (2 * KeyRun::BUFFER_SIZE), (size_t) 2);
+    while (runs_.size() > max_way_num) {
+        std::vector<KeyRun *> merged_runs;
+        for (size_t first = 0; first < runs_.size(); first += max_way_num) {
+            size_t last = std::min(first + max_way_num, runs_.size());
+            KeyRun *run = new KeyRun;
+            RC rc = run->create(options_.temp_dir, key_length_);
+            if (rc == RC::SUCCESS) {
+                rc = merge(first, last, run);
+            }
+            if (rc != RC::SUCCESS) {
+                delete run;
+                for (KeyRun *merged_run : merged_runs) {
+                    delete merged_run;
+                }
+                return rc;
+            }
+            merged_runs.push_back(run);
+        }
+        for (KeyRun *run : runs_) {
+            delete run;
+        }
+        runs_.swap(merged_runs);
+    }
+    return merge(0, runs_.size(), nullptr);
+}
+
+RC BplusTreeBuilder::next_merged_key(const char *&key) {
+    int way = loser_tree_.top();
+    if (exhausted_[way]) {
+        return RC::RECORD_EOF;
+    }
+    // 读取下一项后heads_中的数据就会被覆盖
+    memcpy(current_key_.data(), heads_[way], key_length_);
+    key = current_key_.data();
+    RC rc = runs_[way]->next(heads_[way]);
+    if (rc == RC::RECORD_EOF) {
+        exhausted_[way] = true;
+    } else if (rc != RC::SUCCESS) {
+        return rc;
+    }
+    loser_tree_.adjust(way);
+    return RC::SUCCESS;
+}
+
+bool BplusTreeBuilder::has_null(const char *key) const {
+    const IndexFileHeader &header = handler_.file_header_;
+    int offset = 0;
+    for (int i = 0; i < header.attr_num; i++) {
+        if (key[offset] == '!') {
+            return true;
+        }
+        offset += header.attr_length[i];
+    }
+    return false;
+}
+
+RC BplusTreeBuilder::check_unique(const char *key) {
+    if (!unique_ || has_null(key)) {
+        return RC::SUCCESS;
+    }
+    if (!previous_key_.empty() && handler_.compare_key_without_rid(previous_key_.data(), key) == 0) {
+        LOG_WARN("Found duplicate keys while building unique index.");
+        return RC::UNIQUEINDEX_CONFLICT;
+    }
+    previous_key_.assign(key, key + key_length_);
+    return RC::SUCCESS;
+}
+
+RC BplusTreeBuilder::finish() {
+    RC rc = RC::SUCCESS;
+    std::function<RC(const char *&)> next_key;
+    if (runs_.empty()) {
+        sort_entries();
+        next_key = [this](const char *&key) {
+            if (pos_ >= sorted_.size()) {
+                return RC::RECORD_EOF;
+            }
+            key = sorted_[pos_++];
+            return check_unique(key);
+        };
+    } else {
+        if (!entries_.empty()) {
+            rc = spill();
+        }
+        // 归并时每一路有自己的缓存，不再需要内存中的索引项
+        std::vector<char>().swap(entries_);
+        std::vector<const char *>().swap(sorted_);
+        if (rc == RC::SUCCESS) {
+            rc = start_merge();
+        }
+        if (rc != RC::SUCCESS) {
+            LOG_ERROR("Failed to merge the sorted index runs. rc=%d:%s", rc, strrc(rc));
+            return rc;
+        }
+        next_key = [this](const char *&key) {
+            RC rc = next_merged_key(key);
+            return rc == RC::SUCCESS ? check_unique(key) : rc;
+        };
+    }
+
+    rc = handler_.bulk_load(entry_num_, options_.fill_factor, next_key);
+    if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to load %d entries into the index. rc=%d:%s", entry_num_, rc, strrc(rc));
+    }
+    std::vector<char>().swap(entries_);
+    std::vector<const char *>().swap(sorted_);
+    return rc;
+}
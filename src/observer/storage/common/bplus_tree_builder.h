@@ -0,0 +1,139 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_BPLUS_TREE_BUILDER_H_
+#define __OBSERVER_STORAGE_COMMON_BPLUS_TREE_BUILDER_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "rc.h"
+#include "storage/common/bplus_tree.h"
+#include "sql/executor/external_sort.h"
+
+/**
+ * 在已有数据上创建索引时的参数，来自配置文件中DefaultStorageStage的IndexFillFactor和IndexSortMemoryLimit
+ */
+struct IndexBuildOptions {
+    static const int DEFAULT_FILL_FACTOR = 90;
+    static const size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+    int fill_factor = DEFAULT_FILL_FACTOR;       // B+树节点填充的百分比
+    size_t memory_limit = DEFAULT_MEMORY_LIMIT;  // 排序使用的内存，超过后把排好序的索引项写到临时文件中
+    std::string temp_dir = ".";
+};
+
+/**
+ * 临时文件中一段有序的索引项，每一项是定长的键值(包含rid)。文件创建后立即删除
+ */
+class KeyRun {
+public:
+    static const int BUFFER_SIZE = 64 * 1024;
+
+    KeyRun() = default;
+    ~KeyRun();
+
+    RC create(const std::string &temp_dir, int key_length);
+    RC append(const char *key);
+
+    /**
+     * 写完所有数据后调用，之后就可以从头读取
+     */
+    RC finish();
+
+    /**
+     * 读取下一项，key在下一次调用前有效。没有更多数据时返回RECORD_EOF
+     */
+    RC next(const char *&key);
+
+private:
+    RC flush();
+
+private:
+    int fd_ = -1;
+    int key_length_ = 0;
+    std::vector<char> buffer_;
+    size_t pos_ = 0;  // 读的时候下一项在buffer_中的位置
+};
+
+/**
+ * 批量构建B+树。加入所有的索引项后排序，超过内存限制时把排好序的一段写到临时文件中，最后用
+ * external_sort.h中的LoserTree归并。然后按顺序填满叶子节点，再逐层构建内部节点，
+ * 不需要每一项都从根节点查找和分裂节点
+ */
+class BplusTreeBuilder {
+public:
+    /**
+     * @param unique 唯一索引。排好序后相同的键值一定相邻，构建时比较相邻的两项，含有空值的键值不检查
+     */
+    BplusTreeBuilder(BplusTreeHandler &handler, const IndexBuildOptions &options, bool unique = false);
+    ~BplusTreeBuilder();
+
+    /**
+     * @param pkey 所有索引字段的值
+     */
+    RC add_entry(const char *pkey, const RID *rid);
+
+    /**
+     * 排序所有的索引项并构建B+树。唯一索引有重复的键值时返回UNIQUEINDEX_CONFLICT
+     */
+    RC finish();
+
+    int entry_num() const { return entry_num_; }
+
+    /**
+     * 写到临时文件中的有序段的个数，没有超过内存限制时为0
+     */
+    int spilled_run_num() const { return spilled_run_num_; }
+
+    /**
+     * 内存中的索引项和排序用的指针按容量计算占用的内存，不会超过memory_limit
+     */
+    size_t memory_used() const {
+        return entries_.capacity() + sorted_.capacity() * sizeof(const char *);
+    }
+
+private:
+    void sort_entries();
+    RC spill();
+    RC merge(size_t first, size_t last, KeyRun *output);
+    RC start_merge();
+    bool less(int left_way, int right_way) const;
+    RC next_merged_key(const char *&key);
+    bool has_null(const char *key) const;
+
+    /**
+     * 唯一索引中key与上一项的键值(不含rid)相同时返回UNIQUEINDEX_CONFLICT
+     */
+    RC check_unique(const char *key);
+
+private:
+    BplusTreeHandler &handler_;
+    IndexBuildOptions options_;
+    int key_length_;
+    bool unique_;
+    size_t max_entry_num_;  // 内存中最多保存的索引项个数
+
+    std::vector<char> entries_;
+    std::vector<const char *> sorted_;
+    size_t pos_ = 0;
+    int entry_num_ = 0;
+
+    std::vector<KeyRun *> runs_;
+    int spilled_run_num_ = 0;
+    std::vector<const char *> heads_;  // 每一路当前最小的索引项
+    std::vector<bool> exhausted_;
+    LoserTree loser_tree_;
+    std::vector<char> current_key_;
+    std::vector<char> previous_key_;  // 唯一索引检查时上一项的键值，空表示还没有
+};
+
+#endif //__OBSERVER_STORAGE_COMMON_BPLUS_TREE_BUILDER_H_
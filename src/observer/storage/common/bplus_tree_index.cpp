@@ -17,6 +17,7 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 
 BplusTreeIndex::~BplusTreeIndex() noexcept {
+    delete builder_;
     close();
 }
 
@@ -66,40 +67,83 @@ RC BplusTreeIndex::close() {
     return RC::SUCCESS;
 }
 
-RC BplusTreeIndex::insert_entry(const char *record, const RID *rid) {
+std::string BplusTreeIndex::make_key(const char *record) const {
     std::string key;
     for (auto &field_meta : fields_meta_) {
         std::string tmp(record + field_meta.offset(), field_meta.len());
         key += tmp;
     }
-    if (index_meta_.unique()) {
-        if(key!="!null"){ // null key can be not unique
-            if (unique_conflict(key)) {
-                return RC::UNIQUEINDEX_CONFLICT;
-            } else {
-                unique2Key_[key]++;
-            }
+    return key;
+}
+
+bool BplusTreeIndex::has_null(const std::string &key) const {
+    size_t offset = 0;
+    for (auto &field_meta : fields_meta_) {
+        if (key[offset] == '!') {
+            return true;
         }
+        offset += field_meta.len();
+    }
+    return false;
+}
+
+RC BplusTreeIndex::insert_entry(const char *record, const RID *rid) {
+    std::string key = make_key(record);
+    if (index_meta_.unique() && unique_conflict(key)) {
+        return RC::UNIQUEINDEX_CONFLICT;
     }
     return index_handler_.insert_entry(key.c_str(), rid);
 }
 
-RC BplusTreeIndex::delete_entry(const char *record, const RID *rid) {
-    std::string key;
-    for (auto &field_meta : fields_meta_) {
-        std::string tmp(record + field_meta.offset(), field_meta.len());
-        key += tmp;
+RC BplusTreeIndex::begin_load(const IndexBuildOptions &options) {
+    if (!inited_) {
+        return RC::RECORD_CLOSED;
     }
-    if (index_meta_.unique()) {
-        if (unique_conflict(key)) {
-            unique2Key_[key]--;
-        }
+    delete builder_;
+    builder_ = new BplusTreeBuilder(index_handler_, options, index_meta_.unique());
+    return RC::SUCCESS;
+}
+
+RC BplusTreeIndex::load_entry(const char *record, const RID *rid) {
+    if (builder_ == nullptr) {
+        return RC::RECORD_CLOSED;
+    }
+    std::string key = make_key(record);
+    return builder_->add_entry(key.c_str(), rid);
+}
+
+RC BplusTreeIndex::end_load() {
+    if (builder_ == nullptr) {
+        return RC::RECORD_CLOSED;
     }
+    RC rc = builder_->finish();
+    if (rc == RC::SUCCESS) {
+        LOG_INFO("Loaded %d entries into index %s with %d sorted runs spilled",
+                 builder_->entry_num(), index_meta_.name(), builder_->spilled_run_num());
+    }
+    delete builder_;
+    builder_ = nullptr;
+    return rc;
+}
+
+RC BplusTreeIndex::delete_entry(const char *record, const RID *rid) {
+    std::string key = make_key(record);
     return index_handler_.delete_entry(key.c_str(), rid);
 }
 
 bool BplusTreeIndex::unique_conflict(std::string key) {
-    return unique2Key_.count(key);
+    // 含有空值的键值可以重复
+    if (has_null(key)) {
+        return false;
+    }
+    BplusTreeScanner scanner(index_handler_);
+    if (scanner.open(EQUAL_TO, key.c_str()) != RC::SUCCESS) {
+        return false;
+    }
+    RID rid;
+    const bool found = scanner.next_entry(&rid) == RC::SUCCESS;
+    scanner.close();
+    return found;
 }
 
 IndexScanner *BplusTreeIndex::create_scanner(CompOp comp_op, const char *value) {
@@ -115,6 +159,22 @@ IndexScanner *BplusTreeIndex::create_scanner(CompOp comp_op, const char *value)
     return index_scanner;
 }
 
+IndexScanner *BplusTreeIndex::create_scanner(const IndexScanRange &range) {
+    BplusTreeScanner *bplus_tree_scanner = new BplusTreeScanner(index_handler_);
+    RC rc = bplus_tree_scanner->open(range.left_attr_num > 0 ? range.left_key.data() : nullptr, range.left_attr_num,
+                                     range.left_inclusive,
+                                     range.right_attr_num > 0 ? range.right_key.data() : nullptr, range.right_attr_num,
+                                     range.right_inclusive);
+    if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to open index scanner. rc=%d:%s", rc, strrc(rc));
+        delete bplus_tree_scanner;
+        return nullptr;
+    }
+
+    BplusTreeIndexScanner *index_scanner = new BplusTreeIndexScanner(bplus_tree_scanner);
+    return index_scanner;
+}
+
 RC BplusTreeIndex::sync() {
     return index_handler_.sync();
 }
@@ -133,6 +193,10 @@ RC BplusTreeIndexScanner::next_entry(RID *rid) {
     return tree_scanner_->next_entry(rid);
 }
 
+RC BplusTreeIndexScanner::next_entry(RID *rid, char *key) {
+    return tree_scanner_->next_entry(rid, key);
+}
+
 RC BplusTreeIndexScanner::destroy() {
     delete this;
     return RC::SUCCESS;
@@ -17,7 +17,7 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/common/index.h"
 #include "storage/common/bplus_tree.h"
-#include <unordered_map>
+#include "storage/common/bplus_tree_builder.h"
 #include <vector>
 
 class BplusTreeIndex : public Index {
@@ -36,18 +36,36 @@ public:
 
     RC delete_entry(const char *record, const RID *rid) override;
 
+    /**
+     * 在刚创建的空索引上批量插入已有的记录：begin_load之后用load_entry加入所有的记录，
+     * 最后end_load排序并自底向上构建B+树
+     */
+    RC begin_load(const IndexBuildOptions &options);
+    RC load_entry(const char *record, const RID *rid);
+    RC end_load();
+
     IndexScanner *create_scanner(CompOp comp_op, const char *value) override;
 
+    IndexScanner *create_scanner(const IndexScanRange &range) override;
+
     bool unique_conflict(std::string key) override;
 
     int compare_key(const char *key1, const char *key2);
 
     RC sync() override;
 
+private:
+    std::string make_key(const char *record) const;
+
+    /**
+     * 键值中有字段是空值
+     */
+    bool has_null(const std::string &key) const;
+
 private:
     bool inited_ = false;
     BplusTreeHandler index_handler_;
-    std::unordered_map<std::string, int> unique2Key_;
+    BplusTreeBuilder *builder_ = nullptr;
 };
 
 class BplusTreeIndexScanner : public IndexScanner {
@@ -58,6 +76,8 @@ public:
 
     RC next_entry(RID *rid) override;
 
+    RC next_entry(RID *rid, char *key) override;
+
     RC destroy() override;
 
 private:
@@ -443,6 +443,9 @@ bool DefaultConditionFilter::filter_composed(const Record &rec, CompOp comp_op,
 
 CompositeConditionFilter::~CompositeConditionFilter() {
     if (memory_owner_) {
+        for (int i = 0; i < filter_num_; i++) {
+            delete filters_[i];
+        }
         delete[] filters_;
         filters_ = nullptr;
     }
@@ -70,6 +70,14 @@ public:
     return comp_op_;
   }
 
+  AttrType left_attr_type() const {
+    return left_attr_type_;
+  }
+
+  AttrType right_attr_type() const {
+    return right_attr_type_;
+  }
+
 private:
   ConDesc  left_;
   ConDesc  right_;
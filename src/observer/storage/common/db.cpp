@@ -101,6 +101,18 @@ RC Db::drop_table(const char *table_name){
         LOG_ERROR("Fail to remove file %s, due to %s.", table_name, strerror(errno));
         return RC::IOERR_DELETE;
     }
+    // remove("name.fsm")
+    std::string fsm_file = std::string(path_) + "/" + table_name + TABLE_FSM_SUFFIX;
+    if(remove(fsm_file.c_str())!=0 && errno != ENOENT){
+        LOG_ERROR("Fail to remove file %s, due to %s.", table_name, strerror(errno));
+        return RC::IOERR_DELETE;
+    }
+    // remove("name.stats")，没有执行过ANALYZE TABLE时不存在
+    std::string stats_file = table_stats_file(path_.c_str(), table_name);
+    if(remove(stats_file.c_str())!=0 && errno != ENOENT){
+        LOG_ERROR("Fail to remove file %s, due to %s.", table_name, strerror(errno));
+        return RC::IOERR_DELETE;
+    }
     
     LOG_INFO("Drop table success. table name=%s", table_name);
     return RC::SUCCESS;
@@ -30,6 +30,8 @@ const char *ATTR_TYPE_NAME[] = {
   "ints",
   "floats",
   "dates",
+  "nulls",
+  "texts",
 };
 
 const char *attr_type_to_string(AttrType type) {
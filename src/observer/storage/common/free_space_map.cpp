@@ -0,0 +1,180 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/common/free_space_map.h"
+#include <algorithm>
+
+#include "common/log/log.h"
+
+using namespace common;
+
+FreeSpaceMap::~FreeSpaceMap()
+{
+  close();
+}
+
+RC FreeSpaceMap::init(DiskBufferPool &buffer_pool, int file_id)
+{
+  int page_count = 0;
+  RC rc = buffer_pool.get_page_count(file_id, &page_count);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to get page count of free space map file %d. rc=%d:%s", file_id, rc, strrc(rc));
+    return rc;
+  }
+  int page_size = 0;
+  buffer_pool.get_page_size(file_id, &page_size);
+
+  disk_buffer_pool_ = &buffer_pool;
+  file_id_ = file_id;
+  entries_per_page_ = page_size - (int)sizeof(PageNum);
+  empty_ = page_count <= 1;
+  classes_.clear();
+  for (std::vector<PageNum> &bucket : buckets_) {
+    bucket.clear();
+  }
+
+  // 第0页是buffer pool的文件头，从第1页开始每页记录entries_per_page_个数据页
+  for (PageNum i = 1; i < page_count; i++) {
+    BPPageHandle page_handle;
+    rc = buffer_pool.get_this_page(file_id, i, &page_handle);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to load page %d of free space map file %d. rc=%d:%s", i, file_id, rc, strrc(rc));
+      close();
+      return rc;
+    }
+    char *data = nullptr;
+    buffer_pool.get_data(&page_handle, &data);
+    classes_.insert(classes_.end(), (uint8_t *)data, (uint8_t *)data + entries_per_page_);
+    buffer_pool.unpin_page(&page_handle);
+  }
+
+  // 逆序加入，相同等级的页面优先使用页号小的
+  for (PageNum page_num = (PageNum)classes_.size() - 1; page_num >= 0; page_num--) {
+    if (classes_[page_num] > 0 && classes_[page_num] < CLASS_NUM) {
+      buckets_[classes_[page_num]].push_back(page_num);
+    }
+  }
+  LOG_INFO("Successfully load free space map file %d with %d pages.", file_id, page_count);
+  return RC::SUCCESS;
+}
+
+void FreeSpaceMap::close()
+{
+  disk_buffer_pool_ = nullptr;
+  file_id_ = -1;
+  classes_.clear();
+  for (std::vector<PageNum> &bucket : buckets_) {
+    bucket.clear();
+  }
+}
+
+int FreeSpaceMap::get(PageNum page_num) const
+{
+  if (page_num < 0 || page_num >= (PageNum)classes_.size()) {
+    return 0;
+  }
+  return classes_[page_num];
+}
+
+RC FreeSpaceMap::update(PageNum page_num, int free_class)
+{
+  if (page_num < 0 || free_class < 0 || free_class >= CLASS_NUM) {
+    LOG_ERROR("Invalid free space class %d of page %d.", free_class, page_num);
+    return RC::INVALID_ARGUMENT;
+  }
+  if (page_num >= (PageNum)classes_.size()) {
+    classes_.resize(page_num + 1, 0);
+  }
+  if (classes_[page_num] == free_class) {
+    return RC::SUCCESS;
+  }
+
+  classes_[page_num] = (uint8_t)free_class;
+  if (free_class > 0) {
+    std::vector<PageNum> &bucket = buckets_[free_class];
+    bucket.push_back(page_num);
+    // 页面等级来回变化时会留下很多过期的记录，过多时清理一次
+    if (bucket.size() > classes_.size() * 2 + 64) {
+      std::vector<PageNum> valid_pages;
+      for (PageNum candidate : bucket) {
+        if (classes_[candidate] == free_class) {
+          valid_pages.push_back(candidate);
+        }
+      }
+      bucket.swap(valid_pages);
+    }
+  }
+  return write_class(page_num, free_class);
+}
+
+PageNum FreeSpaceMap::find(int min_class)
+{
+  for (int c = std::max(min_class, 1); c < CLASS_NUM; c++) {
+    std::vector<PageNum> &bucket = buckets_[c];
+    while (!bucket.empty()) {
+      PageNum page_num = bucket.back();
+      if (classes_[page_num] == c) {
+        return page_num;
+      }
+      bucket.pop_back();
+    }
+  }
+  return -1;
+}
+
+int FreeSpaceMap::free_class(int free_size, int total_size)
+{
+  if (free_size <= 0 || total_size <= 0) {
+    return 0;
+  }
+  return std::min(CLASS_NUM - 1, free_size * (CLASS_NUM - 1) / total_size);
+}
+
+int FreeSpaceMap::min_class(int size, int total_size)
+{
+  if (size <= 0 || total_size <= 0) {
+    return 1;
+  }
+  return std::max(1, std::min(CLASS_NUM - 1, (size * (CLASS_NUM - 1) + total_size - 1) / total_size));
+}
+
+RC FreeSpaceMap::write_class(PageNum page_num, int free_class)
+{
+  PageNum map_page_num = page_num / entries_per_page_ + 1;
+  int page_count = 0;
+  RC rc = disk_buffer_pool_->get_page_count(file_id_, &page_count);
+  if (rc != RC::SUCCESS) {
+    return rc;
+  }
+  while (page_count <= map_page_num) {
+    BPPageHandle page_handle;
+    rc = disk_buffer_pool_->allocate_page(file_id_, &page_handle);
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to extend free space map file %d. rc=%d:%s", file_id_, rc, strrc(rc));
+      return rc;
+    }
+    disk_buffer_pool_->unpin_page(&page_handle);
+    page_count++;
+  }
+
+  BPPageHandle page_handle;
+  rc = disk_buffer_pool_->get_this_page(file_id_, map_page_num, &page_handle);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to load page %d of free space map file %d. rc=%d:%s", map_page_num, file_id_, rc, strrc(rc));
+    return rc;
+  }
+  char *data = nullptr;
+  disk_buffer_pool_->get_data(&page_handle, &data);
+  data[page_num % entries_per_page_] = (char)free_class;
+  disk_buffer_pool_->mark_dirty(&page_handle);
+  disk_buffer_pool_->unpin_page(&page_handle);
+  empty_ = false;
+  return RC::SUCCESS;
+}
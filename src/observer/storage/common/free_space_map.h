@@ -0,0 +1,79 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_FREE_SPACE_MAP_H_
+#define __OBSERVER_STORAGE_COMMON_FREE_SPACE_MAP_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "rc.h"
+#include "storage/default/disk_buffer_pool.h"
+
+/**
+ * 数据文件的空闲空间表，保存在单独的文件中，每个数据页占一个字节，记录页面剩余空间的等级。
+ * 等级为0表示页面几乎没有剩余空间或者不是记录页，等级越高剩余空间越多。
+ * 空闲空间表只是插入时选择页面的提示，实际能否插入仍以数据页为准
+ */
+class FreeSpaceMap {
+public:
+  static const int CLASS_NUM = 64;
+
+  FreeSpaceMap() = default;
+  ~FreeSpaceMap();
+
+  /**
+   * 从空闲空间表文件中加载所有页面的等级
+   */
+  RC init(DiskBufferPool &buffer_pool, int file_id);
+  void close();
+
+  bool is_open() const { return disk_buffer_pool_ != nullptr; }
+
+  /**
+   * 空闲空间表文件中还没有任何记录，需要根据数据文件重建
+   */
+  bool empty() const { return empty_; }
+
+  /**
+   * 更新数据页的等级，等级变化时才会修改空闲空间表文件
+   */
+  RC update(PageNum page_num, int free_class);
+
+  /**
+   * 找到一个等级不低于min_class的页面，优先选择剩余空间最少的页面。没有时返回-1
+   */
+  PageNum find(int min_class);
+
+  int get(PageNum page_num) const;
+
+  /**
+   * 根据剩余空间和页面总空间计算等级，等级为c的页面至少有c/(CLASS_NUM-1)的剩余空间
+   */
+  static int free_class(int free_size, int total_size);
+
+  /**
+   * 能放下size大小数据的最低等级
+   */
+  static int min_class(int size, int total_size);
+
+private:
+  RC write_class(PageNum page_num, int free_class);
+
+private:
+  DiskBufferPool *disk_buffer_pool_ = nullptr;
+  int file_id_ = -1;
+  int entries_per_page_ = 0;
+  bool empty_ = true;
+  std::vector<uint8_t> classes_;
+  std::vector<PageNum> buckets_[CLASS_NUM];  // 每个等级的候选页面，页面等级变化后旧的记录在查找时丢弃
+};
+
+#endif  //__OBSERVER_STORAGE_COMMON_FREE_SPACE_MAP_H_
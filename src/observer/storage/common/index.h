@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #define __OBSERVER_STORAGE_COMMON_INDEX_H_
 
 #include <stddef.h>
+#include <string>
 #include <vector>
 
 #include "rc.h"
@@ -34,6 +35,19 @@ public:
 
 class IndexScanner;
 
+/**
+ * 索引上的扫描范围。左右边界只比较键值的前left_attr_num/right_attr_num个字段，为0时表示这一边没有边界。
+ * 边界的长度是整个键值的长度，没有用到的字段填0
+ */
+struct IndexScanRange {
+    std::string left_key;
+    int left_attr_num = 0;
+    bool left_inclusive = true;
+    std::string right_key;
+    int right_attr_num = 0;
+    bool right_inclusive = true;
+};
+
 class Index {
 
 public:
@@ -55,6 +69,8 @@ public:
 
     virtual IndexScanner *create_scanner(CompOp comp_op, const char *value) = 0;
 
+    virtual IndexScanner *create_scanner(const IndexScanRange &range) = 0;
+
     virtual RC sync() = 0;
 
     virtual bool unique_conflict(std::string key)  = 0;
@@ -75,6 +91,11 @@ public:
 
     virtual RC next_entry(RID *rid) = 0;
 
+    /**
+     * 同时取出索引项中各个字段的值，按照索引字段的顺序连续存放在key中
+     */
+    virtual RC next_entry(RID *rid, char *key) = 0;
+
     virtual RC destroy() = 0;
 };
 
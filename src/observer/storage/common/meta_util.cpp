@@ -21,3 +21,7 @@ std::string index_data_file(const char *base_dir, const char *table_name, const
   return std::string(base_dir) + "/" + table_name + "-" + index_name + TABLE_INDEX_SUFFIX;
 }
 
+
+std::string table_stats_file(const char *base_dir, const char *table_name) {
+  return std::string(base_dir) + "/" + table_name + TABLE_STATS_SUFFIX;
+}
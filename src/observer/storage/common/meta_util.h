@@ -19,9 +19,12 @@ See the Mulan PSL v2 for more details. */
 static const char *TABLE_META_SUFFIX = ".table";
 static const char *TABLE_META_FILE_PATTERN = ".*\\.table$";
 static const char *TABLE_DATA_SUFFIX = ".data";
+static const char *TABLE_FSM_SUFFIX = ".fsm";
 static const char *TABLE_INDEX_SUFFIX = ".index";
+static const char *TABLE_STATS_SUFFIX = ".stats";
 
 std::string table_meta_file(const char *base_dir, const char *table_name);
 std::string index_data_file(const char *base_dir, const char *table_name, const char *index_name);
+std::string table_stats_file(const char *base_dir, const char *table_name);
 
 #endif //__OBSERVER_STORAGE_COMMON_META_UTIL_H_
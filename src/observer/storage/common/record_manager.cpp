@@ -11,54 +11,146 @@ See the Mulan PSL v2 for more details. */
 //
 // Created by Longda on 2021/4/13.
 //
+#include <algorithm>
+
 #include "storage/common/record_manager.h"
 #include "rc.h"
 #include "common/log/log.h"
-#include "common/lang/bitmap.h"
 #include "condition_filter.h"
 
 using namespace common;
 
+// 顺序扫描时每次预读的页面数
+static const int RECORD_READ_AHEAD_PAGES = 64;
+// 选择页大小时，每页至少能存放的记录数
+static const int MIN_RECORDS_PER_PAGE = 16;
+
+// 记录的最小长度，保证记录迁移后原位置能放下新位置的RID
+static const int MIN_RECORD_LENGTH = sizeof(RID);
+
+/**
+ * 页面的格式：页头之后是槽位数组，记录从页面末尾向前存放，中间是空闲空间。
+ * 记录的RID是槽位号，页面整理时移动记录只修改槽位中的偏移，RID不变
+ */
 struct PageHeader {
-  int record_num;  // 当前页面记录的个数
-  int record_capacity; // 最大记录个数
-  int record_real_size; // 每条记录的实际大小
-  int record_size; // 每条记录占用实际空间大小(可能对齐)
-  int first_record_offset; // 第一条记录的偏移量
+  int page_type;     // 页面类型，数据文件中还有保存大字段的溢出页
+  int record_num;    // 当前页面记录的个数，包括迁移的记录
+  int slot_num;      // 槽位个数
+  int data_offset;   // 记录区的起始位置
+  int fragment_size; // 删除或者更新记录留下的空洞大小，整理页面后可以重新使用
+};
+
+/**
+ * 溢出页保存放不进记录的大字段，一个字段的数据保存在一个或多个溢出页组成的链表中
+ */
+struct OverflowPageHeader {
+  int     page_type;
+  PageNum next_page;  // 下一个溢出页，-1表示最后一页
+  int     length;     // 当前页面保存的数据长度
 };
 
-int align8(int size) {
-  return size / 8 * 8 + ((size % 8 == 0) ? 0 : 8);
+static const int RECORD_PAGE = 0x52454344;   // "RECD"
+static const int OVERFLOW_PAGE = 0x4f564552; // "OVER"
+
+struct RecordSlot {
+  uint16_t offset;   // 记录在页面中的偏移，0表示空闲的槽位
+  uint16_t length;   // 编码后记录的长度
+  uint16_t flags;
+};
+
+static int page_record_capacity(int data_size, int record_size) {
+  return (data_size - (int)sizeof(PageHeader)) / (record_size + (int)sizeof(RecordSlot));
 }
 
-int page_fix_size() {
-  return sizeof(PageHeader::record_num)
-      + sizeof(PageHeader::record_capacity)
-      + sizeof(PageHeader::record_real_size)
-      + sizeof(PageHeader::record_size)
-      + sizeof(PageHeader::first_record_offset);
+static int page_contiguous_free(const PageHeader *page_header) {
+  return page_header->data_offset - (int)sizeof(PageHeader) - page_header->slot_num * (int)sizeof(RecordSlot);
 }
 
-int page_record_capacity(int page_size, int record_size) {
-  // (record_capacity * record_size) + record_capacity/8 + 1 <= (page_size - fix_size)
-  // ==> record_capacity = ((page_size - fix_size) - 1) / (record_size + 0.125)
-  return (int)((page_size - page_fix_size() - 1) / (record_size + 0.125));
+static int decoded_length(const RecordCodec *codec, int length) {
+  return (nullptr == codec) ? length : codec->record_size();
 }
 
-int page_bitmap_size(int record_capacity) {
-  return record_capacity / 8 + ((record_capacity % 8 == 0) ? 0 : 1);
+static RC decode_record(const RecordCodec *codec, const char *data, int length, char *record) {
+  if (nullptr == codec) {
+    memcpy(record, data, length);
+    return RC::SUCCESS;
+  }
+  return codec->decode(data, length, record);
 }
 
-int page_header_size(int record_capacity) {
-  const int bitmap_size = page_bitmap_size(record_capacity);
-  return align8(page_fix_size() + bitmap_size);
+static RC decode_record(const RecordCodec *codec, const char *data, int length, std::vector<char> &buffer) {
+  buffer.resize(decoded_length(codec, length));
+  return decode_record(codec, data, length, buffer.data());
+}
+////////////////////////////////////////////////////////////////////////////////
+void RecordCodec::init(int record_size, const std::vector<std::pair<int, int>> &var_fields) {
+  record_size_ = record_size;
+  var_fields_ = var_fields;
+  std::sort(var_fields_.begin(), var_fields_.end());
+}
+
+int RecordCodec::max_encoded_size() const {
+  return record_size_ + (int)(var_fields_.size() * sizeof(uint16_t));
+}
+
+int RecordCodec::encode(const char *record, char *buf) const {
+  char *out = buf;
+  int pos = 0;
+  for (const std::pair<int, int> &field : var_fields_) {
+    memcpy(out, record + pos, field.first - pos);
+    out += field.first - pos;
+
+    uint16_t length = (uint16_t)strnlen(record + field.first, field.second);
+    memcpy(out, &length, sizeof(length));
+    out += sizeof(length);
+    memcpy(out, record + field.first, length);
+    out += length;
+    pos = field.first + field.second;
+  }
+  memcpy(out, record + pos, record_size_ - pos);
+  out += record_size_ - pos;
+  return (int)(out - buf);
+}
+
+RC RecordCodec::decode(const char *buf, int length, char *record) const {
+  const char *in = buf;
+  const char *end = buf + length;
+  int pos = 0;
+  for (const std::pair<int, int> &field : var_fields_) {
+    const int fixed_size = field.first - pos;
+    uint16_t var_length = 0;
+    if (end - in < fixed_size + (int)sizeof(var_length)) {
+      LOG_ERROR("Invalid encoded record, length=%d", length);
+      return RC::RECORD_INVALIDRECSIZE;
+    }
+    memcpy(record + pos, in, fixed_size);
+    in += fixed_size;
+    memcpy(&var_length, in, sizeof(var_length));
+    in += sizeof(var_length);
+    if (var_length > field.second || end - in < var_length) {
+      LOG_ERROR("Invalid encoded record, length=%d", length);
+      return RC::RECORD_INVALIDRECSIZE;
+    }
+    memcpy(record + field.first, in, var_length);
+    memset(record + field.first + var_length, 0, field.second - var_length);
+    in += var_length;
+    pos = field.first + field.second;
+  }
+
+  // 短记录后面可能有补齐的数据
+  if (end - in < record_size_ - pos) {
+    LOG_ERROR("Invalid encoded record, length=%d", length);
+    return RC::RECORD_INVALIDRECSIZE;
+  }
+  memcpy(record + pos, in, record_size_ - pos);
+  return RC::SUCCESS;
 }
 ////////////////////////////////////////////////////////////////////////////////
 RecordPageHandler::RecordPageHandler() : 
     disk_buffer_pool_(nullptr),
     file_id_(-1),
     page_header_(nullptr),
-    bitmap_(nullptr) {
+    slots_(nullptr) {
   page_handle_.open = false;
   page_handle_.frame = nullptr;
 }
@@ -68,6 +160,19 @@ RecordPageHandler::~RecordPageHandler() {
 }
 
 RC RecordPageHandler::init(DiskBufferPool &buffer_pool, int file_id, PageNum page_num) {
+  RC ret = init_page(buffer_pool, file_id, page_num);
+  if (ret != RC::SUCCESS) {
+    return ret;
+  }
+  if (page_header_->page_type != RECORD_PAGE) {
+    LOG_TRACE("Page is not a record page. file_id:page_num %d:%d", file_id, page_num);
+    deinit();
+    return RC::RECORD_NOT_RECORD_PAGE;
+  }
+  return ret;
+}
+
+RC RecordPageHandler::init_page(DiskBufferPool &buffer_pool, int file_id, PageNum page_num) {
   if (disk_buffer_pool_ != nullptr) {
     LOG_WARN("Disk buffer pool has been opened for file_id:page_num %d:%d.",
              file_id, page_num);
@@ -91,29 +196,33 @@ RC RecordPageHandler::init(DiskBufferPool &buffer_pool, int file_id, PageNum pag
   file_id_ = file_id;
 
   page_header_ = (PageHeader*)(data);
-  bitmap_ = data + page_fix_size();
+  slots_ = (RecordSlot *)(data + sizeof(PageHeader));
   LOG_TRACE("Successfully init file_id:page_num %d:%d.", file_id, page_num);
   return ret;
 }
 
-RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, int file_id, PageNum page_num, int record_size) {
-  RC ret = init(buffer_pool, file_id, page_num);
+int RecordPageHandler::page_size_for(int record_size) {
+  int page_size = BP_PAGE_SIZE;
+  while (page_size < BP_MAX_PAGE_SIZE &&
+         page_record_capacity(page_size - sizeof(PageNum), record_size) < MIN_RECORDS_PER_PAGE) {
+    page_size <<= 1;
+  }
+  return page_size;
+}
+
+RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, int file_id, PageNum page_num) {
+  RC ret = init_page(buffer_pool, file_id, page_num);
   if (ret != RC::SUCCESS) {
-    LOG_ERROR("Failed to init empty page file_id:page_num:record_size %d:%d:%d."
-              , file_id, page_num, record_size);
+    LOG_ERROR("Failed to init empty page file_id:page_num %d:%d.", file_id, page_num);
     return ret;
   }
 
-  int page_size = sizeof(page_handle_.frame->page.data);
-  int record_phy_size = align8(record_size);
+  page_header_->page_type = RECORD_PAGE;
   page_header_->record_num = 0;
-  page_header_->record_capacity = page_record_capacity(page_size, record_phy_size);
-  page_header_->record_real_size = record_size;
-  page_header_->record_size = record_phy_size;
-  page_header_->first_record_offset = page_header_size(page_header_->record_capacity);
-  bitmap_ = page_handle_.frame->page.data + page_fix_size();
+  page_header_->slot_num = 0;
+  page_header_->data_offset = data_size();
+  page_header_->fragment_size = 0;
 
-  memset(bitmap_, 0, page_bitmap_size(page_header_->record_capacity));
   ret = disk_buffer_pool_->mark_dirty(&page_handle_);
   if (ret != RC::SUCCESS) {
     LOG_ERROR("Failed to mark page dirty. ret=%s", strrc(ret));
@@ -125,7 +234,7 @@ RC RecordPageHandler::init_empty_page(DiskBufferPool &buffer_pool, int file_id,
 RC RecordPageHandler::deinit() {
   // if (page_header_ != nullptr) {
   //   disk_buffer_pool_->unpin_page(&page_handle_);
-  //   disk_buffer_pool_->force_page(file_id_, page_handle_.frame->page.page_num);
+  //   disk_buffer_pool_->force_page(file_id_, page_handle_.frame->page->page_num);
   //   page_header_ = nullptr;
   // }
   if (disk_buffer_pool_ != nullptr) {
@@ -135,28 +244,71 @@ RC RecordPageHandler::deinit() {
     }
     disk_buffer_pool_ = nullptr;
   }
+  page_header_ = nullptr;
+  slots_ = nullptr;
 
   return RC::SUCCESS;
 }
 
-RC RecordPageHandler::insert_record(const char *data, RID *rid) {
+void RecordPageHandler::compact() {
+  std::vector<SlotNum> slot_nums;
+  for (SlotNum i = 0; i < page_header_->slot_num; i++) {
+    if (slots_[i].offset != 0) {
+      slot_nums.push_back(i);
+    }
+  }
+  // 从后往前移动，记录只会向页面末尾移动，不会覆盖还没有移动的记录
+  std::sort(slot_nums.begin(), slot_nums.end(), [this](SlotNum left, SlotNum right) {
+    return slots_[left].offset > slots_[right].offset;
+  });
+
+  char *data = page_handle_.frame->page->data;
+  int offset = data_size();
+  for (SlotNum i : slot_nums) {
+    offset -= slots_[i].length;
+    memmove(data + offset, data + slots_[i].offset, slots_[i].length);
+    slots_[i].offset = (uint16_t)offset;
+  }
+  page_header_->data_offset = offset;
+  page_header_->fragment_size = 0;
+}
+
+RC RecordPageHandler::insert_record(const char *data, int length, RID *rid, int flags) {
 
-  if (page_header_->record_num == page_header_->record_capacity) {
+  // 修改页面内容时持有页帧的写锁，防止其它线程同时修改同一个页面
+  page_handle_.wlatch();
+  if (!can_insert(length)) {
+    page_handle_.unlatch();
     LOG_WARN("Page is full, file_id:page_num %d:%d.", file_id_,
-              page_handle_.frame->page.page_num);
+              page_handle_.frame->page->page_num);
     return RC::RECORD_NOMEM;
   }
 
-  // 找到空闲位置
-  Bitmap bitmap(bitmap_, page_header_->record_capacity);
-  int index = bitmap.next_unsetted_bit(0);
-  bitmap.set_bit(index);
-  page_header_->record_num++;
+  // 找到空闲的槽位，没有的话在槽位数组末尾增加一个
+  SlotNum index = page_header_->slot_num;
+  if (page_header_->record_num < page_header_->slot_num) {
+    for (SlotNum i = 0; i < page_header_->slot_num; i++) {
+      if (slots_[i].offset == 0) {
+        index = i;
+        break;
+      }
+    }
+  }
+  const int new_slot_size = (index == page_header_->slot_num) ? (int)sizeof(RecordSlot) : 0;
+  if (page_contiguous_free(page_header_) < length + new_slot_size) {
+    compact();
+  }
+  if (new_slot_size > 0) {
+    page_header_->slot_num++;
+  }
 
-  // assert index < page_header_->record_capacity
-  char *record_data = page_handle_.frame->page.data +
-      page_header_->first_record_offset + (index * page_header_->record_size);
-  memcpy(record_data, data, page_header_->record_real_size);
+  page_header_->data_offset -= length;
+  memcpy(page_handle_.frame->page->data + page_header_->data_offset, data, length);
+  slots_[index].offset = (uint16_t)page_header_->data_offset;
+  slots_[index].length = (uint16_t)length;
+  slots_[index].flags = (uint16_t)flags;
+  page_header_->record_num++;
+  page_handle_.unlatch();
 
   RC rc = disk_buffer_pool_->mark_dirty(&page_handle_);
   if (rc != RC::SUCCESS) {
@@ -173,54 +325,84 @@ RC RecordPageHandler::insert_record(const char *data, RID *rid) {
   return RC::SUCCESS;
 }
 
-RC RecordPageHandler::update_record(const Record *rec) {
+RC RecordPageHandler::update_record(const RID *rid, const char *data, int length, int flags) {
   RC ret = RC::SUCCESS;
 
-  if (rec->rid.slot_num >= page_header_->record_capacity) {
-    LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, file_id:page_num %d:%d.",
-              rec->rid.slot_num,
+  if (rid->slot_num < 0 || rid->slot_num >= page_header_->slot_num) {
+    LOG_ERROR("Invalid slot_num %d, exceed page's slot number, file_id:page_num %d:%d.",
+              rid->slot_num,
               file_id_,
-              page_handle_.frame->page.page_num);
+              page_handle_.frame->page->page_num);
     return RC::INVALID_ARGUMENT;
   }
 
-  Bitmap bitmap(bitmap_, page_header_->record_capacity);
-  if (!bitmap.get_bit(rec->rid.slot_num)) {
+  page_handle_.wlatch();
+  RecordSlot &slot = slots_[rid->slot_num];
+  if (slot.offset == 0) {
+    page_handle_.unlatch();
     LOG_ERROR("Invalid slot_num %d, slot is empty, file_id:page_num %d:%d.",
-              rec->rid.slot_num,
+              rid->slot_num,
               file_id_,
-              page_handle_.frame->page.page_num);
-    ret = RC::RECORD_RECORD_NOT_EXIST;
+              page_handle_.frame->page->page_num);
+    return RC::RECORD_RECORD_NOT_EXIST;
+  }
+
+  if (length <= slot.length) {
+    memcpy(page_handle_.frame->page->data + slot.offset, data, length);
+    page_header_->fragment_size += slot.length - length;
   } else {
-    char *record_data = page_handle_.frame->page.data +
-        page_header_->first_record_offset + (rec->rid.slot_num * page_header_->record_size);
+    if (page_contiguous_free(page_header_) + page_header_->fragment_size + slot.length < length) {
+      page_handle_.unlatch();
+      LOG_TRACE("No space to update record in page, file_id:page_num %d:%d.",
+                file_id_, page_handle_.frame->page->page_num);
+      return RC::RECORD_NOMEM;
+    }
 
-    memcpy(record_data, rec->data, page_header_->record_real_size);
-    ret = disk_buffer_pool_->mark_dirty(&page_handle_);
-    if (ret != RC::SUCCESS) {
-      LOG_ERROR("Failed to mark page dirty. ret=%s", strrc(ret));
+    // 原来的位置变成空洞，在空闲空间中重新放置记录
+    page_header_->fragment_size += slot.length;
+    slot.offset = 0;
+    if (page_contiguous_free(page_header_) < length) {
+      compact();
     }
+    page_header_->data_offset -= length;
+    memcpy(page_handle_.frame->page->data + page_header_->data_offset, data, length);
+    slot.offset = (uint16_t)page_header_->data_offset;
   }
+  slot.length = (uint16_t)length;
+  slot.flags = (uint16_t)flags;
+  page_handle_.unlatch();
 
-  LOG_TRACE("Update record. page num=%d,slot=%d", rec->rid.page_num, rec->rid.slot_num);
+  ret = disk_buffer_pool_->mark_dirty(&page_handle_);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to mark page dirty. ret=%s", strrc(ret));
+  }
+
+  LOG_TRACE("Update record. page num=%d,slot=%d", rid->page_num, rid->slot_num);
   return ret;
 }
 
 RC RecordPageHandler::delete_record(const RID *rid) {
   RC ret = RC::SUCCESS;
 
-  if (rid->slot_num >= page_header_->record_capacity) {
-    LOG_ERROR("Invalid slot_num %d, exceed page's record capacity, file_id:page_num %d:%d.",
+  if (rid->slot_num < 0 || rid->slot_num >= page_header_->slot_num) {
+    LOG_ERROR("Invalid slot_num %d, exceed page's slot number, file_id:page_num %d:%d.",
               rid->slot_num,
               file_id_,
-              page_handle_.frame->page.page_num);
+              page_handle_.frame->page->page_num);
     return RC::INVALID_ARGUMENT;
   }
 
-  Bitmap bitmap(bitmap_, page_header_->record_capacity);
-  if (bitmap.get_bit(rid->slot_num)) {
-    bitmap.clear_bit(rid->slot_num);
+  page_handle_.wlatch();
+  RecordSlot &slot = slots_[rid->slot_num];
+  if (slot.offset != 0) {
+    page_header_->fragment_size += slot.length;
+    slot.offset = 0;
     page_header_->record_num--;
+    // 末尾的空闲槽位直接回收
+    while (page_header_->slot_num > 0 && slots_[page_header_->slot_num - 1].offset == 0) {
+      page_header_->slot_num--;
+    }
+    page_handle_.unlatch();
     ret = disk_buffer_pool_->mark_dirty(&page_handle_);
     if (ret != RC::SUCCESS) {
       LOG_ERROR("failed to mark page dirty in delete record. ret=%d:%s", ret, strrc(ret));
@@ -235,95 +417,96 @@ RC RecordPageHandler::delete_record(const RID *rid) {
       disk_buffer_pool->dispose_page(file_id, page_num);
     }
   } else {
+    page_handle_.unlatch();
     LOG_ERROR("Invalid slot_num %d, slot is empty, file_id:page_num %d:%d.",
               rid->slot_num,
               file_id_,
-              page_handle_.frame->page.page_num);
+              page_handle_.frame->page->page_num);
     ret = RC::RECORD_RECORD_NOT_EXIST;
   }
   return ret;
 }
 
-RC RecordPageHandler::get_record(const RID *rid, Record *rec) {
-  if (rid->slot_num >= page_header_->record_capacity) {
-    LOG_ERROR("Invalid slot_num:%d, exceed page's record capacity, file_id:page_num %d:%d.",
+RC RecordPageHandler::get_record(const RID *rid, const char **data, int *length, int *flags) {
+  if (rid->slot_num < 0) {
+    LOG_ERROR("Invalid slot_num:%d, file_id:page_num %d:%d.",
               rid->slot_num,
               file_id_,
-              page_handle_.frame->page.page_num);
+              page_handle_.frame->page->page_num);
     return RC::RECORD_INVALIDRID;
   }
 
-  Bitmap bitmap(bitmap_, page_header_->record_capacity);
-  if (!bitmap.get_bit(rid->slot_num)) {
+  if (rid->slot_num >= page_header_->slot_num || slots_[rid->slot_num].offset == 0) {
     LOG_ERROR("Invalid slot_num:%d, slot is empty, file_id:page_num %d:%d.",
               rid->slot_num,
               file_id_,
-              page_handle_.frame->page.page_num);
+              page_handle_.frame->page->page_num);
     return RC::RECORD_RECORD_NOT_EXIST;
   }
 
-  char *data = page_handle_.frame->page.data +
-      page_header_->first_record_offset + (page_header_->record_size * rid->slot_num);
-
-  // rec->valid = true;
-  rec->rid = *rid;
-  rec->data = data;
+  const RecordSlot &slot = slots_[rid->slot_num];
+  *data = page_handle_.frame->page->data + slot.offset;
+  *length = slot.length;
+  if (flags != nullptr) {
+    *flags = slot.flags;
+  }
   return RC::SUCCESS;
 }
 
-RC RecordPageHandler::get_first_record(Record *rec) {
-  rec->rid.slot_num = -1;
-  return get_next_record(rec);
-}
-
-RC RecordPageHandler::get_next_record(Record *rec) {
-  if (rec->rid.slot_num >= page_header_->record_capacity - 1) {
-    LOG_ERROR("Invalid slot_num:%d, exceed page's record capacity, file_id:page_num %d:%d.",
-              rec->rid.slot_num,
-              file_id_,
-              page_handle_.frame->page.page_num);
-    return RC::RECORD_EOF;
-  }
-
-  Bitmap bitmap(bitmap_, page_header_->record_capacity);
-  int index = bitmap.next_setted_bit(rec->rid.slot_num + 1);
-
-  if (index < 0) {
-    LOG_TRACE("There is no empty slot, file_id:page_num %d:%d.",
-              file_id_,
-              page_handle_.frame->page.page_num);
-    return RC::RECORD_EOF;
+RC RecordPageHandler::get_next_record(RID *rid, const char **data, int *length, int *flags) {
+  for (SlotNum index = std::max(rid->slot_num + 1, 0); index < page_header_->slot_num; index++) {
+    const RecordSlot &slot = slots_[index];
+    if (slot.offset != 0) {
+      rid->page_num = get_page_num();
+      rid->slot_num = index;
+      *data = page_handle_.frame->page->data + slot.offset;
+      *length = slot.length;
+      *flags = slot.flags;
+      return RC::SUCCESS;
+    }
   }
 
-  rec->rid.page_num = get_page_num();
-  rec->rid.slot_num = index;
-  // rec->valid = true;
+  LOG_TRACE("There is no more record, file_id:page_num %d:%d.",
+            file_id_,
+            page_handle_.frame->page->page_num);
+  return RC::RECORD_EOF;
+}
 
-  char *record_data = page_handle_.frame->page.data +
-      page_header_->first_record_offset + (index * page_header_->record_size);
-  rec->data = record_data;
-  return RC::SUCCESS;
+int RecordPageHandler::record_num() const {
+  return page_header_->record_num;
 }
 
 PageNum RecordPageHandler::get_page_num() const {
   if (nullptr == page_header_) {
     return (PageNum)(-1);
   }
-  return page_handle_.frame->page.page_num;
+  return page_handle_.frame->page->page_num;
 }
 
-bool RecordPageHandler::is_full() const {
-  return page_header_->record_num >= page_header_->record_capacity;
+bool RecordPageHandler::can_insert(int length) const {
+  const int new_slot_size = (page_header_->record_num < page_header_->slot_num) ? 0 : (int)sizeof(RecordSlot);
+  return page_contiguous_free(page_header_) + page_header_->fragment_size >= length + new_slot_size;
+}
+
+int RecordPageHandler::free_space() const {
+  return std::max(0, page_contiguous_free(page_header_) + page_header_->fragment_size - (int)sizeof(RecordSlot));
+}
+
+int RecordPageHandler::free_space_class() const {
+  return FreeSpaceMap::free_class(free_space(), data_size());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 RecordFileHandler::RecordFileHandler() :
     disk_buffer_pool_(nullptr),
-    file_id_(-1) {
+    file_id_(-1),
+    codec_(nullptr),
+    page_data_size_(0),
+    record_num_(0) {
 }
 
-RC RecordFileHandler::init(DiskBufferPool &buffer_pool, int file_id) {
+RC RecordFileHandler::init(DiskBufferPool &buffer_pool, int file_id, int fsm_file_id, const RecordCodec *codec) {
 
   RC ret = RC::SUCCESS;
 
@@ -332,8 +515,36 @@ RC RecordFileHandler::init(DiskBufferPool &buffer_pool, int file_id) {
     return RC::RECORD_OPENNED;
   }
 
+  int page_size = 0;
+  if ((ret = buffer_pool.get_page_size(file_id, &page_size)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to get page size of %d. ret=%d:%s", file_id, ret, strrc(ret));
+    return ret;
+  }
+
   disk_buffer_pool_ = &buffer_pool;
   file_id_ = file_id;
+  codec_ = codec;
+  page_data_size_ = page_size - (int)sizeof(PageNum);
+
+  if (fsm_file_id >= 0) {
+    ret = free_space_map_.init(buffer_pool, fsm_file_id);
+    if (ret == RC::SUCCESS && free_space_map_.empty()) {
+      ret = rebuild_free_space_map();
+    }
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to init free space map of %d. ret=%d:%s", file_id, ret, strrc(ret));
+      disk_buffer_pool_ = nullptr;
+      return ret;
+    }
+  }
+
+  ret = estimate_record_num();
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to estimate record number of %d. ret=%d:%s", file_id, ret, strrc(ret));
+    free_space_map_.close();
+    disk_buffer_pool_ = nullptr;
+    return ret;
+  }
 
   LOG_TRACE("Successfully open %d.", file_id);
   return ret;
@@ -341,52 +552,124 @@ RC RecordFileHandler::init(DiskBufferPool &buffer_pool, int file_id) {
 
 void RecordFileHandler::close() {
   if (disk_buffer_pool_ != nullptr) {
+    record_page_handler_.deinit();
+    free_space_map_.close();
     disk_buffer_pool_ = nullptr;
   }
 }
 
-RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid) {
-  RC ret = RC::SUCCESS;
-  // 找到没有填满的页面 
+RC RecordFileHandler::rebuild_free_space_map() {
   int page_count = 0;
-  if ((ret = disk_buffer_pool_->get_page_count(file_id_, &page_count)) != RC::SUCCESS) {
-    LOG_ERROR("Failed to get page count while inserting record");
+  RC ret = disk_buffer_pool_->get_page_count(file_id_, &page_count);
+  if (ret != RC::SUCCESS) {
     return ret;
   }
+  for (PageNum page_num = 1; page_num < page_count; page_num++) {
+    RecordPageHandler page_handler;
+    if (page_handler.init(*disk_buffer_pool_, file_id_, page_num) != RC::SUCCESS) {
+      continue;  // 已经释放的页面
+    }
+    ret = free_space_map_.update(page_num, page_handler.free_space_class());
+    if (ret != RC::SUCCESS) {
+      return ret;
+    }
+  }
+  LOG_INFO("Rebuild free space map of %d with %d pages.", file_id_, page_count);
+  return RC::SUCCESS;
+}
 
-  PageNum current_page_num = record_page_handler_.get_page_num();
-  if (current_page_num < 0) {
-    if (page_count >= 2) { // 当前buffer pool 有页面时才尝试加载第一页
-      // 参考diskBufferPool，pageNum从1开始
-      if ((ret = record_page_handler_.init(*disk_buffer_pool_, file_id_, 1)) != RC::SUCCESS) {
-        LOG_ERROR("Failed to init record page handler.ret=%d", ret);
-        return ret;
-      }
-      current_page_num = record_page_handler_.get_page_num();
-    } else {
-      current_page_num = 0;
+RC RecordFileHandler::estimate_record_num() {
+  static const int SAMPLE_PAGE_NUM = 64;
+  int page_count = 0;
+  RC ret = disk_buffer_pool_->get_page_count(file_id_, &page_count);
+  if (ret != RC::SUCCESS) {
+    return ret;
+  }
+  // 第0页是文件头。溢出页和已经释放的页面按0条记录计算
+  const int data_page_num = page_count - 1;
+  const int sample_num = std::min(data_page_num, SAMPLE_PAGE_NUM);
+  long long sampled_record_num = 0;
+  for (int i = 0; i < sample_num; i++) {
+    const PageNum page_num = 1 + (PageNum)((long long)i * data_page_num / sample_num);
+    RecordPageHandler page_handler;
+    if (page_handler.init(*disk_buffer_pool_, file_id_, page_num) == RC::SUCCESS) {
+      sampled_record_num += page_handler.record_num();
     }
   }
+  record_num_ = sample_num > 0 ? (int)(sampled_record_num * data_page_num / sample_num) : 0;
+  return RC::SUCCESS;
+}
+
+void RecordFileHandler::update_free_space(PageNum page_num) {
+  if (!free_space_map_.is_open()) {
+    return;
+  }
+  // 页面的记录全部删除后会被释放，不再是记录页
+  int free_class = 0;
+  RecordPageHandler page_handler;
+  if (page_handler.init(*disk_buffer_pool_, file_id_, page_num) == RC::SUCCESS) {
+    free_class = page_handler.free_space_class();
+  }
+  std::lock_guard<std::mutex> lock_guard(insert_mutex_);
+  free_space_map_.update(page_num, free_class);
+}
+
+int RecordFileHandler::encode(const char *data, int record_size, std::vector<char> &buffer) const {
+  const int max_length = (codec_ != nullptr) ? codec_->max_encoded_size() : record_size;
+  buffer.assign(std::max(max_length, MIN_RECORD_LENGTH), 0);
 
-  bool page_found = false;
-  for (int i = 0; i < page_count; i++) {
-    current_page_num = (current_page_num + i) % page_count; // 从当前打开的页面开始查找
-    if (current_page_num == 0) {
+  int length = record_size;
+  if (codec_ != nullptr) {
+    length = codec_->encode(data, buffer.data());
+  } else {
+    memcpy(buffer.data(), data, record_size);
+  }
+  return std::max(length, MIN_RECORD_LENGTH);
+}
+
+RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid) {
+  if (disk_buffer_pool_->read_only()) {
+    LOG_WARN("Failed to insert record, file %d is read only.", file_id_);
+    return RC::READONLY;
+  }
+
+  std::vector<char> buffer;
+  const int length = encode(data, record_size, buffer);
+  RC ret = insert_encoded(buffer.data(), length, 0, rid);
+  if (ret == RC::SUCCESS) {
+    record_num_++;
+  }
+  return ret;
+}
+
+RC RecordFileHandler::insert_encoded(const char *data, int length, int flags, RID *rid) {
+  std::lock_guard<std::mutex> lock_guard(insert_mutex_);
+  RC ret = RC::SUCCESS;
+  // 优先使用当前打开的页面，放不下时从空闲空间表中找一个空间足够的页面
+  PageNum current_page_num = -1;
+  const int min_class = FreeSpaceMap::min_class(length, page_data_size_);
+  bool page_found = record_page_handler_.get_page_num() >= 0 && record_page_handler_.can_insert(length);
+  while (!page_found && free_space_map_.is_open() && (current_page_num = free_space_map_.find(min_class)) >= 0) {
+    record_page_handler_.deinit();
+    ret = record_page_handler_.init(*disk_buffer_pool_, file_id_, current_page_num);
+    if (ret == RC::BUFFERPOOL_INVALID_PAGE_NUM || ret == RC::RECORD_NOT_RECORD_PAGE) {
+      // 空闲空间表只是提示，页面可能已经被释放或者用作溢出页了
+      free_space_map_.update(current_page_num, 0);
       continue;
     }
-    if (current_page_num != record_page_handler_.get_page_num()) {
-      record_page_handler_.deinit();
-      ret = record_page_handler_.init(*disk_buffer_pool_, file_id_, current_page_num);
-      if (ret != RC::SUCCESS && ret != RC::BUFFERPOOL_INVALID_PAGE_NUM) {
-        LOG_ERROR("Failed to init record page handler. page number is %d. ret=%d:%s", current_page_num, ret, strrc(ret));
-        return ret;
-      }
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to init record page handler. page number is %d. ret=%d:%s", current_page_num, ret, strrc(ret));
+      return ret;
     }
-
-    if (!record_page_handler_.is_full()) {
-      page_found = true;
-      break;
+    if (!record_page_handler_.can_insert(length)) {
+      const int free_class = record_page_handler_.free_space_class();
+      if (free_class == free_space_map_.get(current_page_num)) {
+        break;
+      }
+      free_space_map_.update(current_page_num, free_class);
+      continue;
     }
+    page_found = true;
   }
 
   // 找不到就分配一个新的页面
@@ -398,9 +681,9 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
       return ret;
     }
 
-    current_page_num = page_handle.frame->page.page_num;
+    current_page_num = page_handle.frame->page->page_num;
     record_page_handler_.deinit();
-    ret = record_page_handler_.init_empty_page(*disk_buffer_pool_, file_id_, current_page_num, record_size);
+    ret = record_page_handler_.init_empty_page(*disk_buffer_pool_, file_id_, current_page_num);
     if (ret != RC::SUCCESS) {
       LOG_ERROR("Failed to init empty page. file_id:%d, ret:%d", file_id_, ret);
       if (RC::SUCCESS != disk_buffer_pool_->unpin_page(&page_handle)) {
@@ -413,51 +696,333 @@ RC RecordFileHandler::insert_record(const char *data, int record_size, RID *rid)
     }
   }
 
-  // 找到空闲位置
-  return record_page_handler_.insert_record(data, rid);
+  ret = record_page_handler_.insert_record(data, length, rid, flags);
+  if (ret == RC::SUCCESS && free_space_map_.is_open()) {
+    free_space_map_.update(record_page_handler_.get_page_num(), record_page_handler_.free_space_class());
+  }
+  return ret;
 }
 
 RC RecordFileHandler::update_record(const Record *rec) {
+  if (disk_buffer_pool_->read_only()) {
+    LOG_WARN("Failed to update record, file %d is read only.", file_id_);
+    return RC::READONLY;
+  }
 
   RC ret = RC::SUCCESS;
-
   RecordPageHandler page_handler;
-  if ((ret != page_handler.init(*disk_buffer_pool_, file_id_, rec->rid.page_num)) != RC::SUCCESS) {
+  if ((ret = page_handler.init(*disk_buffer_pool_, file_id_, rec->rid.page_num)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init record page handler.page number=%d, file_id=%d",
               rec->rid.page_num, file_id_);
     return ret;
   }
 
-  return page_handler.update_record(rec);
+  const char *old_data = nullptr;
+  int old_length = 0;
+  int flags = 0;
+  RID moved_rid;
+  page_handler.rlatch();
+  ret = page_handler.get_record(&rec->rid, &old_data, &old_length, &flags);
+  if (ret == RC::SUCCESS && (flags & RecordPageHandler::RECORD_FORWARD)) {
+    memcpy(&moved_rid, old_data, sizeof(moved_rid));
+  }
+  page_handler.unlatch();
+  if (ret != RC::SUCCESS) {
+    return ret;
+  }
+
+  // 不编码的记录是定长的，长度不会变化，也不会迁移
+  std::vector<char> buffer;
+  const int length = encode(rec->data, (codec_ != nullptr) ? codec_->record_size() : old_length, buffer);
+  const char *data = buffer.data();
+
+  if (!(flags & RecordPageHandler::RECORD_FORWARD)) {
+    ret = page_handler.update_record(&rec->rid, data, length);
+    if (ret == RC::SUCCESS || ret != RC::RECORD_NOMEM) {
+      page_handler.deinit();
+      update_free_space(rec->rid.page_num);
+      return ret;
+    }
+  } else {
+    RecordPageHandler moved_page_handler;
+    if ((ret = moved_page_handler.init(*disk_buffer_pool_, file_id_, moved_rid.page_num)) != RC::SUCCESS) {
+      LOG_ERROR("Failed to init record page handler.page number=%d, file_id=%d", moved_rid.page_num, file_id_);
+      return ret;
+    }
+    ret = moved_page_handler.update_record(&moved_rid, data, length, RecordPageHandler::RECORD_MOVED);
+    moved_page_handler.deinit();
+    if (ret == RC::SUCCESS) {
+      update_free_space(moved_rid.page_num);
+    }
+    if (ret != RC::RECORD_NOMEM) {
+      return ret;
+    }
+
+    // 原页面有空间的话搬回原页面
+    ret = page_handler.update_record(&rec->rid, data, length);
+    if (ret != RC::RECORD_NOMEM) {
+      page_handler.deinit();
+      if (ret == RC::SUCCESS) {
+        ret = delete_encoded(&moved_rid);
+        update_free_space(rec->rid.page_num);
+      }
+      return ret;
+    }
+  }
+
+  // 原页面放不下，迁移到其它页面，原来的位置保存新的RID
+  RID new_rid;
+  if ((ret = insert_encoded(data, length, RecordPageHandler::RECORD_MOVED, &new_rid)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to move record. page number=%d, slot=%d, ret=%d:%s",
+              rec->rid.page_num, rec->rid.slot_num, ret, strrc(ret));
+    return ret;
+  }
+  ret = page_handler.update_record(&rec->rid, (const char *)&new_rid, sizeof(new_rid),
+                                   RecordPageHandler::RECORD_FORWARD);
+  page_handler.deinit();
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to forward record. page number=%d, slot=%d, ret=%d:%s",
+              rec->rid.page_num, rec->rid.slot_num, ret, strrc(ret));
+    return ret;
+  }
+  update_free_space(rec->rid.page_num);
+  if (flags & RecordPageHandler::RECORD_FORWARD) {
+    ret = delete_encoded(&moved_rid);
+  }
+  return ret;
 }
 
 RC RecordFileHandler::delete_record(const RID *rid) {
+  if (disk_buffer_pool_->read_only()) {
+    LOG_WARN("Failed to delete record, file %d is read only.", file_id_);
+    return RC::READONLY;
+  }
+
+  RC ret = RC::SUCCESS;
+  RecordPageHandler page_handler;
+  if ((ret = page_handler.init(*disk_buffer_pool_, file_id_, rid->page_num)) != RC::SUCCESS) {
+    LOG_ERROR("Failed to init record page handler.page number=%d, file_id:%d",
+              rid->page_num, file_id_);
+    return ret;
+  }
+
+  const char *data = nullptr;
+  int length = 0;
+  int flags = 0;
+  RID moved_rid;
+  page_handler.rlatch();
+  ret = page_handler.get_record(rid, &data, &length, &flags);
+  if (ret == RC::SUCCESS && (flags & RecordPageHandler::RECORD_FORWARD)) {
+    memcpy(&moved_rid, data, sizeof(moved_rid));
+  }
+  page_handler.unlatch();
+  if (ret != RC::SUCCESS) {
+    return ret;
+  }
+
+  ret = page_handler.delete_record(rid);
+  page_handler.deinit();
+  if (ret == RC::SUCCESS) {
+    record_num_--;
+    update_free_space(rid->page_num);
+    if (flags & RecordPageHandler::RECORD_FORWARD) {
+      ret = delete_encoded(&moved_rid);
+    }
+  }
+  return ret;
+}
 
+RC RecordFileHandler::delete_encoded(const RID *rid) {
   RC ret = RC::SUCCESS;
   RecordPageHandler page_handler;
-  if ((ret != page_handler.init(*disk_buffer_pool_, file_id_, rid->page_num)) != RC::SUCCESS) {
+  if ((ret = page_handler.init(*disk_buffer_pool_, file_id_, rid->page_num)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init record page handler.page number=%d, file_id:%d",
               rid->page_num, file_id_);
     return ret;
   }
-  return page_handler.delete_record(rid);
+  ret = page_handler.delete_record(rid);
+  page_handler.deinit();
+  if (ret == RC::SUCCESS) {
+    update_free_space(rid->page_num);
+  }
+  return ret;
 }
 
-RC RecordFileHandler::get_record(const RID *rid, Record *rec) {
-  //lock?
+RC RecordFileHandler::get_record(const RID *rid, Record *rec, std::vector<char> &buffer) {
   RC ret = RC::SUCCESS;
   if (nullptr == rid || nullptr == rec) {
     LOG_ERROR("Invalid rid %p or rec %p, one of them is null. ", rid, rec);
     return RC::INVALID_ARGUMENT;
   }
   RecordPageHandler page_handler;
-  if ((ret != page_handler.init(*disk_buffer_pool_, file_id_, rid->page_num)) != RC::SUCCESS) {
+  if ((ret = page_handler.init(*disk_buffer_pool_, file_id_, rid->page_num)) != RC::SUCCESS) {
     LOG_ERROR("Failed to init record page handler.page number=%d, file_id:%d",
               rid->page_num, file_id_);
     return ret;
   }
 
-  return page_handler.get_record(rid, rec);
+  const char *data = nullptr;
+  int length = 0;
+  int flags = 0;
+  page_handler.rlatch();
+  if ((ret = page_handler.get_record(rid, &data, &length, &flags)) != RC::SUCCESS) {
+    page_handler.unlatch();
+    return ret;
+  }
+
+  if (flags & RecordPageHandler::RECORD_FORWARD) {
+    RID moved_rid;
+    memcpy(&moved_rid, data, sizeof(moved_rid));
+    page_handler.unlatch();
+
+    RecordPageHandler moved_page_handler;
+    if ((ret = moved_page_handler.init(*disk_buffer_pool_, file_id_, moved_rid.page_num)) != RC::SUCCESS) {
+      LOG_ERROR("Failed to get moved record. page number=%d, slot=%d", moved_rid.page_num, moved_rid.slot_num);
+      return ret;
+    }
+    moved_page_handler.rlatch();
+    if ((ret = moved_page_handler.get_record(&moved_rid, &data, &length)) == RC::SUCCESS) {
+      ret = decode_record(codec_, data, length, buffer);
+    }
+    moved_page_handler.unlatch();
+  } else {
+    ret = decode_record(codec_, data, length, buffer);
+    page_handler.unlatch();
+  }
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to get record. page number=%d, slot=%d, ret=%d:%s",
+              rid->page_num, rid->slot_num, ret, strrc(ret));
+    return ret;
+  }
+  rec->rid = *rid;
+  rec->data = buffer.data();
+  return RC::SUCCESS;
+}
+RC RecordFileHandler::insert_overflow(const char *data, int length, PageNum *first_page) {
+  if (disk_buffer_pool_->read_only()) {
+    LOG_WARN("Failed to insert overflow data, file %d is read only.", file_id_);
+    return RC::READONLY;
+  }
+
+  // 从后往前写，这样每个页面分配时就知道下一页的页号
+  const int capacity = page_data_size_ - (int)sizeof(OverflowPageHeader);
+  int page_num_of_chain = std::max(1, (length + capacity - 1) / capacity);
+  PageNum next_page = -1;
+  for (int i = page_num_of_chain - 1; i >= 0; i--) {
+    BPPageHandle page_handle;
+    RC ret = disk_buffer_pool_->allocate_page(file_id_, &page_handle);
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to allocate overflow page. file_id:%d, ret=%d:%s", file_id_, ret, strrc(ret));
+      if (next_page >= 0) {
+        delete_overflow(next_page);
+      }
+      return ret;
+    }
+
+    char *page_data = nullptr;
+    disk_buffer_pool_->get_data(&page_handle, &page_data);
+    OverflowPageHeader *header = (OverflowPageHeader *)page_data;
+    const int offset = i * capacity;
+    header->page_type = OVERFLOW_PAGE;
+    header->next_page = next_page;
+    header->length = std::min(capacity, length - offset);
+    memcpy(page_data + sizeof(OverflowPageHeader), data + offset, header->length);
+    next_page = page_handle.frame->page->page_num;
+    disk_buffer_pool_->mark_dirty(&page_handle);
+    disk_buffer_pool_->unpin_page(&page_handle);
+  }
+
+  *first_page = next_page;
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::get_overflow(PageNum first_page, std::string &data) {
+  data.clear();
+  for (PageNum page_num = first_page; page_num >= 0; ) {
+    BPPageHandle page_handle;
+    RC ret = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to get overflow page %d. file_id:%d, ret=%d:%s", page_num, file_id_, ret, strrc(ret));
+      return ret;
+    }
+    char *page_data = nullptr;
+    disk_buffer_pool_->get_data(&page_handle, &page_data);
+    const OverflowPageHeader *header = (const OverflowPageHeader *)page_data;
+    if (header->page_type != OVERFLOW_PAGE) {
+      LOG_ERROR("Page %d is not an overflow page. file_id:%d", page_num, file_id_);
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return RC::RECORD_INVALIDRID;
+    }
+    data.append(page_data + sizeof(OverflowPageHeader), header->length);
+    page_num = header->next_page;
+    disk_buffer_pool_->unpin_page(&page_handle);
+  }
+  return RC::SUCCESS;
+}
+
+RC RecordFileHandler::delete_overflow(PageNum first_page) {
+  if (disk_buffer_pool_->read_only()) {
+    LOG_WARN("Failed to delete overflow data, file %d is read only.", file_id_);
+    return RC::READONLY;
+  }
+
+  for (PageNum page_num = first_page; page_num >= 0; ) {
+    BPPageHandle page_handle;
+    RC ret = disk_buffer_pool_->get_this_page(file_id_, page_num, &page_handle);
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to get overflow page %d. file_id:%d, ret=%d:%s", page_num, file_id_, ret, strrc(ret));
+      return ret;
+    }
+    char *page_data = nullptr;
+    disk_buffer_pool_->get_data(&page_handle, &page_data);
+    OverflowPageHeader *header = (OverflowPageHeader *)page_data;
+    if (header->page_type != OVERFLOW_PAGE) {
+      LOG_ERROR("Page %d is not an overflow page. file_id:%d", page_num, file_id_);
+      disk_buffer_pool_->unpin_page(&page_handle);
+      return RC::RECORD_INVALIDRID;
+    }
+    const PageNum next_page = header->next_page;
+    header->page_type = 0;
+    disk_buffer_pool_->mark_dirty(&page_handle);
+    disk_buffer_pool_->unpin_page(&page_handle);
+    ret = disk_buffer_pool_->dispose_page(file_id_, page_num);
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to dispose overflow page %d. file_id:%d, ret=%d:%s", page_num, file_id_, ret, strrc(ret));
+      return ret;
+    }
+    page_num = next_page;
+  }
+  return RC::SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RecordBatch::clear() {
+  records_.clear();
+  offsets_.clear();
+  buffer_.clear();
+}
+
+char *RecordBatch::add_record(const RID &rid, int length) {
+  Record record;
+  record.rid = rid;
+  record.data = nullptr;
+  records_.push_back(record);
+  offsets_.push_back((int)buffer_.size());
+  buffer_.resize(buffer_.size() + length);
+  return buffer_.data() + offsets_.back();
+}
+
+void RecordBatch::remove_last() {
+  buffer_.resize(offsets_.back());
+  offsets_.pop_back();
+  records_.pop_back();
+}
+
+void RecordBatch::finish() {
+  for (size_t i = 0; i < records_.size(); i++) {
+    records_[i].data = buffer_.data() + offsets_[i];
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -465,10 +1030,15 @@ RC RecordFileHandler::get_record(const RID *rid, Record *rec) {
 RecordFileScanner::RecordFileScanner() : 
     disk_buffer_pool_(nullptr),
     file_id_(-1),
-    condition_filter_(nullptr) {
+    condition_filter_(nullptr),
+    codec_(nullptr),
+    batch_page_num_(0),
+    last_page_num_(-1),
+    read_ahead_end_(-1) {
 }
 
-RC RecordFileScanner::open_scan(DiskBufferPool & buffer_pool, int file_id, ConditionFilter *condition_filter)
+RC RecordFileScanner::open_scan(DiskBufferPool & buffer_pool, int file_id, ConditionFilter *condition_filter,
+                                const RecordCodec *codec)
 {
   close_scan();
 
@@ -476,6 +1046,10 @@ RC RecordFileScanner::open_scan(DiskBufferPool & buffer_pool, int file_id, Condi
   file_id_ = file_id;
 
   condition_filter_ = condition_filter;
+  codec_ = codec;
+  batch_page_num_ = 0;
+  last_page_num_ = 0;     // 批量读取从第一页开始，一定是顺序扫描
+  read_ahead_end_ = -1;
   return RC::SUCCESS;
 }
 
@@ -488,12 +1062,15 @@ RC RecordFileScanner::close_scan() {
     condition_filter_ = nullptr;
   }
 
+  record_page_handler_.deinit();
+  moved_page_handler_.deinit();
   return RC::SUCCESS;
 }
 
 RC RecordFileScanner::get_first_record(Record *rec) {
   rec->rid.page_num = 1; // from 1 参考DiskBufferPool
   rec->rid.slot_num = -1;
+  last_page_num_ = 0;     // 从第一页开始的扫描一定是顺序扫描
   // rec->valid = false;
   return get_next_record(rec);
 }
@@ -520,35 +1097,183 @@ RC RecordFileScanner::get_next_record(Record *rec) {
   while (current_record.rid.page_num < page_count) {
 
     if (current_record.rid.page_num != record_page_handler_.get_page_num()) {
+      read_ahead(current_record.rid.page_num, page_count);
       record_page_handler_.deinit();
       ret = record_page_handler_.init(*disk_buffer_pool_, file_id_, current_record.rid.page_num);
-      if (ret != RC::SUCCESS && ret != RC::BUFFERPOOL_INVALID_PAGE_NUM) {
+      if (ret != RC::SUCCESS && ret != RC::BUFFERPOOL_INVALID_PAGE_NUM && ret != RC::RECORD_NOT_RECORD_PAGE) {
         LOG_ERROR("Failed to init record page handler. page num=%d", current_record.rid.page_num);
         return ret;
       }
 
-      if (RC::BUFFERPOOL_INVALID_PAGE_NUM == ret) {
+      // 跳过已经释放的页面和溢出页
+      if (RC::SUCCESS != ret) {
         current_record.rid.page_num++;
         current_record.rid.slot_num = -1;
         continue;
       }
     }
     
-    ret = record_page_handler_.get_next_record(&current_record);
+    const char *data = nullptr;
+    int length = 0;
+    int flags = 0;
+    record_page_handler_.rlatch();
+    ret = record_page_handler_.get_next_record(&current_record.rid, &data, &length, &flags);
     if (RC::SUCCESS == ret) {
+      if (flags & RecordPageHandler::RECORD_MOVED) {
+        record_page_handler_.unlatch();
+        continue; // 迁移过来的记录通过原来的位置访问
+      }
+      if (flags & RecordPageHandler::RECORD_FORWARD) {
+        ret = get_moved_record(data, &data, &length);
+        record_page_handler_.unlatch();
+        if (ret != RC::SUCCESS) {
+          break;
+        }
+        ret = decode_record(codec_, data, length, record_buffer_);
+        moved_page_handler_.unlatch();
+      } else {
+        ret = decode_record(codec_, data, length, record_buffer_);
+        record_page_handler_.unlatch();
+      }
+      if (ret != RC::SUCCESS) {
+        break;
+      }
+      current_record.data = record_buffer_.data();
       if (condition_filter_ == nullptr || condition_filter_->filter(current_record)) {
         break; // got one
       }
     } else if (RC::RECORD_EOF == ret) {
+      record_page_handler_.unlatch();
       current_record.rid.page_num++;
       current_record.rid.slot_num = -1;
     } else {
+      record_page_handler_.unlatch();
       break; // ERROR
     }
   }
 
+  if (current_record.rid.page_num >= page_count) {
+    ret = RC::RECORD_EOF;
+  }
   if (RC::SUCCESS == ret) {
     *rec = current_record;
   }
   return ret;
 }
+
+RC RecordFileScanner::get_records_batch(RecordBatch &batch) {
+  if (nullptr == disk_buffer_pool_) {
+    LOG_ERROR("Scanner has been closed.");
+    return RC::RECORD_CLOSED;
+  }
+
+  batch.clear();
+  int page_count = 0;
+  RC ret = disk_buffer_pool_->get_page_count(file_id_, &page_count);
+  if (ret != RC::SUCCESS) {
+    LOG_ERROR("Failed to get page count while getting records batch. file id=%d", file_id_);
+    return RC::RECORD_EOF;
+  }
+
+  while (batch.empty()) {
+    if (++batch_page_num_ >= page_count) {
+      return RC::RECORD_EOF;
+    }
+
+    read_ahead(batch_page_num_, page_count);
+    record_page_handler_.deinit();
+    ret = record_page_handler_.init(*disk_buffer_pool_, file_id_, batch_page_num_);
+    if (ret == RC::BUFFERPOOL_INVALID_PAGE_NUM || ret == RC::RECORD_NOT_RECORD_PAGE) {
+      continue;  // 跳过已经释放的页面和溢出页
+    }
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to init record page handler. page num=%d", batch_page_num_);
+      return ret;
+    }
+
+    RID rid;
+    rid.page_num = batch_page_num_;
+    rid.slot_num = -1;
+    const char *data = nullptr;
+    int length = 0;
+    int flags = 0;
+    // 持有读锁把整个页面的记录复制到batch中
+    record_page_handler_.rlatch();
+    while (RC::SUCCESS == (ret = record_page_handler_.get_next_record(&rid, &data, &length, &flags))) {
+      if (flags & RecordPageHandler::RECORD_MOVED) {
+        continue;
+      }
+      const bool moved = (flags & RecordPageHandler::RECORD_FORWARD) != 0;
+      if (moved && (ret = get_moved_record(data, &data, &length)) != RC::SUCCESS) {
+        break;
+      }
+
+      char *record_data = batch.add_record(rid, decoded_length(codec_, length));
+      ret = decode_record(codec_, data, length, record_data);
+      if (moved) {
+        moved_page_handler_.unlatch();
+      }
+      if (ret != RC::SUCCESS) {
+        break;
+      }
+
+      if (condition_filter_ != nullptr) {
+        Record record;
+        record.rid = rid;
+        record.data = record_data;
+        if (!condition_filter_->filter(record)) {
+          batch.remove_last();
+        }
+      }
+    }
+    record_page_handler_.unlatch();
+    if (ret != RC::RECORD_EOF) {
+      return ret;
+    }
+  }
+
+  batch.finish();
+  return RC::SUCCESS;
+}
+
+void RecordFileScanner::read_ahead(PageNum page_num, int page_count) {
+  if (page_num != last_page_num_ + 1) {
+    // 随机访问，重新开始计算预读窗口
+    last_page_num_ = page_num;
+    read_ahead_end_ = page_num + 1;
+    return;
+  }
+  last_page_num_ = page_num;
+
+  // 已预读但还没有访问的页面少于一半窗口时，发起下一批预读
+  if (read_ahead_end_ - page_num > RECORD_READ_AHEAD_PAGES / 2 || read_ahead_end_ >= page_count) {
+    return;
+  }
+
+  PageNum start_page = std::max(read_ahead_end_, page_num + 1);
+  int prefetch_num = std::min(RECORD_READ_AHEAD_PAGES, page_count - start_page);
+  if (prefetch_num <= 0) {
+    return;
+  }
+  disk_buffer_pool_->prefetch_pages(file_id_, start_page, prefetch_num);
+  read_ahead_end_ = start_page + prefetch_num;
+}
+
+RC RecordFileScanner::get_moved_record(const char *forward, const char **data, int *length) {
+  RID rid;
+  memcpy(&rid, forward, sizeof(rid));
+  if (moved_page_handler_.get_page_num() != rid.page_num) {
+    moved_page_handler_.deinit();
+    RC ret = moved_page_handler_.init(*disk_buffer_pool_, file_id_, rid.page_num);
+    if (ret != RC::SUCCESS) {
+      LOG_ERROR("Failed to init page of moved record. page num=%d, ret=%d:%s", rid.page_num, ret, strrc(ret));
+      return ret;
+    }
+  }
+  moved_page_handler_.rlatch();
+  RC ret = moved_page_handler_.get_record(&rid, data, length);
+  if (ret != RC::SUCCESS) {
+    moved_page_handler_.unlatch();
+  }
+  return ret;
+}
@@ -14,10 +14,17 @@ See the Mulan PSL v2 for more details. */
 #ifndef __OBSERVER_STORAGE_COMMON_RECORD_MANAGER_H_
 #define __OBSERVER_STORAGE_COMMON_RECORD_MANAGER_H_
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "storage/default/disk_buffer_pool.h"
+#include "storage/common/free_space_map.h"
 
 typedef int SlotNum;
 struct PageHeader;
+struct RecordSlot;
 class ConditionFilter;
 
 struct RID 
@@ -45,56 +52,142 @@ struct Record
   char *data; // record's data
 };
 
+/**
+ * 记录在页面中的编码方式。定长字段原样保存，变长字段(CHARS)只保存字符串的实际内容，
+ * 前面加两个字节的长度。读取时再补齐成定长的格式，上层看到的记录格式不变
+ */
+class RecordCodec {
+public:
+  /**
+   * @param var_fields 变长字段的偏移和长度
+   */
+  void init(int record_size, const std::vector<std::pair<int, int>> &var_fields);
+
+  int record_size() const { return record_size_; }
+
+  /**
+   * 编码后的最大长度
+   */
+  int max_encoded_size() const;
+
+  /**
+   * 编码record，返回编码后的长度
+   */
+  int encode(const char *record, char *buf) const;
+  RC decode(const char *buf, int length, char *record) const;
+
+private:
+  int record_size_ = 0;
+  std::vector<std::pair<int, int>> var_fields_;  // 按照偏移排序
+};
+
 class RecordPageHandler {
 public:
+  /**
+   * 记录的标记。记录在原页面放不下时迁移到其它页面，原来的位置保存新位置的RID
+   */
+  static const int RECORD_FORWARD = 0x1;  // 这里保存的是迁移后的RID
+  static const int RECORD_MOVED = 0x2;    // 从其它页面迁移过来的记录，扫描时跳过
+
   RecordPageHandler();
   ~RecordPageHandler();
+  /**
+   * 页面不是记录页(比如溢出页)时返回RECORD_NOT_RECORD_PAGE
+   */
   RC init(DiskBufferPool &buffer_pool, int file_id, PageNum page_num);
-  RC init_empty_page(DiskBufferPool &buffer_pool, int file_id, PageNum page_num, int record_size);
+  RC init_empty_page(DiskBufferPool &buffer_pool, int file_id, PageNum page_num);
   RC deinit();
 
-  RC insert_record(const char *data, RID *rid);
-  RC update_record(const Record *rec);
+  /**
+   * 根据记录大小选择数据文件的页大小，保证每页至少能放下一定数量的记录
+   */
+  static int page_size_for(int record_size);
 
-  template <class RecordUpdater>
-  RC update_record_in_place(const RID *rid, RecordUpdater updater) {
-    Record record;
-    RC rc = get_record(rid, &record);
-    if (rc != RC::SUCCESS) {
-      return rc;
-    }
-    rc = updater(record);
-    disk_buffer_pool_->mark_dirty(&page_handle_);
-    return rc;
-  }
+  /**
+   * 页面上的记录都是编码后的变长记录，长度为length
+   */
+  RC insert_record(const char *data, int length, RID *rid, int flags = 0);
+
+  /**
+   * 原地更新记录，页面整理后仍然放不下时返回RECORD_NOMEM
+   */
+  RC update_record(const RID *rid, const char *data, int length, int flags = 0);
 
   RC delete_record(const RID *rid);
 
-  RC get_record(const RID *rid, Record *rec);
-  RC get_first_record(Record *rec);
-  RC get_next_record(Record *rec);
+  /**
+   * data指向页面中的数据，需要在rlatch和unlatch之间读取，解锁后页面可能被整理
+   */
+  RC get_record(const RID *rid, const char **data, int *length, int *flags = nullptr);
+
+  /**
+   * 从rid的下一个槽位开始找有记录的槽位，与get_record一样需要持有读锁
+   */
+  RC get_next_record(RID *rid, const char **data, int *length, int *flags);
+
+  /**
+   * 读取页面上的记录时加页帧的读锁。修改页面的接口内部加写锁，调用前不要持有读锁
+   */
+  void rlatch() { page_handle_.rlatch(); }
+  void unlatch() { page_handle_.unlatch(); }
 
   PageNum get_page_num() const;
 
-  bool is_full() const;
+  /**
+   * 页面上的记录个数，迁移的记录在原页面和新页面上各算一次
+   */
+  int record_num() const;
+
+  /**
+   * 是否能放下长度为length的记录
+   */
+  bool can_insert(int length) const;
+
+  /**
+   * 页面剩余空间的等级，用于更新空闲空间表
+   */
+  int free_space_class() const;
+
+  /**
+   * 页面剩余空间，已经预留了新槽位需要的空间
+   */
+  int free_space() const;
+
+private:
+  /**
+   * 加载页面但是不检查页面类型
+   */
+  RC init_page(DiskBufferPool &buffer_pool, int file_id, PageNum page_num);
+
+  /**
+   * 把所有记录移动到页面末尾，回收删除和更新留下的空洞
+   */
+  void compact();
+
+  int data_size() const { return page_handle_.frame->data_size(); }
 
 private:
   DiskBufferPool * disk_buffer_pool_;
   int              file_id_;
   BPPageHandle     page_handle_;
   PageHeader    *  page_header_;
-  char *           bitmap_;
+  RecordSlot    *  slots_;
 };
 
 class RecordFileHandler {
 public:
   RecordFileHandler();
-  RC init(DiskBufferPool &buffer_pool, int file_id);
+
+  /**
+   * @param fsm_file_id 空闲空间表文件，小于0时不使用空闲空间表，插入时只使用当前页面或者新页面
+   * @param codec 记录的编码方式，为空时记录原样保存
+   */
+  RC init(DiskBufferPool &buffer_pool, int file_id, int fsm_file_id = -1, const RecordCodec *codec = nullptr);
   void close();
 
   /**
    * 更新指定文件中的记录，rec指向的记录结构中的rid字段为要更新的记录的标识符，
-   * pData字段指向新的记录内容
+   * pData字段指向新的记录内容。记录变长后原页面放不下时迁移到其它页面，rid不变
    * @param rec
    * @return
    */
@@ -116,30 +209,108 @@ public:
   RC insert_record(const char *data, int record_size, RID *rid);
 
   /**
-   * 获取指定文件中标识符为rid的记录内容到rec指向的记录结构中
+   * 获取指定文件中标识符为rid的记录内容到rec指向的记录结构中。
+   * 记录解码到调用方的buffer中，rec->data指向buffer，修改后需要调用update_record写回
    * @param rid
    * @param rec
    * @return
    */
-  RC get_record(const RID *rid, Record *rec);
+  RC get_record(const RID *rid, Record *rec, std::vector<char> &buffer);
+
+  /**
+   * 文件中的记录数。打开文件时根据抽样的页面估计，之后随插入和删除增减
+   */
+  int record_num() const { return record_num_; }
+
+  /**
+   * 大字段保存在数据文件的溢出页链表中，记录中只保存链表第一页的页号
+   * @param first_page 返回链表第一页的页号
+   */
+  RC insert_overflow(const char *data, int length, PageNum *first_page);
+  RC get_overflow(PageNum first_page, std::string &data);
+  RC delete_overflow(PageNum first_page);
 
   template<class RecordUpdater> // 改成普通模式, 不使用模板
   RC update_record_in_place(const RID *rid, RecordUpdater updater) {
-
-    RC rc = RC::SUCCESS;
-    RecordPageHandler page_handler;
-    if ((rc != page_handler.init(*disk_buffer_pool_, file_id_, rid->page_num)) != RC::SUCCESS) {
+    Record record;
+    std::vector<char> buffer;
+    RC rc = get_record(rid, &record, buffer);
+    if (rc != RC::SUCCESS) {
       return rc;
     }
-
-    return page_handler.update_record_in_place(rid, updater);
+    rc = updater(record);
+    if (rc != RC::SUCCESS) {
+      return rc;
+    }
+    return update_record(&record);
   }
 
+private:
+  /**
+   * 空闲空间表文件是空的，说明是新建的，扫描一遍数据文件建立
+   */
+  RC rebuild_free_space_map();
+  void update_free_space(PageNum page_num);
+
+  /**
+   * 均匀地读取最多SAMPLE_PAGE_NUM个页面，按照平均每页的记录数估计文件中的记录数
+   */
+  RC estimate_record_num();
+
+  /**
+   * 插入或者删除编码后的记录
+   */
+  RC insert_encoded(const char *data, int length, int flags, RID *rid);
+  RC delete_encoded(const RID *rid);
+
+  /**
+   * 把记录编码到buffer中，返回编码后的长度
+   */
+  int encode(const char *data, int record_size, std::vector<char> &buffer) const;
+
 private:
   DiskBufferPool  *   disk_buffer_pool_;
   int                 file_id_;                    // 参考DiskBufferPool中的fileId
+  const RecordCodec * codec_;
+  int                 page_data_size_;
 
+  std::mutex          insert_mutex_;               // 保护record_page_handler_和free_space_map_
   RecordPageHandler   record_page_handler_;        // 目前只有insert record使用
+  FreeSpaceMap        free_space_map_;
+  std::atomic<int>    record_num_;
+};
+
+/**
+ * 一个页面上的一批记录。记录解码到批次自己的缓存中，缓存在多次使用之间复用
+ */
+class RecordBatch {
+public:
+  void clear();
+
+  bool empty() const { return records_.empty(); }
+  int size() const { return (int)records_.size(); }
+  Record &record(int index) { return records_[index]; }
+  const Record &record(int index) const { return records_[index]; }
+
+  /**
+   * 增加一条记录，返回记录数据的位置，在下一次add_record之前有效
+   */
+  char *add_record(const RID &rid, int length);
+
+  /**
+   * 去掉最后一条记录，用于过滤掉不满足条件的记录
+   */
+  void remove_last();
+
+  /**
+   * 所有记录都加入后，设置每条记录的数据指针
+   */
+  void finish();
+
+private:
+  std::vector<Record> records_;
+  std::vector<int>    offsets_;
+  std::vector<char>   buffer_;
 };
 
 class RecordFileScanner 
@@ -158,9 +329,11 @@ public:
    * @param file_id 
    * @param condition_num 
    * @param conditions
+   * @param codec 记录的编码方式，与RecordFileHandler一致
    * @return
    */
-  RC open_scan(DiskBufferPool & buffer_pool, int file_id, ConditionFilter *condition_filter);
+  RC open_scan(DiskBufferPool & buffer_pool, int file_id, ConditionFilter *condition_filter,
+               const RecordCodec *codec = nullptr);
 
   /**
    * 关闭一个文件扫描，释放相应的资源
@@ -179,12 +352,37 @@ public:
    */
   RC get_next_record(Record *rec);
 
+  /**
+   * 一次返回下一个页面上所有符合扫描条件的记录，跳过没有符合条件记录的页面。
+   * 与get_next_record使用各自的扫描位置，不要混用
+   * @return 没有更多记录时返回RECORD_EOF
+   */
+  RC get_records_batch(RecordBatch &batch);
+
+private:
+  /**
+   * 顺序扫描时，提前预读后面的页面
+   */
+  void read_ahead(PageNum page_num, int page_count);
+
+  /**
+   * 读取迁移到其它页面的记录。成功时持有moved_page_handler_的读锁，读取后由调用方解锁
+   */
+  RC get_moved_record(const char *forward, const char **data, int *length);
+
 private:
   DiskBufferPool  *   disk_buffer_pool_;
   int                 file_id_;                    // 参考DiskBufferPool中的fileId
 
   ConditionFilter *   condition_filter_;
+  const RecordCodec * codec_;
   RecordPageHandler   record_page_handler_;
+  RecordPageHandler   moved_page_handler_;         // 迁移后的记录所在的页面
+  std::vector<char>   record_buffer_;              // 解码后的记录
+
+  PageNum             batch_page_num_;             // 批量读取的上一个页面
+  PageNum             last_page_num_;              // 上一次访问的页面号，用于判断是否顺序访问
+  PageNum             read_ahead_end_;             // 已经发起预读的页面的结束位置(不包含)
 };
 
 
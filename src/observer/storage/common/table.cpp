@@ -13,8 +13,10 @@ See the Mulan PSL v2 for more details. */
 //
 
 #include <limits.h>
+#include <stdint.h>
 #include <memory>
 #include <string.h>
+#include <unistd.h>
 #include <algorithm>
 #include<iostream>
 
@@ -30,20 +32,45 @@ See the Mulan PSL v2 for more details. */
 #include "storage/common/record_manager.h"
 #include "storage/common/condition_filter.h"
 #include "storage/common/meta_util.h"
+#include "storage/common/table_stats.h"
 #include "storage/common/index.h"
 #include "storage/common/bplus_tree_index.h"
 #include "storage/trx/trx.h"
 
+/**
+ * TEXT字段在记录中只保存溢出页链表的位置，第一个字节用来和空值标记'!'区分
+ */
+struct TextFieldData {
+    char     flag;
+    char     reserved;
+    uint16_t length;
+    PageNum  first_page;
+};
+
+static const char TEXT_FIELD_FLAG = 'T';
+static const int TEXT_MAX_LENGTH = 4096;
+
 Table::Table() :
         data_buffer_pool_(nullptr),
         file_id_(-1),
-        record_handler_(nullptr) {
+        fsm_file_id_(-1),
+        record_handler_(nullptr),
+        record_codec_(nullptr),
+        table_stats_(nullptr),
+        uncommitted_record_num_(-1) {
 }
 
 Table::~Table() {
     delete record_handler_;
     record_handler_ = nullptr;
+    delete record_codec_;
+    record_codec_ = nullptr;
+    delete table_stats_;
+    table_stats_ = nullptr;
 
+    if (data_buffer_pool_ != nullptr && fsm_file_id_ >= 0) {
+        data_buffer_pool_->close_file(fsm_file_id_);
+    }
     if (data_buffer_pool_ != nullptr && file_id_ >= 0) {
         data_buffer_pool_->close_file(file_id_);
         data_buffer_pool_ = nullptr;
@@ -105,15 +132,22 @@ RC Table::create(const char *path, const char *name, const char *base_dir, int a
 
     std::string data_file = std::string(base_dir) + "/" + name + TABLE_DATA_SUFFIX;
     data_buffer_pool_ = theGlobalDiskBufferPool();
-    rc = data_buffer_pool_->create_file(data_file.c_str());
+    rc = data_buffer_pool_->create_file(data_file.c_str(), RecordPageHandler::page_size_for(table_meta_.record_size()));
     if (rc != RC::SUCCESS) {
         LOG_ERROR("Failed to create disk buffer pool of data file. file name=%s", data_file.c_str());
         return rc;
     }
+    std::string fsm_file = std::string(base_dir) + "/" + name + TABLE_FSM_SUFFIX;
+    rc = data_buffer_pool_->create_file(fsm_file.c_str());
+    if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to create free space map file. file name=%s", fsm_file.c_str());
+        return rc;
+    }
 
     rc = init_record_handler(base_dir);
 
     base_dir_ = base_dir;
+    uncommitted_record_num_ = 0;
     LOG_INFO("Successfully create table %s:%s", base_dir, name);
     return rc;
 }
@@ -220,23 +254,47 @@ RC Table::open(const char *meta_file, const char *base_dir) {
         }
         indexes_.push_back(index);
     }
+
+    // 统计信息文件只在执行过ANALYZE TABLE后存在
+    std::string stats_file = table_stats_file(base_dir, name());
+    if (access(stats_file.c_str(), F_OK) == 0) {
+        TableStats *stats = new TableStats();
+        if (stats->load(stats_file.c_str()) == RC::SUCCESS) {
+            table_stats_ = stats;
+        } else {
+            LOG_WARN("Failed to load table stats, ignore it. table=%s, file=%s", name(), stats_file.c_str());
+            delete stats;
+        }
+    }
     return rc;
 }
 
 RC Table::commit_insert(Trx *trx, const RID &rid) {
     Record record;
-    RC rc = record_handler_->get_record(&rid, &record);
+    std::vector<char> record_buffer;
+    RC rc = record_handler_->get_record(&rid, &record, record_buffer);
     if (rc != RC::SUCCESS) {
         return rc;
     }
 
-    return trx->commit_insert(this, record);
+    // 记录是解码后的副本，修改后需要写回
+    const bool marked = has_trx_mark(record.data);
+    rc = trx->commit_insert(this, record);
+    if (rc != RC::SUCCESS) {
+        return rc;
+    }
+    rc = record_handler_->update_record(&record);
+    if (rc == RC::SUCCESS && marked) {
+        add_uncommitted_record_num(-1);
+    }
+    return rc;
 }
 
 RC Table::rollback_insert(Trx *trx, const RID &rid) {
 
     Record record;
-    RC rc = record_handler_->get_record(&rid, &record);
+    std::vector<char> record_buffer;
+    RC rc = record_handler_->get_record(&rid, &record, record_buffer);
     if (rc != RC::SUCCESS) {
         return rc;
     }
@@ -247,7 +305,12 @@ RC Table::rollback_insert(Trx *trx, const RID &rid) {
         LOG_ERROR("Failed to delete indexes of record(rid=%d.%d) while rollback insert, rc=%d:%s",
                   rid.page_num, rid.slot_num, rc, strrc(rc));
     } else {
+        const bool marked = has_trx_mark(record.data);
+        delete_text_of_record(record.data);
         rc = record_handler_->delete_record(&rid);
+        if (rc == RC::SUCCESS && marked) {
+            add_uncommitted_record_num(-1);
+        }
     }
     return rc;
 }
@@ -297,6 +360,9 @@ RC Table::insert_record(Trx *trx, Record *record) {
         }
         return rc;
     }
+    if (has_trx_mark(record->data)) {
+        add_uncommitted_record_num(1);
+    }
     return rc;
 }
 
@@ -321,6 +387,7 @@ RC Table::mulit_insert_record(Trx *trx, int value_num, const Value *values, std:
     trash.push_back(record);
     if (rc != RC::SUCCESS) {
         trash.pop_back();
+        delete_text_of_record(record_data);
     }
     delete[] record_data;
     return rc;
@@ -343,6 +410,9 @@ RC Table::insert_record(Trx *trx, int value_num, const Value *values) {
     record.data = record_data;
     // record.valid = true;
     rc = insert_record(trx, &record);
+    if (rc != RC::SUCCESS) {
+        delete_text_of_record(record_data);
+    }
     delete[] record_data;
     return rc;
 }
@@ -351,27 +421,74 @@ const char *Table::name() const {
     return table_meta_.name();
 }
 
-class IndexInserter {
-public:
-    explicit IndexInserter(Index *index) : index_(index) {
-    }
+const TableMeta &Table::table_meta() const {
+    return table_meta_;
+}
 
-    RC insert_index(const Record *record) {
-        return index_->insert_entry(record->data, &record->rid);
+
+RC Table::write_text(const char *text, char *field_data) {
+    TextFieldData text_field;
+    text_field.flag = TEXT_FIELD_FLAG;
+    text_field.reserved = 0;
+    text_field.length = (uint16_t) strnlen(text, TEXT_MAX_LENGTH);
+    RC rc = record_handler_->insert_overflow(text, text_field.length, &text_field.first_page);
+    if (rc != RC::SUCCESS) {
+        return rc;
     }
+    memcpy(field_data, &text_field, sizeof(text_field));
+    return rc;
+}
 
-    Index *get_index() {
-        return index_;
+RC Table::read_text(const char *field_data, std::string &text) {
+    if (*field_data == '!') {
+        text = "!null";
+        return RC::SUCCESS;
     }
+    TextFieldData text_field;
+    memcpy(&text_field, field_data, sizeof(text_field));
+    if (text_field.flag != TEXT_FIELD_FLAG) {
+        LOG_WARN("Invalid text field of table %s.", name());
+        text.clear();
+        return RC::INVALID_ARGUMENT;
+    }
+    return record_handler_->get_overflow(text_field.first_page, text);
+}
 
-private:
-    Index *index_;
-};
+RC Table::delete_text(const char *field_data) {
+    TextFieldData text_field;
+    memcpy(&text_field, field_data, sizeof(text_field));
+    if (text_field.flag != TEXT_FIELD_FLAG) {
+        return RC::SUCCESS; // 空值
+    }
+    return record_handler_->delete_overflow(text_field.first_page);
+}
 
-const TableMeta &Table::table_meta() const {
-    return table_meta_;
+RC Table::delete_text_of_record(const char *record) {
+    RC rc = RC::SUCCESS;
+    for (int i = table_meta_.sys_field_num(); i < table_meta_.field_num(); i++) {
+        const FieldMeta *field = table_meta_.field(i);
+        if (field->type() == TEXTS) {
+            RC rc2 = delete_text(record + field->offset());
+            if (rc2 != RC::SUCCESS) {
+                LOG_ERROR("Failed to delete text field %s of table %s. rc=%d:%s", field->name(), name(), rc2, strrc(rc2));
+                rc = rc2;
+            }
+        }
+    }
+    return rc;
 }
 
+/**
+ * 字符串和空值的长度可能小于字段的长度，只复制实际的内容，剩下的部分填0
+ */
+static void copy_field_value(char *field_data, const FieldMeta &field, const Value &value) {
+    int len = field.len();
+    if (value.type == CHARS || value.type == NULLS) {
+        len = std::min(len, (int) strlen((const char *) value.data) + 1);
+    }
+    memset(field_data, 0, field.len());
+    memcpy(field_data, value.data, len);
+}
 
 RC Table::make_record(int value_num, const Value *values, char *&record_out) {
     // 检查字段类型是否一致
@@ -384,44 +501,13 @@ RC Table::make_record(int value_num, const Value *values, char *&record_out) {
     table_meta_.fields_nullable_type(fields_nullable);
     for (int i = 0; i < value_num; i++) {
         const FieldMeta *field = table_meta_.field(i + normal_field_start_index);
-        Value &value = const_cast<Value &>(values[i]);
+        const Value &value = values[i];
         if (field->type() != value.type && NULLS != value.type &&
             field->type() != TEXTS) {  // NULLS type can match any type
             LOG_ERROR("Invalid value type. field name=%s, type=%d, but given=%d",
                       field->name(), field->type(), value.type);
             return RC::SCHEMA_FIELD_TYPE_MISMATCH;
         }
-        if (field->type() == TEXTS && value.type == CHARS) {
-            value.type = TEXTS;
-            char text[4097];
-            char *val = static_cast<char *>(value.data);
-            if (strlen(val) > 4096) {
-                std::strncpy(text, static_cast<char *>(value.data), 4096);
-            } else {
-                strcpy(text , static_cast<char *>(value.data));
-            }
-//           std:: string out;
-            std::ostringstream os;
-            {
-                os << text << std::endl;
-            }
-            int a = rand();
-            int b = rand();
-            int c = rand();
-            int key = a * 99 + b * 9 + c;
-            const char *name = "text";
-            std::string path = name;
-            std::ofstream fout(
-                    "./miniob/db/sys/" + std::string(const_cast<char *>(table_meta_.name())) + "_" +
-                    std::to_string(key) + "_" +
-                    path + ".txt");
-            if (fout) {
-                //将out流转换为string类型，写入到文件流中
-                fout << os.str() << std::endl;
-                fout.close();
-            }
-            value.data = static_cast<void *>(&key);
-        }
         if (NULLS == value.type && fields_nullable[i] == false) {
             LOG_ERROR("fields not nullable. field name=%s, type=%d, but given=%d",
                       field->name(), field->type(), value.type);
@@ -432,13 +518,23 @@ RC Table::make_record(int value_num, const Value *values, char *&record_out) {
     // 复制所有字段的值
     int record_size = table_meta_.record_size();
     char *record = new char[record_size];
+    memset(record, 0, record_size);
 
     for (int i = 0; i < value_num; i++) {
         const FieldMeta *field = table_meta_.field(i + normal_field_start_index);
         const Value &value = values[i];
-        std::string data = (char *) (value.data);
+        if (field->type() == TEXTS && value.type != NULLS) {
+            RC rc = write_text((const char *) value.data, record + field->offset());
+            if (rc != RC::SUCCESS) {
+                LOG_ERROR("Failed to write text field %s. rc=%d:%s", field->name(), rc, strrc(rc));
+                delete_text_of_record(record);
+                delete[] record;
+                return rc;
+            }
+            continue;
+        }
         // std::transform(data.begin(), data.end(), ::tolower);
-        memcpy(record + field->offset(), value.data, field->len());
+        copy_field_value(record + field->offset(), *field, value);
     }
 
     record_out = record;
@@ -459,8 +555,36 @@ RC Table::init_record_handler(const char *base_dir) {
         return rc;
     }
 
+    // 只读模式下不会插入记录，不需要空闲空间表。早期创建的表没有空闲空间表，打开时补上
+    if (!data_buffer_pool_->read_only()) {
+        std::string fsm_file = std::string(base_dir) + "/" + table_meta_.name() + TABLE_FSM_SUFFIX;
+        if (access(fsm_file.c_str(), F_OK) != 0) {
+            rc = data_buffer_pool_->create_file(fsm_file.c_str());
+            if (rc != RC::SUCCESS) {
+                LOG_ERROR("Failed to create free space map file:%s. rc=%d:%s", fsm_file.c_str(), rc, strrc(rc));
+                return rc;
+            }
+        }
+        rc = data_buffer_pool_->open_file(fsm_file.c_str(), &fsm_file_id_);
+        if (rc != RC::SUCCESS) {
+            LOG_ERROR("Failed to open free space map file:%s. rc=%d:%s", fsm_file.c_str(), rc, strrc(rc));
+            return rc;
+        }
+    }
+
+    // 字符串字段只保存实际的内容
+    std::vector<std::pair<int, int>> var_fields;
+    for (int i = 0; i < table_meta_.field_num(); i++) {
+        const FieldMeta *field = table_meta_.field(i);
+        if (field->type() == CHARS) {
+            var_fields.emplace_back(field->offset(), field->len());
+        }
+    }
+    record_codec_ = new RecordCodec();
+    record_codec_->init(table_meta_.record_size(), var_fields);
+
     record_handler_ = new RecordFileHandler();
-    rc = record_handler_->init(*data_buffer_pool_, data_buffer_pool_file_id);
+    rc = record_handler_->init(*data_buffer_pool_, data_buffer_pool_file_id, fsm_file_id_, record_codec_);
     if (rc != RC::SUCCESS) {
         LOG_ERROR("Failed to init record handler. rc=%d:%s", rc, strrc(rc));
         return rc;
@@ -515,29 +639,35 @@ RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *contex
         limit = INT_MAX;
     }
 
-    // IndexScanner *index_scanner = find_index_for_scan(filter);
-    // if (index_scanner != nullptr) {
-    //     return scan_record_by_index(trx, index_scanner, filter, limit, context, record_reader);
-    // }
+    IndexScanner *index_scanner = find_index_for_scan(filter);
+    if (index_scanner != nullptr) {
+        return scan_record_by_index(trx, index_scanner, filter, limit, context, record_reader);
+    }
 
     RC rc = RC::SUCCESS;
     RecordFileScanner scanner;
-    rc = scanner.open_scan(*data_buffer_pool_, file_id_, filter);
+    rc = scanner.open_scan(*data_buffer_pool_, file_id_, filter, record_codec_);
     if (rc != RC::SUCCESS) {
         LOG_ERROR("failed to open scanner. file id=%d. rc=%d:%s", file_id_, rc, strrc(rc));
         return rc;
     }
 
+    // 每次取出一个页面上的记录
     int record_count = 0;
-    Record record;
-    rc = scanner.get_first_record(&record);
-    for (; RC::SUCCESS == rc && record_count < limit; rc = scanner.get_next_record(&record)) {
-        if (trx == nullptr || trx->is_visible(this, &record)) {
-            rc = record_reader(&record, context);
-            if (rc != RC::SUCCESS) {
-                break;
+    RecordBatch batch;
+    while (record_count < limit && RC::SUCCESS == (rc = scanner.get_records_batch(batch))) {
+        for (int i = 0; i < batch.size() && record_count < limit; i++) {
+            Record &record = batch.record(i);
+            if (trx == nullptr || trx->is_visible(this, &record)) {
+                rc = record_reader(&record, context);
+                if (rc != RC::SUCCESS) {
+                    break;
+                }
+                record_count++;
             }
-            record_count++;
+        }
+        if (rc != RC::SUCCESS) {
+            break;
         }
     }
 
@@ -550,133 +680,92 @@ RC Table::scan_record(Trx *trx, ConditionFilter *filter, int limit, void *contex
     return rc;
 }
 
-RC Table::scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter *filter, int limit, void *context,
-                               RC (*record_reader)(Record *, void *)) {
-    RC rc = RC::SUCCESS;
-    RID rid;
-    Record record;
-    int record_count = 0;
-    while (record_count < limit) {
-        rc = scanner->next_entry(&rid);
-        if (rc != RC::SUCCESS) {
-            if (RC::RECORD_EOF == rc || RC::RECORD_NO_MORE_IDX_IN_MEM == rc) {
-                rc = RC::SUCCESS;
-                break;
-            }
-            LOG_ERROR("Failed to scan table by index. rc=%d:%s", rc, strrc(rc));
-            break;
-        }
-
-        rc = record_handler_->get_record(&rid, &record);
-        if (rc != RC::SUCCESS) {
-            LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s", rid.page_num, rid.slot_num, rc, strrc(rc));
-            break;
-        }
-
-        if ((trx == nullptr || trx->is_visible(this, &record)) && (filter == nullptr || filter->filter(record))) {
-            rc = record_reader(&record, context);
-            if (rc != RC::SUCCESS) {
-                LOG_TRACE("Record reader break the table scanning. rc=%d:%s", rc, strrc(rc));
-                break;
-            }
-        }
-
-        record_count++;
+RC Table::open_scanner(RecordFileScanner &scanner, ConditionFilter *filter) {
+    RC rc = scanner.open_scan(*data_buffer_pool_, file_id_, filter, record_codec_);
+    if (rc != RC::SUCCESS) {
+        LOG_ERROR("failed to open scanner. file id=%d. rc=%d:%s", file_id_, rc, strrc(rc));
     }
-
-    scanner->destroy();
     return rc;
 }
 
-
-static RC insert_index_record_reader_adapter(Record *record, void *context) {
-    IndexInserter &inserter = *(IndexInserter *) context;
-
-    return inserter.insert_index(record);
+int Table::estimated_record_num() {
+    return std::max(record_handler_->record_num(), 0);
 }
 
-/*
-RC Table::create_index(Trx *trx, const char *index_name, const char *attribute_name, const int &is_unique) {
+// 通过索引读取记录时每批最多取出的索引项个数
+static const size_t INDEX_SCAN_BATCH_SIZE = 1024;
 
-    if (index_name == nullptr || common::is_blank(index_name) ||
-        attribute_name == nullptr || common::is_blank(attribute_name)) {
-        return RC::INVALID_ARGUMENT;
-    }
-    if (table_meta_.index(index_name) != nullptr ||
-        table_meta_.find_index_by_field((attribute_name))) {
-        return RC::SCHEMA_INDEX_EXIST;
-    }
+static bool rid_less(const RID &left, const RID &right) {
+    return left.page_num < right.page_num || (left.page_num == right.page_num && left.slot_num < right.slot_num);
+}
 
-    const FieldMeta *field_meta = table_meta_.field(attribute_name);
-    if (!field_meta) {
-        return RC::SCHEMA_FIELD_MISSING;
+/**
+ * 从索引扫描中最多取出max_num个rid并按rid排序，这样读取记录的顺序与扫描数据文件时相同。
+ * 索引扫描已经结束、没有取到rid时返回RECORD_EOF
+ */
+static RC read_index_rids(IndexScanner *scanner, size_t max_num, std::vector<RID> &rids) {
+    rids.clear();
+    RC rc = RC::SUCCESS;
+    RID rid;
+    while (rids.size() < max_num && RC::SUCCESS == (rc = scanner->next_entry(&rid))) {
+        rids.push_back(rid);
     }
-
-    IndexMeta new_index_meta;
-    RC rc = new_index_meta.init(index_name, *field_meta, is_unique);
-    if (rc != RC::SUCCESS) {
+    if (RC::SUCCESS != rc && RC::RECORD_EOF != rc && RC::RECORD_NO_MORE_IDX_IN_MEM != rc) {
         return rc;
     }
-
-    // 创建索引相关数据
-    BplusTreeIndex *index = new BplusTreeIndex();
-    std::string index_file = index_data_file(base_dir_.c_str(), name(), index_name);
-    rc = index->create(index_file.c_str(), new_index_meta, *field_meta);
-    if (rc != RC::SUCCESS) {
-        delete index;
-        LOG_ERROR("Failed to create bplus tree index. file name=%s, rc=%d:%s", index_file.c_str(), rc, strrc(rc));
-        return rc;
+    if (rids.empty()) {
+        return RC::RECORD_EOF;
     }
 
-    // 遍历当前的所有数据，插入这个索引
-    IndexInserter index_inserter(index);
-    rc = scan_record(trx, nullptr, -1, &index_inserter, insert_index_record_reader_adapter);
-    if (rc != RC::SUCCESS) {
-        // rollback
-        delete index;
-        LOG_ERROR("Failed to insert index to all records. table=%s, rc=%d:%s", name(), rc, strrc(rc));
-        return rc;
+    std::sort(rids.begin(), rids.end(), rid_less);
+    return RC::SUCCESS;
+}
+
+RC Table::scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter *filter, int limit, void *context,
+                               RC (*record_reader)(Record *, void *)) {
+    // 只有更新和删除使用，record_reader会修改正在扫描的索引，所以先取出所有的rid再读取记录
+    std::vector<RID> rids;
+    RC rc = read_index_rids(scanner, SIZE_MAX, rids);
+    scanner->destroy();
+    if (rc == RC::RECORD_EOF) {
+        return RC::SUCCESS;
     }
-    indexes_.push_back(index);
-    TableMeta new_table_meta(table_meta_);
-    rc = new_table_meta.add_index(new_index_meta);
     if (rc != RC::SUCCESS) {
-        LOG_ERROR("Failed to add index (%s) on table (%s). error=%d:%s", index_name, name(), rc, strrc(rc));
+        LOG_ERROR("Failed to scan table by index. rc=%d:%s", rc, strrc(rc));
         return rc;
     }
-    // 创建元数据临时文件
-    std::string tmp_file = table_meta_file(base_dir_.c_str(), name()) + ".tmp";
-    std::fstream fs;
-    fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-    if (!fs.is_open()) {
-        LOG_ERROR("Failed to open file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
-        return RC::IOERR; // 创建索引中途出错，要做还原操作
-    }
-    if (new_table_meta.serialize(fs) < 0) {
-        LOG_ERROR("Failed to dump new table meta to file: %s. sys err=%d:%s", tmp_file.c_str(), errno, strerror(errno));
-        return RC::IOERR;
-    }
-    fs.close();
 
-    // 覆盖原始元数据文件
-    std::string meta_file = table_meta_file(base_dir_.c_str(), name());
-    int ret = rename(tmp_file.c_str(), meta_file.c_str());
-    if (ret != 0) {
-        LOG_ERROR(
-                "Failed to rename tmp meta file (%s) to normal meta file (%s) while creating index (%s) on table (%s). " \
-              "system error=%d:%s", tmp_file.c_str(), meta_file.c_str(), index_name, name(), errno, strerror(errno));
-        return RC::IOERR;
+    Record record;
+    std::vector<char> record_buffer;
+    int record_count = 0;
+    for (size_t i = 0; i < rids.size() && record_count < limit; i++) {
+        rc = record_handler_->get_record(&rids[i], &record, record_buffer);
+        if (rc != RC::SUCCESS) {
+            LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s", rids[i].page_num, rids[i].slot_num, rc, strrc(rc));
+            return rc;
+        }
+
+        if ((trx == nullptr || trx->is_visible(this, &record)) && (filter == nullptr || filter->filter(record))) {
+            rc = record_reader(&record, context);
+            if (rc != RC::SUCCESS) {
+                LOG_TRACE("Record reader break the table scanning. rc=%d:%s", rc, strrc(rc));
+                return rc;
+            }
+            record_count++;
+        }
     }
+    return RC::SUCCESS;
+}
 
-    table_meta_.swap(new_table_meta);
 
-    LOG_INFO("add a new index (%s) on the table (%s)", index_name, name());
+static RC load_index_record_reader_adapter(Record *record, void *context) {
+    BplusTreeIndex &index = *(BplusTreeIndex *) context;
 
+    return index.load_entry(record->data, &record->rid);
+}
 
-    return rc;
-} */
-
-RC Table::create_index(Trx *trx, const char *index_name, const char *const attributes_name[], int attribute_num, const int &is_unique) {
+RC Table::create_index(Trx *trx, const char *index_name, const char *const attributes_name[], int attribute_num,
+                       const int &is_unique, const IndexBuildOptions &options) {
     // 检查参数
     if (index_name == nullptr || common::is_blank(index_name)) {
         return RC::INVALID_ARGUMENT;
@@ -694,7 +783,7 @@ RC Table::create_index(Trx *trx, const char *index_name, const char *const attri
     for (int i = attribute_num - 1; i >= 0; i--) {
         name_lens += (strlen(attributes_name[i]) + 1);
     }
-    std::unique_ptr<char> field_name(new char[name_lens + 1]);
+    std::unique_ptr<char[]> field_name(new char[name_lens + 1]);
     char* field_name_ptr = field_name.get();
     name_lens = 0;
     for (int i = attribute_num - 1; i >= 0; i--) {
@@ -737,9 +826,16 @@ RC Table::create_index(Trx *trx, const char *index_name, const char *const attri
         return rc;
     }
 
-    // 遍历当前的所有数据，插入这个索引
-    IndexInserter index_inserter(index);
-    rc = scan_record(trx, nullptr, -1, &index_inserter, insert_index_record_reader_adapter);
+    // 遍历当前的所有数据，排序后批量构建索引，临时文件放在表所在的目录中
+    IndexBuildOptions build_options = options;
+    build_options.temp_dir = base_dir_;
+    rc = index->begin_load(build_options);
+    if (rc == RC::SUCCESS) {
+        rc = scan_record(trx, nullptr, -1, index, load_index_record_reader_adapter);
+    }
+    if (rc == RC::SUCCESS) {
+        rc = index->end_load();
+    }
     if (rc != RC::SUCCESS) {
         // rollback
         delete index;
@@ -829,6 +925,10 @@ RC Table::update_record(Trx *trx, ConditionFilter *filter, const char *attribute
 }
 
 RC Table::update_record(Trx *trx, Record *record, const char *attribute_name, const Value *value) {
+    if (data_buffer_pool_->read_only()) {
+        LOG_WARN("Failed to update record of table %s, it is read only.", name());
+        return RC::READONLY;
+    }
     RC rc = RC::SUCCESS;
     Record record_new;
     record_new.rid = record->rid;
@@ -843,24 +943,111 @@ RC Table::update_record(Trx *trx, Record *record, const char *attribute_name, co
                   field->name(), field->type(), value->type);
         return RC::SCHEMA_FIELD_TYPE_MISMATCH;
     }
-    if (field->type() == TEXTS) {
-        int num = *(int *) (record_data + field->offset());
-        // value->data 写入文件
-        // value->data 赋值文件名
-        std::string path =
-                "./miniob/db/sys/" + std::string(const_cast<char *>(table_meta_.name())) + "_" + std::to_string(num) +
-                "_" + "text.txt";
-        std::ofstream fout(path, std::ios::trunc);
-        fout << static_cast<char *>(value->data);
-        memcpy(record_data + field->offset(), static_cast<void *>(&num), field->len());
+
+    // 包含这个字段的索引，需要先删除原来的索引项，记录更新后再插入新的索引项
+    std::vector<Index *> field_indexes;
+    for (Index *index: indexes_) {
+        for (const FieldMeta &index_field: index->field_meta()) {
+            if (0 == strcmp(index_field.name(), field->name())) {
+                field_indexes.push_back(index);
+                break;
+            }
+        }
+    }
+    if (field->type() != TEXTS) {
+        std::vector<char> new_data(record_data, record_data + table_meta_.record_size());
+        copy_field_value(new_data.data() + field->offset(), *field, *value);
+        for (Index *index: field_indexes) {
+            if (!index->index_meta().unique()) {
+                continue;
+            }
+            std::string old_key;
+            std::string new_key;
+            for (const FieldMeta &index_field: index->field_meta()) {
+                old_key.append(record_data + index_field.offset(), index_field.len());
+                new_key.append(new_data.data() + index_field.offset(), index_field.len());
+            }
+            if (old_key != new_key && index->unique_conflict(new_key)) {
+                return RC::CONSTRAINT_UNIQUE;
+            }
+        }
+    }
+    // 任何一步失败时都恢复原来的记录和索引项
+    const std::vector<char> old_data(record_data, record_data + table_meta_.record_size());
+    size_t deleted_index_num = 0;
+    for (; deleted_index_num < field_indexes.size(); deleted_index_num++) {
+        Index *index = field_indexes[deleted_index_num];
+        rc = index->delete_entry(old_data.data(), &record->rid);
+        if (rc != RC::SUCCESS) {
+            LOG_ERROR("Failed to delete index entry of record(rid=%d.%d). index=%s, rc=%d:%s",
+                      record->rid.page_num, record->rid.slot_num, index->index_meta().name(), rc, strrc(rc));
+            break;
+        }
+    }
+
+    bool text_written = false;
+    bool record_updated = false;
+    size_t inserted_index_num = 0;
+    if (rc == RC::SUCCESS) {
+        if (field->type() == TEXTS) {
+            // 先写新的数据，记录更新成功后再释放原来的溢出页
+            rc = write_text((const char *) value->data, record_data + field->offset());
+            text_written = (rc == RC::SUCCESS);
+        } else {
+            copy_field_value(record_data + field->offset(), *field, *value);
+        }
+    }
+    if (rc == RC::SUCCESS) {
         record_new.data = record_data;
         rc = record_handler_->update_record(&record_new);
+        record_updated = (rc == RC::SUCCESS);
+    }
+    for (; rc == RC::SUCCESS && inserted_index_num < field_indexes.size(); inserted_index_num++) {
+        Index *index = field_indexes[inserted_index_num];
+        rc = index->insert_entry(record_data, &record->rid);
+        if (rc != RC::SUCCESS) {
+            LOG_ERROR("Failed to insert index entry of record(rid=%d.%d). index=%s, rc=%d:%s",
+                      record->rid.page_num, record->rid.slot_num, index->index_meta().name(), rc, strrc(rc));
+        }
+    }
+    if (rc == RC::SUCCESS) {
+        if (field->type() == TEXTS) {
+            return delete_text(old_data.data() + field->offset());
+        }
         return rc;
+    }
 
+    RC rc2 = RC::SUCCESS;
+    for (size_t i = 0; i < inserted_index_num; i++) {
+        rc2 = field_indexes[i]->delete_entry(record_data, &record->rid);
+        if (rc2 != RC::SUCCESS) {
+            LOG_PANIC("Failed to rollback new index entry when update record failed. table name=%s, rc=%d:%s",
+                      name(), rc2, strrc(rc2));
+        }
+    }
+    if (text_written) {
+        rc2 = delete_text(record_data + field->offset());
+        if (rc2 != RC::SUCCESS) {
+            LOG_ERROR("Failed to free new text when update record failed. table name=%s, rc=%d:%s",
+                      name(), rc2, strrc(rc2));
+        }
+    }
+    memcpy(record_data, old_data.data(), old_data.size());
+    if (record_updated) {
+        record_new.data = record_data;
+        rc2 = record_handler_->update_record(&record_new);
+        if (rc2 != RC::SUCCESS) {
+            LOG_PANIC("Failed to rollback record data when update record failed. table name=%s, rc=%d:%s",
+                      name(), rc2, strrc(rc2));
+        }
+    }
+    for (size_t i = 0; i < deleted_index_num; i++) {
+        rc2 = field_indexes[i]->insert_entry(record_data, &record->rid);
+        if (rc2 != RC::SUCCESS) {
+            LOG_PANIC("Failed to rollback old index entry when update record failed. table name=%s, rc=%d:%s",
+                      name(), rc2, strrc(rc2));
+        }
     }
-    memcpy(record_data + field->offset(), value->data, field->len());
-    record_new.data = record_data;
-    rc = record_handler_->update_record(&record_new);
     return rc;
 }
 
@@ -1075,16 +1262,33 @@ RC Table::delete_record(Trx *trx, ConditionFilter *filter, int *deleted_count) {
 }
 
 RC Table::delete_record(Trx *trx, Record *record) {
+    // 只读模式下记录直接指向只读的映射内存，事务也不能在原地标记删除
+    if (data_buffer_pool_->read_only()) {
+        LOG_WARN("Failed to delete record of table %s, it is read only.", name());
+        return RC::READONLY;
+    }
     RC rc = RC::SUCCESS;
+    const bool marked = has_trx_mark(record->data);
     if (trx != nullptr) {
         rc = trx->delete_record(this, record);
+        if (rc == RC::SUCCESS) {
+            // 写回删除标记
+            rc = record_handler_->update_record(record);
+        }
+        if (rc == RC::SUCCESS && !marked && has_trx_mark(record->data)) {
+            add_uncommitted_record_num(1);
+        }
     } else {
         rc = delete_entry_of_indexes(record->data, record->rid, false);// 重复代码 refer to commit_delete
         if (rc != RC::SUCCESS) {
             LOG_ERROR("Failed to delete indexes of record (rid=%d.%d). rc=%d:%s",
                       record->rid.page_num, record->rid.slot_num, rc, strrc(rc));
         } else {
+            delete_text_of_record(record->data);
             rc = record_handler_->delete_record(&record->rid);
+            if (rc == RC::SUCCESS && marked) {
+                add_uncommitted_record_num(-1);
+            }
         }
     }
     return rc;
@@ -1093,7 +1297,8 @@ RC Table::delete_record(Trx *trx, Record *record) {
 RC Table::commit_delete(Trx *trx, const RID &rid) {
     RC rc = RC::SUCCESS;
     Record record;
-    rc = record_handler_->get_record(&rid, &record);
+    std::vector<char> record_buffer;
+    rc = record_handler_->get_record(&rid, &record, record_buffer);
     if (rc != RC::SUCCESS) {
         return rc;
     }
@@ -1103,23 +1308,37 @@ RC Table::commit_delete(Trx *trx, const RID &rid) {
                   rid.page_num, rid.slot_num, rc, strrc(rc));// panic?
     }
 
+    const bool marked = has_trx_mark(record.data);
+    delete_text_of_record(record.data);
     rc = record_handler_->delete_record(&rid);
     if (rc != RC::SUCCESS) {
         return rc;
     }
-
+    if (marked) {
+        add_uncommitted_record_num(-1);
+    }
     return rc;
 }
 
 RC Table::rollback_delete(Trx *trx, const RID &rid) {
     RC rc = RC::SUCCESS;
     Record record;
-    rc = record_handler_->get_record(&rid, &record);
+    std::vector<char> record_buffer;
+    rc = record_handler_->get_record(&rid, &record, record_buffer);
     if (rc != RC::SUCCESS) {
         return rc;
     }
 
-    return trx->rollback_delete(this, record); // update record in place
+    const bool marked = has_trx_mark(record.data);
+    rc = trx->rollback_delete(this, record);
+    if (rc != RC::SUCCESS) {
+        return rc;
+    }
+    rc = record_handler_->update_record(&record);
+    if (rc == RC::SUCCESS && marked) {
+        add_uncommitted_record_num(-1);
+    }
+    return rc;
 }
 
 RC Table::insert_entry_of_indexes(const char *record, const RID &rid) {
@@ -1155,38 +1374,373 @@ Index *Table::find_index(const char *index_name) const {
     return nullptr;
 }
 
-IndexScanner *Table::find_index_for_scan(const DefaultConditionFilter &filter) {
-    const ConDesc *field_cond_desc = nullptr;
-    const ConDesc *value_cond_desc = nullptr;
+bool Table::has_trx_mark(const char *record) const {
+    return *(const int32_t *) (record + table_meta_.trx_field()->offset()) != 0;
+}
+
+void Table::add_uncommitted_record_num(int delta) {
+    if (uncommitted_record_num_ >= 0) {
+        uncommitted_record_num_ += delta;
+    }
+}
+
+struct AnalyzeContext {
+    Table *table;
+    Trx *trx;
+    TableStatsCollector *collector;
+    const FieldMeta *trx_field;
+    int uncommitted_record_num;
+};
+
+static RC collect_stats_record_reader(Record *record, void *context) {
+    AnalyzeContext *analyze_context = (AnalyzeContext *) context;
+    if (*(const int32_t *) (record->data + analyze_context->trx_field->offset()) != 0) {
+        analyze_context->uncommitted_record_num++;
+    }
+    if (analyze_context->trx == nullptr || analyze_context->trx->is_visible(analyze_context->table, record)) {
+        analyze_context->collector->add_record(record->data);
+    }
+    return RC::SUCCESS;
+}
+
+RC Table::analyze(Trx *trx) {
+    // 扫描所有的记录，同时统计带有事务号的记录数，只有可见的记录计入统计信息
+    TableStatsCollector collector(table_meta_);
+    AnalyzeContext context{this, trx, &collector, table_meta_.trx_field(), 0};
+    RC rc = scan_record(nullptr, nullptr, -1, &context, collect_stats_record_reader);
+    if (rc != RC::SUCCESS) {
+        LOG_ERROR("Failed to scan table while analyzing. table=%s, rc=%d:%s", name(), rc, strrc(rc));
+        return rc;
+    }
+
+    TableStats *stats = new TableStats();
+    collector.finish(*stats);
+    std::string stats_file = table_stats_file(base_dir_.c_str(), name());
+    rc = stats->save(stats_file.c_str());
+    if (rc != RC::SUCCESS) {
+        delete stats;
+        return rc;
+    }
+
+    delete table_stats_;
+    table_stats_ = stats;
+    uncommitted_record_num_ = context.uncommitted_record_num;
+    LOG_INFO("Analyze table success. table=%s, rows=%d, uncommitted records=%d",
+             name(), stats->row_count, uncommitted_record_num_);
+    return RC::SUCCESS;
+}
+
+const TableStats *Table::table_stats() const {
+    return table_stats_;
+}
+
+Index *Table::find_index_by_field(const char *field_name) const {
+    for (Index *index: indexes_) {
+        const std::vector<FieldMeta> &fields = index->field_meta();
+        if (fields.size() == 1 && 0 == strcmp(fields[0].name(), field_name)) {
+            return index;
+        }
+    }
+    return nullptr;
+}
+
+RC Table::get_records_by_range(Trx *trx, IndexScanner *scanner, RecordBatch &batch) {
+    batch.clear();
+    const int record_size = table_meta_.record_size();
+    std::vector<RID> rids;
+    Record record;
+    std::vector<char> record_buffer;
+    while (batch.empty()) {
+        RC rc = read_index_rids(scanner, INDEX_SCAN_BATCH_SIZE, rids);
+        if (rc != RC::SUCCESS) {
+            if (rc != RC::RECORD_EOF) {
+                LOG_ERROR("Failed to scan index of table %s. rc=%d:%s", name(), rc, strrc(rc));
+            }
+            return rc;
+        }
+
+        for (const RID &record_rid : rids) {
+            rc = record_handler_->get_record(&record_rid, &record, record_buffer);
+            if (rc != RC::SUCCESS) {
+                LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s",
+                          record_rid.page_num, record_rid.slot_num, rc, strrc(rc));
+                return rc;
+            }
+            if (trx == nullptr || trx->is_visible(this, &record)) {
+                memcpy(batch.add_record(record_rid, record_size), record.data, record_size);
+            }
+        }
+    }
+    batch.finish();
+    return RC::SUCCESS;
+}
+
+static CompOp reverse_comp_op(CompOp op) {
+    switch (op) {
+        case LESS_THAN:   return GREAT_THAN;
+        case LESS_EQUAL:  return GREAT_EQUAL;
+        case GREAT_THAN:  return LESS_THAN;
+        case GREAT_EQUAL: return LESS_EQUAL;
+        default:          return op;
+    }
+}
+
+RC Table::get_index_only_records(Trx *trx, Index *index, IndexScanner *scanner, RecordBatch &batch) {
+    batch.clear();
+    const std::vector<FieldMeta> &fields = index->field_meta();
+    int key_len = 0;
+    for (const FieldMeta &field : fields) {
+        key_len += field.len();
+    }
+
+    // 所有记录都已经提交时，索引中的项都对事务可见
+    const bool check_visibility = trx != nullptr && uncommitted_record_num_ != 0;
+    const int record_size = table_meta_.record_size();
+    std::vector<RID> rids;
+    std::vector<char> keys;
+    std::vector<int> order;
+    Record record;
+    std::vector<char> record_buffer;
+    while (batch.empty()) {
+        // 索引项中的字段值直接读到一块连续的缓存中
+        rids.clear();
+        keys.resize(INDEX_SCAN_BATCH_SIZE * key_len);
+        RC rc = RC::SUCCESS;
+        RID rid;
+        while (rids.size() < INDEX_SCAN_BATCH_SIZE &&
+               RC::SUCCESS == (rc = scanner->next_entry(&rid, keys.data() + rids.size() * key_len))) {
+            rids.push_back(rid);
+        }
+        if (RC::SUCCESS != rc && RC::RECORD_EOF != rc && RC::RECORD_NO_MORE_IDX_IN_MEM != rc) {
+            LOG_ERROR("Failed to scan index %s. rc=%d:%s", index->index_meta().name(), rc, strrc(rc));
+            return rc;
+        }
+        if (rids.empty()) {
+            return RC::RECORD_EOF;
+        }
+
+        // 与get_records_by_range一样批内按照rid排序
+        order.resize(rids.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = (int) i;
+        }
+        std::sort(order.begin(), order.end(), [&rids](int left, int right) {
+            return rid_less(rids[left], rids[right]);
+        });
+
+        for (int i : order) {
+            if (check_visibility) {
+                rc = record_handler_->get_record(&rids[i], &record, record_buffer);
+                if (rc != RC::SUCCESS) {
+                    LOG_ERROR("Failed to fetch record of rid=%d:%d, rc=%d:%s",
+                              rids[i].page_num, rids[i].slot_num, rc, strrc(rc));
+                    return rc;
+                }
+                if (!trx->is_visible(this, &record)) {
+                    continue;
+                }
+            }
+
+            char *data = batch.add_record(rids[i], record_size);
+            memset(data, 0, record_size);
+            const char *field_value = keys.data() + i * key_len;
+            for (const FieldMeta &field : fields) {
+                memcpy(data + field.offset(), field_value, field.len());
+                field_value += field.len();
+            }
+        }
+    }
+    batch.finish();
+    return RC::SUCCESS;
+}
+
+/**
+ * 条件是 字段 op 常量，并且可以用来确定索引上的扫描范围时，返回把字段放在左边后的比较符和值
+ */
+static bool index_bound_of_filter(const DefaultConditionFilter &filter, const FieldMeta &field, CompOp &comp_op,
+                                  const char *&value) {
+    const ConDesc *field_desc = nullptr;
+    const ConDesc *value_desc = nullptr;
+    AttrType value_type = UNDEFINED;
+    comp_op = filter.comp_op();
     if (filter.left().is_attr && !filter.right().is_attr) {
-        field_cond_desc = &filter.left();
-        value_cond_desc = &filter.right();
+        field_desc = &filter.left();
+        value_desc = &filter.right();
+        value_type = filter.right_attr_type();
     } else if (filter.right().is_attr && !filter.left().is_attr) {
-        field_cond_desc = &filter.right();
-        value_cond_desc = &filter.left();
+        // 值在左边时交换比较符，例如 5 < a 等价于 a > 5
+        field_desc = &filter.right();
+        value_desc = &filter.left();
+        value_type = filter.left_attr_type();
+        comp_op = reverse_comp_op(comp_op);
+    } else {
+        return false;
     }
-    if (field_cond_desc == nullptr || value_cond_desc == nullptr) {
-        return nullptr;
+
+    if (field_desc->attr_offset != field.offset() || value_type != field.type() || field.type() == TEXTS) {
+        return false;
+    }
+    if (comp_op != EQUAL_TO && comp_op != LESS_THAN && comp_op != LESS_EQUAL &&
+        comp_op != GREAT_THAN && comp_op != GREAT_EQUAL) {
+        return false;
     }
+    value = (const char *) value_desc->value;
+    if (value == nullptr || *value == '!') {
+        return false;
+    }
+    // 比字段长的字符串在索引中没有对应的位置
+    return field.type() != CHARS || (int) strlen(value) <= field.len();
+}
 
-    const FieldMeta *field_meta = table_meta_.find_field_by_offset(field_cond_desc->attr_offset);
-    if (nullptr == field_meta) {
-        LOG_PANIC("Cannot find field by offset %d. table=%s",
-                  field_cond_desc->attr_offset, name());
-        return nullptr;
+static void set_bound_field(std::string &key, int offset, const FieldMeta &field, const char *value) {
+    int len = field.type() == CHARS ? strlen(value) : field.len();
+    memcpy(&key[offset], value, len);
+}
+
+static double bound_selectivity(const TableStats *stats, const FieldMeta &field, CompOp comp_op, const char *value) {
+    if (stats != nullptr) {
+        return stats->selectivity(field.name(), comp_op, field.type(), value);
     }
+    return comp_op == EQUAL_TO ? TableStats::DEFAULT_EQUAL_SELECTIVITY : TableStats::DEFAULT_RANGE_SELECTIVITY;
+}
 
-    const IndexMeta *index_meta = table_meta_.find_index_by_field(field_meta->name());
-    if (nullptr == index_meta) {
-        return nullptr;
+/**
+ * 按照索引字段的顺序，用等值条件确定键值的前缀，第一个没有等值条件的字段上再使用一个上界和一个下界。
+ * 浮点数在索引中按照误差比较，边界都包含等于，多取出的记录会再由条件过滤掉
+ */
+static bool build_index_range(const Index &index, const std::vector<const DefaultConditionFilter *> &filters,
+                              const TableStats *stats, IndexScanRange &range, double &selectivity) {
+    const std::vector<FieldMeta> &fields = index.field_meta();
+    int key_len = 0;
+    for (const FieldMeta &field : fields) {
+        key_len += field.len();
+    }
+    range = IndexScanRange();
+    range.left_key.assign(key_len, '\0');
+    range.right_key.assign(key_len, '\0');
+    selectivity = 1;
+
+    int offset = 0;
+    for (size_t i = 0; i < fields.size(); i++) {
+        const FieldMeta &field = fields[i];
+        const char *equal_value = nullptr;
+        const char *lower_value = nullptr;
+        const char *upper_value = nullptr;
+        CompOp lower_op = NO_OP;
+        CompOp upper_op = NO_OP;
+        for (const DefaultConditionFilter *filter : filters) {
+            CompOp comp_op = NO_OP;
+            const char *value = nullptr;
+            if (!index_bound_of_filter(*filter, field, comp_op, value)) {
+                continue;
+            }
+            if (comp_op == EQUAL_TO && equal_value == nullptr) {
+                equal_value = value;
+            } else if ((comp_op == GREAT_THAN || comp_op == GREAT_EQUAL) && lower_value == nullptr) {
+                lower_value = value;
+                lower_op = comp_op;
+            } else if ((comp_op == LESS_THAN || comp_op == LESS_EQUAL) && upper_value == nullptr) {
+                upper_value = value;
+                upper_op = comp_op;
+            }
+        }
+
+        if (equal_value != nullptr) {
+            set_bound_field(range.left_key, offset, field, equal_value);
+            set_bound_field(range.right_key, offset, field, equal_value);
+            range.left_attr_num = range.right_attr_num = i + 1;
+            selectivity *= bound_selectivity(stats, field, EQUAL_TO, equal_value);
+            offset += field.len();
+            continue;
+        }
+
+        double lower_selectivity = 1;
+        double upper_selectivity = 1;
+        if (lower_value != nullptr) {
+            set_bound_field(range.left_key, offset, field, lower_value);
+            range.left_attr_num = i + 1;
+            range.left_inclusive = lower_op == GREAT_EQUAL || field.type() == FLOATS;
+            lower_selectivity = bound_selectivity(stats, field, lower_op, lower_value);
+        }
+        if (upper_value != nullptr) {
+            set_bound_field(range.right_key, offset, field, upper_value);
+            range.right_attr_num = i + 1;
+            range.right_inclusive = upper_op == LESS_EQUAL || field.type() == FLOATS;
+            upper_selectivity = bound_selectivity(stats, field, upper_op, upper_value);
+        }
+        if (stats != nullptr && lower_value != nullptr && upper_value != nullptr) {
+            // 两个边界之间的行 = 大于下界的行 + 小于上界的行 - 所有的行
+            selectivity *= std::max(lower_selectivity + upper_selectivity - 1, 0.0);
+        } else {
+            selectivity *= lower_selectivity * upper_selectivity;
+        }
+        break;
     }
+    return range.left_attr_num > 0 || range.right_attr_num > 0;
+}
 
-    Index *index = find_index(index_meta->name());
-    if (nullptr == index) {
+static bool index_covers(const Index &index, const std::vector<std::string> &fields) {
+    for (const std::string &field_name : fields) {
+        bool found = false;
+        for (const FieldMeta &field : index.field_meta()) {
+            if (field_name == field.name()) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Index *Table::find_index_range(const ConditionFilter *filter, const std::vector<std::string> *fields,
+                               IndexScanRange &range, double &cost) {
+    std::vector<const DefaultConditionFilter *> filters;
+    const DefaultConditionFilter *default_condition_filter = dynamic_cast<const DefaultConditionFilter *>(filter);
+    if (default_condition_filter != nullptr) {
+        filters.push_back(default_condition_filter);
+    }
+    const CompositeConditionFilter *composite_condition_filter = dynamic_cast<const CompositeConditionFilter *>(filter);
+    if (composite_condition_filter != nullptr) {
+        for (int i = 0; i < composite_condition_filter->filter_num(); i++) {
+            const DefaultConditionFilter *sub_filter =
+                    dynamic_cast<const DefaultConditionFilter *>(&composite_condition_filter->filter(i));
+            if (sub_filter != nullptr) {
+                filters.push_back(sub_filter);
+            }
+        }
+    }
+    if (filters.empty()) {
         return nullptr;
     }
 
-    return index->create_scanner(filter.comp_op(), (const char *) value_cond_desc->value);
+    // 通过索引读取一行的代价：需要读取记录时是随机读，只读索引时按照索引项与记录的长度之比计算。
+    // 代价相同时选择用到字段多的索引
+    const double rows = table_stats_ != nullptr ? table_stats_->row_count : estimated_record_num();
+    Index *best_index = nullptr;
+    int best_attr_num = 0;
+    for (Index *index : indexes_) {
+        IndexScanRange index_range;
+        double selectivity = 1;
+        if (!build_index_range(*index, filters, table_stats_, index_range, selectivity)) {
+            continue;
+        }
+        double row_cost = TableStats::INDEX_FETCH_COST;
+        if (fields != nullptr && uncommitted_record_num_ == 0 && index_covers(*index, *fields)) {
+            row_cost = (double) (index_range.left_key.size() + sizeof(RID)) / table_meta_.record_size();
+        }
+        double index_cost = TableStats::index_scan_cost(rows, selectivity, row_cost);
+        int attr_num = std::max(index_range.left_attr_num, index_range.right_attr_num);
+        if (best_index == nullptr || index_cost < cost || (index_cost == cost && attr_num > best_attr_num)) {
+            best_index = index;
+            best_attr_num = attr_num;
+            range = std::move(index_range);
+            cost = index_cost;
+        }
+    }
+    return best_index;
 }
 
 IndexScanner *Table::find_index_for_scan(const ConditionFilter *filter) {
@@ -1194,23 +1748,19 @@ IndexScanner *Table::find_index_for_scan(const ConditionFilter *filter) {
         return nullptr;
     }
 
-    // remove dynamic_cast
-    const DefaultConditionFilter *default_condition_filter = dynamic_cast<const DefaultConditionFilter *>(filter);
-    if (default_condition_filter != nullptr) {
-        return find_index_for_scan(*default_condition_filter);
+    IndexScanRange range;
+    double cost = 0;
+    Index *index = find_index_range(filter, nullptr, range, cost);
+    if (nullptr == index) {
+        return nullptr;
     }
 
-    const CompositeConditionFilter *composite_condition_filter = dynamic_cast<const CompositeConditionFilter *>(filter);
-    if (composite_condition_filter != nullptr) {
-        int filter_num = composite_condition_filter->filter_num();
-        for (int i = 0; i < filter_num; i++) {
-            IndexScanner *scanner = find_index_for_scan(&composite_condition_filter->filter(i));
-            if (scanner != nullptr) {
-                return scanner; // 可以找到一个最优的，比如比较符号是=
-            }
-        }
+    // 满足条件的行太多时不如直接扫描数据文件
+    double rows = table_stats_ != nullptr ? table_stats_->row_count : estimated_record_num();
+    if (cost >= rows) {
+        return nullptr;
     }
-    return nullptr;
+    return index->create_scanner(range);
 }
 
 RC Table::sync() {
@@ -1219,6 +1769,13 @@ RC Table::sync() {
         LOG_ERROR("Failed to flush table's data pages. table=%s, rc=%d:%s", name(), rc, strrc(rc));
         return rc;
     }
+    if (fsm_file_id_ >= 0) {
+        rc = data_buffer_pool_->flush_all_pages(fsm_file_id_);
+        if (rc != RC::SUCCESS) {
+            LOG_ERROR("Failed to flush table's free space map. table=%s, rc=%d:%s", name(), rc, strrc(rc));
+            return rc;
+        }
+    }
 
     for (Index *index: indexes_) {
         rc = index->sync();
@@ -19,15 +19,21 @@ See the Mulan PSL v2 for more details. */
 
 class DiskBufferPool;
 class RecordFileHandler;
+class RecordFileScanner;
+class RecordBatch;
+class RecordCodec;
 class ConditionFilter;
 class DefaultConditionFilter;
 struct Record;
 struct RID;
 class Index;
 class IndexScanner;
+struct IndexScanRange;
+struct IndexBuildOptions;
 class RecordDeleter;
 // class RecordUpdater;
 class Trx;
+class TableStats;
 
 class Table {
 public:
@@ -61,7 +67,56 @@ public:
 
   RC scan_record(Trx *trx, ConditionFilter *filter, int limit,  void *context, void (*record_reader)(const char *data, void *context));
 
-  RC create_index(Trx *trx, const char *index_name, const char *const attributes_name[], int attribute_num, const int &is_unique);
+  /**
+   * 打开数据文件上的扫描，由调用方逐页取出记录并自己判断记录对事务是否可见
+   */
+  RC open_scanner(RecordFileScanner &scanner, ConditionFilter *filter);
+
+  /**
+   * 估计的表中的记录数，包括未提交的记录，只用于选择执行计划
+   */
+  int estimated_record_num();
+
+  /**
+   * 扫描对事务可见的记录，收集表的统计信息并保存到统计信息文件中
+   */
+  RC analyze(Trx *trx);
+
+  /**
+   * ANALYZE TABLE收集的统计信息，没有收集过时返回nullptr
+   */
+  const TableStats *table_stats() const;
+
+  /**
+   * 找到只包含这一个字段的索引，没有时返回nullptr
+   */
+  Index *find_index_by_field(const char *field_name) const;
+
+  /**
+   * 从索引扫描中取出下一批对事务可见的记录放到batch中。每批读取有限个索引项，批内按照rid排序后读取数据文件，
+   * 索引扫描结束时返回RECORD_EOF
+   */
+  RC get_records_by_range(Trx *trx, IndexScanner *scanner, RecordBatch &batch);
+
+  /**
+   * 与get_records_by_range相同，但是只用索引项中的字段值构造记录，其它字段填0，用于索引包含所有需要的字段时。
+   * 数据文件中没有未提交的记录时不读取数据文件，否则只为判断可见性读取记录
+   */
+  RC get_index_only_records(Trx *trx, Index *index, IndexScanner *scanner, RecordBatch &batch);
+
+  /**
+   * 根据条件中 字段 op 常量 的部分，选出估计代价最小的索引和扫描范围，没有可用的索引时返回nullptr。
+   * 复合索引可以用等值条件匹配前缀。fields是需要读取的字段，索引包含所有这些字段时不需要读取数据文件，
+   * 为nullptr表示需要整条记录。cost是估计的代价，顺序扫描一行的代价是1
+   */
+  Index *find_index_range(const ConditionFilter *filter, const std::vector<std::string> *fields,
+                          IndexScanRange &range, double &cost);
+
+  /**
+   * 创建索引，对表中已有的记录排序后批量构建B+树
+   */
+  RC create_index(Trx *trx, const char *index_name, const char *const attributes_name[], int attribute_num,
+                  const int &is_unique, const IndexBuildOptions &options);
 
   RC mulit_insert_record(Trx *trx, int value_num, const Value *values, std::vector<Record>& trash);
 
@@ -72,6 +127,11 @@ public:
 
   RC sync();
 
+  /**
+   * 读取TEXT字段的内容，field_data指向记录中的字段
+   */
+  RC read_text(const char *field_data, std::string &text);
+
 public:
   RC commit_insert(Trx *trx, const RID &rid);
   RC commit_delete(Trx *trx, const RID &rid);
@@ -82,7 +142,6 @@ private:
   RC scan_record(Trx *trx, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context));
   RC scan_record_by_index(Trx *trx, IndexScanner *scanner, ConditionFilter *filter, int limit, void *context, RC (*record_reader)(Record *record, void *context));
   IndexScanner *find_index_for_scan(const ConditionFilter *filter);
-  IndexScanner *find_index_for_scan(const DefaultConditionFilter &filter);
 
   RC insert_record(Trx *trx, Record *record);
   RC delete_record(Trx *trx, Record *record);
@@ -93,20 +152,38 @@ private:
 
   RC insert_entry_of_indexes(const char *record, const RID &rid);
   RC delete_entry_of_indexes(const char *record, const RID &rid, bool error_on_not_exists);
+
 private:
   RC init_record_handler(const char *base_dir);
   RC make_record(int value_num, const Value *values, char * &record_out);
 
+  /**
+   * TEXT字段的内容保存在数据文件的溢出页中
+   */
+  RC write_text(const char *text, char *field_data);
+  RC delete_text(const char *field_data);
+  RC delete_text_of_record(const char *record);
+
 private:
   Index *find_index(const char *index_name) const;
 
+  /**
+   * 记录上有事务号，即未提交的插入或者删除
+   */
+  bool has_trx_mark(const char *record) const;
+  void add_uncommitted_record_num(int delta);
+
 private:
   std::string             base_dir_;
   TableMeta               table_meta_;
   DiskBufferPool *        data_buffer_pool_; /// 数据文件关联的buffer pool
   int                     file_id_;
+  int                     fsm_file_id_;      /// 空闲空间表文件
   RecordFileHandler *     record_handler_;   /// 记录操作
+  RecordCodec *           record_codec_;     /// 记录在数据页中的编码方式
   std::vector<Index *>    indexes_;
+  TableStats *            table_stats_;      /// 统计信息，用于选择执行计划
+  int                     uncommitted_record_num_; /// 带有事务号的记录数，-1表示不知道，打开表后由ANALYZE TABLE统计
 
     bool insert_unique_conflict(const char *data);
 };
@@ -0,0 +1,548 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "storage/common/table_stats.h"
+#include "storage/common/table_meta.h"
+#include "json/json.h"
+#include "common/log/log.h"
+
+static const Json::StaticString FIELD_ROW_COUNT("row_count");
+static const Json::StaticString FIELD_COLUMNS("columns");
+static const Json::StaticString FIELD_NAME("name");
+static const Json::StaticString FIELD_NDV("ndv");
+static const Json::StaticString FIELD_NULL_COUNT("null_count");
+static const Json::StaticString FIELD_MIN("min");
+static const Json::StaticString FIELD_MAX("max");
+static const Json::StaticString FIELD_MCVS("mcvs");
+static const Json::StaticString FIELD_VALUE("value");
+static const Json::StaticString FIELD_FREQUENCY("frequency");
+static const Json::StaticString FIELD_BOUNDS("bounds");
+
+void ColumnStats::to_json(Json::Value &json_value) const {
+  json_value[FIELD_NAME] = name;
+  json_value[FIELD_NDV] = ndv;
+  json_value[FIELD_NULL_COUNT] = null_count;
+  if (has_range) {
+    json_value[FIELD_MIN] = min;
+    json_value[FIELD_MAX] = max;
+  }
+
+  if (!mcvs.empty()) {
+    Json::Value mcvs_value(Json::arrayValue);
+    for (const MostCommonValue &mcv : mcvs) {
+      Json::Value mcv_value;
+      if (has_range) {
+        mcv_value[FIELD_VALUE] = mcv.number;
+      } else {
+        mcv_value[FIELD_VALUE] = mcv.text;
+      }
+      mcv_value[FIELD_FREQUENCY] = mcv.frequency;
+      mcvs_value.append(std::move(mcv_value));
+    }
+    json_value[FIELD_MCVS] = std::move(mcvs_value);
+  }
+  if (!bounds.empty()) {
+    Json::Value bounds_value(Json::arrayValue);
+    for (double bound : bounds) {
+      bounds_value.append(bound);
+    }
+    json_value[FIELD_BOUNDS] = std::move(bounds_value);
+  }
+}
+
+RC ColumnStats::from_json(const Json::Value &json_value, ColumnStats &column) {
+  if (!json_value.isObject()) {
+    LOG_ERROR("Failed to deserialize column stats. json is not an object. json value=%s",
+        json_value.toStyledString().c_str());
+    return RC::GENERIC_ERROR;
+  }
+
+  const Json::Value &name_value = json_value[FIELD_NAME];
+  const Json::Value &ndv_value = json_value[FIELD_NDV];
+  const Json::Value &null_count_value = json_value[FIELD_NULL_COUNT];
+  if (!name_value.isString() || !ndv_value.isInt() || !null_count_value.isInt()) {
+    LOG_ERROR("Invalid column stats. json value=%s", json_value.toStyledString().c_str());
+    return RC::GENERIC_ERROR;
+  }
+
+  column.name = name_value.asString();
+  column.ndv = ndv_value.asInt();
+  column.null_count = null_count_value.asInt();
+
+  const Json::Value &min_value = json_value[FIELD_MIN];
+  const Json::Value &max_value = json_value[FIELD_MAX];
+  column.has_range = min_value.isNumeric() && max_value.isNumeric();
+  if (column.has_range) {
+    column.min = min_value.asDouble();
+    column.max = max_value.asDouble();
+  }
+
+  // 旧的统计信息中没有最常见的值和直方图
+  const Json::Value &mcvs_value = json_value[FIELD_MCVS];
+  column.mcvs.clear();
+  for (Json::ArrayIndex i = 0; mcvs_value.isArray() && i < mcvs_value.size(); i++) {
+    const Json::Value &value = mcvs_value[i][FIELD_VALUE];
+    const Json::Value &frequency = mcvs_value[i][FIELD_FREQUENCY];
+    if (!frequency.isNumeric() || !(value.isNumeric() || value.isString())) {
+      LOG_ERROR("Invalid most common value. json value=%s", mcvs_value[i].toStyledString().c_str());
+      return RC::GENERIC_ERROR;
+    }
+    MostCommonValue mcv;
+    if (value.isNumeric()) {
+      mcv.number = value.asDouble();
+    } else {
+      mcv.text = value.asString();
+    }
+    mcv.frequency = frequency.asDouble();
+    column.mcvs.push_back(mcv);
+  }
+
+  const Json::Value &bounds_value = json_value[FIELD_BOUNDS];
+  column.bounds.clear();
+  for (Json::ArrayIndex i = 0; bounds_value.isArray() && i < bounds_value.size(); i++) {
+    if (!bounds_value[i].isNumeric()) {
+      LOG_ERROR("Invalid histogram bound. json value=%s", bounds_value.toStyledString().c_str());
+      return RC::GENERIC_ERROR;
+    }
+    column.bounds.push_back(bounds_value[i].asDouble());
+  }
+  return RC::SUCCESS;
+}
+
+const ColumnStats *TableStats::column(const char *name) const {
+  for (const ColumnStats &column : columns) {
+    if (0 == strcmp(column.name.c_str(), name)) {
+      return &column;
+    }
+  }
+  return nullptr;
+}
+
+static bool value_to_double(AttrType type, const void *value, double &result) {
+  if (value == nullptr || *(const char *)value == '!') {
+    return false;
+  }
+  switch (type) {
+    case INTS:
+    case DATES:
+      result = *(const int *)value;
+      return true;
+    case FLOATS:
+      result = *(const float *)value;
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * 直方图中小于value的值所占的比例，假设每个桶内的值均匀分布
+ */
+static double histogram_fraction_below(const std::vector<double> &bounds, double value) {
+  const int bucket_num = (int)bounds.size() - 1;
+  if (value <= bounds.front()) {
+    return 0;
+  }
+  if (value > bounds.back() || bucket_num == 0) {
+    return 1;
+  }
+  int bucket = std::upper_bound(bounds.begin(), bounds.end(), value) - bounds.begin() - 1;
+  bucket = std::min(bucket, bucket_num - 1);
+  double within = 0;
+  if (bounds[bucket + 1] > bounds[bucket]) {
+    within = (value - bounds[bucket]) / (bounds[bucket + 1] - bounds[bucket]);
+  }
+  return (bucket + within) / bucket_num;
+}
+
+double TableStats::selectivity(const char *field, CompOp op, const Value &value) const {
+  return selectivity(field, op, value.type, value.data);
+}
+
+double TableStats::selectivity(const char *field, CompOp op, AttrType value_type, const void *value) const {
+  const ColumnStats *stats = column(field);
+  if (stats == nullptr || row_count <= 0) {
+    return op == EQUAL_TO ? DEFAULT_EQUAL_SELECTIVITY : DEFAULT_RANGE_SELECTIVITY;
+  }
+
+  const double null_fraction = (double)stats->null_count / row_count;
+  const double not_null_fraction = 1 - null_fraction;
+  double number = 0;
+  const bool is_number = stats->has_range && value_to_double(value_type, value, number);
+  const bool is_text = !stats->has_range && value_type == CHARS && value != nullptr;
+
+  // 最常见的值单独计算，其余的值平均分配剩下的比例
+  double mcv_fraction = 0;
+  double equal = -1;
+  double mcv_below = 0;
+  for (const MostCommonValue &mcv : stats->mcvs) {
+    mcv_fraction += mcv.frequency;
+    if ((is_number && mcv.number == number) || (is_text && mcv.text == (const char *)value)) {
+      equal = mcv.frequency;
+    }
+    if (is_number && mcv.number < number) {
+      mcv_below += mcv.frequency;
+    }
+  }
+  const double other_fraction = std::max(not_null_fraction - mcv_fraction, 0.0);
+  if (equal < 0) {
+    const int other_ndv = stats->ndv - (int)stats->mcvs.size();
+    if (is_number && (number < stats->min || number > stats->max)) {
+      equal = 0;
+    } else if (stats->ndv > 0) {
+      equal = other_ndv > 0 ? other_fraction / other_ndv : 0;
+    } else {
+      equal = DEFAULT_EQUAL_SELECTIVITY;
+    }
+  }
+
+  switch (op) {
+    case IS_COMPOP:
+      return null_fraction;
+    case IS_NOT_COMPOP:
+      return not_null_fraction;
+    case EQUAL_TO:
+      return equal;
+    case NOT_EQUAL:
+      return std::max(not_null_fraction - equal, 0.0);
+    case LESS_THAN:
+    case LESS_EQUAL:
+    case GREAT_THAN:
+    case GREAT_EQUAL: {
+      if (!is_number) {
+        return DEFAULT_RANGE_SELECTIVITY;
+      }
+      double less = 0;
+      if (!stats->bounds.empty()) {
+        less = mcv_below + other_fraction * histogram_fraction_below(stats->bounds, number);
+      } else if (stats->max > stats->min) {
+        // 没有直方图时假设值在min和max之间均匀分布
+        less = not_null_fraction * std::min(std::max((number - stats->min) / (stats->max - stats->min), 0.0), 1.0);
+      } else {
+        less = number > stats->min ? not_null_fraction : 0;
+      }
+      if (op == LESS_EQUAL || op == GREAT_THAN) {
+        less += equal;  // 包含等于value的值
+      }
+      less = std::min(less, not_null_fraction);
+      return (op == LESS_THAN || op == LESS_EQUAL) ? less : not_null_fraction - less;
+    }
+    default:
+      return DEFAULT_RANGE_SELECTIVITY;
+  }
+}
+
+double TableStats::join_selectivity(const char *field, const TableStats *other, const char *other_field) const {
+  int ndv = 0;
+  const ColumnStats *stats = column(field);
+  if (stats != nullptr) {
+    ndv = stats->ndv;
+  }
+  if (other != nullptr) {
+    const ColumnStats *other_stats = other->column(other_field);
+    if (other_stats != nullptr) {
+      ndv = std::max(ndv, other_stats->ndv);
+    }
+  }
+  return ndv > 0 ? 1.0 / ndv : DEFAULT_EQUAL_SELECTIVITY;
+}
+
+int TableStats::serialize(std::ostream &os) const {
+  Json::Value stats_value;
+  stats_value[FIELD_ROW_COUNT] = row_count;
+
+  Json::Value columns_value(Json::arrayValue);
+  for (const ColumnStats &column : columns) {
+    Json::Value column_value;
+    column.to_json(column_value);
+    columns_value.append(std::move(column_value));
+  }
+  stats_value[FIELD_COLUMNS] = std::move(columns_value);
+
+  Json::StreamWriterBuilder builder;
+  Json::StreamWriter *writer = builder.newStreamWriter();
+
+  std::streampos old_pos = os.tellp();
+  writer->write(stats_value, &os);
+  int ret = (int)(os.tellp() - old_pos);
+
+  delete writer;
+  return ret;
+}
+
+int TableStats::deserialize(std::istream &is) {
+  Json::Value stats_value;
+  Json::CharReaderBuilder builder;
+  std::string errors;
+
+  std::streampos old_pos = is.tellg();
+  if (!Json::parseFromStream(builder, is, &stats_value, &errors)) {
+    LOG_ERROR("Failed to deserialize table stats. error=%s", errors.c_str());
+    return -1;
+  }
+
+  const Json::Value &row_count_value = stats_value[FIELD_ROW_COUNT];
+  const Json::Value &columns_value = stats_value[FIELD_COLUMNS];
+  if (!row_count_value.isInt() || !columns_value.isArray()) {
+    LOG_ERROR("Invalid table stats. json value=%s", stats_value.toStyledString().c_str());
+    return -1;
+  }
+
+  std::vector<ColumnStats> new_columns(columns_value.size());
+  for (Json::ArrayIndex i = 0; i < columns_value.size(); i++) {
+    if (ColumnStats::from_json(columns_value[i], new_columns[i]) != RC::SUCCESS) {
+      return -1;
+    }
+  }
+
+  row_count = row_count_value.asInt();
+  columns.swap(new_columns);
+  return (int)(is.tellg() - old_pos);
+}
+
+RC TableStats::save(const char *file) const {
+  std::string tmp_file = std::string(file) + ".tmp";
+  std::fstream fs;
+  fs.open(tmp_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!fs.is_open()) {
+    LOG_ERROR("Failed to open file for write. file name=%s, errmsg=%s", tmp_file.c_str(), strerror(errno));
+    return RC::IOERR;
+  }
+  if (serialize(fs) < 0) {
+    LOG_ERROR("Failed to dump table stats to file: %s. sys err=%d:%s", tmp_file.c_str(), errno, strerror(errno));
+    return RC::IOERR;
+  }
+  fs.close();
+
+  if (rename(tmp_file.c_str(), file) != 0) {
+    LOG_ERROR("Failed to rename tmp stats file (%s) to %s. system error=%d:%s",
+              tmp_file.c_str(), file, errno, strerror(errno));
+    return RC::IOERR;
+  }
+  return RC::SUCCESS;
+}
+
+RC TableStats::load(const char *file) {
+  std::fstream fs;
+  fs.open(file, std::ios_base::in | std::ios_base::binary);
+  if (!fs.is_open()) {
+    return RC::IOERR_ACCESS;
+  }
+  if (deserialize(fs) < 0) {
+    LOG_ERROR("Failed to deserialize table stats. file name=%s", file);
+    return RC::GENERIC_ERROR;
+  }
+  return RC::SUCCESS;
+}
+
+const int TableStatsCollector::SAMPLE_SIZE;
+const int TableStatsCollector::HISTOGRAM_BUCKETS;
+const int TableStatsCollector::MAX_MCV_NUM;
+
+TableStatsCollector::TableStatsCollector(const TableMeta &table_meta)
+    : table_meta_(table_meta) {
+  for (int i = table_meta.sys_field_num(); i < table_meta.field_num(); i++) {
+    const FieldMeta *field = table_meta.field(i);
+    ColumnStats column;
+    column.name = field->name();
+    stats_.columns.push_back(column);
+
+    // TEXT字段在记录中只保存溢出页的位置，不统计值的分布
+    Collector collector;
+    collector.offset = field->offset();
+    collector.len = field->type() == TEXTS ? 0 : field->len();
+    collector.type = field->type();
+    collectors_.push_back(std::move(collector));
+  }
+}
+
+void TableStatsCollector::add_record(const char *record) {
+  stats_.row_count++;
+  for (size_t i = 0; i < collectors_.size(); i++) {
+    Collector &collector = collectors_[i];
+    ColumnStats &column = stats_.columns[i];
+    const char *data = record + collector.offset;
+    if (*data == '!') {
+      column.null_count++;
+      continue;
+    }
+    if (collector.len == 0) {
+      continue;
+    }
+
+    double number = 0;
+    if (!value_to_double(collector.type, data, number)) {
+      continue;
+    }
+    if (!column.has_range) {
+      column.has_range = true;
+      column.min = column.max = number;
+    } else {
+      column.min = std::min(column.min, number);
+      column.max = std::max(column.max, number);
+    }
+  }
+
+  // 蓄水池抽样，每一行被选中的概率相同
+  const int record_size = table_meta_.record_size();
+  if ((int)samples_.size() < SAMPLE_SIZE) {
+    samples_.emplace_back(record, record_size);
+  } else {
+    std::uniform_int_distribution<int> distribution(0, stats_.row_count - 1);
+    int pos = distribution(random_);
+    if (pos < SAMPLE_SIZE) {
+      samples_[pos].assign(record, record_size);
+    }
+  }
+}
+
+/**
+ * 把排好序的值中相同的值合并，得到每个值出现的次数
+ */
+template <typename T>
+static void count_values(const std::vector<T> &sorted_values, std::vector<std::pair<T, int>> &counts) {
+  for (const T &value : sorted_values) {
+    if (counts.empty() || counts.back().first != value) {
+      counts.emplace_back(value, 0);
+    }
+    counts.back().second++;
+  }
+}
+
+/**
+ * 出现次数超过平均次数1.25倍并且至少出现两次的值作为最常见的值
+ */
+template <typename T>
+static void choose_mcvs(std::vector<std::pair<T, int>> &counts, int value_num, int max_num,
+                        std::vector<std::pair<T, int>> &mcvs) {
+  if (counts.empty()) {
+    return;
+  }
+  const double threshold = std::max(1.25 * value_num / counts.size(), 2.0);
+  for (const auto &item : counts) {
+    if (item.second >= threshold) {
+      mcvs.push_back(item);
+    }
+  }
+  std::stable_sort(mcvs.begin(), mcvs.end(), [](const std::pair<T, int> &left, const std::pair<T, int> &right) {
+    return left.second > right.second;
+  });
+  if ((int)mcvs.size() > max_num) {
+    mcvs.resize(max_num);
+  }
+}
+
+/**
+ * 用Duj1估计量(与PostgreSQL相同)根据样本估计不同值的个数：n*d / (n - f1 + f1*n/N)。
+ * d是样本中不同值的个数，f1是样本中只出现一次的值的个数。样本包含所有的行时就是精确值
+ * @param value_num 样本中非空值的个数n
+ * @param total_value_num 全表中非空值的个数N
+ */
+template <typename T>
+static int estimate_ndv(const std::vector<std::pair<T, int>> &counts, int value_num, int total_value_num) {
+  if (value_num == 0) {
+    return 0;
+  }
+  const double distinct_num = counts.size();
+  if (value_num >= total_value_num) {
+    return (int)distinct_num;
+  }
+  int once_num = 0;
+  for (const auto &item : counts) {
+    if (item.second == 1) {
+      once_num++;
+    }
+  }
+  const double n = value_num;
+  const double ndv = n * distinct_num / (n - once_num + once_num * n / total_value_num);
+  return (int)std::round(std::max(distinct_num, std::min<double>(ndv, total_value_num)));
+}
+
+void TableStatsCollector::build_distribution(const Collector &collector, ColumnStats &column) const {
+  const double sample_num = samples_.size();
+  if (collector.len == 0 || sample_num == 0) {
+    return;
+  }
+
+  if (collector.type == CHARS) {
+    std::vector<std::string> values;
+    for (const std::string &sample : samples_) {
+      const char *data = sample.data() + collector.offset;
+      if (*data != '!') {
+        values.emplace_back(data, strnlen(data, collector.len));
+      }
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<std::pair<std::string, int>> counts, mcvs;
+    count_values(values, counts);
+    column.ndv = estimate_ndv(counts, values.size(), stats_.row_count - column.null_count);
+    choose_mcvs(counts, values.size(), MAX_MCV_NUM, mcvs);
+    for (const auto &item : mcvs) {
+      MostCommonValue mcv;
+      mcv.text = item.first;
+      mcv.frequency = item.second / sample_num;
+      column.mcvs.push_back(mcv);
+    }
+    return;
+  }
+
+  std::vector<double> values;
+  for (const std::string &sample : samples_) {
+    double number = 0;
+    if (value_to_double(collector.type, sample.data() + collector.offset, number)) {
+      values.push_back(number);
+    }
+  }
+  std::sort(values.begin(), values.end());
+  std::vector<std::pair<double, int>> counts, mcvs;
+  count_values(values, counts);
+  column.ndv = estimate_ndv(counts, values.size(), stats_.row_count - column.null_count);
+  choose_mcvs(counts, values.size(), MAX_MCV_NUM, mcvs);
+  for (const auto &item : mcvs) {
+    MostCommonValue mcv;
+    mcv.number = item.first;
+    mcv.frequency = item.second / sample_num;
+    column.mcvs.push_back(mcv);
+  }
+
+  // 去掉最常见的值后，剩下的值按个数平均分到每个桶中
+  std::vector<double> others;
+  for (double value : values) {
+    bool is_mcv = false;
+    for (const auto &item : mcvs) {
+      is_mcv = is_mcv || item.first == value;
+    }
+    if (!is_mcv) {
+      others.push_back(value);
+    }
+  }
+  if (others.empty()) {
+    return;
+  }
+  const int bucket_num = std::min<int>(HISTOGRAM_BUCKETS, others.size());
+  for (int i = 0; i <= bucket_num; i++) {
+    column.bounds.push_back(others[(size_t)i * (others.size() - 1) / bucket_num]);
+  }
+}
+
+void TableStatsCollector::finish(TableStats &stats) {
+  for (size_t i = 0; i < collectors_.size(); i++) {
+    build_distribution(collectors_[i], stats_.columns[i]);
+  }
+  samples_.clear();
+  stats = stats_;
+}
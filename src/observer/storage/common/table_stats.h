@@ -0,0 +1,127 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_COMMON_TABLE_STATS_H__
+#define __OBSERVER_STORAGE_COMMON_TABLE_STATS_H__
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "rc.h"
+#include "sql/parser/parse_defs.h"
+
+namespace Json {
+class Value;
+}  // namespace Json
+
+class TableMeta;
+
+/**
+ * 出现次数最多的值及其占总行数的比例。数字和日期保存在number中，字符串保存在text中
+ */
+struct MostCommonValue {
+  double number = 0;
+  std::string text;
+  double frequency = 0;
+};
+
+/**
+ * 一个字段的统计信息。min/max和直方图只对INTS、FLOATS、DATES字段有效。
+ * 直方图是等深的，每个桶中的行数相同，不包含最常见的值
+ */
+class ColumnStats {
+public:
+  std::string name;
+  int ndv = 0;         // 不同非空值的个数，0表示不知道
+  int null_count = 0;
+  bool has_range = false;
+  double min = 0;
+  double max = 0;
+  std::vector<MostCommonValue> mcvs;
+  std::vector<double> bounds;  // n个桶有n+1个边界，第i个桶是[bounds[i], bounds[i+1]]
+
+  void to_json(Json::Value &json_value) const;
+  static RC from_json(const Json::Value &json_value, ColumnStats &column);
+};
+
+/**
+ * ANALYZE TABLE收集的表统计信息，保存在表元数据文件旁边的<表名>.stats文件中，只用于选择执行计划
+ */
+class TableStats {
+public:
+  static constexpr double DEFAULT_EQUAL_SELECTIVITY = 0.1;
+  static constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+  static constexpr double INDEX_PROBE_COST = 10;  // 在B+树中查找一个键值，约等于顺序读取的行数
+  static constexpr double INDEX_FETCH_COST = 4;   // 通过索引随机读取一行相对于顺序读取一行的代价
+
+  int row_count = 0;
+  std::vector<ColumnStats> columns;
+
+  const ColumnStats *column(const char *name) const;
+
+  /**
+   * 估计 field op value 这个条件过滤后剩下的行所占的比例
+   */
+  double selectivity(const char *field, CompOp op, const Value &value) const;
+  double selectivity(const char *field, CompOp op, AttrType value_type, const void *value) const;
+
+  /**
+   * 估计两个表的字段做等值连接时的选择率，other为nullptr时只使用本表的统计信息
+   */
+  double join_selectivity(const char *field, const TableStats *other, const char *other_field) const;
+
+  /**
+   * 通过索引读取占rows行中selectivity比例的行的代价，row_cost是读取一行的代价
+   */
+  static double index_scan_cost(double rows, double selectivity, double row_cost) {
+    return INDEX_PROBE_COST + rows * selectivity * row_cost;
+  }
+
+  int serialize(std::ostream &os) const;
+  int deserialize(std::istream &is);
+
+  RC save(const char *file) const;
+  RC load(const char *file);
+};
+
+/**
+ * 逐条读取记录计算统计信息。行数、空值个数和min/max是精确的，不同值的个数、
+ * 最常见的值和直方图根据蓄水池抽样得到的最多SAMPLE_SIZE行计算
+ */
+class TableStatsCollector {
+public:
+  static const int SAMPLE_SIZE = 30000;
+  static const int HISTOGRAM_BUCKETS = 20;
+  static const int MAX_MCV_NUM = 10;
+
+  explicit TableStatsCollector(const TableMeta &table_meta);
+
+  void add_record(const char *record);
+  void finish(TableStats &stats);
+
+private:
+  struct Collector {
+    int offset;
+    int len;
+    AttrType type;
+  };
+
+  void build_distribution(const Collector &collector, ColumnStats &column) const;
+
+  const TableMeta &table_meta_;
+  TableStats stats_;
+  std::vector<Collector> collectors_;
+  std::vector<std::string> samples_;
+  std::mt19937 random_;  // 固定的种子，同样的数据得到同样的统计信息
+};
+
+#endif  // __OBSERVER_STORAGE_COMMON_TABLE_STATS_H__
@@ -143,7 +143,8 @@ RC DefaultHandler::create_index(Trx *trx, const char *dbname, const CreateIndex
     if (nullptr == table) {
         return RC::SCHEMA_TABLE_NOT_EXIST;
     }
-    return table->create_index(trx, createIndex->index_name, createIndex->attribute_name, createIndex->attribute_num, createIndex->isUnique);
+    return table->create_index(trx, createIndex->index_name, createIndex->attribute_name, createIndex->attribute_num,
+                               createIndex->isUnique, index_build_options_);
 }
 
 RC DefaultHandler::drop_index(Trx *trx, const char *dbname, const char *relation_name, const char *index_name) {
@@ -151,6 +152,14 @@ RC DefaultHandler::drop_index(Trx *trx, const char *dbname, const char *relation
     return RC::GENERIC_ERROR;
 }
 
+RC DefaultHandler::analyze_table(Trx *trx, const char *dbname, const char *relation_name) {
+    Table *table = find_table(dbname, relation_name);
+    if (nullptr == table) {
+        return RC::SCHEMA_TABLE_NOT_EXIST;
+    }
+    return table->analyze(trx);
+}
+
 RC DefaultHandler::insert_record(Trx *trx, const char *dbname, const char *relation_name, const Inserts *inserts) {
     Table *table = find_table(dbname, relation_name);
     if (nullptr == table) {
@@ -18,6 +18,7 @@ See the Mulan PSL v2 for more details. */
 #include <map>
 
 #include "storage/common/db.h"
+#include "storage/common/bplus_tree_builder.h"
 
 class Trx;
 
@@ -30,6 +31,13 @@ public:
   RC init(const char *base_dir);
   void destroy();
 
+  /**
+   * 在已有数据上创建索引时使用的参数
+   */
+  void set_index_build_options(const IndexBuildOptions &options) {
+    index_build_options_ = options;
+  }
+
   /**
    * 在路径dbPath下创建一个名为dbName的空库，生成相应的系统文件。
    * 接口要求：一个数据库对应一个文件夹， dbName即为文件夹名，
@@ -112,6 +120,11 @@ public:
    */
   RC drop_index(Trx *trx, const char *dbname, const char *relation_name, const char *index_name);
 
+  /**
+   * 收集表的统计信息，保存到表所在文件夹的统计信息文件中，优化器根据统计信息选择执行计划
+   */
+  RC analyze_table(Trx *trx, const char *dbname, const char *relation_name);
+
   /**
    * 该函数用来在relName表中插入具有指定属性值的新元组，
    * nValues为属性值个数，values为对应的属性值数组。
@@ -163,6 +176,7 @@ private:
   std::string base_dir_;
   std::string db_dir_;
   std::map<std::string, Db*>          opened_dbs_;
+  IndexBuildOptions                   index_build_options_;
 }; // class Handler
 
 #endif // __OBSERVER_STORAGE_DEFAULT_ENGINE_H__
\ No newline at end of file
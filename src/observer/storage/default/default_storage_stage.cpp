@@ -25,6 +25,7 @@ See the Mulan PSL v2 for more details. */
 #include "common/metrics/metrics_registry.h"
 #include "rc.h"
 #include "storage/default/default_handler.h"
+#include "storage/default/disk_buffer_pool.h"
 #include "storage/common/condition_filter.h"
 #include "storage/common/table.h"
 #include "storage/common/table_meta.h"
@@ -40,6 +41,14 @@ using namespace common;
 const std::string DefaultStorageStage::QUERY_METRIC_TAG = "DefaultStorageStage.query";
 const char *CONF_BASE_DIR = "BaseDir";
 const char *CONF_SYSTEM_DB = "SystemDb";
+const char *CONF_BUFFER_POOL_SIZE = "BufferPoolSize";
+const char *CONF_BUFFER_POOL_PARTITIONS = "BufferPoolPartitions";
+const char *CONF_HUGE_PAGE = "HugePage";
+const char *CONF_DIRECT_IO = "DirectIO";
+const char *CONF_READ_ONLY = "ReadOnly";
+const char *CONF_EXTENT_PAGES = "ExtentPages";
+const char *CONF_INDEX_FILL_FACTOR = "IndexFillFactor";
+const char *CONF_INDEX_SORT_MEMORY_LIMIT = "IndexSortMemoryLimit";
 
 
 const char *DEFAULT_SYSTEM_DB = "sys";
@@ -61,7 +70,13 @@ Stage *DefaultStorageStage::make_stage(const std::string &tag) {
         LOG_ERROR("new DefaultStorageStage failed");
         return nullptr;
     }
-    stage->set_properties();
+    if (!stage->set_properties()) {
+        LOG_ERROR("Failed to set properties of DefaultStorageStage");
+        // handler_可能已经指向全局的DefaultHandler，先清理再释放
+        stage->cleanup();
+        delete stage;
+        return nullptr;
+    }
     return stage;
 }
 
@@ -87,11 +102,79 @@ bool DefaultStorageStage::set_properties() {
         LOG_INFO("Use %s as system db", sys_db);
     }
 
+    // 缓冲池的大小需要在打开任何数据文件之前确定
+    int buffer_pool_size = BP_BUFFER_SIZE;
+    iter = section.find(CONF_BUFFER_POOL_SIZE);
+    if (iter != section.end()) {
+        if (!str_to_val(iter->second, buffer_pool_size) || buffer_pool_size <= 0) {
+            LOG_ERROR("Invalid config %s: %s", CONF_BUFFER_POOL_SIZE, iter->second.c_str());
+            return false;
+        }
+    }
+    int buffer_pool_partitions = 1;
+    iter = section.find(CONF_BUFFER_POOL_PARTITIONS);
+    if (iter != section.end()) {
+        if (!str_to_val(iter->second, buffer_pool_partitions) || buffer_pool_partitions <= 0) {
+            LOG_ERROR("Invalid config %s: %s", CONF_BUFFER_POOL_PARTITIONS, iter->second.c_str());
+            return false;
+        }
+    }
+    bool huge_page = false;
+    iter = section.find(CONF_HUGE_PAGE);
+    if (iter != section.end() && iter->second.compare("true") == 0) {
+        huge_page = true;
+    }
+    bool direct_io = false;
+    iter = section.find(CONF_DIRECT_IO);
+    if (iter != section.end() && iter->second.compare("true") == 0) {
+        direct_io = true;
+    }
+    bool read_only = false;
+    iter = section.find(CONF_READ_ONLY);
+    if (iter != section.end() && iter->second.compare("true") == 0) {
+        read_only = true;
+    }
+    int extent_pages = BP_EXTENT_PAGES;
+    iter = section.find(CONF_EXTENT_PAGES);
+    if (iter != section.end()) {
+        if (!str_to_val(iter->second, extent_pages) || extent_pages <= 0) {
+            LOG_ERROR("Invalid config %s: %s", CONF_EXTENT_PAGES, iter->second.c_str());
+            return false;
+        }
+    }
+    if (RC::SUCCESS != theGlobalDiskBufferPool()->init(buffer_pool_size, buffer_pool_partitions,
+                                                       huge_page, direct_io, read_only, extent_pages)) {
+        LOG_ERROR("Failed to init buffer pool with %d pages in %d partitions",
+                  buffer_pool_size, buffer_pool_partitions);
+        return false;
+    }
+
+    // 在已有数据上创建索引时，排序后按照填充因子批量构建B+树
+    IndexBuildOptions index_build_options;
+    iter = section.find(CONF_INDEX_FILL_FACTOR);
+    if (iter != section.end()) {
+        if (!str_to_val(iter->second, index_build_options.fill_factor) ||
+            index_build_options.fill_factor < 50 || index_build_options.fill_factor > 100) {
+            LOG_ERROR("Invalid config %s: %s, should be in [50, 100]", CONF_INDEX_FILL_FACTOR, iter->second.c_str());
+            return false;
+        }
+    }
+    iter = section.find(CONF_INDEX_SORT_MEMORY_LIMIT);
+    if (iter != section.end()) {
+        long long memory_limit = 0;
+        if (!str_to_val(iter->second, memory_limit) || memory_limit <= 0) {
+            LOG_ERROR("Invalid config %s: %s", CONF_INDEX_SORT_MEMORY_LIMIT, iter->second.c_str());
+            return false;
+        }
+        index_build_options.memory_limit = (size_t) memory_limit;
+    }
+
     handler_ = &DefaultHandler::get_default();
     if (RC::SUCCESS != handler_->init(base_dir)) {
         LOG_ERROR("Failed to init default handler");
         return false;
     }
+    handler_->set_index_build_options(index_build_options);
 
     RC ret = handler_->create_db(sys_db);
     if (ret != RC::SUCCESS && ret != RC::SCHEMA_DB_EXIST) {
@@ -272,6 +355,13 @@ void DefaultStorageStage::handle_event(StageEvent *event) {
         }
             break;
 
+        case SCF_ANALYZE_TABLE: {
+            const char *table_name = sql->sstr.analyze_table.relation_name;
+            rc = handler_->analyze_table(current_trx, current_db, table_name);
+            snprintf(response, sizeof(response), "%s\n", rc == RC::SUCCESS ? "SUCCESS" : "FAILURE");
+        }
+            break;
+
         case SCF_SHOW_TABLES: {
             Db *db = handler_->find_db(current_db);
             if (nullptr == db) {
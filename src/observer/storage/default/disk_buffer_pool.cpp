@@ -14,6 +14,9 @@ See the Mulan PSL v2 for more details. */
 #include "disk_buffer_pool.h"
 #include <errno.h>
 #include <string.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <algorithm>
 
 #include "common/log/log.h"
 
@@ -26,6 +29,215 @@ unsigned long current_time()
   return tp.tv_sec * 1000 * 1000 * 1000UL + tp.tv_nsec;
 }
 
+/**
+ * 页大小对应的分区组下标，4K为0，8K为1，以此类推。不是合法的页大小时返回-1
+ */
+static int page_size_class(int page_size)
+{
+  int index = 0;
+  for (int size = BP_PAGE_SIZE; size <= BP_MAX_PAGE_SIZE; size <<= 1, index++) {
+    if (size == page_size) {
+      return index;
+    }
+  }
+  return -1;
+}
+
+BPManager::BPManager(int size, int page_size, bool huge_page)
+{
+  MUTEX_INIT(&lock_, nullptr);
+  init(size, page_size, huge_page);
+}
+
+BPManager::~BPManager()
+{
+  destroy();
+  MUTEX_DESTROY(&lock_);
+}
+
+RC BPManager::init(int size, int page_size, bool huge_page)
+{
+  if (!page_table_.empty()) {
+    LOG_ERROR("Failed to resize buffer pool, there are %d frames in use.", (int)page_table_.size());
+    return RC::BUFFERPOOL_OPEN;
+  }
+  if (size <= 0) {
+    LOG_ERROR("Invalid buffer pool size %d.", size);
+    return RC::INVALID_ARGUMENT;
+  }
+  if (page_size_class(page_size) < 0) {
+    LOG_ERROR("Invalid page size %d.", page_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  destroy();
+
+  void *pages = nullptr;
+  size_t mmap_size = 0;
+  if (huge_page) {
+    mmap_size = ((size_t)size * page_size + BP_HUGE_PAGE_SIZE - 1) / BP_HUGE_PAGE_SIZE * BP_HUGE_PAGE_SIZE;
+    pages = mmap(nullptr, mmap_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (pages == MAP_FAILED) {
+      // 系统没有预留足够的大页，退化为普通映射，建议内核使用透明大页
+      LOG_WARN("Failed to map %d pages with huge pages, due to %s. fallback to transparent huge pages.",
+          size, strerror(errno));
+      pages = mmap(nullptr, mmap_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (pages == MAP_FAILED) {
+        LOG_ERROR("Failed to map %d pages for buffer pool, due to %s.", size, strerror(errno));
+        return RC::NOMEM;
+      }
+      if (madvise(pages, mmap_size, MADV_HUGEPAGE) != 0) {
+        LOG_WARN("Failed to advise huge pages for buffer pool, due to %s.", strerror(errno));
+      }
+    }
+  } else {
+    int ret = posix_memalign(&pages, BP_PAGE_SIZE, (size_t)size * page_size);
+    if (ret != 0) {
+      LOG_ERROR("Failed to allocate %d pages for buffer pool, due to %s.", size, strerror(ret));
+      return RC::NOMEM;
+    }
+  }
+
+  size_ = size;
+  page_size_ = page_size;
+  mmap_size_ = mmap_size;
+  pages_ = (Page *)pages;
+  frames_ = new Frame[size];
+  clock_hand_ = 0;
+  free_list_.reserve(size);
+  page_table_.reserve(size);
+  for (int i = size - 1; i >= 0; i--) {
+    Frame *frame = frames_ + i;
+    frame->dirty = false;
+    frame->referenced = false;
+    frame->pin_count = 0;
+    frame->acc_time = 0;
+    frame->file_desc = -1;
+    frame->page_size = page_size;
+    frame->page = (Page *)((char *)pages_ + (size_t)i * page_size);
+    pthread_rwlock_init(&frame->latch, nullptr);
+    free_list_.push_back(frame);
+  }
+  return RC::SUCCESS;
+}
+
+void BPManager::destroy()
+{
+  page_table_.clear();
+  free_list_.clear();
+  for (int i = 0; i < size_; i++) {
+    pthread_rwlock_destroy(&frames_[i].latch);
+  }
+  delete[] frames_;
+  frames_ = nullptr;
+  if (mmap_size_ > 0) {
+    munmap(pages_, mmap_size_);
+  } else {
+    ::free(pages_);
+  }
+  pages_ = nullptr;
+  mmap_size_ = 0;
+  size_ = 0;
+  clock_hand_ = 0;
+}
+
+Frame *BPManager::alloc(int file_desc, PageNum page_num)
+{
+  if (free_list_.empty()) {
+    return nullptr;
+  }
+
+  Frame *frame = free_list_.back();
+  free_list_.pop_back();
+
+  frame->file_desc = file_desc;
+  frame->referenced = true;
+  frame->page->page_num = page_num;
+  page_table_[BPFrameId{file_desc, page_num}] = frame;
+  return frame;
+}
+
+Frame *BPManager::get(int file_desc, PageNum page_num)
+{
+  auto iter = page_table_.find(BPFrameId{file_desc, page_num});
+  if (iter == page_table_.end()) {
+    return nullptr;
+  }
+
+  Frame *frame = iter->second;
+  frame->referenced = true;
+  return frame;
+}
+
+Frame *BPManager::victim()
+{
+  // 每个页帧最多被扫过两次：第一次清除访问标记，第二次即可被选中
+  for (int i = 0; i < 2 * size_; i++) {
+    Frame *frame = frames_ + clock_hand_;
+    clock_hand_ = (clock_hand_ + 1) % size_;
+
+    if (frame->file_desc < 0 || frame->pin_count != 0) {
+      continue;
+    }
+    if (frame->referenced) {
+      frame->referenced = false;
+      continue;
+    }
+    return frame;
+  }
+  return nullptr;
+}
+
+void BPManager::free(Frame *frame)
+{
+  page_table_.erase(BPFrameId{frame->file_desc, frame->page->page_num});
+  frame->dirty = false;
+  frame->referenced = false;
+  frame->file_desc = -1;
+  free_list_.push_back(frame);
+}
+
+std::vector<Frame *> BPManager::find_list(int file_desc)
+{
+  std::vector<Frame *> frames;
+  for (int i = 0; i < size_; i++) {
+    if (frames_[i].file_desc == file_desc) {
+      frames.push_back(frames_ + i);
+    }
+  }
+  return frames;
+}
+
+std::vector<Frame *> BPManager::find_dirty_list()
+{
+  std::vector<Frame *> frames;
+  std::vector<Frame *> referenced_frames;
+  for (int i = 0; i < size_; i++) {
+    Frame *frame = frames_ + i;
+    if (frame->file_desc < 0 || !frame->dirty || frame->pin_count != 0) {
+      continue;
+    }
+    if (frame->referenced) {
+      referenced_frames.push_back(frame);
+    } else {
+      frames.push_back(frame);
+    }
+  }
+  frames.insert(frames.end(), referenced_frames.begin(), referenced_frames.end());
+  return frames;
+}
+
+int BPManager::dirty_count() const
+{
+  int count = 0;
+  for (int i = 0; i < size_; i++) {
+    if (frames_[i].file_desc >= 0 && frames_[i].dirty) {
+      count++;
+    }
+  }
+  return count;
+}
+
 DiskBufferPool *theGlobalDiskBufferPool()
 {
   static DiskBufferPool *instance = new DiskBufferPool();
@@ -33,8 +245,126 @@ DiskBufferPool *theGlobalDiskBufferPool()
   return instance;
 }
 
-RC DiskBufferPool::create_file(const char *file_name)
+DiskBufferPool::DiskBufferPool()
 {
+  MUTEX_INIT(&lock_, nullptr);
+  bp_managers_[0].push_back(new BPManager(BP_BUFFER_SIZE));
+}
+
+DiskBufferPool::~DiskBufferPool()
+{
+  for (std::vector<BPManager *> &bp_managers : bp_managers_) {
+    for (BPManager *bp_manager : bp_managers) {
+      delete bp_manager;
+    }
+    bp_managers.clear();
+  }
+  MUTEX_DESTROY(&lock_);
+}
+
+RC DiskBufferPool::init(int buffer_pool_size, int partition_num, bool huge_page, bool direct_io, bool read_only,
+    int extent_pages)
+{
+  if (partition_num <= 0 || buffer_pool_size < partition_num) {
+    LOG_ERROR("Invalid buffer pool size %d or partition number %d.", buffer_pool_size, partition_num);
+    return RC::INVALID_ARGUMENT;
+  }
+  if (extent_pages <= 0) {
+    LOG_ERROR("Invalid extent pages %d.", extent_pages);
+    return RC::INVALID_ARGUMENT;
+  }
+
+  MUTEX_LOCK(&lock_);
+  for (int i = 0; i < MAX_OPEN_FILE; i++) {
+    if (open_list_[i] != nullptr) {
+      LOG_ERROR("Failed to init buffer pool, file %s has been opened.", open_list_[i]->file_name);
+      MUTEX_UNLOCK(&lock_);
+      return RC::BUFFERPOOL_OPEN;
+    }
+  }
+
+  for (std::vector<BPManager *> &bp_managers : bp_managers_) {
+    for (BPManager *bp_manager : bp_managers) {
+      delete bp_manager;
+    }
+    bp_managers.clear();
+  }
+
+  // 其它页大小的分区在用到时才分配
+  buffer_pool_size_ = buffer_pool_size;
+  huge_page_ = huge_page;
+  RC rc = init_partitions(BP_PAGE_SIZE, partition_num);
+  if (rc != RC::SUCCESS) {
+    MUTEX_UNLOCK(&lock_);
+    return rc;
+  }
+  direct_io_ = direct_io;
+  read_only_ = read_only;
+  extent_pages_ = extent_pages;
+  MUTEX_UNLOCK(&lock_);
+
+  LOG_INFO("Successfully init buffer pool with %d pages in %d partitions. "
+           "huge page=%d, direct io=%d, read only=%d, extent pages=%d",
+      buffer_pool_size, partition_num, huge_page, direct_io, read_only, extent_pages);
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::init_partitions(int page_size, int partition_num)
+{
+  // 每种页大小使用相同大小的内存，前面的分区多分一个页帧，保证总数不变
+  std::vector<BPManager *> &bp_managers = bp_managers_of(page_size);
+  int frame_num = std::max(partition_num, (int)((s64_t)buffer_pool_size_ * BP_PAGE_SIZE / page_size));
+  for (int i = 0; i < partition_num; i++) {
+    int size = frame_num / partition_num + (i < frame_num % partition_num ? 1 : 0);
+    BPManager *bp_manager = new BPManager(size, page_size, huge_page_);
+    if (bp_manager->size() != size) {
+      LOG_ERROR("Failed to init buffer pool partition %d with %d pages of %d bytes.", i, size, page_size);
+      delete bp_manager;
+      for (BPManager *created : bp_managers) {
+        delete created;
+      }
+      bp_managers.clear();
+      return RC::NOMEM;
+    }
+    bp_managers.push_back(bp_manager);
+  }
+  return RC::SUCCESS;
+}
+
+std::vector<BPManager *> &DiskBufferPool::bp_managers_of(int page_size)
+{
+  return bp_managers_[page_size_class(page_size)];
+}
+
+BPManager &DiskBufferPool::bp_manager_of(int page_size, int file_desc, PageNum page_num)
+{
+  std::vector<BPManager *> &bp_managers = bp_managers_of(page_size);
+  size_t hash = BPFrameIdHasher()(BPFrameId{file_desc, page_num});
+  return *bp_managers[hash % bp_managers.size()];
+}
+
+std::vector<BPManager *> DiskBufferPool::all_bp_managers()
+{
+  std::vector<BPManager *> all;
+  MUTEX_LOCK(&lock_);
+  for (std::vector<BPManager *> &bp_managers : bp_managers_) {
+    all.insert(all.end(), bp_managers.begin(), bp_managers.end());
+  }
+  MUTEX_UNLOCK(&lock_);
+  return all;
+}
+
+RC DiskBufferPool::create_file(const char *file_name, int page_size)
+{
+  if (read_only_) {
+    LOG_WARN("Failed to create %s, buffer pool is read only.", file_name);
+    return RC::READONLY;
+  }
+  if (page_size_class(page_size) < 0) {
+    LOG_ERROR("Failed to create %s, invalid page size %d.", file_name, page_size);
+    return RC::INVALID_ARGUMENT;
+  }
+
   int fd = open(file_name, O_RDWR | O_CREAT | O_EXCL, S_IREAD | S_IWRITE);
   if (fd < 0) {
     LOG_ERROR("Failed to create %s, due to %s.", file_name, strerror(errno));
@@ -52,23 +382,18 @@ RC DiskBufferPool::create_file(const char *file_name)
     return RC::IOERR_ACCESS;
   }
 
-  Page page;
-  memset(&page, 0, sizeof(Page));
+  std::vector<char> buffer(page_size, 0);
+  Page *page = (Page *)buffer.data();
 
   BPFileSubHeader *fileSubHeader;
-  fileSubHeader = (BPFileSubHeader *)page.data;
+  fileSubHeader = (BPFileSubHeader *)page->data;
   fileSubHeader->allocated_pages = 1;
   fileSubHeader->page_count = 1;
+  fileSubHeader->page_size = page_size;
 
-  char *bitmap = page.data + (int)BP_FILE_SUB_HDR_SIZE;
+  char *bitmap = page->data + (int)BP_FILE_SUB_HDR_SIZE;
   bitmap[0] |= 0x01;
-  if (lseek(fd, 0, SEEK_SET) == -1) {
-    LOG_ERROR("Failed to seek file %s to position 0, due to %s .", file_name, strerror(errno));
-    close(fd);
-    return RC::IOERR_SEEK;
-  }
-
-  if (write(fd, (char *)&page, sizeof(Page)) != sizeof(Page)) {
+  if (pwrite(fd, buffer.data(), page_size, 0) != page_size) {
     LOG_ERROR("Failed to write header to file %s, due to %s.", file_name, strerror(errno));
     close(fd);
     return RC::IOERR_WRITE;
@@ -82,11 +407,13 @@ RC DiskBufferPool::create_file(const char *file_name)
 RC DiskBufferPool::open_file(const char *file_name, int *file_id)
 {
   int fd, i;
+  MUTEX_LOCK(&lock_);
   // This part isn't gentle, the better method is using LRU queue.
   for (i = 0; i < MAX_OPEN_FILE; i++) {
     if (open_list_[i]) {
       if (!strcmp(open_list_[i]->file_name, file_name)) {
         *file_id = i;
+        MUTEX_UNLOCK(&lock_);
         LOG_INFO("%s has already been opened.", file_name);
         return RC::SUCCESS;
       }
@@ -96,24 +423,45 @@ RC DiskBufferPool::open_file(const char *file_name, int *file_id)
   while (i < MAX_OPEN_FILE && open_list_[i++])
     ;
   if (i >= MAX_OPEN_FILE && open_list_[i - 1]) {
+    MUTEX_UNLOCK(&lock_);
     LOG_ERROR("Failed to open file %s, because too much files has been opened.", file_name);
     return RC::BUFFERPOOL_OPEN_TOO_MANY_FILES;
   }
 
-  if ((fd = open(file_name, O_RDWR)) < 0) {
+  // 页帧按BP_PAGE_SIZE对齐，文件读写的偏移和长度也都是整页，满足O_DIRECT的要求
+  bool direct_io = direct_io_ && !read_only_;
+  fd = open(file_name, (read_only_ ? O_RDONLY : O_RDWR) | (direct_io ? O_DIRECT : 0));
+  if (fd < 0 && direct_io && errno == EINVAL) {
+    LOG_WARN("File system of %s does not support O_DIRECT, open it with page cache.", file_name);
+    direct_io = false;
+    fd = open(file_name, O_RDWR);
+  }
+  if (fd < 0) {
+    MUTEX_UNLOCK(&lock_);
     LOG_ERROR("Failed to open file %s, because %s.", file_name, strerror(errno));
     return RC::IOERR_ACCESS;
   }
   LOG_INFO("Successfully open file %s.", file_name);
 
+  int page_size = 0;
+  RC tmp = read_page_size(fd, file_name, &page_size);
+  if (tmp == RC::SUCCESS && bp_managers_of(page_size).empty()) {
+    tmp = init_partitions(page_size, (int)bp_managers_of(BP_PAGE_SIZE).size());
+  }
+  if (tmp != RC::SUCCESS) {
+    MUTEX_UNLOCK(&lock_);
+    close(fd);
+    return tmp;
+  }
+
   BPFileHandle *file_handle = new (std::nothrow) BPFileHandle();
   if (file_handle == nullptr) {
+    MUTEX_UNLOCK(&lock_);
     LOG_ERROR("Failed to alloc memory of BPFileHandle for %s.", file_name);
     close(fd);
     return RC::NOMEM;
   }
 
-  RC tmp;
   file_handle->bopen = true;
   int file_name_len = strlen(file_name) + 1;
   char *cloned_file_name = new char[file_name_len];
@@ -121,29 +469,65 @@ RC DiskBufferPool::open_file(const char *file_name, int *file_id)
   cloned_file_name[file_name_len - 1] = '\0';
   file_handle->file_name = cloned_file_name;
   file_handle->file_desc = fd;
-  if ((tmp = allocate_block(&file_handle->hdr_frame)) != RC::SUCCESS) {
-    LOG_ERROR("Failed to allocate block for %s's BPFileHandle.", file_name);
-    delete file_handle;
-    close(fd);
-    return tmp;
+  file_handle->page_size = page_size;
+  file_handle->direct_io = direct_io;
+  MUTEX_INIT(&file_handle->lock, nullptr);
+
+  if (read_only_) {
+    if ((tmp = map_file(file_handle)) != RC::SUCCESS) {
+      MUTEX_UNLOCK(&lock_);
+      MUTEX_DESTROY(&file_handle->lock);
+      delete file_handle;
+      close(fd);
+      return tmp;
+    }
+  } else {
+    BPManager &bp_manager = bp_manager_of(page_size, fd, 0);
+    bp_manager.lock();
+    if ((tmp = allocate_block(page_size, fd, 0, &file_handle->hdr_frame)) != RC::SUCCESS) {
+      bp_manager.unlock();
+      MUTEX_UNLOCK(&lock_);
+      LOG_ERROR("Failed to allocate block for %s's BPFileHandle.", file_name);
+      MUTEX_DESTROY(&file_handle->lock);
+      delete file_handle;
+      close(fd);
+      return tmp;
+    }
+    file_handle->hdr_frame->dirty = false;
+    file_handle->hdr_frame->acc_time = current_time();
+    file_handle->hdr_frame->file_desc = fd;
+    file_handle->hdr_frame->pin_count = 1;
+    if ((tmp = load_page(0, file_handle, file_handle->hdr_frame)) != RC::SUCCESS) {
+      file_handle->hdr_frame->pin_count = 0;
+      dispose_block(file_handle->hdr_frame);
+      bp_manager.unlock();
+      MUTEX_UNLOCK(&lock_);
+      close(fd);
+      MUTEX_DESTROY(&file_handle->lock);
+      delete file_handle;
+      return tmp;
+    }
+    bp_manager.unlock();
   }
-  file_handle->hdr_frame->dirty = false;
-  file_handle->hdr_frame->acc_time = current_time();
-  file_handle->hdr_frame->file_desc = fd;
-  file_handle->hdr_frame->pin_count = 1;
-  if ((tmp = load_page(0, file_handle, file_handle->hdr_frame)) != RC::SUCCESS) {
+
+  file_handle->hdr_page = file_handle->hdr_frame->page;
+  file_handle->bitmap = file_handle->hdr_page->data + BP_FILE_SUB_HDR_SIZE;
+  file_handle->file_sub_header = (BPFileSubHeader *)file_handle->hdr_page->data;
+  if (!read_only_ && (tmp = init_free_summary(file_handle)) != RC::SUCCESS) {
+    BPManager &bp_manager = bp_manager_of(page_size, fd, 0);
+    bp_manager.lock();
     file_handle->hdr_frame->pin_count = 0;
     dispose_block(file_handle->hdr_frame);
+    bp_manager.unlock();
+    MUTEX_UNLOCK(&lock_);
     close(fd);
+    MUTEX_DESTROY(&file_handle->lock);
     delete file_handle;
     return tmp;
   }
-
-  file_handle->hdr_page = &(file_handle->hdr_frame->page);
-  file_handle->bitmap = file_handle->hdr_page->data + BP_FILE_SUB_HDR_SIZE;
-  file_handle->file_sub_header = (BPFileSubHeader *)file_handle->hdr_page->data;
   open_list_[i - 1] = file_handle;
   *file_id = i - 1;
+  MUTEX_UNLOCK(&lock_);
   LOG_INFO("Successfully open %s. file_id=%d, hdr_frame=%p", file_name, *file_id, file_handle->hdr_frame);
   return RC::SUCCESS;
 }
@@ -151,26 +535,44 @@ RC DiskBufferPool::open_file(const char *file_name, int *file_id)
 RC DiskBufferPool::close_file(int file_id)
 {
   RC tmp;
+  MUTEX_LOCK(&lock_);
   if ((tmp = check_file_id(file_id)) != RC::SUCCESS) {
+    MUTEX_UNLOCK(&lock_);
     LOG_ERROR("Failed to close file, due to invalid fileId %d", file_id);
     return tmp;
   }
 
   BPFileHandle *file_handle = open_list_[file_id];
+  BPManager &hdr_bp_manager = bp_manager_of(file_handle->page_size, file_handle->file_desc, 0);
+  MUTEX_LOCK(&file_handle->lock);
+  hdr_bp_manager.lock();
   file_handle->hdr_frame->pin_count--;
+  hdr_bp_manager.unlock();
   if ((tmp = force_all_pages(file_handle)) != RC::SUCCESS) {
+    hdr_bp_manager.lock();
     file_handle->hdr_frame->pin_count++;
+    hdr_bp_manager.unlock();
+    MUTEX_UNLOCK(&file_handle->lock);
+    MUTEX_UNLOCK(&lock_);
     LOG_ERROR("Failed to closeFile %d:%s, due to failed to force all pages.", file_id, file_handle->file_name);
     return tmp;
   }
+  MUTEX_UNLOCK(&file_handle->lock);
 
+  if (file_handle->mmap_frames != nullptr) {
+    unmap_file(file_handle);
+  }
   if (close(file_handle->file_desc) < 0) {
+    MUTEX_UNLOCK(&lock_);
     LOG_ERROR("Failed to close fileId:%d, fileName:%s, error:%s", file_id, file_handle->file_name, strerror(errno));
     return RC::IOERR_CLOSE;
   }
   open_list_[file_id] = nullptr;
-  delete (file_handle);
+  MUTEX_UNLOCK(&lock_);
   LOG_INFO("Successfully close file %d:%s.", file_id, file_handle->file_name);
+  delete[] file_handle->free_summary;
+  MUTEX_DESTROY(&file_handle->lock);
+  delete (file_handle);
   return RC::SUCCESS;
 }
 
@@ -183,29 +585,47 @@ RC DiskBufferPool::get_this_page(int file_id, PageNum page_num, BPPageHandle *pa
   }
 
   BPFileHandle *file_handle = open_list_[file_id];
-  if ((tmp = check_page_num(page_num, file_handle)) != RC::SUCCESS) {
+  MUTEX_LOCK(&file_handle->lock);
+  tmp = check_page_num(page_num, file_handle);
+  MUTEX_UNLOCK(&file_handle->lock);
+  if (tmp != RC::SUCCESS) {
     LOG_ERROR("Failed to load page %s:%d, due to invalid pageNum.", file_handle->file_name, page_num);
     return tmp;
   }
 
-  for (int i = 0; i < BP_BUFFER_SIZE; i++) {
-    if (!bp_manager_.allocated[i])
-      continue;
-    if (bp_manager_.frame[i].file_desc != file_handle->file_desc)
-      continue;
+  BPManager &bp_manager = bp_manager_of(file_handle->page_size, file_handle->file_desc, page_num);
+  bp_manager.lock();
 
-    // This page has been loaded.
-    if (bp_manager_.frame[i].page.page_num == page_num) {
-      page_handle->frame = bp_manager_.frame + i;
-      page_handle->frame->pin_count++;
-      page_handle->frame->acc_time = current_time();
-      page_handle->open = true;
-      return RC::SUCCESS;
+  // 只读模式下页面已经映射到内存中，不需要读盘和缓冲区
+  if (file_handle->mmap_frames != nullptr) {
+    if (page_num >= file_handle->mmap_page_count) {
+      bp_manager.unlock();
+      LOG_ERROR("Failed to load page %s:%d, exceed mapped pages %d.",
+          file_handle->file_name, page_num, file_handle->mmap_page_count);
+      return RC::BUFFERPOOL_INVALID_PAGE_NUM;
     }
+    page_handle->frame = file_handle->mmap_frames + page_num;
+    page_handle->frame->pin_count++;
+    page_handle->frame->acc_time = current_time();
+    page_handle->open = true;
+    bp_manager.unlock();
+    return RC::SUCCESS;
+  }
+
+  // This page has been loaded.
+  Frame *frame = bp_manager.get(file_handle->file_desc, page_num);
+  if (frame != nullptr) {
+    page_handle->frame = frame;
+    page_handle->frame->pin_count++;
+    page_handle->frame->acc_time = current_time();
+    page_handle->open = true;
+    bp_manager.unlock();
+    return RC::SUCCESS;
   }
 
   // Allocate one page and load the data into this page
-  if ((tmp = allocate_block(&(page_handle->frame))) != RC::SUCCESS) {
+  if ((tmp = allocate_block(file_handle->page_size, file_handle->file_desc, page_num, &(page_handle->frame))) != RC::SUCCESS) {
+    bp_manager.unlock();
     LOG_ERROR("Failed to load page %s:%d, due to failed to alloc page.", file_handle->file_name, page_num);
     return tmp;
   }
@@ -217,8 +637,10 @@ RC DiskBufferPool::get_this_page(int file_id, PageNum page_num, BPPageHandle *pa
     LOG_ERROR("Failed to load page %s:%d", file_handle->file_name, page_num);
     page_handle->frame->pin_count = 0;
     dispose_block(page_handle->frame);
+    bp_manager.unlock();
     return tmp;
   }
+  bp_manager.unlock();
 
   page_handle->open = true;
   return RC::SUCCESS;
@@ -231,29 +653,49 @@ RC DiskBufferPool::allocate_page(int file_id, BPPageHandle *page_handle)
     LOG_ERROR("Failed to alloc page, due to invalid fileId %d", file_id);
     return tmp;
   }
+  if (read_only_) {
+    LOG_WARN("Failed to alloc page of file %d, buffer pool is read only.", file_id);
+    return RC::READONLY;
+  }
 
   BPFileHandle *file_handle = open_list_[file_id];
+  MUTEX_LOCK(&file_handle->lock);
 
   int byte = 0, bit = 0;
-  if ((file_handle->file_sub_header->allocated_pages) < (file_handle->file_sub_header->page_count)) {
-    // There is one free page
-    for (int i = 0; i < file_handle->file_sub_header->page_count; i++) {
-      byte = i / 8;
-      bit = i % 8;
-      if (((file_handle->bitmap[byte]) & (1 << bit)) == 0) {
-        (file_handle->file_sub_header->allocated_pages)++;
-        file_handle->bitmap[byte] |= (1 << bit);
-        return get_this_page(file_id, i, page_handle);
-      }
-    }
+  PageNum free_page = find_free_page(file_handle);
+  if (free_page >= 0) {
+    byte = free_page / 8;
+    bit = free_page % 8;
+    (file_handle->file_sub_header->allocated_pages)++;
+    file_handle->bitmap[byte] |= (1 << bit);
+    file_handle->hdr_frame->dirty = true;
+    update_free_summary(file_handle, free_page);
+    MUTEX_UNLOCK(&file_handle->lock);
+    return get_this_page(file_id, free_page, page_handle);
   }
 
-  if ((tmp = allocate_block(&(page_handle->frame))) != RC::SUCCESS) {
+  PageNum page_num = file_handle->file_sub_header->page_count;
+  if (page_num >= file_handle->max_page_count) {
+    MUTEX_UNLOCK(&file_handle->lock);
+    LOG_ERROR("Failed to allocate page %s, the file has reached the max page count %d.",
+        file_handle->file_name, file_handle->max_page_count);
+    return RC::BUFFERPOOL_NOBUF;
+  }
+  // 预分配失败时退化为写出新页面来扩展文件
+  if (page_num >= file_handle->file_pages) {
+    extend_file(file_handle);
+  }
+  bool preallocated = page_num < file_handle->file_pages;
+
+  BPManager &bp_manager = bp_manager_of(file_handle->page_size, file_handle->file_desc, page_num);
+  bp_manager.lock();
+  if ((tmp = allocate_block(file_handle->page_size, file_handle->file_desc, page_num, &(page_handle->frame))) != RC::SUCCESS) {
+    bp_manager.unlock();
+    MUTEX_UNLOCK(&file_handle->lock);
     LOG_ERROR("Failed to allocate page %s, due to no free page.", file_handle->file_name);
     return tmp;
   }
 
-  PageNum page_num = file_handle->file_sub_header->page_count;
   file_handle->file_sub_header->allocated_pages++;
   file_handle->file_sub_header->page_count++;
 
@@ -266,14 +708,20 @@ RC DiskBufferPool::allocate_page(int file_id, BPPageHandle *page_handle)
   page_handle->frame->file_desc = file_handle->file_desc;
   page_handle->frame->pin_count = 1;
   page_handle->frame->acc_time = current_time();
-  memset(&(page_handle->frame->page), 0, sizeof(Page));
-  page_handle->frame->page.page_num = file_handle->file_sub_header->page_count - 1;
-
-  // Use flush operation to extion file
-  if ((tmp = flush_block(page_handle->frame)) != RC::SUCCESS) {
+  memset(page_handle->frame->page, 0, page_handle->frame->page_size);
+  page_handle->frame->page->page_num = file_handle->file_sub_header->page_count - 1;
+
+  // 文件空间已经预先分配，新页面和其它脏页一起写出即可
+  if (preallocated) {
+    page_handle->frame->dirty = true;
+  } else if ((tmp = flush_block(page_handle->frame)) != RC::SUCCESS) {
+    bp_manager.unlock();
+    MUTEX_UNLOCK(&file_handle->lock);
     LOG_ERROR("Failed to alloc page %s , due to failed to extend one page.", file_handle->file_name);
     return tmp;
   }
+  bp_manager.unlock();
+  MUTEX_UNLOCK(&file_handle->lock);
 
   page_handle->open = true;
   return RC::SUCCESS;
@@ -283,7 +731,7 @@ RC DiskBufferPool::get_page_num(BPPageHandle *page_handle, PageNum *page_num)
 {
   if (!page_handle->open)
     return RC::BUFFERPOOL_CLOSED;
-  *page_num = page_handle->frame->page.page_num;
+  *page_num = page_handle->frame->page->page_num;
   return RC::SUCCESS;
 }
 
@@ -291,20 +739,32 @@ RC DiskBufferPool::get_data(BPPageHandle *page_handle, char **data)
 {
   if (!page_handle->open)
     return RC::BUFFERPOOL_CLOSED;
-  *data = page_handle->frame->page.data;
+  *data = page_handle->frame->page->data;
   return RC::SUCCESS;
 }
 
 RC DiskBufferPool::mark_dirty(BPPageHandle *page_handle)
 {
-  page_handle->frame->dirty = true;
+  if (read_only_) {
+    LOG_WARN("Failed to mark page %d dirty, buffer pool is read only.", page_handle->frame->page->page_num);
+    return RC::READONLY;
+  }
+  Frame *frame = page_handle->frame;
+  BPManager &bp_manager = bp_manager_of(frame->page_size, frame->file_desc, frame->page->page_num);
+  bp_manager.lock();
+  frame->dirty = true;
+  bp_manager.unlock();
   return RC::SUCCESS;
 }
 
 RC DiskBufferPool::unpin_page(BPPageHandle *page_handle)
 {
+  Frame *frame = page_handle->frame;
+  BPManager &bp_manager = bp_manager_of(frame->page_size, frame->file_desc, frame->page->page_num);
+  bp_manager.lock();
   page_handle->open = false;
-  page_handle->frame->pin_count--;
+  frame->pin_count--;
+  bp_manager.unlock();
   return RC::SUCCESS;
 }
 
@@ -322,32 +782,39 @@ RC DiskBufferPool::dispose_page(int file_id, PageNum page_num)
     LOG_ERROR("Failed to alloc page, due to invalid fileId %d", file_id);
     return rc;
   }
+  if (read_only_) {
+    LOG_WARN("Failed to dispose page %d of file %d, buffer pool is read only.", page_num, file_id);
+    return RC::READONLY;
+  }
 
   BPFileHandle *file_handle = open_list_[file_id];
+  MUTEX_LOCK(&file_handle->lock);
   if ((rc = check_page_num(page_num, file_handle)) != RC::SUCCESS) {
+    MUTEX_UNLOCK(&file_handle->lock);
     LOG_ERROR("Failed to dispose page %s:%d, due to invalid pageNum", file_handle->file_name, page_num);
     return rc;
   }
 
-  for (int i = 0; i < BP_BUFFER_SIZE; i++) {
-    if (!bp_manager_.allocated[i])
-      continue;
-    if (bp_manager_.frame[i].file_desc != file_handle->file_desc) {
-      continue;
-    }
-
-    if (bp_manager_.frame[i].page.page_num == page_num) {
-      if (bp_manager_.frame[i].pin_count != 0)
-        return RC::BUFFERPOOL_PAGE_PINNED;
-      bp_manager_.allocated[i] = false;
+  BPManager &bp_manager = bp_manager_of(file_handle->page_size, file_handle->file_desc, page_num);
+  bp_manager.lock();
+  Frame *frame = bp_manager.get(file_handle->file_desc, page_num);
+  if (frame != nullptr) {
+    if (frame->pin_count != 0) {
+      bp_manager.unlock();
+      MUTEX_UNLOCK(&file_handle->lock);
+      return RC::BUFFERPOOL_PAGE_PINNED;
     }
+    bp_manager.free(frame);
   }
+  bp_manager.unlock();
 
   file_handle->hdr_frame->dirty = true;
   file_handle->file_sub_header->allocated_pages--;
   // file_handle->pFileSubHeader->pageCount--;
   char tmp = 1 << (page_num % 8);
   file_handle->bitmap[page_num / 8] &= ~tmp;
+  update_free_summary(file_handle, page_num);
+  MUTEX_UNLOCK(&file_handle->lock);
   return RC::SUCCESS;
 }
 
@@ -359,7 +826,10 @@ RC DiskBufferPool::force_page(int file_id, PageNum page_num)
     return rc;
   }
   BPFileHandle *file_handle = open_list_[file_id];
-  return force_page(file_handle, page_num);
+  MUTEX_LOCK(&file_handle->lock);
+  rc = force_page(file_handle, page_num);
+  MUTEX_UNLOCK(&file_handle->lock);
+  return rc;
 }
 /**
  * dispose_page will delete the data of the page of pageNum
@@ -370,33 +840,34 @@ RC DiskBufferPool::force_page(int file_id, PageNum page_num)
  */
 RC DiskBufferPool::force_page(BPFileHandle *file_handle, PageNum page_num)
 {
-  int i;
-  for (i = 0; i < BP_BUFFER_SIZE; i++) {
-    if (!bp_manager_.allocated[i])
-      continue;
+  if (page_num == -1) {
+    return force_all_pages(file_handle);
+  }
 
-    Frame *frame = &bp_manager_.frame[i];
-    if (frame->file_desc != file_handle->file_desc)
-      continue;
-    if (frame->page.page_num != page_num && page_num != -1) {
-      continue;
-    }
+  BPManager &bp_manager = bp_manager_of(file_handle->page_size, file_handle->file_desc, page_num);
+  bp_manager.lock();
+  Frame *frame = bp_manager.get(file_handle->file_desc, page_num);
+  if (frame == nullptr) {
+    bp_manager.unlock();
+    return RC::SUCCESS;
+  }
 
-    if (frame->pin_count != 0) {
-      LOG_ERROR("Page :%s:%d has been pinned.", file_handle->file_name, page_num);
-      return RC::BUFFERPOOL_PAGE_PINNED;
-    }
+  if (frame->pin_count != 0) {
+    bp_manager.unlock();
+    LOG_ERROR("Page :%s:%d has been pinned.", file_handle->file_name, page_num);
+    return RC::BUFFERPOOL_PAGE_PINNED;
+  }
 
-    if (frame->dirty) {
-      RC rc = RC::SUCCESS;
-      if ((rc = flush_block(frame)) != RC::SUCCESS) {
-        LOG_ERROR("Failed to flush page:%s:%d.", file_handle->file_name, page_num);
-        return rc;
-      }
+  if (frame->dirty) {
+    RC rc = RC::SUCCESS;
+    if ((rc = flush_block(frame)) != RC::SUCCESS) {
+      bp_manager.unlock();
+      LOG_ERROR("Failed to flush page:%s:%d.", file_handle->file_name, page_num);
+      return rc;
     }
-    bp_manager_.allocated[i] = false;
-    return RC::SUCCESS;
   }
+  bp_manager.free(frame);
+  bp_manager.unlock();
   return RC::SUCCESS;
 }
 
@@ -409,27 +880,130 @@ RC DiskBufferPool::flush_all_pages(int file_id)
   }
 
   BPFileHandle *file_handle = open_list_[file_id];
-  return force_all_pages(file_handle);
+  MUTEX_LOCK(&file_handle->lock);
+  rc = force_all_pages(file_handle);
+  MUTEX_UNLOCK(&file_handle->lock);
+  return rc;
 }
 
-RC DiskBufferPool::force_all_pages(BPFileHandle *file_handle)
+void DiskBufferPool::get_dirty_page_count(int *dirty_page_count, int *frame_count)
 {
+  *dirty_page_count = 0;
+  *frame_count = 0;
+  for (BPManager *bp_manager : all_bp_managers()) {
+    bp_manager->lock();
+    *dirty_page_count += bp_manager->dirty_count();
+    *frame_count += bp_manager->size();
+    bp_manager->unlock();
+  }
+}
 
-  for (int i = 0; i < BP_BUFFER_SIZE; i++) {
-    if (!bp_manager_.allocated[i])
-      continue;
+RC DiskBufferPool::clean_pages(int max_pages, int *cleaned_pages)
+{
+  *cleaned_pages = 0;
+  RC rc = RC::SUCCESS;
+  std::vector<BPManager *> bp_managers = all_bp_managers();
+  for (size_t i = 0; i < bp_managers.size() && *cleaned_pages < max_pages; i++) {
+    BPManager *bp_manager = bp_managers[i];
+    // 没有被pin住的页面不会被修改，持有分区锁期间也不会被淘汰或者关闭文件
+    bp_manager->lock();
+    std::vector<Frame *> dirty_frames = bp_manager->find_dirty_list();
+    int quota = std::min((int)dirty_frames.size(), max_pages - *cleaned_pages);
+    dirty_frames.resize(quota);
+
+    std::unordered_map<int, std::vector<Frame *>> file_frames;
+    for (Frame *frame : dirty_frames) {
+      file_frames[frame->file_desc].push_back(frame);
+    }
+    for (auto &iter : file_frames) {
+      rc = flush_blocks(iter.second);
+      if (rc != RC::SUCCESS) {
+        break;
+      }
+      *cleaned_pages += (int)iter.second.size();
+    }
+    bp_manager->unlock();
 
-    if (bp_manager_.frame[i].file_desc != file_handle->file_desc)
-      continue;
+    if (rc != RC::SUCCESS) {
+      LOG_ERROR("Failed to clean pages of buffer pool partition %d. rc=%d:%s", (int)i, rc, strrc(rc));
+      return rc;
+    }
+  }
+  return RC::SUCCESS;
+}
 
-    if (bp_manager_.frame[i].dirty) {
-      RC rc = flush_block(&bp_manager_.frame[i]);
-      if (rc != RC::SUCCESS) {
-        LOG_ERROR("Failed to flush all pages' of %s.", file_handle->file_name);
-        return rc;
+RC DiskBufferPool::force_all_pages(BPFileHandle *file_handle)
+{
+  // 按顺序锁住文件页大小对应的所有分区，其它地方同一时间最多只持有一个分区的锁，所以不会死锁
+  std::vector<BPManager *> &bp_managers = bp_managers_of(file_handle->page_size);
+  for (BPManager *bp_manager : bp_managers) {
+    bp_manager->lock();
+  }
+
+  std::vector<Frame *> frames;
+  std::vector<Frame *> dirty_frames;
+  for (BPManager *bp_manager : bp_managers) {
+    std::vector<Frame *> partition_frames = bp_manager->find_list(file_handle->file_desc);
+    for (Frame *frame : partition_frames) {
+      frames.push_back(frame);
+      if (frame->dirty) {
+        dirty_frames.push_back(frame);
       }
     }
-    bp_manager_.allocated[i] = false;
+  }
+
+  RC rc = flush_blocks(dirty_frames);
+  if (rc != RC::SUCCESS) {
+    LOG_ERROR("Failed to flush all pages' of %s.", file_handle->file_name);
+  } else {
+    for (Frame *frame : frames) {
+      // pinned page is still in use, such as the header page of an opened file
+      if (frame->pin_count == 0) {
+        bp_manager_of(frame->page_size, frame->file_desc, frame->page->page_num).free(frame);
+      }
+    }
+  }
+
+  for (BPManager *bp_manager : bp_managers) {
+    bp_manager->unlock();
+  }
+  return rc;
+}
+
+RC DiskBufferPool::flush_blocks(std::vector<Frame *> &frames)
+{
+  std::sort(frames.begin(), frames.end(), [](const Frame *left, const Frame *right) {
+    return left->page->page_num < right->page->page_num;
+  });
+
+  struct iovec iov[BP_FLUSH_BATCH_PAGES];
+  size_t begin = 0;
+  while (begin < frames.size()) {
+    int iov_count = 0;
+    size_t end = begin;
+    do {
+      iov[iov_count].iov_base = frames[end]->page;
+      iov[iov_count].iov_len = frames[end]->page_size;
+      iov_count++;
+      end++;
+    } while (end < frames.size() && iov_count < BP_FLUSH_BATCH_PAGES &&
+             frames[end]->page->page_num == frames[end - 1]->page->page_num + 1);
+
+    Frame *first = frames[begin];
+    s64_t offset = ((s64_t)first->page->page_num) * first->page_size;
+    ssize_t length = (ssize_t)iov_count * first->page_size;
+    if (pwritev(first->file_desc, iov, iov_count, offset) != length) {
+      LOG_ERROR("Failed to flush pages %d-%d of %d due to %s.",
+          first->page->page_num, first->page->page_num + iov_count - 1, first->file_desc, strerror(errno));
+      return RC::IOERR_WRITE;
+    }
+    LOG_DEBUG("Flush blocks. file desc=%d, page num=%d-%d",
+        first->file_desc, first->page->page_num, first->page->page_num + iov_count - 1);
+
+    for (size_t i = begin; i < end; i++) {
+      frames[i]->dirty = false;
+    }
+    begin = end;
   }
   return RC::SUCCESS;
 }
@@ -439,83 +1013,61 @@ RC DiskBufferPool::flush_block(Frame *frame)
   // The better way is use mmap the block into memory,
   // so it is easier to flush data to file.
 
-  s64_t offset = ((s64_t)frame->page.page_num) * sizeof(Page);
-  if (lseek(frame->file_desc, offset, SEEK_SET) == offset - 1) {
-    LOG_ERROR("Failed to flush page %lld of %d due to failed to seek %s.", offset, frame->file_desc, strerror(errno));
-    return RC::IOERR_SEEK;
-  }
-
-  if (write(frame->file_desc, &(frame->page), sizeof(Page)) != sizeof(Page)) {
+  // 多个线程共享同一个文件描述符，使用pwrite避免lseek和write之间被其它线程打断
+  s64_t offset = ((s64_t)frame->page->page_num) * frame->page_size;
+  if (pwrite(frame->file_desc, frame->page, frame->page_size, offset) != frame->page_size) {
     LOG_ERROR("Failed to flush page %lld of %d due to %s.", offset, frame->file_desc, strerror(errno));
     return RC::IOERR_WRITE;
   }
   frame->dirty = false;
-  LOG_DEBUG("Flush block. file desc=%d, page num=%d", frame->file_desc, frame->page.page_num);
+  LOG_DEBUG("Flush block. file desc=%d, page num=%d", frame->file_desc, frame->page->page_num);
 
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::allocate_block(Frame **buffer)
+RC DiskBufferPool::allocate_block(int page_size, int file_desc, PageNum page_num, Frame **buffer)
 {
-
-  // There is one Frame which is free.
-  for (int i = 0; i < BP_BUFFER_SIZE; i++) {
-    if (!bp_manager_.allocated[i]) {
-      bp_manager_.allocated[i] = true;
-      *buffer = bp_manager_.frame + i;
-      LOG_DEBUG("Allocate block frame=%p", bp_manager_.frame + i);
-      return RC::SUCCESS;
-    }
+  BPManager &bp_manager = bp_manager_of(page_size, file_desc, page_num);
+  Frame *frame = bp_manager.alloc(file_desc, page_num);
+  if (frame != nullptr) {
+    *buffer = frame;
+    LOG_DEBUG("Allocate block frame=%p", frame);
+    return RC::SUCCESS;
   }
 
-  int min = 0;
-  unsigned long mintime = 0;
-  bool flag = false;
-  for (int i = 0; i < BP_BUFFER_SIZE; i++) {
-    if (bp_manager_.frame[i].pin_count != 0)
-      continue;
-    if (!flag) {
-      flag = true;
-      min = i;
-      mintime = bp_manager_.frame[i].acc_time;
-    }
-    if (bp_manager_.frame[i].acc_time < mintime) {
-      min = i;
-      mintime = bp_manager_.frame[i].acc_time;
-    }
-  }
-  if (!flag) {
+  Frame *victim = bp_manager.victim();
+  if (victim == nullptr) {
     LOG_ERROR("All pages have been used and pinned.");
     return RC::NOMEM;
   }
 
-  if (bp_manager_.frame[min].dirty) {
-    RC rc = flush_block(&(bp_manager_.frame[min]));
+  if (victim->dirty) {
+    RC rc = flush_block(victim);
     if (rc != RC::SUCCESS) {
-      LOG_ERROR("Failed to flush block of %d for %d.", min, bp_manager_.frame[min].file_desc);
+      LOG_ERROR("Failed to flush block of %d for %d.", victim->page->page_num, victim->file_desc);
       return rc;
     }
   }
-  *buffer = bp_manager_.frame + min;
+  bp_manager.free(victim);
+
+  *buffer = bp_manager.alloc(file_desc, page_num);
   return RC::SUCCESS;
 }
 
 RC DiskBufferPool::dispose_block(Frame *buf)
 {
   if (buf->pin_count != 0) {
-    LOG_WARN("Begin to free page %d of %d, but it's pinned.", buf->page.page_num, buf->file_desc);
+    LOG_WARN("Begin to free page %d of %d, but it's pinned.", buf->page->page_num, buf->file_desc);
     return RC::LOCKED_UNLOCK;
   }
   if (buf->dirty) {
     RC rc = flush_block(buf);
     if (rc != RC::SUCCESS) {
-      LOG_WARN("Failed to flush block %d of %d during dispose block.", buf->page.page_num, buf->file_desc);
+      LOG_WARN("Failed to flush block %d of %d during dispose block.", buf->page->page_num, buf->file_desc);
       return rc;
     }
   }
-  buf->dirty = false;
-  int pos = buf - bp_manager_.frame;
-  bp_manager_.allocated[pos] = false;
+  bp_manager_of(buf->page_size, buf->file_desc, buf->page->page_num).free(buf);
   LOG_DEBUG("dispost block frame =%p", buf);
   return RC::SUCCESS;
 }
@@ -539,7 +1091,54 @@ RC DiskBufferPool::get_page_count(int file_id, int *page_count)
   if ((rc = check_file_id(file_id)) != RC::SUCCESS) {
     return rc;
   }
-  *page_count = open_list_[file_id]->file_sub_header->page_count;
+  BPFileHandle *file_handle = open_list_[file_id];
+  MUTEX_LOCK(&file_handle->lock);
+  *page_count = file_handle->file_sub_header->page_count;
+  MUTEX_UNLOCK(&file_handle->lock);
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::get_page_size(int file_id, int *page_size)
+{
+  RC rc = RC::SUCCESS;
+  if ((rc = check_file_id(file_id)) != RC::SUCCESS) {
+    return rc;
+  }
+  *page_size = open_list_[file_id]->page_size;
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::prefetch_pages(int file_id, PageNum start_page, int page_num)
+{
+  RC rc = RC::SUCCESS;
+  if ((rc = check_file_id(file_id)) != RC::SUCCESS) {
+    return rc;
+  }
+  BPFileHandle *file_handle = open_list_[file_id];
+  if (file_handle->direct_io) {
+    // 绕过了page cache，预读没有意义
+    return RC::SUCCESS;
+  }
+  MUTEX_LOCK(&file_handle->lock);
+  int page_count = file_handle->file_sub_header->page_count;
+  MUTEX_UNLOCK(&file_handle->lock);
+  if (start_page < 0 || page_num <= 0 || start_page >= page_count) {
+    return RC::SUCCESS;
+  }
+  if (start_page + page_num > page_count) {
+    page_num = page_count - start_page;
+  }
+
+  // 由内核在后台把数据读入page cache，之后load_page时就不需要等待磁盘
+  s64_t offset = ((s64_t)start_page) * file_handle->page_size;
+  s64_t length = ((s64_t)page_num) * file_handle->page_size;
+  int ret = posix_fadvise(file_handle->file_desc, offset, length, POSIX_FADV_WILLNEED);
+  if (ret != 0) {
+    LOG_WARN("Failed to prefetch pages %s:%d-%d, due to %s.",
+        file_handle->file_name, start_page, start_page + page_num - 1, strerror(ret));
+    return RC::IOERR_READ;
+  }
+  LOG_DEBUG("Prefetch pages %s:%d-%d", file_handle->file_name, start_page, start_page + page_num - 1);
   return RC::SUCCESS;
 }
 
@@ -556,19 +1155,172 @@ RC DiskBufferPool::check_page_num(PageNum page_num, BPFileHandle *file_handle)
   return RC::SUCCESS;
 }
 
-RC DiskBufferPool::load_page(PageNum page_num, BPFileHandle *file_handle, Frame *frame)
+RC DiskBufferPool::map_file(BPFileHandle *file_handle)
 {
-  s64_t offset = ((s64_t)page_num) * sizeof(Page);
-  if (lseek(file_handle->file_desc, offset, SEEK_SET) == -1) {
-    LOG_ERROR(
-        "Failed to load page %s:%d, due to failed to lseek:%s.", file_handle->file_name, page_num, strerror(errno));
+  struct stat st;
+  if (fstat(file_handle->file_desc, &st) < 0) {
+    LOG_ERROR("Failed to stat file %s, due to %s.", file_handle->file_name, strerror(errno));
+    return RC::IOERR_FSTAT;
+  }
+  int page_count = (int)(st.st_size / file_handle->page_size);
+  if (page_count <= 0) {
+    LOG_ERROR("Failed to map file %s, it is empty.", file_handle->file_name);
+    return RC::IOERR_SHORT_READ;
+  }
+
+  size_t mmap_size = (size_t)page_count * file_handle->page_size;
+  void *addr = mmap(nullptr, mmap_size, PROT_READ, MAP_SHARED, file_handle->file_desc, 0);
+  if (addr == MAP_FAILED) {
+    LOG_ERROR("Failed to map file %s, due to %s.", file_handle->file_name, strerror(errno));
+    return RC::IOERR_MMAP;
+  }
 
-    return RC::IOERR_SEEK;
+  Frame *frames = new (std::nothrow) Frame[page_count];
+  if (frames == nullptr) {
+    LOG_ERROR("Failed to alloc %d frames for mapped file %s.", page_count, file_handle->file_name);
+    munmap(addr, mmap_size);
+    return RC::NOMEM;
+  }
+  for (int i = 0; i < page_count; i++) {
+    Frame *frame = frames + i;
+    frame->dirty = false;
+    frame->referenced = false;
+    frame->pin_count = 0;
+    frame->acc_time = 0;
+    frame->file_desc = file_handle->file_desc;
+    frame->page_size = file_handle->page_size;
+    frame->page = (Page *)((char *)addr + (size_t)i * file_handle->page_size);
+    pthread_rwlock_init(&frame->latch, nullptr);
   }
-  if (read(file_handle->file_desc, &(frame->page), sizeof(Page)) != sizeof(Page)) {
+
+  file_handle->mmap_frames = frames;
+  file_handle->mmap_page_count = page_count;
+  file_handle->mmap_size = mmap_size;
+  file_handle->hdr_frame = frames;
+  file_handle->hdr_frame->pin_count = 1;
+  LOG_INFO("Successfully map file %s with %d pages.", file_handle->file_name, page_count);
+  return RC::SUCCESS;
+}
+
+void DiskBufferPool::unmap_file(BPFileHandle *file_handle)
+{
+  void *addr = file_handle->mmap_frames[0].page;
+  for (int i = 0; i < file_handle->mmap_page_count; i++) {
+    pthread_rwlock_destroy(&file_handle->mmap_frames[i].latch);
+  }
+  delete[] file_handle->mmap_frames;
+  munmap(addr, file_handle->mmap_size);
+
+  file_handle->mmap_frames = nullptr;
+  file_handle->mmap_page_count = 0;
+  file_handle->mmap_size = 0;
+  file_handle->hdr_frame = nullptr;
+}
+
+RC DiskBufferPool::init_free_summary(BPFileHandle *file_handle)
+{
+  struct stat st;
+  if (fstat(file_handle->file_desc, &st) < 0) {
+    LOG_ERROR("Failed to stat file %s, due to %s.", file_handle->file_name, strerror(errno));
+    return RC::IOERR_FSTAT;
+  }
+  file_handle->file_pages = (PageNum)(st.st_size / file_handle->page_size);
+
+  // bitmap按64位的字访问，每个字对应摘要中的一位
+  int bitmap_size = file_handle->hdr_frame->data_size() - (int)BP_FILE_SUB_HDR_SIZE;
+  file_handle->max_page_count = bitmap_size / sizeof(uint64_t) * 64;
+  int summary_size = (file_handle->max_page_count / 64 + 63) / 64;
+  file_handle->free_summary = new (std::nothrow) uint64_t[summary_size]();
+  if (file_handle->free_summary == nullptr) {
+    LOG_ERROR("Failed to alloc free page summary for %s.", file_handle->file_name);
+    return RC::NOMEM;
+  }
+  for (PageNum page_num = 0; page_num < file_handle->file_sub_header->page_count; page_num += 64) {
+    update_free_summary(file_handle, page_num);
+  }
+  return RC::SUCCESS;
+}
+
+PageNum DiskBufferPool::find_free_page(BPFileHandle *file_handle)
+{
+  int word_num = (file_handle->file_sub_header->page_count + 63) / 64;
+  for (int i = 0; i < (word_num + 63) / 64; i++) {
+    if (file_handle->free_summary[i] == 0) {
+      continue;
+    }
+    int word = i * 64 + __builtin_ctzll(file_handle->free_summary[i]);
+    uint64_t bits;
+    memcpy(&bits, file_handle->bitmap + word * sizeof(uint64_t), sizeof(bits));
+    return word * 64 + __builtin_ctzll(~bits);
+  }
+  return -1;
+}
+
+void DiskBufferPool::update_free_summary(BPFileHandle *file_handle, PageNum page_num)
+{
+  int word = page_num / 64;
+  uint64_t bits;
+  memcpy(&bits, file_handle->bitmap + word * sizeof(uint64_t), sizeof(bits));
+  // page_count之后的页面还不存在，不算空闲页
+  int valid_bits = std::min(64, file_handle->file_sub_header->page_count - word * 64);
+  uint64_t mask = valid_bits >= 64 ? ~0ULL : ((1ULL << valid_bits) - 1);
+  if ((~bits & mask) != 0) {
+    file_handle->free_summary[word / 64] |= 1ULL << (word % 64);
+  } else {
+    file_handle->free_summary[word / 64] &= ~(1ULL << (word % 64));
+  }
+}
+
+RC DiskBufferPool::extend_file(BPFileHandle *file_handle)
+{
+  // 小文件按当前大小翻倍扩展，避免小表也占用整个extent
+  int extend_pages = std::min(std::max(file_handle->file_pages, 1), extent_pages_);
+  extend_pages = std::min(extend_pages, file_handle->max_page_count - file_handle->file_pages);
+  s64_t offset = ((s64_t)file_handle->file_pages) * file_handle->page_size;
+  s64_t length = ((s64_t)extend_pages) * file_handle->page_size;
+  if (fallocate(file_handle->file_desc, 0, offset, length) != 0) {
+    LOG_WARN("Failed to extend file %s by %d pages, due to %s.", file_handle->file_name, extend_pages, strerror(errno));
+    return RC::IOERR_WRITE;
+  }
+  file_handle->file_pages += extend_pages;
+  LOG_DEBUG("Extend file %s to %d pages.", file_handle->file_name, file_handle->file_pages);
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::read_page_size(int file_desc, const char *file_name, int *page_size)
+{
+  // 文件可能是以O_DIRECT方式打开的，读取头部时也要用对齐的缓冲区
+  void *buffer = nullptr;
+  int ret = posix_memalign(&buffer, BP_PAGE_SIZE, BP_PAGE_SIZE);
+  if (ret != 0) {
+    LOG_ERROR("Failed to alloc memory to read header of %s, due to %s.", file_name, strerror(ret));
+    return RC::NOMEM;
+  }
+  if (pread(file_desc, buffer, BP_PAGE_SIZE, 0) != BP_PAGE_SIZE) {
+    LOG_ERROR("Failed to read header of %s, due to %s.", file_name, strerror(errno));
+    ::free(buffer);
+    return RC::IOERR_READ;
+  }
+  BPFileSubHeader *file_sub_header = (BPFileSubHeader *)((Page *)buffer)->data;
+  *page_size = file_sub_header->page_size;
+  ::free(buffer);
+
+  if (page_size_class(*page_size) < 0) {
+    LOG_ERROR("Invalid page size %d in header of %s.", *page_size, file_name);
+    return RC::IOERR_READ;
+  }
+  return RC::SUCCESS;
+}
+
+RC DiskBufferPool::load_page(PageNum page_num, BPFileHandle *file_handle, Frame *frame)
+{
+  s64_t offset = ((s64_t)page_num) * frame->page_size;
+  if (pread(file_handle->file_desc, frame->page, frame->page_size, offset) != frame->page_size) {
     LOG_ERROR(
         "Failed to load page %s:%d, due to failed to read data:%s.", file_handle->file_name, page_num, strerror(errno));
     return RC::IOERR_READ;
   }
+  // 预先分配的页面在写出之前被释放，磁盘上是全0，页号以请求的为准
+  frame->page->page_num = page_num;
   return RC::SUCCESS;
 }
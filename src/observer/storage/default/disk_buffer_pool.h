@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <string.h>
@@ -23,20 +24,30 @@ See the Mulan PSL v2 for more details. */
 #include <time.h>
 
 #include <vector>
-#include <list>
+#include <unordered_map>
 
 #include "rc.h"
+#include "common/lang/mutex.h"
 
 typedef int PageNum;
 
 //
 #define BP_INVALID_PAGE_NUM (-1)
 #define BP_PAGE_SIZE (1 << 12)
+#define BP_MAX_PAGE_SIZE (1 << 16)
+#define BP_PAGE_SIZE_CLASS_NUM 5  // 4K, 8K, 16K, 32K, 64K
 #define BP_PAGE_DATA_SIZE (BP_PAGE_SIZE - sizeof(PageNum))
 #define BP_FILE_SUB_HDR_SIZE (sizeof(BPFileSubHeader))
 #define BP_BUFFER_SIZE 50
+#define BP_FLUSH_BATCH_PAGES 64  // 一次pwritev最多写出的页面数
+#define BP_HUGE_PAGE_SIZE (2 << 20)
+#define BP_EXTENT_PAGES 64  // 文件每次扩展的最大页数
 #define MAX_OPEN_FILE 1024
 
+/**
+ * 页面的布局。文件可以使用更大的页，这时data的实际长度是页大小减去page_num，
+ * 而不是BP_PAGE_DATA_SIZE
+ */
 typedef struct {
   PageNum page_num;
   char data[BP_PAGE_DATA_SIZE];
@@ -46,20 +57,33 @@ typedef struct {
 typedef struct {
   PageNum page_count;
   int allocated_pages;
+  int page_size;  // 文件的页大小，在创建文件时确定
 } BPFileSubHeader;
 
-typedef struct {
+struct Frame {
   bool dirty;
+  bool referenced;  // CLOCK置换算法的访问标记，命中时置位，时钟指针扫过时清除
   unsigned int pin_count;
   unsigned long acc_time;
   int file_desc;
-  Page page;
-} Frame;
+  int page_size;    // 页面的大小，同一个BPManager中的页帧大小相同
+  Page *page;       // 指向BPManager页面内存池中的一个页
+  pthread_rwlock_t latch;  // 保护页面内容的读写锁
 
-typedef struct {
+  int data_size() const { return page_size - (int)sizeof(PageNum); }
+};
+
+struct BPPageHandle {
   bool open;
   Frame *frame;
-} BPPageHandle;
+
+  /**
+   * pin只能保证页面不会被换出，多个线程并发读写同一个页面时，还需要加页面的读写锁
+   */
+  void rlatch() { pthread_rwlock_rdlock(&frame->latch); }
+  void wlatch() { pthread_rwlock_wrlock(&frame->latch); }
+  void unlatch() { pthread_rwlock_unlock(&frame->latch); }
+};
 
 class BPFileHandle{
 public:
@@ -71,81 +95,143 @@ public:
   bool bopen;
   const char *file_name;
   int file_desc;
+  int page_size;
+  bool direct_io;        // 是否以O_DIRECT方式打开
   Frame *hdr_frame;
   Page *hdr_page;
   char *bitmap;
   BPFileSubHeader *file_sub_header;
+  pthread_mutex_t lock;  // 保护文件头页，即bitmap和file_sub_header
+  Frame *mmap_frames;    // 只读模式下，每个页面对应的页帧直接指向文件的映射
+  int mmap_page_count;
+  size_t mmap_size;
+  uint64_t *free_summary;  // bitmap的第二层，第i位表示bitmap的第i个64位字中有空闲页
+  int max_page_count;      // 头页的bitmap最多能管理的页数
+  PageNum file_pages;      // 文件实际占用的页数，包括预先分配还没有使用的页
 } ;
 
-class BPManager {
-public:
-  BPManager(int size = BP_BUFFER_SIZE) {
-    this->size = size;
-    frame = new Frame[size];
-    allocated = new bool[size];
-    for (int i = 0; i < size; i++) {
-      allocated[i] = false;
-      frame[i].pin_count = 0;
-    }
-  }
+/**
+ * 页表的键，一个页帧由所在文件和页号唯一确定
+ */
+struct BPFrameId {
+  int file_desc;
+  PageNum page_num;
 
-  ~BPManager() {
-    delete[] frame;
-    delete[] allocated;
-    size = 0;
-    frame = nullptr;
-    allocated = nullptr;
+  bool operator== (const BPFrameId &other) const {
+    return file_desc == other.file_desc && page_num == other.page_num;
   }
+};
 
-  Frame *alloc() {
-    for (int i = 0; i < size; i++) {
-      if (!allocated[i]) {
-        allocated[i] = true;
-        list_.push_front(frame + i);
-        return frame + i;
-      }
-    }
-
-    // zzm:
-    // If there are no frames available, return the last frame of list_.
-    Frame* tmp = list_.back();
-    list_.pop_back();
-    list_.push_front(tmp);
-    return tmp; // TODO for test
+class BPFrameIdHasher {
+public:
+  size_t operator() (const BPFrameId &frame_id) const {
+    return ((size_t)(frame_id.file_desc) << 32) | (unsigned int)frame_id.page_num;
   }
+};
 
-  Frame *get(int file_desc, PageNum page_num) {
-    Frame* tmp = nullptr;
-    for (auto iter = list_.begin(); iter != list_.end(); iter++) {
-      if ((*iter)->file_desc == file_desc && (*iter)->page.page_num == page_num) {
-        tmp = *iter;
-        list_.erase(iter);
-        list_.push_front(tmp);
-        break;
-      }
-    }
-    return tmp; // TODO for test
-  }
+/**
+ * 管理所有的页帧。
+ * 页表(哈希表)负责从(file_desc, page_num)找到页帧，未使用的页帧放在空闲链表中。
+ * 所有页面的内存是一整块按页对齐的内存池，页帧的元数据单独存放。
+ * 页帧的置换使用CLOCK算法，跳过被pin住的页帧，命中时只需要设置访问标记。
+ * BPManager本身不加锁，调用者需要通过lock/unlock保护一组操作。
+ */
+class BPManager {
+public:
+  BPManager(int size = BP_BUFFER_SIZE, int page_size = BP_PAGE_SIZE, bool huge_page = false);
+  ~BPManager();
 
-  Frame *getFrame() { return frame; }
+  /**
+   * 按照指定的页帧个数重新分配内存池。只能在没有页帧被使用时调用
+   * @param page_size 每个页帧的大小
+   * @param huge_page 使用2MB的大页作为内存池，系统没有预留大页时退化为透明大页
+   */
+  RC init(int size, int page_size = BP_PAGE_SIZE, bool huge_page = false);
 
-  bool *getAllocated() { return allocated; }
+  /**
+   * 从空闲链表中取一个页帧，登记到页表中。
+   * 没有空闲页帧时返回nullptr，此时需要先通过victim找到可以淘汰的页帧并free掉
+   */
+  Frame *alloc(int file_desc, PageNum page_num);
 
-public:
-  int size;
-  Frame * frame = nullptr;
-  bool *allocated = nullptr;
+  /**
+   * 在页表中查找指定的页面，找到后设置访问标记
+   */
+  Frame *get(int file_desc, PageNum page_num);
+
+  /**
+   * 移动时钟指针，找到一个没有被pin住并且最近没有被访问过的页帧。
+   * 不会从页表中移除该页帧，如果页帧是脏的，调用者需要先将其刷回磁盘再free
+   */
+  Frame *victim();
+
+  /**
+   * 将页帧从页表中移除，放回空闲链表
+   */
+  void free(Frame *frame);
+
+  /**
+   * 返回指定文件当前在缓冲区中的所有页帧
+   */
+  std::vector<Frame *> find_list(int file_desc);
+
+  /**
+   * 返回没有被pin住的脏页帧，最近没有被访问过的排在前面，它们会最先被淘汰
+   */
+  std::vector<Frame *> find_dirty_list();
+
+  int dirty_count() const;
+
+  int size() const { return size_; }
+
+  int page_size() const { return page_size_; }
+
+  int used_count() const { return (int)page_table_.size(); }
+
+  void lock() { MUTEX_LOCK(&lock_); }
+  void unlock() { MUTEX_UNLOCK(&lock_); }
+
+private:
+  void destroy();
 
 private:
-  std::list<Frame*> list_;
+  pthread_mutex_t lock_;
+  int size_ = 0;
+  int page_size_ = BP_PAGE_SIZE;
+  Frame *frames_ = nullptr;
+  Page *pages_ = nullptr;    // 页面内存池，按BP_PAGE_SIZE对齐
+  size_t mmap_size_ = 0;     // 内存池通过mmap分配时映射的大小，否则为0
+  int clock_hand_ = 0;
+  std::vector<Frame *> free_list_;
+  std::unordered_map<BPFrameId, Frame *, BPFrameIdHasher> page_table_;
 };
 
+/**
+ * 缓冲池按照(file_desc, page_num)的哈希值分成多个分区，每个分区是一个BPManager，有自己的锁。
+ * 每种页大小有自己的一组分区，内存大小与默认页大小的分区相同，在第一次打开对应页大小的文件时才分配。
+ * 加锁顺序：lock_ -> BPFileHandle::lock -> BPManager::lock
+ */
 class DiskBufferPool {
 public:
+  DiskBufferPool();
+  ~DiskBufferPool();
+
+  /**
+   * 按照指定的页帧个数和分区个数初始化缓冲池，需要在打开任何文件之前调用
+   * @param buffer_pool_size 默认页大小的页帧个数，其它页大小的分区使用同样大小的内存
+   * @param huge_page 页帧内存池使用大页
+   * @param direct_io 使用O_DIRECT打开数据文件，页面不再经过操作系统的page cache
+   * @param read_only 只读模式，文件以mmap方式映射，页面直接指向映射的内存，不占用缓冲池
+   * @param extent_pages 文件空间不足时用fallocate一次扩展的最大页数
+   */
+  RC init(int buffer_pool_size, int partition_num = 1, bool huge_page = false, bool direct_io = false,
+      bool read_only = false, int extent_pages = BP_EXTENT_PAGES);
+
   /**
   * 创建一个名称为指定文件名的分页文件
+  * @param page_size 文件的页大小，是4K到64K之间2的幂
   */
-  RC create_file(const char *file_name);
+  RC create_file(const char *file_name, int page_size = BP_PAGE_SIZE);
 
   /**
    * 根据文件名打开一个分页文件，返回文件ID
@@ -212,10 +298,39 @@ public:
    */
   RC get_page_count(int file_id, int *page_count);
 
+  /**
+   * 获取文件的页大小
+   */
+  RC get_page_size(int file_id, int *page_size);
+
+  /**
+   * 提示操作系统异步预读从start_page开始的page_num个页面，调用者不会被阻塞
+   */
+  RC prefetch_pages(int file_id, PageNum start_page, int page_num);
+
   RC flush_all_pages(int file_id);
 
+  /**
+   * 只读模式下所有修改文件的操作都会返回READONLY
+   */
+  bool read_only() const { return read_only_; }
+
+  /**
+   * 统计缓冲池中的脏页数和页帧总数
+   */
+  void get_dirty_page_count(int *dirty_page_count, int *frame_count);
+
+  /**
+   * 把最多max_pages个没有被pin住的脏页刷回磁盘，页面仍然留在缓冲池中。
+   * 由后台的page cleaner调用，减少前台淘汰页面时的写盘等待
+   */
+  RC clean_pages(int max_pages, int *cleaned_pages);
+
 protected:
-  RC allocate_block(Frame **buf);
+  /**
+   * allocate_block/dispose_block/flush_block需要调用者持有页帧所在分区的锁
+   */
+  RC allocate_block(int page_size, int file_desc, PageNum page_num, Frame **buf);
   RC dispose_block(Frame *buf);
 
   /**
@@ -229,9 +344,37 @@ protected:
   RC check_page_num(PageNum page_num, BPFileHandle *file_handle);
   RC load_page(PageNum page_num, BPFileHandle *file_handle, Frame *frame);
   RC flush_block(Frame *frame);
+  /**
+   * 把同一个文件的多个脏页按页号排序，连续的页面合并成一次pwritev写出
+   */
+  RC flush_blocks(std::vector<Frame *> &frames);
+  BPManager &bp_manager_of(int page_size, int file_desc, PageNum page_num);
+  std::vector<BPManager *> &bp_managers_of(int page_size);
+  std::vector<BPManager *> all_bp_managers();
+  RC init_partitions(int page_size, int partition_num);
+  RC read_page_size(int file_desc, const char *file_name, int *page_size);
+  RC map_file(BPFileHandle *file_handle);
+  void unmap_file(BPFileHandle *file_handle);
+
+  /**
+   * 根据头页的bitmap建立第二层的空闲页摘要，分配页面时不需要扫描整个bitmap
+   */
+  RC init_free_summary(BPFileHandle *file_handle);
+  PageNum find_free_page(BPFileHandle *file_handle);
+  void update_free_summary(BPFileHandle *file_handle, PageNum page_num);
+  /**
+   * 按extent预先分配文件空间，避免每次新增页面都扩展文件
+   */
+  RC extend_file(BPFileHandle *file_handle);
 
 private:
-  BPManager bp_manager_;
+  pthread_mutex_t lock_;  // 保护open_list_
+  std::vector<BPManager *> bp_managers_[BP_PAGE_SIZE_CLASS_NUM];  // 按页大小分组的分区
+  int buffer_pool_size_ = BP_BUFFER_SIZE;
+  bool huge_page_ = false;
+  bool direct_io_ = false;
+  bool read_only_ = false;
+  int extent_pages_ = BP_EXTENT_PAGES;
   BPFileHandle *open_list_[MAX_OPEN_FILE] = {nullptr};
 };
 
@@ -0,0 +1,193 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <string>
+#include <algorithm>
+
+#include "storage/default/page_cleaner_stage.h"
+
+#include "common/conf/ini.h"
+#include "common/lang/string.h"
+#include "common/log/log.h"
+#include "common/seda/timer_stage.h"
+#include "common/metrics/metrics_registry.h"
+#include "rc.h"
+#include "storage/default/disk_buffer_pool.h"
+
+using namespace common;
+
+const std::string PageCleanerStage::FLUSH_METRIC_TAG = "PageCleanerStage.flushed_pages";
+const std::string PageCleanerStage::DIRTY_RATIO_METRIC_TAG = "PageCleanerStage.dirty_ratio";
+const char *CONF_FLUSH_INTERVAL = "FlushInterval";
+const char *CONF_DIRTY_RATIO = "DirtyRatio";
+const char *CONF_FLUSH_PAGES = "FlushPages";
+
+/**
+ * 快照时直接统计缓冲池中脏页的百分比
+ */
+class DirtyRatioGauge : public Gauge {
+public:
+  DirtyRatioGauge() { set_snapshot(new SnapshotBasic<double>()); }
+  virtual ~DirtyRatioGauge() { delete snapshot_value_; }
+
+  void snapshot() override {
+    int dirty_page_count = 0;
+    int frame_count = 0;
+    theGlobalDiskBufferPool()->get_dirty_page_count(&dirty_page_count, &frame_count);
+    double ratio = frame_count == 0 ? 0 : 100.0 * dirty_page_count / frame_count;
+    ((SnapshotBasic<double> *)snapshot_value_)->setValue(ratio);
+  }
+};
+
+//! Constructor
+PageCleanerStage::PageCleanerStage(const char *tag) : Stage(tag) {}
+
+//! Destructor
+PageCleanerStage::~PageCleanerStage() {}
+
+//! Parse properties, instantiate a stage object
+Stage *PageCleanerStage::make_stage(const std::string &tag) {
+  PageCleanerStage *stage = new (std::nothrow) PageCleanerStage(tag.c_str());
+  if (stage == nullptr) {
+    LOG_ERROR("new PageCleanerStage failed");
+    return nullptr;
+  }
+  if (!stage->set_properties()) {
+    LOG_ERROR("Failed to set properties of PageCleanerStage");
+    delete stage;
+    return nullptr;
+  }
+  return stage;
+}
+
+//! Set properties for this object set in stage specific properties
+bool PageCleanerStage::set_properties() {
+  std::string stage_name_str(stage_name_);
+  std::map<std::string, std::string> section = get_properties()->get(stage_name_str);
+
+  std::map<std::string, std::string>::iterator it = section.find(CONF_FLUSH_INTERVAL);
+  if (it != section.end()) {
+    str_to_val(it->second, flush_interval_);
+  }
+  it = section.find(CONF_DIRTY_RATIO);
+  if (it != section.end()) {
+    str_to_val(it->second, dirty_ratio_);
+  }
+  it = section.find(CONF_FLUSH_PAGES);
+  if (it != section.end()) {
+    str_to_val(it->second, flush_pages_);
+  }
+
+  if (flush_interval_ <= 0 || dirty_ratio_ < 0 || dirty_ratio_ > 100 || flush_pages_ <= 0) {
+    LOG_ERROR("Invalid page cleaner config. flush interval=%d, dirty ratio=%d, flush pages=%d",
+              flush_interval_, dirty_ratio_, flush_pages_);
+    return false;
+  }
+  LOG_INFO("Page cleaner config. flush interval=%dms, dirty ratio=%d%%, flush pages=%d",
+           flush_interval_, dirty_ratio_, flush_pages_);
+  return true;
+}
+
+//! Initialize stage params and validate outputs
+bool PageCleanerStage::initialize() {
+  LOG_TRACE("Enter");
+
+  std::list<Stage *>::iterator stgp = next_stage_list_.begin();
+  if (stgp == next_stage_list_.end()) {
+    LOG_ERROR("PageCleanerStage needs TimerStage as its next stage");
+    return false;
+  }
+  timer_stage_ = *(stgp++);
+
+  MetricsRegistry &metrics_registry = get_metrics_registry();
+  flush_metric_ = new Meter();
+  metrics_registry.register_metric(FLUSH_METRIC_TAG, flush_metric_);
+  dirty_ratio_metric_ = new DirtyRatioGauge();
+  metrics_registry.register_metric(DIRTY_RATIO_METRIC_TAG, dirty_ratio_metric_);
+
+  add_event(new StageEvent());
+  LOG_TRACE("Exit");
+  return true;
+}
+
+//! Cleanup after disconnection
+void PageCleanerStage::cleanup() {
+  LOG_TRACE("Enter");
+
+  MetricsRegistry &metrics_registry = get_metrics_registry();
+  if (flush_metric_ != nullptr) {
+    metrics_registry.unregister(FLUSH_METRIC_TAG);
+    delete flush_metric_;
+    flush_metric_ = nullptr;
+  }
+  if (dirty_ratio_metric_ != nullptr) {
+    metrics_registry.unregister(DIRTY_RATIO_METRIC_TAG);
+    delete dirty_ratio_metric_;
+    dirty_ratio_metric_ = nullptr;
+  }
+  LOG_TRACE("Exit");
+}
+
+void PageCleanerStage::handle_event(StageEvent *event) {
+  LOG_TRACE("Enter\n");
+
+  CompletionCallback *cb = new (std::nothrow) CompletionCallback(this, nullptr);
+  if (cb == nullptr) {
+    LOG_ERROR("Failed to new callback");
+    event->done();
+    return;
+  }
+
+  TimerRegisterEvent *tm_event = new (std::nothrow) TimerRegisterEvent(event, (u64_t)flush_interval_ * 1000);
+  if (tm_event == nullptr) {
+    LOG_ERROR("Failed to new TimerRegisterEvent");
+    delete cb;
+    event->done();
+    return;
+  }
+
+  event->push_callback(cb);
+  timer_stage_->add_event(tm_event);
+
+  LOG_TRACE("Exit\n");
+}
+
+void PageCleanerStage::callback_event(StageEvent *event, CallbackContext *context) {
+  LOG_TRACE("Enter\n");
+
+  clean_pages();
+
+  // do it again.
+  add_event(event);
+
+  LOG_TRACE("Exit\n");
+}
+
+void PageCleanerStage::clean_pages() {
+  DiskBufferPool *disk_buffer_pool = theGlobalDiskBufferPool();
+  int dirty_page_count = 0;
+  int frame_count = 0;
+  disk_buffer_pool->get_dirty_page_count(&dirty_page_count, &frame_count);
+
+  int target_count = (int)((long)frame_count * dirty_ratio_ / 100);
+  if (dirty_page_count <= target_count) {
+    return;
+  }
+
+  int cleaned_pages = 0;
+  int max_pages = std::min(dirty_page_count - target_count, flush_pages_);
+  RC rc = disk_buffer_pool->clean_pages(max_pages, &cleaned_pages);
+  if (rc != RC::SUCCESS) {
+    LOG_WARN("Failed to clean dirty pages. rc=%d:%s", rc, strrc(rc));
+  }
+  flush_metric_->inc(cleaned_pages);
+  LOG_DEBUG("Page cleaner flushed %d pages, dirty pages %d/%d", cleaned_pages, dirty_page_count, frame_count);
+}
@@ -0,0 +1,54 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __OBSERVER_STORAGE_DEFAULT_PAGE_CLEANER_STAGE_H__
+#define __OBSERVER_STORAGE_DEFAULT_PAGE_CLEANER_STAGE_H__
+
+#include "common/seda/stage.h"
+#include "common/metrics/metrics.h"
+
+/**
+ * 后台刷脏页的stage。通过TimerStage定时触发，
+ * 当缓冲池中脏页的比例超过目标值时，把多出来的脏页刷回磁盘，
+ * 这样前台淘汰页面时通常不需要等待写盘
+ */
+class PageCleanerStage : public common::Stage {
+public:
+  ~PageCleanerStage();
+  static Stage *make_stage(const std::string &tag);
+
+protected:
+  // common function
+  PageCleanerStage(const char *tag);
+  bool set_properties() override;
+
+  bool initialize() override;
+  void cleanup() override;
+  void handle_event(common::StageEvent *event) override;
+  void callback_event(common::StageEvent *event,
+                     common::CallbackContext *context) override;
+
+private:
+  void clean_pages();
+
+protected:
+  static const std::string FLUSH_METRIC_TAG;
+  static const std::string DIRTY_RATIO_METRIC_TAG;
+
+private:
+  common::Stage *timer_stage_ = nullptr;
+  int flush_interval_ = 1000;   // 每隔多少毫秒检查一次，单位ms
+  int dirty_ratio_ = 10;        // 脏页占缓冲池的目标百分比
+  int flush_pages_ = 1024;      // 每次最多刷多少个页面
+  common::Meter *flush_metric_ = nullptr;
+  common::Gauge *dirty_ratio_metric_ = nullptr;
+};
+
+#endif //__OBSERVER_STORAGE_DEFAULT_PAGE_CLEANER_STAGE_H__
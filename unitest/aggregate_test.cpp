@@ -0,0 +1,104 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sql/executor/aggregate.h"
+#include "exe_node_test.h"
+
+// 输出 (k, id, f)，k是偶数，避开第一个字节是'!'被当作空值的整数
+static GeneratedRowsExeNode *group_rows(int row_num, int group_num) {
+  TupleSchema schema;
+  schema.add(INTS, "t", "k");
+  schema.add(INTS, "t", "id");
+  schema.add(FLOATS, "t", "f");
+  return new GeneratedRowsExeNode(schema, row_num, [group_num](int i, Tuple &tuple) {
+    tuple.add((i * 7) % group_num * 2);
+    tuple.add(i);
+    tuple.add((float)(i % 10) / 4);
+  });
+}
+
+static std::vector<std::string> aggregate_rows(int row_num, int group_num, size_t memory_limit,
+                                               int *spilled_partition_num) {
+  TupleSchema output_schema;
+  output_schema.add(INTS, "t", "k");
+  output_schema.add(INTS, "t", "*", COUNT);
+  output_schema.add(INTS, "t", "id", MIN);
+  output_schema.add(INTS, "t", "id", MAX);
+  output_schema.add(FLOATS, "t", "f", AVG);
+
+  RelAttr groupby;
+  memset(&groupby, 0, sizeof(groupby));
+  groupby.relation_name = (char *)"t";
+  groupby.attribute_name = (char *)"k";
+
+  SortOptions options;
+  options.memory_limit = memory_limit;
+  HashAggregateExeNode node;
+  EXPECT_EQ(RC::SUCCESS, node.init(group_rows(row_num, group_num), output_schema, {groupby}, options));
+  EXPECT_EQ(RC::SUCCESS, node.open());
+
+  std::vector<std::string> rows;
+  EXPECT_EQ(RC::RECORD_EOF, drain_rows(node, rows));
+  *spilled_partition_num = node.spilled_partition_num();
+  node.close();
+  return rows;
+}
+
+TEST(test_aggregate, test_group_hash_table) {
+  GroupHashTable table;
+  std::hash<std::string> hash_fn;
+  for (int i = 0; i < 1000; i++) {
+    std::string key = std::to_string(i);
+    size_t hash = hash_fn(key);
+    ASSERT_EQ(-1, table.find(key, hash));
+    ASSERT_EQ(i, table.insert(std::string(key), hash));
+  }
+  ASSERT_EQ(1000, table.group_num());
+  for (int i = 0; i < 1000; i++) {
+    std::string key = std::to_string(i);
+    ASSERT_EQ(i, table.find(key, hash_fn(key)));
+  }
+
+  table.clear();
+  ASSERT_EQ(0, table.group_num());
+  ASSERT_EQ(-1, table.find("1", hash_fn("1")));
+}
+
+TEST(test_aggregate, test_aggregate_values) {
+  int spilled_partition_num = 0;
+  std::vector<std::string> rows = aggregate_rows(10, 3, SortOptions::DEFAULT_MEMORY_LIMIT, &spilled_partition_num);
+  ASSERT_EQ(0, spilled_partition_num);
+  // 分组按第一次出现的顺序输出：k=0的行是0,3,6,9，k=2是1,4,7，k=4是2,5,8
+  std::vector<std::string> expected = {"0|4|0|9|1.13|", "2|3|1|7|1|", "4|3|2|8|1.25|"};
+  ASSERT_EQ(expected, rows);
+}
+
+// 分组超过内存限制时写到分区中，结果和顺序都要与全部在内存中聚合一样
+TEST(test_aggregate, test_spill_same_as_memory) {
+  int memory_partition_num = 0;
+  int spilled_partition_num = 0;
+  std::vector<std::string> expected = aggregate_rows(20000, 5000, SortOptions::DEFAULT_MEMORY_LIMIT,
+                                                     &memory_partition_num);
+  std::vector<std::string> rows = aggregate_rows(20000, 5000, 16 * 1024, &spilled_partition_num);
+  ASSERT_EQ(0, memory_partition_num);
+  ASSERT_GE(spilled_partition_num, HashAggregateExeNode::PARTITION_NUM);
+  ASSERT_EQ(5000, (int)expected.size());
+  ASSERT_EQ(expected, rows);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
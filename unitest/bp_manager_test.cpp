@@ -12,47 +12,414 @@ See the Mulan PSL v2 for more details. */
 // Created by wangyunlai.wyl on 2021
 //
 
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
 #include "storage/default/disk_buffer_pool.h"
 #include "gtest/gtest.h"
 
-TEST(test_bp_manager, test_bp_manager_simple_lru) {
-  BPManager bp_manager(2);
+TEST(test_bp_manager, test_bp_manager_clock) {
+  BPManager bp_manager(3);
 
-  Frame * frame1 = bp_manager.alloc();
+  Frame * frame1 = bp_manager.alloc(0, 1);
   ASSERT_NE(frame1, nullptr);
-
-  frame1->file_desc = 0;
-  frame1->page.page_num = 1;
+  ASSERT_EQ(frame1->file_desc, 0);
+  ASSERT_EQ(frame1->page->page_num, 1);
 
   ASSERT_EQ(frame1, bp_manager.get(0, 1));
 
-  Frame *frame2 = bp_manager.alloc();
+  Frame *frame2 = bp_manager.alloc(0, 2);
   ASSERT_NE(frame2, nullptr);
-  frame2->file_desc = 0;
-  frame2->page.page_num = 2;
+  Frame *frame3 = bp_manager.alloc(0, 3);
+  ASSERT_NE(frame3, nullptr);
 
-  ASSERT_EQ(frame1, bp_manager.get(0, 1));
+  // no free frame, every frame has been referenced, so the clock goes around once
+  ASSERT_EQ(nullptr, bp_manager.alloc(0, 4));
+  ASSERT_EQ(frame1, bp_manager.victim());
+  bp_manager.free(frame1);
+  ASSERT_EQ(nullptr, bp_manager.get(0, 1));
 
-  Frame *frame3 = bp_manager.alloc();
-  ASSERT_NE(frame3, nullptr);
-  frame3->file_desc = 0;
-  frame3->page.page_num = 3;
+  Frame *frame4 = bp_manager.alloc(0, 4);
+  ASSERT_NE(frame4, nullptr);
 
-  frame2 = bp_manager.get(0, 2);
-  ASSERT_EQ(frame2, nullptr);
+  // page 3 is referenced again and gets a second chance, page 2 is evicted
+  ASSERT_EQ(frame3, bp_manager.get(0, 3));
+  ASSERT_EQ(frame2, bp_manager.victim());
+  bp_manager.free(frame2);
+  ASSERT_EQ(nullptr, bp_manager.get(0, 2));
 
-  Frame *frame4 = bp_manager.alloc();
-  frame4->file_desc = 0;
-  frame4->page.page_num = 4;
+  Frame *frame5 = bp_manager.alloc(0, 5);
+  ASSERT_NE(frame5, nullptr);
 
-  frame1 = bp_manager.get(0, 1);
-  ASSERT_EQ(frame1, nullptr);
+  ASSERT_EQ(frame3, bp_manager.get(0, 3));
+  ASSERT_EQ(frame4, bp_manager.get(0, 4));
+  ASSERT_EQ(frame5, bp_manager.get(0, 5));
+  ASSERT_EQ(3, bp_manager.used_count());
+}
 
-  frame3 = bp_manager.get(0, 3);
-  ASSERT_NE(frame3, nullptr);
+TEST(test_bp_manager, test_bp_manager_victim_skip_pinned) {
+  BPManager bp_manager(3);
 
-  frame4 = bp_manager.get(0, 4);
-  ASSERT_NE(frame4, nullptr);
+  Frame *frame1 = bp_manager.alloc(0, 1);
+  Frame *frame2 = bp_manager.alloc(0, 2);
+  Frame *frame3 = bp_manager.alloc(1, 1);
+  ASSERT_NE(frame1, frame3);
+  ASSERT_EQ(frame3, bp_manager.get(1, 1));
+
+  frame1->pin_count = 1;
+  ASSERT_EQ(frame2, bp_manager.victim());
+
+  frame2->pin_count = 1;
+  ASSERT_EQ(frame3, bp_manager.victim());
+
+  frame3->pin_count = 1;
+  ASSERT_EQ(nullptr, bp_manager.victim());
+
+  ASSERT_EQ(2, (int)bp_manager.find_list(0).size());
+  ASSERT_EQ(1, (int)bp_manager.find_list(1).size());
+}
+
+TEST(test_bp_manager, test_bp_manager_init) {
+  BPManager bp_manager(2);
+  ASSERT_EQ(2, bp_manager.size());
+
+  Frame *frame = bp_manager.alloc(0, 1);
+  ASSERT_NE(RC::SUCCESS, bp_manager.init(1024));
+
+  bp_manager.free(frame);
+  ASSERT_EQ(RC::SUCCESS, bp_manager.init(1024));
+  ASSERT_EQ(1024, bp_manager.size());
+
+  frame = bp_manager.alloc(0, 1);
+  ASSERT_NE(frame, nullptr);
+  ASSERT_EQ(0, (int)((unsigned long)frame->page % BP_PAGE_SIZE));
+}
+
+TEST(test_bp_manager, test_bp_manager_huge_page) {
+  // 没有预留大页的机器上会退化为普通映射，行为保持一致
+  BPManager bp_manager(100, BP_PAGE_SIZE, true);
+  ASSERT_EQ(100, bp_manager.size());
+
+  Frame *frame = bp_manager.alloc(0, 1);
+  ASSERT_NE(frame, nullptr);
+  ASSERT_EQ(0, (int)((unsigned long)frame->page % BP_PAGE_SIZE));
+  memset(frame->page->data, 1, BP_PAGE_DATA_SIZE);
+  bp_manager.free(frame);
+
+  ASSERT_EQ(RC::SUCCESS, bp_manager.init(10, BP_PAGE_SIZE, false));
+  ASSERT_EQ(10, bp_manager.size());
+}
+
+TEST(test_bp_manager, test_bp_manager_page_size) {
+  BPManager bp_manager(4, BP_MAX_PAGE_SIZE);
+  ASSERT_EQ(BP_MAX_PAGE_SIZE, bp_manager.page_size());
+
+  Frame *first = bp_manager.alloc(0, 1);
+  Frame *second = bp_manager.alloc(0, 2);
+  ASSERT_EQ(BP_MAX_PAGE_SIZE, first->page_size);
+  ASSERT_EQ(BP_MAX_PAGE_SIZE, abs((int)((char *)second->page - (char *)first->page)));
+  memset(first->page->data, 1, first->data_size());
+  ASSERT_EQ(2, second->page->page_num);
+
+  ASSERT_NE(RC::SUCCESS, bp_manager.init(4, BP_PAGE_SIZE * 3));
+}
+
+TEST(test_disk_buffer_pool, test_mixed_page_size) {
+  const char *small_file = "bp_small_page_test.data";
+  const char *large_file = "bp_large_page_test.data";
+  ::unlink(small_file);
+  ::unlink(large_file);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(16, 2));
+  ASSERT_NE(RC::SUCCESS, buffer_pool.create_file(large_file, BP_PAGE_SIZE + 1));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(small_file));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(large_file, BP_PAGE_SIZE * 4));
+
+  int file_ids[2] = {-1, -1};
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(small_file, &file_ids[0]));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(large_file, &file_ids[1]));
+  int page_size = 0;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.get_page_size(file_ids[1], &page_size));
+  ASSERT_EQ(BP_PAGE_SIZE * 4, page_size);
+
+  // 页面数超过缓冲池大小，需要淘汰和重新读取
+  const int page_num = 20;
+  for (int f = 0; f < 2; f++) {
+    for (int i = 1; i <= page_num; i++) {
+      BPPageHandle page_handle;
+      ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_ids[f], &page_handle));
+      Frame *frame = page_handle.frame;
+      memset(frame->page->data, i, frame->data_size());
+      buffer_pool.mark_dirty(&page_handle);
+      buffer_pool.unpin_page(&page_handle);
+    }
+  }
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_ids[1]));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(large_file, &file_ids[1]));
+
+  for (int f = 0; f < 2; f++) {
+    for (int i = 1; i <= page_num; i++) {
+      BPPageHandle page_handle;
+      ASSERT_EQ(RC::SUCCESS, buffer_pool.get_this_page(file_ids[f], i, &page_handle));
+      Frame *frame = page_handle.frame;
+      ASSERT_EQ((char)i, frame->page->data[0]);
+      ASSERT_EQ((char)i, frame->page->data[frame->data_size() - 1]);
+      buffer_pool.unpin_page(&page_handle);
+    }
+  }
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_ids[0]));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_ids[1]));
+  ::unlink(small_file);
+  ::unlink(large_file);
+}
+
+TEST(test_disk_buffer_pool, test_partition_concurrent_access) {
+  const char *file_name = "bp_partition_test.data";
+  ::unlink(file_name);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(16, 4));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(file_name));
+
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+  // 已经有文件打开时不能调整缓冲池
+  ASSERT_NE(RC::SUCCESS, buffer_pool.init(32, 4));
+
+  const int page_num = 8;
+  for (int i = 0; i < page_num; i++) {
+    BPPageHandle page_handle;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_id, &page_handle));
+    buffer_pool.unpin_page(&page_handle);
+  }
+
+  const int thread_num = 4;
+  const int loops = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; t++) {
+    threads.emplace_back([&buffer_pool, file_id, t]() {
+      for (int i = 0; i < loops; i++) {
+        BPPageHandle page_handle;
+        PageNum page = (i + t) % page_num + 1;
+        ASSERT_EQ(RC::SUCCESS, buffer_pool.get_this_page(file_id, page, &page_handle));
+        char *data = nullptr;
+        buffer_pool.get_data(&page_handle, &data);
+        page_handle.wlatch();
+        (*(int *)data)++;
+        page_handle.unlatch();
+        buffer_pool.mark_dirty(&page_handle);
+        buffer_pool.unpin_page(&page_handle);
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  int total = 0;
+  for (int i = 1; i <= page_num; i++) {
+    BPPageHandle page_handle;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.get_this_page(file_id, i, &page_handle));
+    char *data = nullptr;
+    buffer_pool.get_data(&page_handle, &data);
+    total += *(int *)data;
+    buffer_pool.unpin_page(&page_handle);
+  }
+  ASSERT_EQ(thread_num * loops, total);
+
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(file_name);
+}
+
+TEST(test_disk_buffer_pool, test_flush_all_pages) {
+  const char *file_name = "bp_flush_test.data";
+  ::unlink(file_name);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(BP_FLUSH_BATCH_PAGES * 2 + 10, 3));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(file_name));
+
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+
+  // 页面数超过一个批次，并且跳过一些页面，让脏页分成多段写出
+  const int page_num = BP_FLUSH_BATCH_PAGES + 20;
+  for (int i = 1; i <= page_num; i++) {
+    BPPageHandle page_handle;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_id, &page_handle));
+    if (i % 7 != 0) {
+      char *data = nullptr;
+      buffer_pool.get_data(&page_handle, &data);
+      *(int *)data = i;
+      buffer_pool.mark_dirty(&page_handle);
+    }
+    buffer_pool.unpin_page(&page_handle);
+  }
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.flush_all_pages(file_id));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+  for (int i = 1; i <= page_num; i++) {
+    BPPageHandle page_handle;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.get_this_page(file_id, i, &page_handle));
+    char *data = nullptr;
+    buffer_pool.get_data(&page_handle, &data);
+    ASSERT_EQ(i % 7 != 0 ? i : 0, *(int *)data);
+    buffer_pool.unpin_page(&page_handle);
+  }
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(file_name);
+}
+
+TEST(test_disk_buffer_pool, test_clean_pages) {
+  const char *file_name = "bp_clean_test.data";
+  ::unlink(file_name);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(32, 2));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(file_name));
+
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+
+  BPPageHandle pinned_handle;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_id, &pinned_handle));
+  buffer_pool.mark_dirty(&pinned_handle);
+  for (int i = 0; i < 10; i++) {
+    BPPageHandle page_handle;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_id, &page_handle));
+    buffer_pool.mark_dirty(&page_handle);
+    buffer_pool.unpin_page(&page_handle);
+  }
+
+  int dirty_page_count = 0;
+  int frame_count = 0;
+  buffer_pool.get_dirty_page_count(&dirty_page_count, &frame_count);
+  ASSERT_EQ(32, frame_count);
+  ASSERT_EQ(12, dirty_page_count);  // 包括文件头页
+
+  int cleaned_pages = 0;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.clean_pages(4, &cleaned_pages));
+  ASSERT_EQ(4, cleaned_pages);
+  buffer_pool.get_dirty_page_count(&dirty_page_count, &frame_count);
+  ASSERT_EQ(8, dirty_page_count);
+
+  // 被pin住的页面不会被刷出
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.clean_pages(100, &cleaned_pages));
+  ASSERT_EQ(6, cleaned_pages);
+  buffer_pool.get_dirty_page_count(&dirty_page_count, &frame_count);
+  ASSERT_EQ(2, dirty_page_count);
+
+  buffer_pool.unpin_page(&pinned_handle);
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(file_name);
+}
+
+TEST(test_disk_buffer_pool, test_allocate_page_extent) {
+  const char *file_name = "bp_extent_test.data";
+  ::unlink(file_name);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(16, 1, false, false, false, 8));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(file_name));
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+
+  // 页面数超过一个bitmap字，也超过缓冲池大小
+  const int page_num = 100;
+  for (int i = 1; i <= page_num; i++) {
+    BPPageHandle page_handle;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_id, &page_handle));
+    PageNum allocated = -1;
+    buffer_pool.get_page_num(&page_handle, &allocated);
+    ASSERT_EQ(i, allocated);
+    buffer_pool.unpin_page(&page_handle);
+  }
+  struct stat st;
+  ASSERT_EQ(0, stat(file_name, &st));
+  ASSERT_EQ(0, (int)(st.st_size % (8 * BP_PAGE_SIZE)));
+  ASSERT_GE(st.st_size, (page_num + 1) * BP_PAGE_SIZE);
+
+  // 释放的页面按页号从小到大重新分配
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.dispose_page(file_id, 70));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.dispose_page(file_id, 3));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+
+  const PageNum expected[] = {3, 70, page_num + 1};
+  for (PageNum expected_page : expected) {
+    BPPageHandle page_handle;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_id, &page_handle));
+    PageNum allocated = -1;
+    buffer_pool.get_page_num(&page_handle, &allocated);
+    ASSERT_EQ(expected_page, allocated);
+    buffer_pool.unpin_page(&page_handle);
+  }
+
+  // 预分配的页面写出后可以重新读入
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+  BPPageHandle page_handle;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.get_this_page(file_id, page_num + 1, &page_handle));
+  ASSERT_EQ(page_num + 1, page_handle.frame->page->page_num);
+  buffer_pool.unpin_page(&page_handle);
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(file_name);
+}
+
+TEST(test_disk_buffer_pool, test_read_only_mmap) {
+  const char *file_name = "bp_read_only_test.data";
+  ::unlink(file_name);
+
+  const int page_num = 5;
+  {
+    DiskBufferPool buffer_pool;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.init(16, 1));
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(file_name));
+    int file_id = -1;
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+    for (int i = 1; i <= page_num; i++) {
+      BPPageHandle page_handle;
+      ASSERT_EQ(RC::SUCCESS, buffer_pool.allocate_page(file_id, &page_handle));
+      char *data = nullptr;
+      buffer_pool.get_data(&page_handle, &data);
+      *(int *)data = i * 10;
+      buffer_pool.mark_dirty(&page_handle);
+      buffer_pool.unpin_page(&page_handle);
+    }
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  }
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(1, 1, false, false, true));
+  ASSERT_TRUE(buffer_pool.read_only());
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+
+  int page_count = 0;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.get_page_count(file_id, &page_count));
+  ASSERT_EQ(page_num + 1, page_count);
+
+  // 缓冲池只有一个页帧，映射的页面可以同时pin住多个
+  BPPageHandle page_handles[page_num];
+  for (int i = 1; i <= page_num; i++) {
+    ASSERT_EQ(RC::SUCCESS, buffer_pool.get_this_page(file_id, i, &page_handles[i - 1]));
+    char *data = nullptr;
+    buffer_pool.get_data(&page_handles[i - 1], &data);
+    ASSERT_EQ(i * 10, *(int *)data);
+  }
+  ASSERT_EQ(RC::READONLY, buffer_pool.mark_dirty(&page_handles[0]));
+  for (int i = 0; i < page_num; i++) {
+    buffer_pool.unpin_page(&page_handles[i]);
+  }
+
+  BPPageHandle page_handle;
+  ASSERT_EQ(RC::READONLY, buffer_pool.allocate_page(file_id, &page_handle));
+  ASSERT_EQ(RC::READONLY, buffer_pool.dispose_page(file_id, 1));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(file_name);
 }
 
 int main(int argc, char **argv) {
@@ -64,4 +431,4 @@ int main(int argc, char **argv) {
   // 调用RUN_ALL_TESTS()运行所有测试用例
   // main函数返回RUN_ALL_TESTS()的运行结果
   return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,358 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "storage/common/bplus_tree.h"
+#include "storage/common/bplus_tree_builder.h"
+#include "storage/common/field_meta.h"
+#include "gtest/gtest.h"
+
+static std::vector<RID> scan_equal(BplusTreeHandler &handler, const char *key) {
+  std::vector<RID> rids;
+  BplusTreeScanner scanner(handler);
+  EXPECT_EQ(RC::SUCCESS, scanner.open(EQUAL_TO, key));
+  RID rid;
+  while (RC::SUCCESS == scanner.next_entry(&rid)) {
+    rids.push_back(rid);
+  }
+  scanner.close();
+  return rids;
+}
+
+static RID make_rid(int i) {
+  RID rid;
+  rid.page_num = 1 + i / 100;
+  rid.slot_num = i % 100;
+  return rid;
+}
+
+TEST(test_bplus_tree, test_delete_duplicate_keys) {
+  const char *file_name = "bplus_tree_delete_test.index";
+  ::unlink(file_name);
+
+  FieldMeta field_meta;
+  ASSERT_EQ(RC::SUCCESS, field_meta.init("k", INTS, 0, sizeof(int), true, false));
+  std::vector<const FieldMeta *> fields_meta{&field_meta};
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(file_name, fields_meta, sizeof(int)));
+
+  const int entry_num = 3000;
+  for (int i = 0; i < entry_num; i++) {
+    int key = i % 5;
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+  }
+
+  // 删除足够多的项，触发叶子节点的合并和重新分配
+  const int deleted_num = 2000;
+  for (int i = 0; i < deleted_num; i++) {
+    int key = i % 5;
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&key, &rid));
+  }
+
+  for (int key = 0; key < 5; key++) {
+    std::vector<RID> rids = scan_equal(handler, (const char *)&key);
+    ASSERT_EQ((size_t)(entry_num - deleted_num) / 5, rids.size());
+    // 相同键值的项按照rid的顺序保存
+    for (size_t j = 0; j < rids.size(); j++) {
+      RID expected = make_rid(deleted_num + key + 5 * j);
+      ASSERT_EQ(expected, rids[j]);
+    }
+  }
+
+  int missing = 5;
+  ASSERT_TRUE(scan_equal(handler, (const char *)&missing).empty());
+
+  handler.close();
+  ::unlink(file_name);
+}
+
+TEST(test_bplus_tree, test_compare_chars_key) {
+  const char *file_name = "bplus_tree_chars_test.index";
+  ::unlink(file_name);
+
+  const int key_len = 8;
+  FieldMeta field_meta;
+  ASSERT_EQ(RC::SUCCESS, field_meta.init("s", CHARS, 0, key_len, true, false));
+  std::vector<const FieldMeta *> fields_meta{&field_meta};
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(file_name, fields_meta, key_len));
+
+  const char *values[] = {"b", "a", "c", "b", "ab"};
+  for (int i = 0; i < 5; i++) {
+    char key[key_len] = {0};
+    strcpy(key, values[i]);
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry(key, &rid));
+  }
+
+  char key[key_len] = {0};
+  strcpy(key, "b");
+  std::vector<RID> rids = scan_equal(handler, key);
+  ASSERT_EQ(2, (int)rids.size());
+  ASSERT_EQ(make_rid(0), rids[0]);
+  ASSERT_EQ(make_rid(3), rids[1]);
+
+  handler.close();
+  ::unlink(file_name);
+}
+
+static std::vector<int> scan_range(BplusTreeHandler &handler, const char *left_key, int left_attr_num,
+                                   bool left_inclusive, const char *right_key, int right_attr_num,
+                                   bool right_inclusive) {
+  std::vector<int> slots;
+  BplusTreeScanner scanner(handler);
+  EXPECT_EQ(RC::SUCCESS, scanner.open(left_key, left_attr_num, left_inclusive, right_key, right_attr_num,
+                                      right_inclusive));
+  RID rid;
+  while (RC::SUCCESS == scanner.next_entry(&rid)) {
+    slots.push_back((rid.page_num - 1) * 100 + rid.slot_num);
+  }
+  scanner.close();
+  return slots;
+}
+
+TEST(test_bplus_tree, test_range_scan) {
+  const char *file_name = "bplus_tree_range_test.index";
+  ::unlink(file_name);
+
+  FieldMeta field_meta;
+  ASSERT_EQ(RC::SUCCESS, field_meta.init("k", INTS, 0, sizeof(int), true, false));
+  std::vector<const FieldMeta *> fields_meta{&field_meta};
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(file_name, fields_meta, sizeof(int)));
+
+  // 键值与rid中的编号相同，插入的顺序打乱
+  const int entry_num = 5000;
+  for (int i = 0; i < entry_num; i++) {
+    int key = (i * 7919) % entry_num;
+    RID rid = make_rid(key);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+  }
+
+  // 第一个字节是'!'的值被当作空值，不满足任何范围
+  auto expected_num = [](int from, int to) {
+    int num = 0;
+    for (int key = from; key <= to; key++) {
+      num += (key & 0xff) != '!' ? 1 : 0;
+    }
+    return num;
+  };
+
+  int lower = 300;
+  int upper = 500;
+  std::vector<int> slots = scan_range(handler, (const char *)&lower, 1, false, (const char *)&upper, 1, false);
+  ASSERT_EQ(199, (int)slots.size());
+  for (size_t i = 0; i < slots.size(); i++) {
+    ASSERT_EQ(lower + 1 + (int)i, slots[i]);
+  }
+  slots = scan_range(handler, (const char *)&lower, 1, true, (const char *)&upper, 1, true);
+  ASSERT_EQ(201, (int)slots.size());
+  ASSERT_EQ(lower, slots.front());
+  ASSERT_EQ(upper, slots.back());
+
+  // 只有一边的边界
+  slots = scan_range(handler, nullptr, 0, true, (const char *)&lower, 1, true);
+  ASSERT_EQ(expected_num(0, lower), (int)slots.size());
+  slots = scan_range(handler, (const char *)&upper, 1, false, nullptr, 0, true);
+  ASSERT_EQ(expected_num(upper + 1, entry_num - 1), (int)slots.size());
+
+  BplusTreeScanner scanner(handler);
+  ASSERT_EQ(RC::SUCCESS, scanner.open(LESS_EQUAL, (const char *)&lower));
+  RID rid;
+  int count = 0;
+  while (RC::SUCCESS == scanner.next_entry(&rid)) {
+    count++;
+  }
+  scanner.close();
+  ASSERT_EQ(expected_num(0, lower), count);
+
+  // 边界相反时没有结果
+  ASSERT_TRUE(scan_range(handler, (const char *)&upper, 1, true, (const char *)&lower, 1, true).empty());
+
+  handler.close();
+  ::unlink(file_name);
+}
+
+TEST(test_bplus_tree, test_composite_prefix_scan) {
+  const char *file_name = "bplus_tree_prefix_test.index";
+  ::unlink(file_name);
+
+  FieldMeta field_a;
+  FieldMeta field_b;
+  ASSERT_EQ(RC::SUCCESS, field_a.init("a", INTS, 0, sizeof(int), true, false));
+  ASSERT_EQ(RC::SUCCESS, field_b.init("b", INTS, sizeof(int), sizeof(int), true, false));
+  std::vector<const FieldMeta *> fields_meta{&field_a, &field_b};
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(file_name, fields_meta, 2 * sizeof(int)));
+
+  // (a, b) = (i / 100, i % 100)
+  const int entry_num = 3000;
+  for (int i = entry_num - 1; i >= 0; i--) {
+    int key[2] = {i / 100, i % 100};
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)key, &rid));
+  }
+
+  // a = 7
+  int prefix[2] = {7, 0};
+  std::vector<int> slots = scan_range(handler, (const char *)prefix, 1, true, (const char *)prefix, 1, true);
+  ASSERT_EQ(100, (int)slots.size());
+  ASSERT_EQ(700, slots.front());
+  ASSERT_EQ(799, slots.back());
+
+  // a = 7 and b > 10 and b <= 20
+  int left[2] = {7, 10};
+  int right[2] = {7, 20};
+  slots = scan_range(handler, (const char *)left, 2, false, (const char *)right, 2, true);
+  ASSERT_EQ(10, (int)slots.size());
+  ASSERT_EQ(711, slots.front());
+  ASSERT_EQ(720, slots.back());
+
+  // a = 7 and b >= 90
+  int from[2] = {7, 90};
+  slots = scan_range(handler, (const char *)from, 2, true, (const char *)prefix, 1, true);
+  ASSERT_EQ(10, (int)slots.size());
+  ASSERT_EQ(790, slots.front());
+
+  // 索引项中的键值与rid对应
+  BplusTreeScanner scanner(handler);
+  ASSERT_EQ(RC::SUCCESS, scanner.open((const char *)left, 2, false, (const char *)right, 2, true));
+  RID rid;
+  int key[2];
+  int count = 0;
+  while (RC::SUCCESS == scanner.next_entry(&rid, (char *)key)) {
+    int i = (rid.page_num - 1) * 100 + rid.slot_num;
+    ASSERT_EQ(i / 100, key[0]);
+    ASSERT_EQ(i % 100, key[1]);
+    count++;
+  }
+  scanner.close();
+  ASSERT_EQ(10, count);
+
+  handler.close();
+  ::unlink(file_name);
+}
+
+TEST(test_bplus_tree, test_bulk_load) {
+  const char *file_name = "bplus_tree_bulk_load_test.index";
+  ::unlink(file_name);
+
+  FieldMeta field_meta;
+  ASSERT_EQ(RC::SUCCESS, field_meta.init("k", INTS, 0, sizeof(int), true, false));
+  std::vector<const FieldMeta *> fields_meta{&field_meta};
+  BplusTreeHandler handler;
+  ASSERT_EQ(RC::SUCCESS, handler.create(file_name, fields_meta, sizeof(int)));
+
+  // 很小的内存限制，排序时写出多个有序段并且需要多轮归并。键值都是偶数，最低字节不会是'!'，不会被当作空值
+  IndexBuildOptions options;
+  options.memory_limit = 16 * 1024;
+  BplusTreeBuilder builder(handler, options);
+  const int entry_num = 20000;
+  for (int i = 0; i < entry_num; i++) {
+    int j = (int)((long long)i * 7919 % entry_num);
+    int key = 4 * j;
+    RID rid = make_rid(j);
+    ASSERT_EQ(RC::SUCCESS, builder.add_entry((const char *)&key, &rid));
+    ASSERT_LE(builder.memory_used(), options.memory_limit);
+  }
+  ASSERT_EQ(RC::SUCCESS, builder.finish());
+  ASSERT_GT(builder.spilled_run_num(), 2);
+
+  std::vector<int> slots = scan_range(handler, nullptr, 0, true, nullptr, 0, true);
+  ASSERT_EQ(entry_num, (int)slots.size());
+  for (int i = 0; i < entry_num; i++) {
+    ASSERT_EQ(i, slots[i]);
+  }
+
+  // 重新打开后从文件头中找到新的根节点
+  handler.close();
+  ASSERT_EQ(RC::SUCCESS, handler.open(file_name));
+  int lower = 4 * 5000;
+  int upper = 4 * 5100;
+  slots = scan_range(handler, (const char *)&lower, 1, true, (const char *)&upper, 1, false);
+  ASSERT_EQ(100, (int)slots.size());
+  ASSERT_EQ(5000, slots.front());
+
+  // 留出的空间可以继续插入和删除
+  for (int i = 0; i < entry_num; i += 2) {
+    int key = 4 * i + 2;
+    RID rid = make_rid(entry_num + i);
+    ASSERT_EQ(RC::SUCCESS, handler.insert_entry((const char *)&key, &rid));
+  }
+  for (int i = 1; i < entry_num; i += 2) {
+    int key = 4 * i;
+    RID rid = make_rid(i);
+    ASSERT_EQ(RC::SUCCESS, handler.delete_entry((const char *)&key, &rid));
+  }
+  slots = scan_range(handler, (const char *)&lower, 1, true, (const char *)&upper, 1, false);
+  ASSERT_EQ(100, (int)slots.size());
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_EQ(5000 + i, slots[i]);
+    ASSERT_EQ(entry_num + 5000 + i, slots[i + 1]);
+  }
+
+  handler.close();
+  ::unlink(file_name);
+}
+
+TEST(test_bplus_tree, test_bulk_load_unique) {
+  const char *file_name = "bplus_tree_bulk_load_unique_test.index";
+
+  FieldMeta field_meta;
+  ASSERT_EQ(RC::SUCCESS, field_meta.init("k", INTS, 0, sizeof(int), true, false));
+  std::vector<const FieldMeta *> fields_meta{&field_meta};
+  IndexBuildOptions options;
+  options.memory_limit = 16 * 1024;
+  const int entry_num = 5000;
+
+  // 重复的键值分别落在内存排序和多路归并的情况
+  for (bool spill : {false, true}) {
+    for (bool duplicate : {false, true}) {
+      ::unlink(file_name);
+      BplusTreeHandler handler;
+      ASSERT_EQ(RC::SUCCESS, handler.create(file_name, fields_meta, sizeof(int)));
+      IndexBuildOptions build_options;
+      if (spill) {
+        build_options = options;
+      }
+      BplusTreeBuilder builder(handler, build_options, true);
+      for (int i = 0; i < entry_num; i++) {
+        int key = 4 * i;
+        RID rid = make_rid(i);
+        ASSERT_EQ(RC::SUCCESS, builder.add_entry((const char *)&key, &rid));
+      }
+      // 空值可以重复
+      const int null_key = '!';
+      for (int i = 0; i < 3; i++) {
+        RID rid = make_rid(entry_num + i);
+        ASSERT_EQ(RC::SUCCESS, builder.add_entry((const char *)&null_key, &rid));
+      }
+      if (duplicate) {
+        int key = 4 * (entry_num / 2);
+        RID rid = make_rid(entry_num + 10);
+        ASSERT_EQ(RC::SUCCESS, builder.add_entry((const char *)&key, &rid));
+      }
+      ASSERT_EQ(spill, builder.spilled_run_num() > 0);
+      ASSERT_EQ(duplicate ? RC::UNIQUEINDEX_CONFLICT : RC::SUCCESS, builder.finish());
+      handler.close();
+    }
+  }
+  ::unlink(file_name);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#ifndef __UNITEST_EXE_NODE_TEST_H_
+#define __UNITEST_EXE_NODE_TEST_H_
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sql/executor/execution_node.h"
+
+/**
+ * 测试用的数据源，按顺序输出row_num行，第i行由generator(i, tuple)生成
+ */
+class GeneratedRowsExeNode : public ExecutionNode {
+public:
+  GeneratedRowsExeNode(const TupleSchema &schema, int row_num, std::function<void(int, Tuple &)> generator)
+      : schema_(schema), row_num_(row_num), estimated_rows_(row_num), generator_(std::move(generator)) {
+  }
+
+  RC open() override {
+    pos_ = 0;
+    return RC::SUCCESS;
+  }
+  RC next(Tuple &tuple) override {
+    if (pos_ >= row_num_) {
+      return RC::RECORD_EOF;
+    }
+    generator_(pos_++, tuple);
+    return RC::SUCCESS;
+  }
+  RC close() override {
+    return RC::SUCCESS;
+  }
+  const TupleSchema &schema() const override {
+    return schema_;
+  }
+  double estimated_rows() const override {
+    return estimated_rows_;
+  }
+
+  /**
+   * 默认估计的行数就是实际的行数，测试选择执行方式时可以修改
+   */
+  void set_estimated_rows(double rows) {
+    estimated_rows_ = rows;
+  }
+
+private:
+  TupleSchema schema_;
+  int row_num_;
+  double estimated_rows_;
+  std::function<void(int, Tuple &)> generator_;
+  int pos_ = 0;
+};
+
+/**
+ * 取出已经打开的node中剩下的所有行，每一行的值用'|'连接。返回最后一次next的结果，正常结束时是RECORD_EOF
+ */
+inline RC drain_rows(ExecutionNode &node, std::vector<std::string> &rows) {
+  RC rc = RC::SUCCESS;
+  while (true) {
+    Tuple tuple;
+    rc = node.next(tuple);
+    if (rc != RC::SUCCESS) {
+      break;
+    }
+    std::stringstream ss;
+    for (const auto &value : tuple.values()) {
+      value->to_string(ss);
+      ss << "|";
+    }
+    rows.push_back(ss.str());
+  }
+  return rc;
+}
+
+#endif //__UNITEST_EXE_NODE_TEST_H_
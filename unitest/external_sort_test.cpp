@@ -0,0 +1,98 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sql/executor/external_sort.h"
+#include "exe_node_test.h"
+
+// 输出 (k, id, s)，k有很多重复。k是偶数，避开第一个字节是'!'被当作空值的整数
+static GeneratedRowsExeNode *unsorted_rows(int row_num) {
+  TupleSchema schema;
+  schema.add(INTS, "t", "k");
+  schema.add(INTS, "t", "id");
+  schema.add(CHARS, "t", "s");
+  return new GeneratedRowsExeNode(schema, row_num, [](int i, Tuple &tuple) {
+    const int key = (i * 7919) % 97 * 2;
+    char s[16];
+    int len = snprintf(s, sizeof(s), "s%d", key % 13);
+    tuple.add(key);
+    tuple.add(i);
+    tuple.add(s, len);
+  });
+}
+
+static std::vector<std::string> sort_rows(int row_num, std::vector<SortKey> keys, size_t memory_limit,
+                                          int *spilled_run_num) {
+  SortOptions options;
+  options.memory_limit = memory_limit;
+  SortExeNode node;
+  EXPECT_EQ(RC::SUCCESS, node.init(unsorted_rows(row_num), std::move(keys), options));
+  EXPECT_EQ(RC::SUCCESS, node.open());
+
+  std::vector<std::string> rows;
+  EXPECT_EQ(RC::RECORD_EOF, drain_rows(node, rows));
+  *spilled_run_num = node.spilled_run_num();
+  node.close();
+  return rows;
+}
+
+TEST(test_external_sort, test_loser_tree) {
+  std::vector<std::vector<int>> ways = {{1, 4, 9}, {2, 3}, {}, {0, 5, 6, 7}, {8}};
+  std::vector<size_t> pos(ways.size(), 0);
+  auto value = [&](int way) { return pos[way] < ways[way].size() ? ways[way][pos[way]] : 100; };
+
+  LoserTree tree;
+  tree.init(ways.size(), [&](int left, int right) { return value(left) < value(right); });
+  for (int i = 0; i < 10; i++) {
+    int way = tree.top();
+    ASSERT_EQ(i, value(way));
+    pos[way]++;
+    tree.adjust(way);
+  }
+}
+
+// 写到临时文件中归并的结果要和全部在内存中排序的结果一致，相等的行保持原来的顺序
+TEST(test_external_sort, test_spill_same_as_memory) {
+  const int row_num = 5000;
+  std::vector<std::vector<SortKey>> keys_list = {
+      {{0, true}}, {{0, false}}, {{2, false}, {0, true}}, {{1, false}}};
+
+  for (auto &keys : keys_list) {
+    int memory_run_num = 0;
+    int spilled_run_num = 0;
+    std::vector<std::string> expected = sort_rows(row_num, keys, SortOptions::DEFAULT_MEMORY_LIMIT, &memory_run_num);
+    std::vector<std::string> rows = sort_rows(row_num, keys, 8 * 1024, &spilled_run_num);
+    ASSERT_EQ(0, memory_run_num);
+    ASSERT_GT(spilled_run_num, 1);
+    ASSERT_EQ((size_t)row_num, expected.size());
+    ASSERT_EQ(expected, rows);
+  }
+}
+
+// 内存只能容纳很少几页时需要多次归并
+TEST(test_external_sort, test_multi_pass_merge) {
+  int spilled_run_num = 0;
+  std::vector<std::string> rows = sort_rows(3000, {{0, true}, {1, true}}, 2 * SortRun::PAGE_SIZE, &spilled_run_num);
+  ASSERT_GT(spilled_run_num, 2);
+  ASSERT_EQ(3000, (int)rows.size());
+  ASSERT_TRUE(std::is_sorted(rows.begin(), rows.end(), [](const std::string &l, const std::string &r) {
+    return std::stoi(l) < std::stoi(r);
+  }));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,148 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "exe_node_test.h"
+#include "sql/executor/external_sort.h"
+
+// 第一个字节是'!'的整数被当作null
+static const int NULL_INT = '!';
+
+// a(k, id)：每10行有一行k是null
+static GeneratedRowsExeNode *outer_rows(int row_num) {
+  TupleSchema schema;
+  schema.add(INTS, "a", "k");
+  schema.add(INTS, "a", "id");
+  return new GeneratedRowsExeNode(schema, row_num, [](int i, Tuple &tuple) {
+    tuple.add(i % 10 == 9 ? NULL_INT : (i * 7) % 13 * 2);
+    tuple.add(i);
+  });
+}
+
+// b(k, v)：每7行有一行k是null
+static GeneratedRowsExeNode *inner_rows(int row_num) {
+  TupleSchema schema;
+  schema.add(INTS, "b", "k");
+  schema.add(INTS, "b", "v");
+  return new GeneratedRowsExeNode(schema, row_num, [](int i, Tuple &tuple) {
+    tuple.add(i % 7 == 3 ? NULL_INT : (i * 5) % 11 * 2);
+    tuple.add(i * 3 % 100);
+  });
+}
+
+static Condition make_condition(const char *left_table, const char *left_field, CompOp comp,
+                                const char *right_table, const char *right_field) {
+  Condition condition;
+  memset(&condition, 0, sizeof(condition));
+  condition.left_type = ATTR;
+  condition.left_attr.relation_name = (char *)left_table;
+  condition.left_attr.attribute_name = (char *)left_field;
+  condition.comp = comp;
+  condition.right_type = ATTR;
+  condition.right_attr.relation_name = (char *)right_table;
+  condition.right_attr.attribute_name = (char *)right_field;
+  return condition;
+}
+
+static std::vector<std::string> run_join(ExecutionNode &node) {
+  std::vector<std::string> rows;
+  EXPECT_EQ(RC::SUCCESS, node.open());
+  EXPECT_EQ(RC::RECORD_EOF, drain_rows(node, rows));
+  node.close();
+  return rows;
+}
+
+class HashJoinTest : public testing::Test {
+protected:
+  void SetUp() override {
+    // 等值条件之外还有一个只能在匹配后计算的条件
+    key_condition_ = make_condition("a", "k", EQUAL_TO, "b", "k");
+    residual_condition_ = make_condition("b", "v", GREAT_THAN, "a", "id");
+
+    JoinExeNode nested_loop;
+    ASSERT_EQ(RC::SUCCESS, nested_loop.init(outer_rows(OUTER_ROWS), inner_rows(INNER_ROWS), conditions()));
+    expected_ = run_join(nested_loop);
+    ASSERT_FALSE(expected_.empty());
+    for (const std::string &row : expected_) {
+      ASSERT_EQ(std::string::npos, row.find("null"));
+    }
+  }
+
+  std::vector<const Condition *> conditions() const {
+    return {&key_condition_, &residual_condition_};
+  }
+
+  static const int OUTER_ROWS = 60;
+  static const int INNER_ROWS = 80;
+
+  Condition key_condition_;
+  Condition residual_condition_;
+  std::vector<std::string> expected_;
+};
+
+TEST_F(HashJoinTest, test_build_on_inner) {
+  // 内层的估计行数较少，哈希表建在内层，输出的顺序与嵌套循环连接相同
+  GeneratedRowsExeNode *outer = outer_rows(OUTER_ROWS);
+  GeneratedRowsExeNode *inner = inner_rows(INNER_ROWS);
+  outer->set_estimated_rows(1000);
+  HashJoinExeNode node;
+  ASSERT_EQ(RC::SUCCESS, node.init(outer, inner, conditions(), false));
+  ASSERT_TRUE(node.build_on_inner());
+  ASSERT_EQ(expected_, run_join(node));
+}
+
+TEST_F(HashJoinTest, test_build_on_outer) {
+  // 外层的估计行数较少，哈希表建在外层，按内层的顺序输出，行的集合与嵌套循环连接相同
+  HashJoinExeNode node;
+  ASSERT_EQ(RC::SUCCESS, node.init(outer_rows(OUTER_ROWS), inner_rows(INNER_ROWS), conditions(), false));
+  ASSERT_FALSE(node.build_on_inner());
+  std::vector<std::string> rows = run_join(node);
+  std::vector<std::string> expected = expected_;
+  std::sort(rows.begin(), rows.end());
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(expected, rows);
+
+  // 重新打开后结果不变
+  std::vector<std::string> rows_again = run_join(node);
+  std::sort(rows_again.begin(), rows_again.end());
+  ASSERT_EQ(expected, rows_again);
+}
+
+TEST_F(HashJoinTest, test_keep_order) {
+  // 需要保持嵌套循环的顺序时，即使外层较少也建在内层
+  HashJoinExeNode node;
+  ASSERT_EQ(RC::SUCCESS, node.init(outer_rows(OUTER_ROWS), inner_rows(INNER_ROWS), conditions(), true));
+  ASSERT_TRUE(node.build_on_inner());
+  ASSERT_EQ(expected_, run_join(node));
+}
+
+TEST_F(HashJoinTest, test_merge_join_keep_order) {
+  // 哈希表放不下时改用排序归并连接，没有ORDER BY时输出的顺序仍然与嵌套循环连接相同
+  SortOptions options;
+  options.memory_limit = 1024;
+  MergeJoinExeNode node;
+  ASSERT_EQ(RC::SUCCESS, node.init(outer_rows(OUTER_ROWS), inner_rows(INNER_ROWS), conditions(), options, true));
+  ASSERT_EQ(expected_, run_join(node));
+
+  // 不需要保持顺序时按连接字段排序，行的集合相同
+  MergeJoinExeNode unordered;
+  ASSERT_EQ(RC::SUCCESS, unordered.init(outer_rows(OUTER_ROWS), inner_rows(INNER_ROWS), conditions(), options, false));
+  std::vector<std::string> rows = run_join(unordered);
+  std::vector<std::string> expected = expected_;
+  ASSERT_NE(expected, rows);
+  std::sort(rows.begin(), rows.end());
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQ(expected, rows);
+}
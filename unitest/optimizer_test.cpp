@@ -0,0 +1,248 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sql/optimizer/optimizer.h"
+#include "storage/common/table_meta.h"
+#include "storage/common/table_stats.h"
+
+// 与Optimizer相同的代价：最外层表的行数加上每次连接后的行数
+static double join_cost(const std::vector<double> &rows, const std::vector<std::vector<double>> &selectivity,
+                        const std::vector<int> &order) {
+  double card = rows[order[0]];
+  double cost = card;
+  for (size_t i = 1; i < order.size(); i++) {
+    card *= rows[order[i]];
+    for (size_t j = 0; j < i; j++) {
+      card *= selectivity[order[i]][order[j]];
+    }
+    cost += card;
+  }
+  return cost;
+}
+
+static void random_graph(int n, std::vector<double> &rows, std::vector<std::vector<double>> &selectivity) {
+  rows.clear();
+  selectivity.assign(n, std::vector<double>(n, 1.0));
+  for (int i = 0; i < n; i++) {
+    rows.push_back(1 + rand() % 10000);
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      if (rand() % 2 == 0) {
+        selectivity[i][j] = selectivity[j][i] = 1.0 / (1 + rand() % 1000);
+      }
+    }
+  }
+}
+
+TEST(test_optimizer, test_dp_is_optimal) {
+  srand(1);
+  for (int round = 0; round < 20; round++) {
+    const int n = 2 + round % 4;
+    std::vector<double> rows;
+    std::vector<std::vector<double>> selectivity;
+    random_graph(n, rows, selectivity);
+
+    std::vector<int> order;
+    double cost = Optimizer::order_joins(rows, selectivity, order);
+    ASSERT_EQ(n, (int)order.size());
+    ASSERT_DOUBLE_EQ(join_cost(rows, selectivity, order), cost);
+
+    std::vector<int> permutation;
+    for (int i = 0; i < n; i++) {
+      permutation.push_back(i);
+    }
+    double best = join_cost(rows, selectivity, permutation);
+    while (std::next_permutation(permutation.begin(), permutation.end())) {
+      best = std::min(best, join_cost(rows, selectivity, permutation));
+    }
+    ASSERT_LE(cost, best * (1 + 1e-9));
+  }
+}
+
+TEST(test_optimizer, test_keep_order_without_difference) {
+  // 所有表都一样时保持从最后一张表开始连接的顺序
+  std::vector<double> rows(4, 100);
+  std::vector<std::vector<double>> selectivity(4, std::vector<double>(4, 0.01));
+  std::vector<int> order;
+  Optimizer::order_joins(rows, selectivity, order);
+  ASSERT_EQ((std::vector<int>{3, 2, 1, 0}), order);
+}
+
+TEST(test_optimizer, test_greedy_order) {
+  // 超过MAX_DP_TABLES张表，链式连接 t0-t1-...-t7，t5最小
+  const int n = Optimizer::MAX_DP_TABLES + 2;
+  std::vector<double> rows(n, 1000);
+  rows[5] = 10;
+  std::vector<std::vector<double>> selectivity(n, std::vector<double>(n, 1.0));
+  for (int i = 0; i + 1 < n; i++) {
+    selectivity[i][i + 1] = selectivity[i + 1][i] = 0.001;
+  }
+
+  std::vector<int> order;
+  double cost = Optimizer::order_joins(rows, selectivity, order);
+  ASSERT_EQ(n, (int)order.size());
+  ASSERT_EQ(5, order[0]);
+  ASSERT_DOUBLE_EQ(join_cost(rows, selectivity, order), cost);
+
+  // 每张新加入的表都和已经连接的表有连接条件，没有笛卡尔积
+  for (int i = 1; i < n; i++) {
+    bool connected = false;
+    for (int j = 0; j < i; j++) {
+      connected = connected || selectivity[order[i]][order[j]] < 1;
+    }
+    ASSERT_TRUE(connected);
+  }
+}
+
+TEST(test_optimizer, test_table_stats) {
+  TableStats stats;
+  stats.row_count = 1000;
+  ColumnStats id;
+  id.name = "id";
+  id.ndv = 1000;
+  id.has_range = true;
+  id.min = 1;
+  id.max = 1000;
+  stats.columns.push_back(id);
+  ColumnStats name;
+  name.name = "name";
+  name.ndv = 10;
+  name.null_count = 500;
+  stats.columns.push_back(name);
+
+  std::stringstream ss;
+  ASSERT_GT(stats.serialize(ss), 0);
+  TableStats loaded;
+  ASSERT_GT(loaded.deserialize(ss), 0);
+  ASSERT_EQ(1000, loaded.row_count);
+  ASSERT_EQ(2, (int)loaded.columns.size());
+  ASSERT_TRUE(loaded.column("id")->has_range);
+  ASSERT_DOUBLE_EQ(1000, loaded.column("id")->max);
+  ASSERT_FALSE(loaded.column("name")->has_range);
+  ASSERT_EQ(500, loaded.column("name")->null_count);
+  ASSERT_EQ(nullptr, loaded.column("age"));
+
+  int number = 251;
+  Value value;
+  value.type = INTS;
+  value.data = &number;
+  ASSERT_DOUBLE_EQ(0.001, loaded.selectivity("id", EQUAL_TO, value));
+  ASSERT_NEAR(0.25, loaded.selectivity("id", LESS_THAN, value), 0.01);
+  ASSERT_NEAR(0.75, loaded.selectivity("id", GREAT_EQUAL, value), 0.01);
+  number = 2000;
+  ASSERT_DOUBLE_EQ(0, loaded.selectivity("id", EQUAL_TO, value));
+
+  char text[] = "a";
+  value.type = CHARS;
+  value.data = text;
+  ASSERT_DOUBLE_EQ(0.05, loaded.selectivity("name", EQUAL_TO, value));
+  ASSERT_DOUBLE_EQ(0.5, loaded.selectivity("name", IS_COMPOP, value));
+  ASSERT_DOUBLE_EQ(TableStats::DEFAULT_EQUAL_SELECTIVITY, loaded.selectivity("age", EQUAL_TO, value));
+
+  ASSERT_DOUBLE_EQ(0.001, loaded.join_selectivity("name", &loaded, "id"));
+}
+
+TEST(test_optimizer, test_histogram_on_skewed_column) {
+  AttrInfo attr;
+  attr_info_init(&attr, "k", INTS, sizeof(int), 0);
+  TableMeta table_meta;
+  ASSERT_EQ(RC::SUCCESS, table_meta.init("t", 1, &attr));
+  attr_info_destroy(&attr);
+  const FieldMeta *field = table_meta.field("k");
+
+  // 40%的行是500，其它的行在[0, 1000)中均匀分布，跳过第一个字节是'!'的整数
+  srand(2);
+  const int row_num = 100000;
+  int less_num = 0;
+  std::vector<char> record(table_meta.record_size(), 0);
+  TableStatsCollector collector(table_meta);
+  for (int i = 0; i < row_num; i++) {
+    int k = 500;
+    if (rand() % 10 >= 4) {
+      do {
+        k = rand() % 1000;
+      } while (k % 256 == '!');
+    }
+    less_num += k < 250 ? 1 : 0;
+    memcpy(record.data() + field->offset(), &k, sizeof(k));
+    collector.add_record(record.data());
+  }
+
+  TableStats stats;
+  collector.finish(stats);
+  const ColumnStats *column = stats.column("k");
+  ASSERT_NE(nullptr, column);
+  ASSERT_EQ(row_num, stats.row_count);
+  ASSERT_FALSE(column->mcvs.empty());
+  ASSERT_DOUBLE_EQ(500, column->mcvs[0].number);
+  ASSERT_EQ(TableStatsCollector::HISTOGRAM_BUCKETS + 1, (int)column->bounds.size());
+
+  int number = 500;
+  Value value;
+  value.type = INTS;
+  value.data = &number;
+  ASSERT_NEAR(0.4, stats.selectivity("k", EQUAL_TO, value), 0.02);
+  ASSERT_NEAR(0.4 + 0.6 * 0.5, stats.selectivity("k", LESS_EQUAL, value), 0.03);
+  ASSERT_NEAR(0.6 * 0.5, stats.selectivity("k", GREAT_THAN, value), 0.03);
+  number = 250;
+  ASSERT_NEAR((double)less_num / row_num, stats.selectivity("k", LESS_THAN, value), 0.02);
+  ASSERT_NEAR(0.6 / 1000, stats.selectivity("k", EQUAL_TO, value), 0.0005);
+
+  // 直方图和最常见的值可以保存后再读出来
+  std::stringstream ss;
+  ASSERT_GT(stats.serialize(ss), 0);
+  TableStats loaded;
+  ASSERT_GT(loaded.deserialize(ss), 0);
+  ASSERT_EQ(column->bounds, loaded.column("k")->bounds);
+  ASSERT_EQ(column->mcvs.size(), loaded.column("k")->mcvs.size());
+  ASSERT_DOUBLE_EQ(stats.selectivity("k", LESS_THAN, value), loaded.selectivity("k", LESS_THAN, value));
+}
+
+TEST(test_optimizer, test_estimate_ndv_from_sample) {
+  AttrInfo attrs[2];
+  attr_info_init(&attrs[0], "id", INTS, sizeof(int), 0);
+  attr_info_init(&attrs[1], "k", INTS, sizeof(int), 0);
+  TableMeta table_meta;
+  ASSERT_EQ(RC::SUCCESS, table_meta.init("t", 2, attrs));
+  attr_info_destroy(&attrs[0]);
+  attr_info_destroy(&attrs[1]);
+  const FieldMeta *id_field = table_meta.field("id");
+  const FieldMeta *k_field = table_meta.field("k");
+
+  // 行数超过样本大小，id每行都不同，k只有200个不同的值
+  const int row_num = 4 * TableStatsCollector::SAMPLE_SIZE;
+  std::vector<char> record(table_meta.record_size(), 0);
+  TableStatsCollector collector(table_meta);
+  for (int i = 0; i < row_num; i++) {
+    int id = i * 4;
+    int k = (i % 200) * 4;
+    memcpy(record.data() + id_field->offset(), &id, sizeof(id));
+    memcpy(record.data() + k_field->offset(), &k, sizeof(k));
+    collector.add_record(record.data());
+  }
+
+  TableStats stats;
+  collector.finish(stats);
+  ASSERT_NEAR(row_num, stats.column("id")->ndv, row_num * 0.05);
+  ASSERT_EQ(200, stats.column("k")->ndv);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
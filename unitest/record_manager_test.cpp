@@ -0,0 +1,396 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "storage/common/record_manager.h"
+#include "gtest/gtest.h"
+
+TEST(test_free_space_map, test_free_space_map_find) {
+  const char *file_name = "fsm_find_test.fsm";
+  ::unlink(file_name);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(16, 1));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(file_name));
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+
+  FreeSpaceMap free_space_map;
+  ASSERT_EQ(RC::SUCCESS, free_space_map.init(buffer_pool, file_id));
+  ASSERT_TRUE(free_space_map.empty());
+  ASSERT_EQ(-1, free_space_map.find(1));
+
+  ASSERT_EQ(0, FreeSpaceMap::free_class(0, 100));
+  ASSERT_EQ(0, FreeSpaceMap::free_class(1, 100));
+  ASSERT_EQ((FreeSpaceMap::CLASS_NUM - 1) / 2, FreeSpaceMap::free_class(50, 100));
+  // 剩余空间不够的页面等级一定低于min_class
+  for (int size = 1; size <= 100; size++) {
+    ASSERT_LT(FreeSpaceMap::free_class(size - 1, 100), FreeSpaceMap::min_class(size, 100));
+  }
+  ASSERT_EQ(FreeSpaceMap::CLASS_NUM - 1, FreeSpaceMap::free_class(100, 100));
+
+  // 优先选择剩余空间最少并且足够的页面
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(5, 3));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(9000, 6));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(7, 2));
+  ASSERT_EQ(7, free_space_map.find(1));
+  ASSERT_EQ(5, free_space_map.find(3));
+  ASSERT_EQ(9000, free_space_map.find(4));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.update(7, 0));
+  ASSERT_EQ(5, free_space_map.find(1));
+  ASSERT_EQ(-1, free_space_map.find(FreeSpaceMap::CLASS_NUM));
+
+  // 重新打开后从文件中恢复
+  free_space_map.close();
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(file_name, &file_id));
+  ASSERT_EQ(RC::SUCCESS, free_space_map.init(buffer_pool, file_id));
+  ASSERT_FALSE(free_space_map.empty());
+  ASSERT_EQ(3, free_space_map.get(5));
+  ASSERT_EQ(0, free_space_map.get(7));
+  ASSERT_EQ(6, free_space_map.get(9000));
+  ASSERT_EQ(5, free_space_map.find(1));
+
+  free_space_map.close();
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(file_name);
+}
+
+TEST(test_record_file_handler, test_insert_reuse_free_space) {
+  const char *data_file = "fsm_record_test.data";
+  const char *fsm_file = "fsm_record_test.fsm";
+  ::unlink(data_file);
+  ::unlink(fsm_file);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(64, 1));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(data_file));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(fsm_file));
+  int file_id = -1;
+  int fsm_file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(data_file, &file_id));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(fsm_file, &fsm_file_id));
+
+  const int record_size = 100;
+  const int record_num = 1000;
+  char record[record_size] = {0};
+  std::vector<RID> rids(record_num);
+  {
+    RecordFileHandler record_handler;
+    ASSERT_EQ(RC::SUCCESS, record_handler.init(buffer_pool, file_id, fsm_file_id));
+    for (int i = 0; i < record_num; i++) {
+      ASSERT_EQ(RC::SUCCESS, record_handler.insert_record(record, record_size, &rids[i]));
+    }
+    // 每隔一条删除，空出来的位置散布在所有页面上
+    for (int i = 0; i < record_num; i += 2) {
+      ASSERT_EQ(RC::SUCCESS, record_handler.delete_record(&rids[i]));
+    }
+    ASSERT_EQ(record_num / 2, record_handler.record_num());
+    record_handler.close();
+  }
+
+  int page_count = 0;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.get_page_count(file_id, &page_count));
+
+  // 重新打开后插入的记录使用删除后空出的位置，文件不再增长
+  RecordFileHandler record_handler;
+  ASSERT_EQ(RC::SUCCESS, record_handler.init(buffer_pool, file_id, fsm_file_id));
+  // 页面数少于抽样的页面数，重新打开后估计的记录数是准确的
+  ASSERT_EQ(record_num / 2, record_handler.record_num());
+  for (int i = 0; i < record_num / 2; i++) {
+    RID rid;
+    ASSERT_EQ(RC::SUCCESS, record_handler.insert_record(record, record_size, &rid));
+  }
+  ASSERT_EQ(record_num, record_handler.record_num());
+  int new_page_count = 0;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.get_page_count(file_id, &new_page_count));
+  ASSERT_EQ(page_count, new_page_count);
+  record_handler.close();
+
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(fsm_file_id));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(data_file);
+  ::unlink(fsm_file);
+}
+
+TEST(test_record_file_handler, test_variable_length_record) {
+  const char *data_file = "var_record_test.data";
+  ::unlink(data_file);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(64, 1));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(data_file));
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(data_file, &file_id));
+
+  // 记录格式: int id; char name[200]; int value
+  const int record_size = 208;
+  RecordCodec codec;
+  codec.init(record_size, {{4, 200}});
+
+  RecordFileHandler record_handler;
+  ASSERT_EQ(RC::SUCCESS, record_handler.init(buffer_pool, file_id, -1, &codec));
+
+  const int record_num = 1000;
+  std::vector<RID> rids(record_num);
+  char record[record_size];
+  for (int i = 0; i < record_num; i++) {
+    memset(record, 0, sizeof(record));
+    memcpy(record, &i, sizeof(i));
+    snprintf(record + 4, 200, "name%d", i);
+    memcpy(record + 204, &i, sizeof(i));
+    ASSERT_EQ(RC::SUCCESS, record_handler.insert_record(record, record_size, &rids[i]));
+  }
+
+  // 短字符串只占实际长度，页面数远少于定长存放需要的页面数
+  int page_count = 0;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.get_page_count(file_id, &page_count));
+  ASSERT_LT(page_count, record_num * record_size / BP_PAGE_DATA_SIZE / 4);
+
+  // 变长后放不下的记录迁移到其它页面，rid不变
+  for (int i = 0; i < record_num; i += 3) {
+    Record rec;
+    std::vector<char> buffer;
+    ASSERT_EQ(RC::SUCCESS, record_handler.get_record(&rids[i], &rec, buffer));
+    memset(rec.data + 4, 'a' + i % 26, 199);
+    ASSERT_EQ(RC::SUCCESS, record_handler.update_record(&rec));
+  }
+  for (int i = 0; i < record_num; i += 2) {
+    ASSERT_EQ(RC::SUCCESS, record_handler.delete_record(&rids[i]));
+  }
+
+  for (int i = 1; i < record_num; i += 2) {
+    Record rec;
+    std::vector<char> buffer;
+    ASSERT_EQ(RC::SUCCESS, record_handler.get_record(&rids[i], &rec, buffer));
+    ASSERT_EQ(0, memcmp(rec.data, &i, sizeof(i)));
+    ASSERT_EQ(0, memcmp(rec.data + 204, &i, sizeof(i)));
+    if (i % 3 == 0) {
+      ASSERT_EQ(199, (int)strlen(rec.data + 4));
+      ASSERT_EQ('a' + i % 26, rec.data[4]);
+    } else {
+      ASSERT_STREQ(("name" + std::to_string(i)).c_str(), rec.data + 4);
+    }
+  }
+
+  // 扫描时每条记录只返回一次，包括迁移过的记录
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, scanner.open_scan(buffer_pool, file_id, nullptr, &codec));
+  Record rec;
+  int count = 0;
+  RC rc = scanner.get_first_record(&rec);
+  for (; rc == RC::SUCCESS; rc = scanner.get_next_record(&rec)) {
+    int id = 0;
+    memcpy(&id, rec.data, sizeof(id));
+    ASSERT_EQ(1, id % 2);
+    ASSERT_TRUE(rec.rid == rids[id]);
+    count++;
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(record_num / 2, count);
+  scanner.close_scan();
+
+  // 按页面批量读取的结果与逐条读取一致
+  ASSERT_EQ(RC::SUCCESS, scanner.open_scan(buffer_pool, file_id, nullptr, &codec));
+  RecordBatch batch;
+  count = 0;
+  while ((rc = scanner.get_records_batch(batch)) == RC::SUCCESS) {
+    ASSERT_FALSE(batch.empty());
+    for (int i = 0; i < batch.size(); i++) {
+      int id = 0;
+      memcpy(&id, batch.record(i).data, sizeof(id));
+      ASSERT_TRUE(batch.record(i).rid == rids[id]);
+      ASSERT_EQ(0, memcmp(batch.record(i).data + 204, &id, sizeof(id)));
+      count++;
+    }
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(record_num / 2, count);
+  scanner.close_scan();
+
+  record_handler.close();
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(data_file);
+}
+
+// 记录格式与test_variable_length_record相同，name由同一个字符重复length次组成
+static void make_concurrent_record(char *record, int id, int length) {
+  memset(record, 0, 208);
+  memcpy(record, &id, sizeof(id));
+  memset(record + 4, 'a' + (length + id) % 26, length);
+  memcpy(record + 204, &id, sizeof(id));
+}
+
+static bool check_concurrent_record(const char *record, int id) {
+  const char *name = record + 4;
+  const int length = (int)strnlen(name, 200);
+  for (int i = 0; i < length; i++) {
+    if (name[i] != 'a' + (length + id) % 26) {
+      return false;
+    }
+  }
+  return memcmp(record, &id, sizeof(id)) == 0 && memcmp(record + 204, &id, sizeof(id)) == 0;
+}
+
+TEST(test_record_file_handler, test_concurrent_read_update) {
+  const char *data_file = "concurrent_record_test.data";
+  ::unlink(data_file);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(64, 1));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(data_file));
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(data_file, &file_id));
+
+  const int record_size = 208;
+  RecordCodec codec;
+  codec.init(record_size, {{4, 200}});
+  RecordFileHandler record_handler;
+  ASSERT_EQ(RC::SUCCESS, record_handler.init(buffer_pool, file_id, -1, &codec));
+
+  const int record_num = 200;
+  std::vector<RID> rids(record_num);
+  char record[record_size];
+  for (int i = 0; i < record_num; i++) {
+    make_concurrent_record(record, i, 1);
+    ASSERT_EQ(RC::SUCCESS, record_handler.insert_record(record, record_size, &rids[i]));
+  }
+
+  // 更新时记录在页面中移动，页面还会被整理，读取的线程不能看到写了一半的记录
+  const int writer_num = 2;
+  std::atomic<bool> stop(false);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < writer_num; t++) {
+    threads.emplace_back([&, t]() {
+      char data[record_size];
+      for (int loop = 0; loop < 50; loop++) {
+        for (int i = t; i < record_num; i += writer_num) {
+          make_concurrent_record(data, i, 1 + (loop * 37 + i) % 150);
+          Record rec;
+          rec.rid = rids[i];
+          rec.data = data;
+          if (record_handler.update_record(&rec) != RC::SUCCESS) {
+            errors++;
+          }
+        }
+      }
+    });
+  }
+  threads.emplace_back([&]() {
+    std::vector<char> buffer;
+    while (!stop) {
+      for (int i = 0; i < record_num; i++) {
+        Record rec;
+        if (record_handler.get_record(&rids[i], &rec, buffer) != RC::SUCCESS ||
+            !check_concurrent_record(rec.data, i)) {
+          errors++;
+        }
+      }
+    }
+  });
+  threads.emplace_back([&]() {
+    while (!stop) {
+      RecordFileScanner scanner;
+      RecordBatch batch;
+      scanner.open_scan(buffer_pool, file_id, nullptr, &codec);
+      while (scanner.get_records_batch(batch) == RC::SUCCESS) {
+        for (int i = 0; i < batch.size(); i++) {
+          int id = 0;
+          memcpy(&id, batch.record(i).data, sizeof(id));
+          if (id < 0 || id >= record_num || !check_concurrent_record(batch.record(i).data, id)) {
+            errors++;
+          }
+        }
+      }
+      scanner.close_scan();
+    }
+  });
+
+  for (int t = 0; t < writer_num; t++) {
+    threads[t].join();
+  }
+  stop = true;
+  for (size_t t = writer_num; t < threads.size(); t++) {
+    threads[t].join();
+  }
+  ASSERT_EQ(0, errors.load());
+
+  record_handler.close();
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(data_file);
+}
+
+TEST(test_record_file_handler, test_overflow_pages) {
+  const char *data_file = "overflow_record_test.data";
+  ::unlink(data_file);
+
+  DiskBufferPool buffer_pool;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.init(64, 1));
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.create_file(data_file));
+  int file_id = -1;
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.open_file(data_file, &file_id));
+
+  RecordFileHandler record_handler;
+  ASSERT_EQ(RC::SUCCESS, record_handler.init(buffer_pool, file_id));
+
+  const int record_size = 16;
+  char record[record_size] = {0};
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, record_handler.insert_record(record, record_size, &rid));
+
+  // 跨越多个页面的大字段
+  std::string text;
+  for (int i = 0; i < 20000; i++) {
+    text.push_back('a' + i % 26);
+  }
+  PageNum first_page = -1;
+  ASSERT_EQ(RC::SUCCESS, record_handler.insert_overflow(text.data(), (int)text.size(), &first_page));
+  PageNum empty_page = -1;
+  ASSERT_EQ(RC::SUCCESS, record_handler.insert_overflow("", 0, &empty_page));
+
+  std::string result;
+  ASSERT_EQ(RC::SUCCESS, record_handler.get_overflow(first_page, result));
+  ASSERT_EQ(text, result);
+  ASSERT_EQ(RC::SUCCESS, record_handler.get_overflow(empty_page, result));
+  ASSERT_TRUE(result.empty());
+
+  // 扫描时跳过溢出页
+  RecordFileScanner scanner;
+  ASSERT_EQ(RC::SUCCESS, scanner.open_scan(buffer_pool, file_id, nullptr));
+  Record rec;
+  ASSERT_EQ(RC::SUCCESS, scanner.get_first_record(&rec));
+  ASSERT_TRUE(rec.rid == rid);
+  ASSERT_EQ(RC::RECORD_EOF, scanner.get_next_record(&rec));
+  scanner.close_scan();
+
+  ASSERT_EQ(RC::SUCCESS, record_handler.delete_overflow(first_page));
+  ASSERT_EQ(RC::SUCCESS, record_handler.delete_overflow(empty_page));
+  ASSERT_NE(RC::SUCCESS, record_handler.get_overflow(first_page, result));
+
+  record_handler.close();
+  ASSERT_EQ(RC::SUCCESS, buffer_pool.close_file(file_id));
+  ::unlink(data_file);
+}
+
+int main(int argc, char **argv) {
+
+  // 分析gtest程序的命令行参数
+  testing::InitGoogleTest(&argc, argv);
+
+  // 调用RUN_ALL_TESTS()运行所有测试用例
+  // main函数返回RUN_ALL_TESTS()的运行结果
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <unistd.h>
+#include <set>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "sql/parser/parse.h"
+#include "storage/common/bplus_tree_builder.h"
+#include "storage/common/index.h"
+#include "storage/common/meta_util.h"
+#include "storage/common/table.h"
+
+static void remove_table_files(const char *table_name, const char *index_name) {
+  ::unlink(table_meta_file(".", table_name).c_str());
+  ::unlink((std::string("./") + table_name + TABLE_DATA_SUFFIX).c_str());
+  ::unlink((std::string("./") + table_name + TABLE_FSM_SUFFIX).c_str());
+  ::unlink(index_data_file(".", table_name, index_name).c_str());
+}
+
+// 创建前删除上次留下的文件，测试结束后表关闭了再删除。需要在Table之前定义
+class TableFilesGuard {
+public:
+  TableFilesGuard(const char *table_name, const char *index_name) : table_name_(table_name), index_name_(index_name) {
+    remove_table_files(table_name_, index_name_);
+  }
+  ~TableFilesGuard() {
+    remove_table_files(table_name_, index_name_);
+  }
+
+private:
+  const char *table_name_;
+  const char *index_name_;
+};
+
+// context是一个string，按它的长度复制记录开头的数据
+static void copy_record_prefix(const char *data, void *context) {
+  std::string &record_data = *(std::string *) context;
+  record_data.assign(data, data + record_data.size());
+}
+
+TEST(test_table, test_update_short_chars) {
+  const char *table_name = "table_update_test";
+  const char *index_name = "table_update_test_name";
+  TableFilesGuard files_guard(table_name, index_name);
+
+  AttrInfo attrs[2];
+  attr_info_init(&attrs[0], "id", INTS, sizeof(int), 0);
+  attr_info_init(&attrs[1], "name", CHARS, 16, 0);
+
+  Table table;
+  std::string meta_file = table_meta_file(".", table_name);
+  ASSERT_EQ(RC::SUCCESS, table.create(meta_file.c_str(), table_name, ".", 2, attrs));
+  const char *index_attrs[] = {"name"};
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, index_name, index_attrs, 1, 0, IndexBuildOptions()));
+
+  Value values[2];
+  value_init_integer_int(&values[0], 1);
+  value_init_string(&values[1], "abcdefghijklmno");
+  ASSERT_EQ(RC::SUCCESS, table.insert_record(nullptr, 2, values));
+
+  // 新值比字段短，字段中剩余的字节要清零，不能读到值后面的内存
+  Value value;
+  value_init_string(&value, "xy");
+  int updated_count = 0;
+  ASSERT_EQ(RC::SUCCESS, table.update_record(nullptr, nullptr, "name", &value, &updated_count));
+  ASSERT_EQ(1, updated_count);
+
+  const FieldMeta *field = table.table_meta().field("name");
+  std::string record_data(field->offset() + field->len(), '\0');
+  ASSERT_EQ(RC::SUCCESS, table.scan_record(nullptr, nullptr, -1, &record_data, copy_record_prefix));
+  std::string expected("xy");
+  expected.resize(field->len(), '\0');
+  ASSERT_EQ(expected, record_data.substr(field->offset()));
+
+  // 索引中是新的键值
+  Index *index = table.find_index_by_field("name");
+  ASSERT_NE(nullptr, index);
+  IndexScanner *scanner = index->create_scanner(EQUAL_TO, expected.data());
+  ASSERT_NE(nullptr, scanner);
+  RID rid;
+  ASSERT_EQ(RC::SUCCESS, scanner->next_entry(&rid));
+  ASSERT_NE(RC::SUCCESS, scanner->next_entry(&rid));
+  scanner->destroy();
+
+  value_destroy(&value);
+  value_destroy(&values[0]);
+  value_destroy(&values[1]);
+}
+
+TEST(test_table, test_index_range_batches) {
+  const char *table_name = "table_range_test";
+  const char *index_name = "table_range_test_id";
+  TableFilesGuard files_guard(table_name, index_name);
+
+  AttrInfo attrs[2];
+  attr_info_init(&attrs[0], "id", INTS, sizeof(int), 0);
+  attr_info_init(&attrs[1], "name", CHARS, 16, 0);
+
+  Table table;
+  std::string meta_file = table_meta_file(".", table_name);
+  ASSERT_EQ(RC::SUCCESS, table.create(meta_file.c_str(), table_name, ".", 2, attrs));
+  const char *index_attrs[] = {"id"};
+  ASSERT_EQ(RC::SUCCESS, table.create_index(nullptr, index_name, index_attrs, 1, 0, IndexBuildOptions()));
+
+  // 键值的低字节不能是'!'，否则会被当成空值
+  const int record_num = 5000;
+  for (int i = 0; i < record_num; i++) {
+    Value values[2];
+    value_init_integer_int(&values[0], i * 4);
+    value_init_string(&values[1], "name");
+    ASSERT_EQ(RC::SUCCESS, table.insert_record(nullptr, 2, values));
+    value_destroy(&values[0]);
+    value_destroy(&values[1]);
+  }
+
+  // 范围内的记录分成多批返回，每条记录只返回一次
+  int left = 400;
+  int right = 16000;
+  IndexScanRange range;
+  range.left_key.assign((const char *) &left, sizeof(left));
+  range.left_attr_num = 1;
+  range.right_key.assign((const char *) &right, sizeof(right));
+  range.right_attr_num = 1;
+  range.right_inclusive = false;
+  Index *index = table.find_index_by_field("id");
+  ASSERT_NE(nullptr, index);
+  IndexScanner *scanner = index->create_scanner(range);
+  ASSERT_NE(nullptr, scanner);
+
+  const FieldMeta *field = table.table_meta().field("id");
+  std::set<int> ids;
+  int batch_num = 0;
+  RecordBatch batch;
+  RC rc = RC::SUCCESS;
+  while (RC::SUCCESS == (rc = table.get_records_by_range(nullptr, scanner, batch))) {
+    ASSERT_FALSE(batch.empty());
+    batch_num++;
+    for (int i = 0; i < batch.size(); i++) {
+      int id = 0;
+      memcpy(&id, batch.record(i).data + field->offset(), sizeof(id));
+      ASSERT_TRUE(id >= left && id < right);
+      ASSERT_TRUE(ids.insert(id).second);
+    }
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  ASSERT_EQ(RC::RECORD_EOF, table.get_records_by_range(nullptr, scanner, batch));
+  scanner->destroy();
+  ASSERT_EQ((right - left) / 4, (int) ids.size());
+  ASSERT_GT(batch_num, 1);
+
+  // 只用索引项构造记录时返回相同的行，不在索引中的字段填0
+  scanner = index->create_scanner(range);
+  ASSERT_NE(nullptr, scanner);
+  const FieldMeta *name_field = table.table_meta().field("name");
+  std::set<int> index_only_ids;
+  while (RC::SUCCESS == (rc = table.get_index_only_records(nullptr, index, scanner, batch))) {
+    ASSERT_FALSE(batch.empty());
+    for (int i = 0; i < batch.size(); i++) {
+      int id = 0;
+      memcpy(&id, batch.record(i).data + field->offset(), sizeof(id));
+      ASSERT_TRUE(index_only_ids.insert(id).second);
+      ASSERT_EQ(0, batch.record(i).data[name_field->offset()]);
+    }
+  }
+  ASSERT_EQ(RC::RECORD_EOF, rc);
+  scanner->destroy();
+  ASSERT_EQ(ids, index_only_ids);
+}
@@ -0,0 +1,141 @@
+/* Copyright (c) 2021 Xie Meiyi(xiemeiyi@hust.edu.cn) and OceanBase and/or its affiliates. All rights reserved.
+miniob is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+         http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include <string.h>
+#include <stdio.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sql/executor/vectorized.h"
+#include "storage/common/condition_filter.h"
+#include "storage/common/field_meta.h"
+#include "storage/common/record_manager.h"
+
+static const int RECORD_SIZE = 16;
+
+static ConDesc attr_desc(const FieldMeta &field) {
+  ConDesc desc;
+  memset(&desc, 0, sizeof(desc));
+  desc.is_attr = true;
+  desc.attr_length = field.len();
+  desc.attr_offset = field.offset();
+  desc.groupby_offset = -1;
+  return desc;
+}
+
+static ConDesc value_desc(void *value) {
+  ConDesc desc;
+  memset(&desc, 0, sizeof(desc));
+  desc.is_attr = false;
+  desc.value = value;
+  desc.groupby_offset = -1;
+  return desc;
+}
+
+// 按列过滤的结果要和逐条记录过滤的结果一致
+static void check_predicate(const DefaultConditionFilter &filter, const DataChunk &chunk, int column_index,
+                            const std::vector<Record> &records) {
+  ASSERT_TRUE(VectorizedPredicate::support(filter));
+  VectorizedPredicate predicate;
+  ASSERT_EQ(RC::SUCCESS, predicate.init(filter, column_index));
+
+  std::vector<int> selection = chunk.selection();
+  predicate.filter(chunk, selection);
+
+  std::vector<int> expected;
+  for (int i = 0; i < chunk.size(); i++) {
+    if (filter.filter(records[i])) {
+      expected.push_back(i);
+    }
+  }
+  ASSERT_EQ(expected, selection);
+}
+
+TEST(test_vectorized, test_column_filter) {
+  FieldMeta id_field, score_field, name_field;
+  id_field.init("id", INTS, 0, 4, true, false);
+  score_field.init("score", FLOATS, 4, 4, true, true);
+  name_field.init("name", CHARS, 8, 8, true, false);
+
+  const int record_num = 1500;
+  std::vector<char> data(record_num * RECORD_SIZE, 0);
+  std::vector<Record> records(record_num);
+  std::vector<const Record *> record_ptrs;
+  for (int i = 0; i < record_num; i++) {
+    char *record = data.data() + i * RECORD_SIZE;
+    int id = i;
+    float score = (i % 100) / 4.0f;
+    memcpy(record, &id, sizeof(id));
+    if (i % 7 == 0) {
+      record[4] = '!';
+    } else {
+      memcpy(record + 4, &score, sizeof(score));
+    }
+    snprintf(record + 8, 8, "n%d", i % 30);
+    records[i].rid.page_num = 1;
+    records[i].rid.slot_num = i;
+    records[i].data = record;
+    record_ptrs.push_back(&records[i]);
+  }
+
+  DataChunk chunk;
+  int id_column = chunk.add_column(id_field);
+  int score_column = chunk.add_column(score_field);
+  int name_column = chunk.add_column(name_field);
+  ASSERT_EQ(id_column, chunk.add_column(id_field));
+  ASSERT_EQ(3, chunk.column_num());
+
+  ASSERT_EQ(DataChunk::CAPACITY, chunk.append(record_ptrs.data(), record_num));
+  ASSERT_TRUE(chunk.full());
+  ASSERT_EQ(0, chunk.append(record_ptrs.data(), record_num));
+  ASSERT_EQ(DataChunk::CAPACITY, (int)chunk.selection().size());
+  ASSERT_TRUE(chunk.column(score_column).is_null(0));
+  ASSERT_EQ(100, chunk.column(id_column).int_value(100));
+  ASSERT_STREQ("n3", chunk.column(name_column).data(33));
+
+  int int_value = 500;
+  float float_value = 10.3f;
+  char chars_value[] = "n12";
+
+  DefaultConditionFilter id_filter;
+  ASSERT_EQ(RC::SUCCESS, id_filter.init(attr_desc(id_field), value_desc(&int_value), INTS, INTS, GREAT_EQUAL));
+  check_predicate(id_filter, chunk, id_column, records);
+
+  DefaultConditionFilter value_left_filter;
+  ASSERT_EQ(RC::SUCCESS, value_left_filter.init(value_desc(&float_value), attr_desc(id_field), FLOATS, INTS, LESS_THAN));
+  check_predicate(value_left_filter, chunk, id_column, records);
+
+  DefaultConditionFilter score_filter;
+  ASSERT_EQ(RC::SUCCESS, score_filter.init(attr_desc(score_field), value_desc(&float_value), FLOATS, FLOATS, NOT_EQUAL));
+  check_predicate(score_filter, chunk, score_column, records);
+
+  DefaultConditionFilter name_filter;
+  ASSERT_EQ(RC::SUCCESS, name_filter.init(attr_desc(name_field), value_desc(chars_value), CHARS, CHARS, LESS_EQUAL));
+  check_predicate(name_filter, chunk, name_column, records);
+
+  DefaultConditionFilter null_filter;
+  ASSERT_EQ(RC::SUCCESS, null_filter.init(attr_desc(score_field), value_desc(nullptr), FLOATS, NULLS, IS_NOT_COMPOP));
+  check_predicate(null_filter, chunk, score_column, records);
+
+  DefaultConditionFilter in_filter;
+  ASSERT_EQ(RC::SUCCESS, in_filter.init(attr_desc(id_field), value_desc(&int_value), INTS, INTS, IN_COMPOP));
+  ASSERT_FALSE(VectorizedPredicate::support(in_filter));
+
+  chunk.reset();
+  ASSERT_EQ(0, chunk.size());
+  ASSERT_EQ(record_num - DataChunk::CAPACITY,
+            chunk.append(record_ptrs.data() + DataChunk::CAPACITY, record_num - DataChunk::CAPACITY));
+  ASSERT_EQ(DataChunk::CAPACITY, chunk.column(id_column).int_value(0));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}